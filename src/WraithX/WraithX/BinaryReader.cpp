@@ -6,6 +6,7 @@
 // We require the patterns utility functions
 #include "Patterns.h"
 #include "Systems.h"
+#include "Encryption.h"
 
 BinaryReader::BinaryReader()
 {
@@ -13,6 +14,9 @@ BinaryReader::BinaryReader()
     FileHandle = nullptr;
     // Init the length
     FileLength = 0;
+    // Init the decryption
+    DecryptionKeyLength = 0;
+    KeystreamBlock = UINT64_MAX;
 }
 
 BinaryReader::~BinaryReader()
@@ -102,6 +106,57 @@ void BinaryReader::Close()
         // Set the values
         FileHandle = nullptr;
         FileLength = 0;
+        DecryptionKeyLength = 0;
+        KeystreamBlock = UINT64_MAX;
+    }
+}
+
+void BinaryReader::SetDecryption(const Salsa20Key& Key)
+{
+    // Make sure we have a valid key
+    if (Key.IV == nullptr || Key.Key == nullptr || Key.KeyLength == 0)
+        return;
+
+    // Copy it, the caller's buffers may not outlive us
+    std::memcpy(DecryptionKey, Key.Key, (Key.KeyLength == 128) ? 16 : 32);
+    std::memcpy(DecryptionIV, Key.IV, sizeof(DecryptionIV));
+    DecryptionKeyLength = Key.KeyLength;
+    KeystreamBlock = UINT64_MAX;
+}
+
+void BinaryReader::Decrypt(uint8_t* Buffer, uint64_t Offset, uint64_t Length)
+{
+    // Nothing to do if we aren't decrypting
+    if (DecryptionKeyLength == 0 || Length == 0)
+        return;
+
+    // The key
+    Salsa20Key Key;
+    Key.Key = DecryptionKey;
+    Key.IV = DecryptionIV;
+    Key.KeyLength = DecryptionKeyLength;
+
+    // Large reads go straight through
+    if (Length > sizeof(Keystream))
+    {
+        Encryption::Salsa20Range((int8_t*)Buffer, Length, Offset, Key);
+        return;
+    }
+
+    // Small reads use the last keystream block, only building a new one when they move past it
+    for (uint64_t i = 0; i < Length; i++)
+    {
+        auto Block = (Offset + i) / sizeof(Keystream);
+
+        if (Block != KeystreamBlock)
+        {
+            // Encrypting zeros gives us the keystream
+            std::memset(Keystream, 0, sizeof(Keystream));
+            Encryption::Salsa20Range((int8_t*)Keystream, sizeof(Keystream), Block * sizeof(Keystream), Key);
+            KeystreamBlock = Block;
+        }
+
+        Buffer[i] ^= Keystream[(Offset + i) % sizeof(Keystream)];
     }
 }
 
@@ -252,8 +307,12 @@ int8_t* BinaryReader::Read(uint64_t Length, uint64_t& Result)
         int8_t* ResultBlock = new int8_t[(size_t)Length];
         // Zero out the memory
         std::memset(ResultBlock, 0, (size_t)Length);
+        // Keep the offset if we must decrypt it
+        auto Offset = (DecryptionKeyLength != 0) ? GetPosition() : 0;
         // Read it
         size_t LengthRead = fread_s(ResultBlock, (size_t)Length, 1, (size_t)Length, FileHandle);
+        // Decrypt what we read
+        Decrypt((uint8_t*)ResultBlock, Offset, LengthRead);
         // Set result
         Result = LengthRead;
         // Return result
@@ -282,8 +341,12 @@ void BinaryReader::Read(uint8_t* Buffer, uint64_t Length, uint64_t& Result)
     // Make sure we are loaded
     if (FileHandle != nullptr)
     {
+        // Keep the offset if we must decrypt it
+        auto Offset = (DecryptionKeyLength != 0) ? GetPosition() : 0;
         // Read to the buffer
         Result = fread(Buffer, 1, Length, FileHandle);
+        // Decrypt what we read
+        Decrypt(Buffer, Offset, Result);
     }
 }
 
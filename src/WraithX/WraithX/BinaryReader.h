@@ -4,6 +4,9 @@
 #include <string>
 #include <cstdio>
 
+// Contains the information for a Salsa20 Cipher (Defined in Encryption.h)
+struct Salsa20Key;
+
 // A class that handles reading and scanning a binary file for data
 class BinaryReader
 {
@@ -13,6 +16,20 @@ private:
     // The length of the file
     uint64_t FileLength;
 
+    // The Salsa20 key reads are decrypted with
+    uint8_t DecryptionKey[32];
+    // The Salsa20 iv reads are decrypted with
+    uint8_t DecryptionIV[8];
+    // The length of the key in bits, 0 if reads aren't decrypted
+    uint32_t DecryptionKeyLength;
+    // The last keystream block used by small reads, so reading a few bytes at a time doesn't rebuild it each read
+    uint8_t Keystream[64];
+    // The index of the keystream block, or UINT64_MAX if none
+    uint64_t KeystreamBlock;
+
+    // Decrypts data that was read from the given offset, if decryption is on
+    void Decrypt(uint8_t* Buffer, uint64_t Offset, uint64_t Length);
+
 public:
     BinaryReader();
     ~BinaryReader();
@@ -28,6 +45,11 @@ public:
     // Close the file (If we aren't already closed)
     void Close();
 
+    // Decrypts every read from the file with the Salsa20 key, the whole file is a single stream, so only the ranges read are decrypted
+    void SetDecryption(const Salsa20Key& Key);
+    // Whether or not reads are decrypted
+    bool IsDecrypting() const { return DecryptionKeyLength != 0; }
+
     // Gets the length of the file
     uint64_t GetLength() const;
     // Gets the current position of the file
@@ -49,8 +71,11 @@ public:
             T ResultValue;
             // Zero out the memory
             std::memset(&ResultValue, 0, sizeof(ResultValue));
+            // Keep the offset if we must decrypt it
+            auto Offset = (DecryptionKeyLength != 0) ? GetPosition() : 0;
             // Read the value from the process
-            fread_s(&ResultValue, sizeof(ResultValue), sizeof(ResultValue), 1, FileHandle);
+            if (fread_s(&ResultValue, sizeof(ResultValue), sizeof(ResultValue), 1, FileHandle) == 1)
+                Decrypt((uint8_t*)&ResultValue, Offset, sizeof(ResultValue));
             // Return the result
             return ResultValue;
         }
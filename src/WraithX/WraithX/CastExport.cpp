@@ -3,124 +3,129 @@
 // The class we are implementing
 #include "CastExport.h"
 
-// We need the binarywriter class
-#include "BinaryWriter.h"
-
 // We need the strings class
 #include "Strings.h"
 
 // We need the hashing class
 #include "Hashing.h"
 
-void WriteCastProperty(BinaryWriter& Writer, const std::string& Name, const CastProperty* Prop)
-{
-	Writer.Write((uint16_t)Prop->Identifier);
-	Writer.Write((uint16_t)Name.size());
-	Writer.Write((uint32_t)Prop->Elements);
-	Writer.Write((const uint8_t*)Name.c_str(), (uint32_t)Name.size());
-	if(Prop->Elements > 0)
-		Writer.Write((const uint8_t*)&Prop->Buffer[0], (uint32_t)Prop->Buffer.size());
-}
-
-void WriteCastNode(BinaryWriter& Writer, const CastNode* Node)
-{
-	Writer.Write((uint32_t)Node->Identifier);
-	Writer.Write((uint32_t)Node->Size());
-	Writer.Write(Node->Hash);
-	Writer.Write((uint32_t)Node->Properties.size());
-	Writer.Write((uint32_t)Node->Children.size());
+// We need the following std classes
+#include <cstring>
 
-	for (auto& Prop : Node->Properties)
-	{
-		WriteCastProperty(Writer, Prop.first, Prop.second.get());
-	}
+// The size of the buffer data is staged in before it's written
+constexpr size_t CastWriterBufferSize = 0x100000;
 
-	for (auto& Child : Node->Children)
+// Gets the name of an animation type, as a curve mode
+static const char* GetCastCurveMode(const WraithAnimationType Type)
+{
+	switch (Type)
 	{
-		WriteCastNode(Writer, Child.get());
+	case WraithAnimationType::Absolute: return "absolute";
+	case WraithAnimationType::Additive: return "additive";
+	default: return "relative";
 	}
 }
 
-void WriteCastFile(BinaryWriter& Writer, const CastNode& Node)
+// Writes a curve node for one component of a key list
+template <class T, class TGetValue>
+static void WriteCastCurve(CastWriter& Writer, const std::string& NodeName, const char* KeyProperty, const char* Mode, const std::vector<uint32_t>& Frames, const std::vector<T>& Values, const CastPropertyId ValueType, const TGetValue& GetValue)
 {
-	Writer.Write(0x74736163);
-	Writer.Write(1);
-	Writer.Write(1);
-	Writer.Write(0);
+	uint32_t LargestFrame = 0;
 
-	WriteCastNode(Writer, &Node);
+	for (auto Frame : Frames)
+		LargestFrame = std::max(LargestFrame, Frame);
+
+	auto KeyFrameBufferType = CastWriter::GetIndexType(LargestFrame);
+
+	Writer.BeginNode(CastNodeId::Curve);
+	Writer.WriteProperty("nn", NodeName);
+	Writer.WriteProperty("kp", KeyProperty);
+	Writer.WriteProperty("m", Mode);
+
+	Writer.BeginProperty("kb", KeyFrameBufferType, Frames.size());
+	for (auto Frame : Frames)
+		Writer.WriteIndex(KeyFrameBufferType, Frame);
+
+	Writer.BeginProperty("kv", ValueType, Values.size());
+	for (auto& Value : Values)
+		Writer.Write(GetValue(Value));
+
+	Writer.EndNode();
 }
 
 void Cast::ExportCastModel(const WraithModel& Model, const std::string& FileName, bool SupportsScale)
 {
-	BinaryWriter Writer;
+	BinaryWriter FileWriter;
 
-	if (!Writer.Create(FileName))
+	if (!FileWriter.Create(FileName))
 		return;
 
-	CastNode CastRoot;
-	auto CastModel = CastRoot.AddNode(CastNodeId::Model);
-	auto CastSkeleton = CastModel->AddNode(CastNodeId::Skeleton);
+	CastWriter Writer(FileWriter);
+
+	Writer.WriteHeader();
+	Writer.BeginNode(CastNodeId::Root);
+	Writer.BeginNode(CastNodeId::Model);
+	Writer.BeginNode(CastNodeId::Skeleton);
 
 	for (auto& Bone : Model.Bones)
 	{
-		auto CastBone = CastSkeleton->AddNode(CastNodeId::Bone);
-
-		CastBone->SetProperty("n", Bone.TagName);
-		CastBone->SetProperty("p", CastPropertyId::Integer32, (uint32_t)Bone.BoneParent);
-		CastBone->SetProperty("lr", CastPropertyId::Vector4, Bone.LocalRotation);
-		CastBone->SetProperty("lp", CastPropertyId::Vector3, Bone.LocalPosition);
-		CastBone->SetProperty("wr", CastPropertyId::Vector4, Bone.GlobalRotation);
-		CastBone->SetProperty("wp", CastPropertyId::Vector3, Bone.GlobalPosition);
-		CastBone->SetProperty("s", CastPropertyId::Vector3, Bone.BoneScale);
+		Writer.BeginNode(CastNodeId::Bone);
+		Writer.WriteProperty("n", Bone.TagName);
+		Writer.WriteProperty("p", CastPropertyId::Integer32, (uint32_t)Bone.BoneParent);
+		Writer.WriteProperty("lr", CastPropertyId::Vector4, Bone.LocalRotation);
+		Writer.WriteProperty("lp", CastPropertyId::Vector3, Bone.LocalPosition);
+		Writer.WriteProperty("wr", CastPropertyId::Vector4, Bone.GlobalRotation);
+		Writer.WriteProperty("wp", CastPropertyId::Vector3, Bone.GlobalPosition);
+		Writer.WriteProperty("s", CastPropertyId::Vector3, Bone.BoneScale);
+		Writer.EndNode();
 	}
 
-	auto BoneCount = Model.BoneCount();
-	auto BoneIndexType = BoneCount <= 0xFFFF ? BoneCount <= 0xFF ? CastPropertyId::Byte : CastPropertyId::Short : CastPropertyId::Integer32;
+	Writer.EndNode();
+
+	auto BoneIndexType = CastWriter::GetIndexType(Model.BoneCount());
 
 	std::vector<uint64_t> MaterialHashes;
 
 	for (auto& Material : Model.Materials)
 	{
-		auto CastMaterial = CastModel->AddNode(CastNodeId::Material, Hashing::HashXXHashString(Material.MaterialName));
-
-		CastMaterial->SetProperty("n", Material.MaterialName);
-		CastMaterial->SetProperty("t", "pbr");
-
-		MaterialHashes.push_back(CastMaterial->Hash);
-
-		auto CastDiffuse = CastMaterial->AddNode(CastNodeId::File, Hashing::HashXXHashString(Material.DiffuseMapName));
-		CastDiffuse->SetProperty("p", Material.DiffuseMapName);
-		CastMaterial->SetProperty("albedo", CastPropertyId::Integer64, CastDiffuse->Hash);
-		auto CastNormal = CastMaterial->AddNode(CastNodeId::File, Hashing::HashXXHashString(Material.NormalMapName));
-		CastNormal->SetProperty("p", Material.NormalMapName);
-		CastMaterial->SetProperty("normal", CastPropertyId::Integer64, CastNormal->Hash);
-		auto CastSpec = CastMaterial->AddNode(CastNodeId::File, Hashing::HashXXHashString(Material.SpecularMapName));
-		CastSpec->SetProperty("p", Material.SpecularMapName);
-		CastMaterial->SetProperty("specular", CastPropertyId::Integer64, CastSpec->Hash);
+		auto MaterialHash = Hashing::HashXXHashString(Material.MaterialName);
+		auto DiffuseHash = Hashing::HashXXHashString(Material.DiffuseMapName);
+		auto NormalHash = Hashing::HashXXHashString(Material.NormalMapName);
+		auto SpecularHash = Hashing::HashXXHashString(Material.SpecularMapName);
+
+		MaterialHashes.push_back(MaterialHash);
+
+		Writer.BeginNode(CastNodeId::Material, MaterialHash);
+		Writer.WriteProperty("n", Material.MaterialName);
+		Writer.WriteProperty("t", "pbr");
+		Writer.WriteProperty("albedo", CastPropertyId::Integer64, DiffuseHash);
+		Writer.WriteProperty("normal", CastPropertyId::Integer64, NormalHash);
+		Writer.WriteProperty("specular", CastPropertyId::Integer64, SpecularHash);
+
+		Writer.BeginNode(CastNodeId::File, DiffuseHash);
+		Writer.WriteProperty("p", Material.DiffuseMapName);
+		Writer.EndNode();
+		Writer.BeginNode(CastNodeId::File, NormalHash);
+		Writer.WriteProperty("p", Material.NormalMapName);
+		Writer.EndNode();
+		Writer.BeginNode(CastNodeId::File, SpecularHash);
+		Writer.WriteProperty("p", Material.SpecularMapName);
+		Writer.EndNode();
+
+		Writer.EndNode();
 	}
 
 	int MeshIndex = 0;
 	for (auto& Mesh : Model.Submeshes)
 	{
 		auto MeshHash = Hashing::HashXXHashString(MeshIndex == 0 ? "CastMesh" : "CastMesh" + std::to_string(MeshIndex));
-		auto CastMesh = CastModel->AddNode(CastNodeId::Mesh, MeshHash);
 		MeshIndex++;
 
 		auto VertCount = Mesh.VertexCount();
-		auto FaceIndexType = VertCount <= 0xFFFF ? VertCount <= 0xFF ? CastPropertyId::Byte : CastPropertyId::Short : CastPropertyId::Integer32;
-
-		auto Positions   = CastMesh->AddProperty("vp", CastPropertyId::Vector3, VertCount * sizeof(Vector3));
-		auto Normals     = CastMesh->AddProperty("vn", CastPropertyId::Vector3, VertCount * sizeof(Vector3));
-		auto Colors      = CastMesh->AddProperty("vc", CastPropertyId::Integer32, VertCount * sizeof(uint32_t));
-		auto Materials   = CastMesh->AddProperty("m", CastPropertyId::Integer64, VertCount * sizeof(uint64_t));
-		auto FaceIndices = CastMesh->AddProperty("f", FaceIndexType, VertCount * sizeof(uint32_t));
-		auto BoneIndices = CastMesh->AddProperty("wb", BoneIndexType);
-		auto BoneWeights = CastMesh->AddProperty("wv", CastPropertyId::Float, VertCount * sizeof(uint32_t));
-		auto UVLayer     = CastMesh->AddProperty("u0", CastPropertyId::Vector2, VertCount * sizeof(float));
-		
-		uint8_t MaterialCountBuffer = (uint8_t)Mesh.MaterialCount();
+		auto FaceIndexType = CastWriter::GetIndexType(VertCount);
+
 		uint8_t MaxSkinInfluenceBuffer = 0;
+		size_t FaceCount = 0;
 
 		// Iterate to dynamically calculate max weight influence
 		for (auto& Vertex : Mesh.Verticies)
@@ -129,337 +134,330 @@ void Cast::ExportCastModel(const WraithModel& Model, const std::string& FileName
 				MaxSkinInfluenceBuffer = (uint8_t)Vertex.WeightCount();
 		}
 
-		CastMesh->SetProperty("mi", CastPropertyId::Byte, MaxSkinInfluenceBuffer);
-		CastMesh->SetProperty("ul", CastPropertyId::Byte, (uint8_t)1); // TODO: Multiple UV Layers, not needed rn now for CoD
+		// Skip degen faces, Maya don't be vibing to it
+		for (auto& Face : Mesh.Faces)
+		{
+			if (Face.Index1 != Face.Index2 && Face.Index2 != Face.Index3 && Face.Index3 != Face.Index1)
+				FaceCount++;
+		}
+
+		Writer.BeginNode(CastNodeId::Mesh, MeshHash);
+		Writer.WriteProperty("mi", CastPropertyId::Byte, MaxSkinInfluenceBuffer);
+		Writer.WriteProperty("ul", CastPropertyId::Byte, (uint8_t)1); // TODO: Multiple UV Layers, not needed rn now for CoD
 
+		if (Mesh.MaterialCount() > 0 && Mesh.MaterialIndicies[0] >= 0 && Mesh.MaterialIndicies[0] < (int32_t)MaterialHashes.size())
+			Writer.WriteProperty("m", CastPropertyId::Integer64, MaterialHashes[Mesh.MaterialIndicies[0]]);
+
+		Writer.BeginProperty("vp", CastPropertyId::Vector3, VertCount);
 		for (auto& Vertex : Mesh.Verticies)
-		{
-			Positions->Write(Vertex.Position);
-			Normals->Write(Vertex.Normal);
-			Colors->Write(*(uint32_t*)&Vertex.Color[0]);
-			UVLayer->Write(Vertex.UVLayers[0]);
+			Writer.Write(Vertex.Position);
+
+		Writer.BeginProperty("vn", CastPropertyId::Vector3, VertCount);
+		for (auto& Vertex : Mesh.Verticies)
+			Writer.Write(Vertex.Normal);
 
+		Writer.BeginProperty("vc", CastPropertyId::Integer32, VertCount);
+		for (auto& Vertex : Mesh.Verticies)
+			Writer.WriteBytes(&Vertex.Color[0], sizeof(uint32_t));
+
+		Writer.BeginProperty("u0", CastPropertyId::Vector2, VertCount);
+		for (auto& Vertex : Mesh.Verticies)
+			Writer.Write(Vertex.UVLayers[0]);
+
+		Writer.BeginProperty("wb", BoneIndexType, (size_t)VertCount * MaxSkinInfluenceBuffer);
+		for (auto& Vertex : Mesh.Verticies)
+		{
 			for (uint32_t i = 0; i < MaxSkinInfluenceBuffer; i++)
-			{
-				// Write IDs
-				auto WeightID = (i < Vertex.WeightCount()) ? Vertex.Weights[i].BoneIndex : 0;
-				auto WeightValue = (i < Vertex.WeightCount()) ? Vertex.Weights[i].Weight : 0.0f;
+				Writer.WriteIndex(BoneIndexType, (i < Vertex.WeightCount()) ? Vertex.Weights[i].BoneIndex : 0);
+		}
 
-				switch (BoneIndexType)
-				{
-				case CastPropertyId::Byte:
-					BoneIndices->Write((uint8_t)WeightID);
-					BoneWeights->Write(WeightValue); break;
-				case CastPropertyId::Short:
-					BoneIndices->Write((uint16_t)WeightID);
-					BoneWeights->Write(WeightValue); break;
-				case CastPropertyId::Integer32:
-					BoneIndices->Write((uint32_t)WeightID);
-					BoneWeights->Write(WeightValue); break;
-				}
-			}
+		Writer.BeginProperty("wv", CastPropertyId::Float, (size_t)VertCount * MaxSkinInfluenceBuffer);
+		for (auto& Vertex : Mesh.Verticies)
+		{
+			for (uint32_t i = 0; i < MaxSkinInfluenceBuffer; i++)
+				Writer.Write((i < Vertex.WeightCount()) ? Vertex.Weights[i].Weight : 0.0f);
 		}
 
+		Writer.BeginProperty("f", FaceIndexType, FaceCount * 3);
 		for (auto& Face : Mesh.Faces)
 		{
-			// Skip degen faces, Maya don't be vibing to it
 			if (Face.Index1 == Face.Index2 || Face.Index2 == Face.Index3 || Face.Index3 == Face.Index1)
 				continue;
 
-			switch (FaceIndexType)
-			{
-			case CastPropertyId::Byte:
-				FaceIndices->Write((uint8_t)Face.Index3);
-				FaceIndices->Write((uint8_t)Face.Index2);
-				FaceIndices->Write((uint8_t)Face.Index1); break;
-			case CastPropertyId::Short:
-				FaceIndices->Write((uint16_t)Face.Index3);
-				FaceIndices->Write((uint16_t)Face.Index2);
-				FaceIndices->Write((uint16_t)Face.Index1); break;
-			case CastPropertyId::Integer32:
-				FaceIndices->Write((uint32_t)Face.Index3);
-				FaceIndices->Write((uint32_t)Face.Index2);
-				FaceIndices->Write((uint32_t)Face.Index1); break;
-			}
+			Writer.WriteIndex(FaceIndexType, Face.Index3);
+			Writer.WriteIndex(FaceIndexType, Face.Index2);
+			Writer.WriteIndex(FaceIndexType, Face.Index1);
 		}
 
+		Writer.EndNode();
+
 		if (Model.BlendShapes.size() > 0)
 		{
-			std::unordered_map<size_t, CastNode*> blendMap;
-			for (int i = 0; i < Mesh.VertexCount(); i++)
+			// The vertex and delta index of each shape's deltas, shapes are written in the order they are first used
+			std::vector<uint32_t> BlendOrder;
+			std::unordered_map<uint32_t, std::vector<std::pair<uint32_t, uint32_t>>> BlendDeltas;
+
+			for (uint32_t i = 0; i < VertCount; i++)
 			{
 				auto& Vertex = Mesh.Verticies[i];
-				for (auto& BlendDeltaPosition : Vertex.BlendShapeDeltas)
+				for (uint32_t d = 0; d < (uint32_t)Vertex.BlendShapeDeltas.size(); d++)
 				{
+					auto& BlendDeltaPosition = Vertex.BlendShapeDeltas[d];
 					if (BlendDeltaPosition.second != Vector3(0, 0, 0))
 					{
-						if (blendMap.find(BlendDeltaPosition.first) == blendMap.end())
-						{
-							auto blend = CastModel->AddNode(CastNodeId::BlendShape);
-							blend->SetProperty("n", Model.BlendShapes[BlendDeltaPosition.first]);
-							blend->SetProperty("b", CastPropertyId::Integer64, CastMesh->Hash);
-							blend->SetProperty("ts", CastPropertyId::Float, 1.0f);
-							blend->AddProperty("vp", CastPropertyId::Vector3, Vertex.BlendShapeDeltas.size() * sizeof(Vector3));
-							blend->AddProperty("vi", FaceIndexType, Vertex.BlendShapeDeltas.size() * sizeof(uint32_t));
-							blendMap[BlendDeltaPosition.first] = blend;
-						}
-						auto& blend = blendMap[BlendDeltaPosition.first];
-
-						blend->Properties["vp"]->Write(Vertex.Position + BlendDeltaPosition.second);
-						switch (FaceIndexType)
-						{
-						case CastPropertyId::Byte:
-							blend->Properties["vi"]->Write((uint8_t)i); break;
-						case CastPropertyId::Short:
-							blend->Properties["vi"]->Write((uint16_t)i); break;
-						case CastPropertyId::Integer32:
-							blend->Properties["vi"]->Write((uint32_t)i); break;
-						}
+						auto& Deltas = BlendDeltas[BlendDeltaPosition.first];
+						if (Deltas.empty())
+							BlendOrder.push_back(BlendDeltaPosition.first);
+						Deltas.emplace_back(i, d);
 					}
 				}
 			}
+
+			for (auto BlendIndex : BlendOrder)
+			{
+				auto& Deltas = BlendDeltas[BlendIndex];
+
+				Writer.BeginNode(CastNodeId::BlendShape);
+				Writer.WriteProperty("n", Model.BlendShapes[BlendIndex]);
+				Writer.WriteProperty("b", CastPropertyId::Integer64, MeshHash);
+				Writer.WriteProperty("ts", CastPropertyId::Float, 1.0f);
+
+				Writer.BeginProperty("vp", CastPropertyId::Vector3, Deltas.size());
+				for (auto& Delta : Deltas)
+				{
+					auto& Vertex = Mesh.Verticies[Delta.first];
+					Writer.Write(Vertex.Position + Vertex.BlendShapeDeltas[Delta.second].second);
+				}
+
+				Writer.BeginProperty("vi", FaceIndexType, Deltas.size());
+				for (auto& Delta : Deltas)
+					Writer.WriteIndex(FaceIndexType, Delta.first);
+
+				Writer.EndNode();
+			}
 		}
-		Materials->Write(MaterialHashes[Mesh.MaterialIndicies[0]]);
 	}
 
-	WriteCastFile(Writer, CastRoot);
+	Writer.EndNode();
+	Writer.EndNode();
 }
 
 void Cast::ExportCastAnim(const WraithAnim& Anim, const std::string& FileName, bool SupportsScale)
 {
-	BinaryWriter Writer;
+	BinaryWriter FileWriter;
 
-	if (!Writer.Create(FileName))
+	if (!FileWriter.Create(FileName))
 		return;
 
-	CastNode CastRoot;
-	auto CastAnim = CastRoot.AddNode(CastNodeId::Animation);
-	//CastNode& CastSkeleton = CastModel.AddNode(CastNodeId::Skeleton);
-
-	CastAnim->SetProperty("fr", CastPropertyId::Float, Anim.FrameRate);
-	CastAnim->SetProperty("lo", CastPropertyId::Byte, Anim.Looping);
-
-	for (auto& Positions : Anim.AnimationPositionKeys)
-	{
-		if (Positions.second.size() == 0)
-			continue;
-
-		auto XCurve = CastAnim->AddNode(CastNodeId::Curve);
-		auto YCurve = CastAnim->AddNode(CastNodeId::Curve);
-		auto ZCurve = CastAnim->AddNode(CastNodeId::Curve);
-
-		XCurve->SetProperty("nn", Positions.first);
-		YCurve->SetProperty("nn", Positions.first);
-		ZCurve->SetProperty("nn", Positions.first);
-
-		XCurve->SetProperty("kp", "tx");
-		YCurve->SetProperty("kp", "ty");
-		ZCurve->SetProperty("kp", "tz");
-
-		switch (Anim.AnimType)
-		{
-		case WraithAnimationType::Absolute:
-			XCurve->SetProperty("m", "absolute");
-			YCurve->SetProperty("m", "absolute");
-			ZCurve->SetProperty("m", "absolute"); break;
-		case WraithAnimationType::Additive:
-			XCurve->SetProperty("m", "additive");
-			YCurve->SetProperty("m", "additive");
-			ZCurve->SetProperty("m", "additive"); break;
-		default:
-			XCurve->SetProperty("m", "relative");
-			YCurve->SetProperty("m", "relative");
-			ZCurve->SetProperty("m", "relative"); break;
-		}
-
-		uint32_t LargestFrame = 0;
-
-		for (auto& Position : Positions.second)
-			if (Position.Frame > LargestFrame)
-				LargestFrame = Position.Frame;
-
-		auto KeyFrameBufferType = LargestFrame <= 0xFFFF ? LargestFrame <= 0xFF ? CastPropertyId::Byte : CastPropertyId::Short : CastPropertyId::Integer32;
+	CastWriter Writer(FileWriter);
 
-		auto XKeyFrameBuffer = XCurve->AddProperty("kb", KeyFrameBufferType);
-		auto YKeyFrameBuffer = YCurve->AddProperty("kb", KeyFrameBufferType);
-		auto ZKeyFrameBuffer = ZCurve->AddProperty("kb", KeyFrameBufferType);
-		auto XKeyValueBuffer = XCurve->AddProperty("kv", CastPropertyId::Float);
-		auto YKeyValueBuffer = YCurve->AddProperty("kv", CastPropertyId::Float);
-		auto ZKeyValueBuffer = ZCurve->AddProperty("kv", CastPropertyId::Float);
+	Writer.WriteHeader();
+	Writer.BeginNode(CastNodeId::Root);
+	Writer.BeginNode(CastNodeId::Animation);
 
-		for (auto& Position : Positions.second)
-		{
-			XKeyValueBuffer->Write(Position.Value.X);
-			YKeyValueBuffer->Write(Position.Value.Y);
-			ZKeyValueBuffer->Write(Position.Value.Z);
+	Writer.WriteProperty("fr", CastPropertyId::Float, Anim.FrameRate);
+	Writer.WriteProperty("lo", CastPropertyId::Byte, Anim.Looping);
 
-			switch (KeyFrameBufferType)
-			{
-			case CastPropertyId::Byte:
-				XKeyFrameBuffer->Write((uint8_t)Position.Frame);
-				YKeyFrameBuffer->Write((uint8_t)Position.Frame);
-				ZKeyFrameBuffer->Write((uint8_t)Position.Frame); break;
-			case CastPropertyId::Short:
-				XKeyFrameBuffer->Write((uint16_t)Position.Frame);
-				YKeyFrameBuffer->Write((uint16_t)Position.Frame);
-				ZKeyFrameBuffer->Write((uint16_t)Position.Frame); break;
-			case CastPropertyId::Integer32:
-				XKeyFrameBuffer->Write((uint32_t)Position.Frame);
-				YKeyFrameBuffer->Write((uint32_t)Position.Frame);
-				ZKeyFrameBuffer->Write((uint32_t)Position.Frame); break;
-			}
-		}
-	}
+	auto Mode = GetCastCurveMode(Anim.AnimType);
 
-	for (auto& Rotations : Anim.AnimationRotationKeys)
+	for (auto& Bone : Anim.GetBones())
 	{
-		if (Rotations.second.size() == 0)
-			continue;
+		auto& Positions = Bone.Translations;
 
-		auto Curve = CastAnim->AddNode(CastNodeId::Curve);
-
-		Curve->SetProperty("nn", Rotations.first);
-		Curve->SetProperty("kp", "rq");
-
-		switch (Anim.AnimType)
-		{
-		case WraithAnimationType::Absolute:
-			Curve->SetProperty("m", "absolute"); break;
-		case WraithAnimationType::Additive:
-			Curve->SetProperty("m", "additive"); break;
-		default:
-			Curve->SetProperty("m", "absolute"); break; // TODO
-		}
-
-		uint32_t LargestFrame = 0;
+		if (Positions.Empty())
+			continue;
 
-		for (auto& Rotation : Rotations.second)
-			if (Rotation.Frame > LargestFrame)
-				LargestFrame = Rotation.Frame;
+		WriteCastCurve(Writer, Bone.Name, "tx", Mode, Positions.Frames, Positions.Values, CastPropertyId::Float, [](const Vector3& Value) { return Value.X; });
+		WriteCastCurve(Writer, Bone.Name, "ty", Mode, Positions.Frames, Positions.Values, CastPropertyId::Float, [](const Vector3& Value) { return Value.Y; });
+		WriteCastCurve(Writer, Bone.Name, "tz", Mode, Positions.Frames, Positions.Values, CastPropertyId::Float, [](const Vector3& Value) { return Value.Z; });
+	}
 
-		auto KeyFrameBufferType = LargestFrame <= 0xFFFF ? LargestFrame <= 0xFF ? CastPropertyId::Byte : CastPropertyId::Short : CastPropertyId::Integer32;
+	// TODO: Relative rotations are written as absolute
+	auto RotationMode = (Anim.AnimType == WraithAnimationType::Additive) ? "additive" : "absolute";
 
-		auto KeyFrameBuffer = Curve->AddProperty("kb", KeyFrameBufferType);
-		auto KeyValueBuffer = Curve->AddProperty("kv", CastPropertyId::Vector4);
+	for (auto& Bone : Anim.GetBones())
+	{
+		auto& Rotations = Bone.Rotations;
 
-		for (auto& Rotation : Rotations.second)
-		{
-			KeyValueBuffer->Write(Rotation.Value);
+		if (Rotations.Empty())
+			continue;
 
-			switch (KeyFrameBufferType)
-			{
-			case CastPropertyId::Byte:
-				KeyFrameBuffer->Write((uint8_t)Rotation.Frame); break;
-			case CastPropertyId::Short:
-				KeyFrameBuffer->Write((uint16_t)Rotation.Frame); break;
-			case CastPropertyId::Integer32:
-				KeyFrameBuffer->Write((uint32_t)Rotation.Frame); break;
-			}
-		}
+		WriteCastCurve(Writer, Bone.Name, "rq", RotationMode, Rotations.Frames, Rotations.Values, CastPropertyId::Vector4, [](const Quaternion& Value) -> const Quaternion& { return Value; });
 	}
 
 	for (auto& BoneModifier : Anim.AnimationBoneModifiers)
 	{
-		auto CastOverride = CastAnim->AddNode(CastNodeId::CurveModeOverride);
-		CastOverride->SetProperty("nn", BoneModifier.first);
-		CastOverride->SetProperty("ot", CastPropertyId::Byte, (uint8_t)1);
-
-		switch (BoneModifier.second)
-		{
-		case WraithAnimationType::Absolute:
-			CastOverride->SetProperty("m", "absolute"); break;
-		case WraithAnimationType::Additive:
-			CastOverride->SetProperty("m", "additive"); break;
-		default:
-			CastOverride->SetProperty("m", "relative"); break;
-		}
+		Writer.BeginNode(CastNodeId::CurveModeOverride);
+		Writer.WriteProperty("nn", BoneModifier.first);
+		Writer.WriteProperty("ot", CastPropertyId::Byte, (uint8_t)1);
+		Writer.WriteProperty("m", GetCastCurveMode(BoneModifier.second));
+		Writer.EndNode();
 	}
 
 	for (auto& Note : Anim.AnimationNotetracks)
 	{
-		auto CastNote = CastAnim->AddNode(CastNodeId::NotificationTrack);
-		CastNote->SetProperty("n", Note.first);
-		auto KeyFrameBuffer = CastNote->AddProperty("kb", CastPropertyId::Integer32);
+		Writer.BeginNode(CastNodeId::NotificationTrack);
+		Writer.WriteProperty("n", Note.first);
+		Writer.BeginProperty("kb", CastPropertyId::Integer32, Note.second.size());
 		for (auto& Key : Note.second)
-			KeyFrameBuffer->Write(Key);
+			Writer.Write(Key);
+		Writer.EndNode();
 	}
 
 	for (auto& Blend : Anim.AnimationBlendShapeWeightKeys)
 	{
-		auto Curve = CastAnim->AddNode(CastNodeId::Curve);
-		Curve->SetProperty("nn", Blend.first);
-		Curve->SetProperty("kp", "bs");
-		Curve->SetProperty("m", "absolute");
-
 		uint32_t LargestFrame = 0;
 
 		for (auto& BlendValue : Blend.second)
 			if (BlendValue.Frame > LargestFrame)
 				LargestFrame = BlendValue.Frame;
 
-		auto KeyFrameBufferType = LargestFrame <= 0xFFFF ? LargestFrame <= 0xFF ? CastPropertyId::Byte : CastPropertyId::Short : CastPropertyId::Integer32;
-		auto KeyFrameBuffer = Curve->AddProperty("kb", KeyFrameBufferType);
-		auto KeyValueBuffer = Curve->AddProperty("kv", CastPropertyId::Float);
+		auto KeyFrameBufferType = CastWriter::GetIndexType(LargestFrame);
 
+		Writer.BeginNode(CastNodeId::Curve);
+		Writer.WriteProperty("nn", Blend.first);
+		Writer.WriteProperty("kp", "bs");
+		Writer.WriteProperty("m", "absolute");
+
+		Writer.BeginProperty("kb", KeyFrameBufferType, Blend.second.size());
 		for (auto& BlendValue : Blend.second)
-		{
-			KeyValueBuffer->Write(BlendValue.Value.X);
+			Writer.WriteIndex(KeyFrameBufferType, BlendValue.Frame);
 
-			switch (KeyFrameBufferType)
-			{
-			case CastPropertyId::Byte:
-				KeyFrameBuffer->Write((uint8_t)BlendValue.Frame); break;
-			case CastPropertyId::Short:
-				KeyFrameBuffer->Write((uint16_t)BlendValue.Frame); break;
-			case CastPropertyId::Integer32:
-				KeyFrameBuffer->Write((uint32_t)BlendValue.Frame); break;
-			}
-		}
+		Writer.BeginProperty("kv", CastPropertyId::Float, Blend.second.size());
+		for (auto& BlendValue : Blend.second)
+			Writer.Write(BlendValue.Value.X);
+
+		Writer.EndNode();
 	}
 
-	WriteCastFile(Writer, CastRoot);
+	Writer.EndNode();
+	Writer.EndNode();
+}
+
+CastWriter::CastWriter(BinaryWriter& Writer) : Writer(Writer), Buffer(CastWriterBufferSize), BufferLength(0), Position(Writer.GetPosition())
+{
+}
+
+CastWriter::~CastWriter()
+{
+	// Write anything left, nodes that were never ended keep a zero size
+	Flush();
+}
+
+void CastWriter::WriteHeader()
+{
+	Write(0x74736163);
+	Write(1);
+	Write(1);
+	Write(0);
 }
 
-CastNode::CastNode() : Identifier(CastNodeId::Root), Hash(0)
+void CastWriter::BeginNode(const CastNodeId Id, const uint64_t Hash)
 {
+	if (!OpenNodes.empty())
+		OpenNodes.back().ChildCount++;
+
+	OpenNodes.push_back({ Position, Hash, 0, 0 });
+
+	// The size, and counts, are written once the root node ends
+	Write((uint32_t)Id);
+	Write((uint32_t)0);
+	Write(Hash);
+	Write((uint32_t)0);
+	Write((uint32_t)0);
 }
 
-CastNode::CastNode(const CastNodeId id) : Identifier(id), Hash(0)
+void CastWriter::EndNode()
 {
+	auto& Node = OpenNodes.back();
 
+	Patches.push_back({ Node.Position, (uint32_t)(Position - Node.Position), Node.Hash, Node.PropertyCount, Node.ChildCount });
+	OpenNodes.pop_back();
+
+	if (OpenNodes.empty())
+		WritePatches();
 }
 
-CastNode::CastNode(const CastNodeId id, const uint64_t hash) : Identifier(id), Hash(hash)
+void CastWriter::BeginProperty(const char* Name, const CastPropertyId Id, const size_t Elements)
 {
+	auto NameLength = strlen(Name);
+
+	OpenNodes.back().PropertyCount++;
+
+	Write((uint16_t)Id);
+	Write((uint16_t)NameLength);
+	Write((uint32_t)Elements);
+	WriteBytes(Name, NameLength);
 }
 
-const size_t CastNode::Size() const
+void CastWriter::WriteProperty(const char* Name, const std::string& Value)
 {
-	size_t result = 24;
+	BeginProperty(Name, CastPropertyId::String, 1);
+	WriteBytes(Value.c_str(), Value.length() + 1);
+}
 
-	for (auto& prop : Properties)
+void CastWriter::WriteIndex(const CastPropertyId Id, const uint32_t Value)
+{
+	switch (Id)
 	{
-		result += 8;
-		result += prop.first.size();
-		result += prop.second->Buffer.size();
+	case CastPropertyId::Byte:
+		Write((uint8_t)Value); break;
+	case CastPropertyId::Short:
+		Write((uint16_t)Value); break;
+	default:
+		Write(Value); break;
 	}
+}
 
-	for (auto& child : Children)
+void CastWriter::WriteBytes(const void* Data, const size_t Size)
+{
+	if (BufferLength + Size > Buffer.size())
 	{
-		result += child->Size();
+		Flush();
+
+		// Too large to stage, write it directly
+		if (Size > Buffer.size())
+		{
+			Writer.Write((const uint8_t*)Data, (uint32_t)Size);
+			Position += Size;
+			return;
+		}
 	}
 
-	return result;
+	std::memcpy(Buffer.data() + BufferLength, Data, Size);
+	BufferLength += Size;
+	Position += Size;
 }
 
-CastNode* CastNode::AddNode(const CastNodeId id)
+CastPropertyId CastWriter::GetIndexType(const uint32_t LargestValue)
 {
-	Children.emplace_back(std::make_unique<CastNode>(id));
-	return Children.back().get();
+	return LargestValue <= 0xFFFF ? LargestValue <= 0xFF ? CastPropertyId::Byte : CastPropertyId::Short : CastPropertyId::Integer32;
 }
 
-CastNode* CastNode::AddNode(const CastNodeId id, const uint64_t hash)
+void CastWriter::Flush()
 {
-	Children.emplace_back(std::make_unique<CastNode>(id, hash));
-	return Children.back().get();
+	if (BufferLength > 0)
+		Writer.Write(Buffer.data(), (uint32_t)BufferLength);
+
+	BufferLength = 0;
+}
+
+void CastWriter::WritePatches()
+{
+	Flush();
+
+	// Patch in file order, so the seeks only move forward
+	std::sort(Patches.begin(), Patches.end(), [](const CastNodePatch& Lhs, const CastNodePatch& Rhs) { return Lhs.Position < Rhs.Position; });
+
+	for (auto& Patch : Patches)
+	{
+		Writer.SetPosition(Patch.Position + sizeof(uint32_t));
+		Writer.Write(Patch.Size);
+		Writer.Write(Patch.Hash);
+		Writer.Write(Patch.PropertyCount);
+		Writer.Write(Patch.ChildCount);
+	}
+
+	Writer.SetPosition(Position);
+	Patches.clear();
 }
@@ -2,11 +2,15 @@
 
 #include <string>
 #include <cstdint>
+#include <vector>
 
 // We need to include external libraries for models
 #include "WraithModel.h"
 #include "WraithAnim.h"
 
+// We need the binarywriter class
+#include "BinaryWriter.h"
+
 // A class that handles writing Cast model/anim files
 class Cast
 {
@@ -47,90 +51,87 @@ enum class CastPropertyId : uint16_t
 	Vector4   = 'v4'
 };
 
-class CastProperty
-{
-public:
-	CastPropertyId Identifier;
-	size_t Elements;
-	std::vector<char> Buffer;
-
-	CastProperty() : Identifier(CastPropertyId::Byte), Elements(0) {}
+// The node header, identifier, size, hash, property count, and child count
+constexpr uint32_t CastNodeHeaderSize = 24;
 
-	template <class T>
-	void Write(const T data)
-	{
-		Elements++;
-		// Quick and dirty adding data to vector for now
-		// TODO: Swap out for expand + memcpy or idk xoxoxoxo
-		auto asChar = (const unsigned char*)&data;
-		for (size_t i = 0; i < sizeof(T); i++)
-		{
-			Buffer.push_back(asChar[i]);
-		}
-	}
-
-	void Write(const char* data, const size_t len)
-	{
-		Elements++;
-		// Quick and dirty adding data to vector for now
-		// TODO: Swap out for expand + memcpy or idk xoxoxoxo
-		for (size_t i = 0; i < len; i++)
-		{
-			Buffer.push_back(data[i]);
-		}
-	}
-};
-
-class CastNode
+// A class that streams Cast nodes to a file, node sizes and counts are patched in once the root node ends
+class CastWriter
 {
 public:
-	CastNodeId Identifier;
-	uint64_t Hash;
-	std::map<std::string, std::unique_ptr<CastProperty>> Properties;
-	std::vector<std::unique_ptr<CastNode>> Children;
+	CastWriter(BinaryWriter& Writer);
+	~CastWriter();
 
-	CastNode();
-	CastNode(const CastNodeId id);
-	CastNode(const CastNodeId id, const uint64_t hash);
+	// Writes the file header
+	void WriteHeader();
 
-	CastProperty* AddProperty(const std::string& propName, const CastPropertyId id)
-	{
-		auto prop = std::make_unique<CastProperty>();
-		auto result = prop.get();
-		prop->Identifier = id;
-		Properties[propName] = std::move(prop);
-		return result;
-	}
+	// Starts a node as a child of the current node
+	void BeginNode(const CastNodeId Id, const uint64_t Hash = 0);
+	// Ends the current node, ending the root node writes all of the node sizes and counts
+	void EndNode();
 
-	CastProperty* AddProperty(const std::string& propName, const CastPropertyId id, const size_t capacity)
-	{
-		auto prop = std::make_unique<CastProperty>();
-		auto result = prop.get();
-		prop->Identifier = id;
-		prop->Buffer.reserve(capacity);
-		Properties[propName] = std::move(prop);
-		return result;
-	}
+	// Starts a property, the given number of elements must be written after it
+	void BeginProperty(const char* Name, const CastPropertyId Id, const size_t Elements);
 
-	void SetProperty(const std::string& propName, const std::string& value)
+	// Writes a string property
+	void WriteProperty(const char* Name, const std::string& Value);
+	// Writes a single value property
+	template <class T>
+	void WriteProperty(const char* Name, const CastPropertyId Id, const T& Value)
 	{
-		auto prop = std::make_unique<CastProperty>();
-		prop->Identifier = CastPropertyId::String;
-		prop->Write(value.c_str(), value.length() + 1);
-		Properties[propName] = std::move(prop);
+		BeginProperty(Name, Id, 1);
+		Write(Value);
 	}
-	
+
+	// Writes an element of the current property
 	template <class T>
-	void SetProperty(const std::string& propName, const CastPropertyId id, const T value)
+	void Write(const T& Value)
 	{
-		auto prop = std::make_unique<CastProperty>();
-		prop->Identifier = id;
-		prop->Write<T>(value);
-		Properties[propName] = std::move(prop);
+		WriteBytes(&Value, sizeof(T));
 	}
+	// Writes an index element of the current property, sized by the given type
+	void WriteIndex(const CastPropertyId Id, const uint32_t Value);
+	// Writes raw data of the current property
+	void WriteBytes(const void* Data, const size_t Size);
 
-	const size_t Size() const;
+	// Gets the smallest index type that can hold the value
+	static CastPropertyId GetIndexType(const uint32_t LargestValue);
 
-	CastNode* AddNode(const CastNodeId id);
-	CastNode* AddNode(const CastNodeId id, const uint64_t hash);
-};
\ No newline at end of file
+private:
+	// A node that has been started, but not ended
+	struct CastOpenNode
+	{
+		uint64_t Position;
+		uint64_t Hash;
+		uint32_t PropertyCount;
+		uint32_t ChildCount;
+	};
+
+	// A node header to write once the root node ends
+	struct CastNodePatch
+	{
+		uint64_t Position;
+		uint32_t Size;
+		uint64_t Hash;
+		uint32_t PropertyCount;
+		uint32_t ChildCount;
+	};
+
+	// The file writer
+	BinaryWriter& Writer;
+	// The data waiting to be written
+	std::vector<uint8_t> Buffer;
+	// The amount of the buffer in use
+	size_t BufferLength;
+	// The position in the file, including the buffer
+	uint64_t Position;
+
+	// The nodes that have been started, the current node is last
+	std::vector<CastOpenNode> OpenNodes;
+	// The node headers to write
+	std::vector<CastNodePatch> Patches;
+
+	// Writes the buffer to the file
+	void Flush();
+	// Writes all of the node headers
+	void WritePatches();
+};
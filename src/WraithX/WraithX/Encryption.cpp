@@ -1,5 +1,9 @@
 #include "stdafx.h"
 
+// We need the following std classes
+#include <atomic>
+#include <algorithm>
+
 // The class we are implementing
 #include "Encryption.h"
 
@@ -22,4 +26,47 @@ uint32_t Encryption::Salsa20Block(int8_t* Buffer, uint32_t BufferSize, const Sal
 
     // Failed
     return 0;
+}
+
+uint64_t Encryption::Salsa20Range(int8_t* Buffer, uint64_t BufferSize, uint64_t StreamOffset, const Salsa20Key& Key, uint32_t MaxParts, const Salsa20PartRunner& RunParts)
+{
+    // Make sure we have a valid key
+    if (Key.IV == nullptr || Key.Key == nullptr || Key.KeyLength == 0) { return 0; }
+
+    // Get key length
+    auto KeyLength = (Key.KeyLength == 128) ? S20_KEYLEN_128 : S20_KEYLEN_256;
+
+    // Each part of the range can be decrypted on its own, so split it up, but never into parts smaller than a chunk
+    auto PartCount = (RunParts != nullptr) ? std::min<uint64_t>(BufferSize / Salsa20ChunkSize, MaxParts) : 1;
+
+    // Small ranges are done here
+    if (PartCount <= 1)
+    {
+        return (s20_crypt64(Key.Key, KeyLength, Key.IV, StreamOffset, (uint8_t*)Buffer, (size_t)BufferSize) == S20_SUCCESS) ? BufferSize : 0;
+    }
+
+    // The size of each part, kept to whole keystream blocks
+    auto PartSize = ((BufferSize / PartCount) + 63) & ~(uint64_t)63;
+    // Whether or not any part failed
+    std::atomic<bool> Failed(false);
+
+    // Decrypts a part of the range
+    auto DecryptPart = [&](uint32_t PartIndex)
+    {
+        auto Start = (uint64_t)PartIndex * PartSize;
+
+        if (Start >= BufferSize)
+            return;
+
+        auto Size = std::min<uint64_t>(PartSize, BufferSize - Start);
+
+        if (s20_crypt64(Key.Key, KeyLength, Key.IV, StreamOffset + Start, (uint8_t*)Buffer + Start, (size_t)Size) != S20_SUCCESS)
+            Failed = true;
+    };
+
+    // Hand the parts off, the runner waits for them
+    RunParts((uint32_t)PartCount, DecryptPart);
+
+    // Check if we worked
+    return Failed ? 0 : BufferSize;
 }
\ No newline at end of file
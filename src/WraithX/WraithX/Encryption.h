@@ -1,12 +1,19 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 
 // We need to include external libraries for encryption
 #include "Salsa20.h"
 
 // -- Salsa20 structures
 
+// The smallest part of a range that's worth decrypting on its own thread (4 MiB), so only ranges of 8 MiB or more are split
+constexpr uint64_t Salsa20ChunkSize = 0x400000;
+
+// Runs the given number of parts of a range, the parts are independent and may run in parallel, it returns once they're all done
+typedef std::function<void(uint32_t PartCount, const std::function<void(uint32_t PartIndex)>& RunPart)> Salsa20PartRunner;
+
 // Contains the information for a Salsa20 Cipher
 struct Salsa20Key
 {
@@ -32,4 +39,6 @@ public:
 
     // Encrypt/Decrypts a block of Salsa20 data, with the given Key and IV
     static uint32_t Salsa20Block(int8_t* Buffer, uint32_t BufferSize, const Salsa20Key& Key);
+    // Encrypt/Decrypts a range of Salsa20 data that starts at the given offset in the stream, large ranges are split into up to the given number of parts, which are handed to the runner
+    static uint64_t Salsa20Range(int8_t* Buffer, uint64_t BufferSize, uint64_t StreamOffset, const Salsa20Key& Key, uint32_t MaxParts = 1, const Salsa20PartRunner& RunParts = nullptr);
 };
\ No newline at end of file
@@ -49,4 +49,51 @@ float HalfFloats::ToFloat(uint16_t Value)
     v.si |= sign;
     // Return the expanded result
     return v.f;
+}
+
+void HalfFloats::ToFloats(const uint16_t* Values, size_t Count, float* Result)
+{
+    // Constants, as used by ToFloat
+    const __m128i SignMask = _mm_set1_epi32(signC);
+    const __m128i Subnormal = _mm_set1_epi32(subC);
+    const __m128i Normal = _mm_set1_epi32(norC);
+    const __m128i Max = _mm_set1_epi32(maxC);
+    const __m128i MinDecimal = _mm_set1_epi32(minD);
+    const __m128i MaxDecimal = _mm_set1_epi32(maxD);
+    const __m128 Multiplier = _mm_castsi128_ps(_mm_set1_epi32(mulC));
+    const __m128i Zero = _mm_setzero_si128();
+
+    // The amount converted
+    size_t i = 0;
+
+    // Convert 8 at a time, using the same steps as ToFloat
+    for (; i + 8 <= Count; i += 8)
+    {
+        // Load and widen the values
+        __m128i Packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Values + i));
+        __m128i Halves[2] = { _mm_unpacklo_epi16(Packed, Zero), _mm_unpackhi_epi16(Packed, Zero) };
+
+        for (uint32_t h = 0; h < 2; h++)
+        {
+            __m128i v = Halves[h];
+            // Calculate sign
+            __m128i sign = _mm_and_si128(v, SignMask);
+            v = _mm_xor_si128(v, sign);
+            sign = _mm_slli_epi32(sign, shiftSign);
+            v = _mm_xor_si128(v, _mm_and_si128(_mm_xor_si128(_mm_add_epi32(v, MinDecimal), v), _mm_cmpgt_epi32(v, Subnormal)));
+            v = _mm_xor_si128(v, _mm_and_si128(_mm_xor_si128(_mm_add_epi32(v, MaxDecimal), v), _mm_cmpgt_epi32(v, Max)));
+            // Inverse Subnormals
+            __m128i s = _mm_castps_si128(_mm_mul_ps(Multiplier, _mm_cvtepi32_ps(v)));
+            __m128i mask = _mm_cmpgt_epi32(Normal, v);
+            v = _mm_slli_epi32(v, shift);
+            v = _mm_xor_si128(v, _mm_and_si128(_mm_xor_si128(s, v), mask));
+            v = _mm_or_si128(v, sign);
+            // Store the expanded result
+            _mm_storeu_ps(Result + i + h * 4, _mm_castsi128_ps(v));
+        }
+    }
+
+    // Convert the rest
+    for (; i < Count; i++)
+        Result[i] = ToFloat(Values[i]);
 }
\ No newline at end of file
@@ -53,4 +53,6 @@ public:
     static uint16_t ToHalfFloat(float Value);
     // Decompress a half float to a float
     static float ToFloat(uint16_t Value);
+    // Decompress a list of half floats to floats, 8 at a time with SSE2
+    static void ToFloats(const uint16_t* Values, size_t Count, float* Result);
 };
\ No newline at end of file
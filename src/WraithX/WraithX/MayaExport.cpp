@@ -64,7 +64,9 @@ void Maya::ExportMaya(const WraithModel& Model, const std::string& FileName)
             for (auto& Vertex : Submesh.Verticies)
             {
                 // Write it, for now, we are only applying the initial UV layer
-                Writer.WriteFmt(" %f %f", Vertex.UVLayers[0].U, (1 - Vertex.UVLayers[0].V));
+                const float UV[2] = { Vertex.UVLayers[0].U, (1 - Vertex.UVLayers[0].V) };
+                Writer.Write(" ", 1);
+                Writer.WriteFloats(UV, 2);
             }
             // Close
             Writer.WriteLine(";");
@@ -79,13 +81,16 @@ void Maya::ExportMaya(const WraithModel& Model, const std::string& FileName)
             // Iterate and output
             for (auto& Face : Submesh.Faces)
             {
+                // The the verts, 3->2->1
+                const uint32_t Indicies[3] = { Face.Index3, Face.Index2, Face.Index1 };
                 // Output (3 instances per face)
-                Writer.WriteFmt(" %f %f %f %f %f %f %f %f %f %f %f %f",
-                    // The the verts, 3->2->1
-                    Submesh.Verticies[Face.Index3].Color[0] / 255.0f, Submesh.Verticies[Face.Index3].Color[1] / 255.0f, Submesh.Verticies[Face.Index3].Color[2] / 255.0f, Submesh.Verticies[Face.Index3].Color[3] / 255.0f,
-                    Submesh.Verticies[Face.Index2].Color[0] / 255.0f, Submesh.Verticies[Face.Index2].Color[1] / 255.0f, Submesh.Verticies[Face.Index2].Color[2] / 255.0f, Submesh.Verticies[Face.Index2].Color[3] / 255.0f,
-                    Submesh.Verticies[Face.Index1].Color[0] / 255.0f, Submesh.Verticies[Face.Index1].Color[1] / 255.0f, Submesh.Verticies[Face.Index1].Color[2] / 255.0f, Submesh.Verticies[Face.Index1].Color[3] / 255.0f
-                );
+                for (auto& Index : Indicies)
+                {
+                    // The normalized color
+                    const float Color[4] = { Submesh.Verticies[Index].Color[0] / 255.0f, Submesh.Verticies[Index].Color[1] / 255.0f, Submesh.Verticies[Index].Color[2] / 255.0f, Submesh.Verticies[Index].Color[3] / 255.0f };
+                    Writer.Write(" ", 1);
+                    Writer.WriteFloats(Color, 4);
+                }
             }
             // Close
             Writer.WriteLine(";");
@@ -102,7 +107,8 @@ void Maya::ExportMaya(const WraithModel& Model, const std::string& FileName)
             for (auto& Vertex : Submesh.Verticies)
             {
                 // Output positions
-                Writer.WriteFmt(" %f %f %f", Vertex.Position.X, Vertex.Position.Y, Vertex.Position.Z);
+                Writer.Write(" ", 1);
+                Writer.WriteFloats(&Vertex.Position.X, 3);
             }
             // Close
             Writer.WriteLine(";");
@@ -116,7 +122,9 @@ void Maya::ExportMaya(const WraithModel& Model, const std::string& FileName)
             for (auto& Face : Submesh.Faces)
             {
                 // Output edge combinations, 3 per face 3->2 2->1 1->3
-                Writer.WriteFmt(" %d %d 0 %d %d 0 %d %d 0", Face.Index3, Face.Index2, Face.Index2, Face.Index1, Face.Index1, Face.Index3);
+                const uint32_t Edges[9] = { Face.Index3, Face.Index2, 0, Face.Index2, Face.Index1, 0, Face.Index1, Face.Index3, 0 };
+                Writer.Write(" ", 1);
+                Writer.WriteIntegers(Edges, 9);
             }
             // Close
             Writer.WriteLine(";");
@@ -129,13 +137,14 @@ void Maya::ExportMaya(const WraithModel& Model, const std::string& FileName)
             // Iterate and output
             for (auto& Face : Submesh.Faces)
             {
+                // The the verts, 3->2->1
+                const uint32_t Indicies[3] = { Face.Index3, Face.Index2, Face.Index1 };
                 // Output normals, 3 per face (3 verts per face) 3, 2, 1
-                Writer.WriteFmt(" %f %f %f %f %f %f %f %f %f",
-                    // The the verts, 3->2->1
-                    Submesh.Verticies[Face.Index3].Normal.X, Submesh.Verticies[Face.Index3].Normal.Y, Submesh.Verticies[Face.Index3].Normal.Z,
-                    Submesh.Verticies[Face.Index2].Normal.X, Submesh.Verticies[Face.Index2].Normal.Y, Submesh.Verticies[Face.Index2].Normal.Z,
-                    Submesh.Verticies[Face.Index1].Normal.X, Submesh.Verticies[Face.Index1].Normal.Y, Submesh.Verticies[Face.Index1].Normal.Z
-                    );
+                for (auto& Index : Indicies)
+                {
+                    Writer.Write(" ", 1);
+                    Writer.WriteFloats(&Submesh.Verticies[Index].Normal.X, 3);
+                }
             }
             // Close
             Writer.WriteLine(";");
@@ -152,13 +161,16 @@ void Maya::ExportMaya(const WraithModel& Model, const std::string& FileName)
                 // Iterate
                 for (auto& Face : Submesh.Faces)
                 {
+                    // The indicies 1->2->3
+                    const uint32_t Edges[3] = { FaceIndex, (FaceIndex + 1), (FaceIndex + 2) };
+                    const uint32_t Indicies[3] = { Face.Index3, Face.Index2, Face.Index1 };
                     // Output face connections, 3 per face, index, uv, index
-                    Writer.WriteFmt(" f 3 %d %d %d mu 0 3 %d %d %d mc 0 3 %d %d %d",
-                        // The indicies 1->2->3
-                        FaceIndex, (FaceIndex + 1), (FaceIndex + 2),
-                        Face.Index3, Face.Index2, Face.Index1,
-                        FaceIndex, (FaceIndex + 1), (FaceIndex + 2)
-                        );
+                    Writer.Write(" f 3 ", 5);
+                    Writer.WriteIntegers(Edges, 3);
+                    Writer.Write(" mu 0 3 ", 8);
+                    Writer.WriteIntegers(Indicies, 3);
+                    Writer.Write(" mc 0 3 ", 8);
+                    Writer.WriteIntegers(Edges, 3);
                     // Advance
                     FaceIndex += 3;
                 }
@@ -27,15 +27,16 @@ void WavefrontOBJ::ExportOBJ(const WraithModel& Model, const std::string& FileNa
         // Iterate over faces
         for (auto& Face : Submesh.Faces)
         {
+            // The vertices of the face
+            const uint32_t Indicies[3] = { Face.Index1, Face.Index2, Face.Index3 };
             // Write positions
-            Writer.WriteLineFmt(
-                "v %f %f %f\n"
-                "v %f %f %f\n"
-                "v %f %f %f",
-                Submesh.Verticies[Face.Index1].Position.X, Submesh.Verticies[Face.Index1].Position.Y, Submesh.Verticies[Face.Index1].Position.Z,
-                Submesh.Verticies[Face.Index2].Position.X, Submesh.Verticies[Face.Index2].Position.Y, Submesh.Verticies[Face.Index2].Position.Z,
-                Submesh.Verticies[Face.Index3].Position.X, Submesh.Verticies[Face.Index3].Position.Y, Submesh.Verticies[Face.Index3].Position.Z
-                );
+            for (auto& Index : Indicies)
+            {
+                // Write the position
+                Writer.Write("v ", 2);
+                Writer.WriteFloats(&Submesh.Verticies[Index].Position.X, 3);
+                Writer.NewLine();
+            }
         }
     }
     // Iterate over the submesh (UVs)
@@ -44,15 +45,18 @@ void WavefrontOBJ::ExportOBJ(const WraithModel& Model, const std::string& FileNa
         // Iterate over faces
         for (auto& Face : Submesh.Faces)
         {
+            // The vertices of the face
+            const uint32_t Indicies[3] = { Face.Index1, Face.Index2, Face.Index3 };
             // Write uvs
-            Writer.WriteLineFmt(
-                "vt %f %f\n"
-                "vt %f %f\n"
-                "vt %f %f",
-                Submesh.Verticies[Face.Index1].UVLayers[0].U, (1 - Submesh.Verticies[Face.Index1].UVLayers[0].V),
-                Submesh.Verticies[Face.Index2].UVLayers[0].U, (1 - Submesh.Verticies[Face.Index2].UVLayers[0].V),
-                Submesh.Verticies[Face.Index3].UVLayers[0].U, (1 - Submesh.Verticies[Face.Index3].UVLayers[0].V)
-                );
+            for (auto& Index : Indicies)
+            {
+                // Flip the V coordinate
+                const float UV[2] = { Submesh.Verticies[Index].UVLayers[0].U, (1 - Submesh.Verticies[Index].UVLayers[0].V) };
+                // Write the uv
+                Writer.Write("vt ", 3);
+                Writer.WriteFloats(UV, 2);
+                Writer.NewLine();
+            }
         }
     }
     // Iterate over the submesh (Normals)
@@ -61,15 +65,16 @@ void WavefrontOBJ::ExportOBJ(const WraithModel& Model, const std::string& FileNa
         // Iterate over faces
         for (auto& Face : Submesh.Faces)
         {
+            // The vertices of the face
+            const uint32_t Indicies[3] = { Face.Index1, Face.Index2, Face.Index3 };
             // Write normals
-            Writer.WriteLineFmt(
-                "vn %f %f %f\n"
-                "vn %f %f %f\n"
-                "vn %f %f %f",
-                Submesh.Verticies[Face.Index1].Normal.X, Submesh.Verticies[Face.Index1].Normal.Y, Submesh.Verticies[Face.Index1].Normal.Z,
-                Submesh.Verticies[Face.Index2].Normal.X, Submesh.Verticies[Face.Index2].Normal.Y, Submesh.Verticies[Face.Index2].Normal.Z,
-                Submesh.Verticies[Face.Index3].Normal.X, Submesh.Verticies[Face.Index3].Normal.Y, Submesh.Verticies[Face.Index3].Normal.Z
-                );
+            for (auto& Index : Indicies)
+            {
+                // Write the normal
+                Writer.Write("vn ", 3);
+                Writer.WriteFloats(&Submesh.Verticies[Index].Normal.X, 3);
+                Writer.NewLine();
+            }
         }
     }
     // A list of unique materials
@@ -95,14 +100,18 @@ void WavefrontOBJ::ExportOBJ(const WraithModel& Model, const std::string& FileNa
         // Iterate over faces
         for (auto& Face : Submesh.Faces)
         {
-            // Write faces
-            Writer.WriteLineFmt(
-                // The format chunks, 3 pairs of 3
-                "f %d/%d/%d %d/%d/%d %d/%d/%d",
-                (VertexIndex + 2), (VertexIndex + 2), (VertexIndex + 2),
-                (VertexIndex + 1), (VertexIndex + 1), (VertexIndex + 1),
-                VertexIndex, VertexIndex, VertexIndex
-                );
+            // Write faces, 3 pairs of 3, in reverse order
+            Writer.Write("f", 1);
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                // The position, uv, and normal share an index
+                const uint32_t Index = VertexIndex + (2 - i);
+                const uint32_t Indicies[3] = { Index, Index, Index };
+                // Write the pair
+                Writer.Write(" ", 1);
+                Writer.WriteIntegers(Indicies, 3, "/");
+            }
+            Writer.NewLine();
             // Advance
             VertexIndex += 3;
         }
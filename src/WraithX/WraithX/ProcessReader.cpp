@@ -6,11 +6,16 @@
 // We require the following WraithX classes
 #include "Patterns.h"
 #include "FileSystems.h"
+#include "ProcessSnapshot.h"
 
 ProcessReader::ProcessReader()
 {
     // Init the handle
     ProcessHandle = NULL;
+    // Init the cache
+    CacheScopes = 0;
+    CacheHits = 0;
+    CacheMisses = 0;
 }
 
 ProcessReader::~ProcessReader()
@@ -21,6 +26,9 @@ ProcessReader::~ProcessReader()
 
 bool ProcessReader::IsRunning()
 {
+    // A snapshot never exits
+    if (Snapshot != nullptr)
+        return true;
     // Make sure we are attached
     if (ProcessHandle != NULL)
     {
@@ -49,12 +57,17 @@ void ProcessReader::Detatch()
     }
     // Set it
     ProcessHandle = NULL;
+    // Close any snapshot, and stop recording
+    Snapshot.reset();
+    Recorder.reset();
+    // Anything cached belonged to the old process
+    InvalidateCache();
 }
 
 bool ProcessReader::Attach(int ProcessID)
 {
     // Attempt to attach to the following process, if we are already attached disconnect first
-    if (ProcessHandle != NULL)
+    if (IsAttached())
     {
         // Detatch first
         Detatch();
@@ -74,7 +87,7 @@ bool ProcessReader::Attach(int ProcessID)
 bool ProcessReader::Attach(const std::string& ProcessName)
 {
     // Detatch if we aren't already
-    if (ProcessHandle != NULL)
+    if (IsAttached())
     {
         // Detatch first
         Detatch();
@@ -115,21 +128,85 @@ bool ProcessReader::Attach(const std::string& ProcessName)
 bool ProcessReader::Connect(HANDLE ProcessHandleReference)
 {
     // Detatch if we aren't already
-    if (ProcessHandle != NULL)
+    if (IsAttached())
     {
         // Detatch first
         Detatch();
     }
     // Set the new instance
     ProcessHandle = ProcessHandleReference;
+    // Make sure nothing from a previous process is served
+    InvalidateCache();
     // Check
     if (ProcessHandle != NULL) { return true; }
     // Failed
     return false;
 }
 
+bool ProcessReader::OpenSnapshot(const std::string& FilePath)
+{
+    // Detatch if we aren't already
+    if (IsAttached())
+    {
+        // Detatch first
+        Detatch();
+    }
+    // Map the snapshot
+    auto NewSnapshot = std::make_unique<ProcessSnapshot>();
+    // Check
+    if (!NewSnapshot->Open(FilePath))
+    {
+        // Failed
+        return false;
+    }
+    // Set the new instance
+    Snapshot = std::move(NewSnapshot);
+    // Worked
+    return true;
+}
+
+void ProcessReader::StartRecording()
+{
+    // Only a live process can be recorded
+    if (ProcessHandle == NULL)
+        return;
+    // Start a new recording, along with what's needed to locate the game again
+    Recorder = std::make_unique<ProcessSnapshotRecorder>();
+    Recorder->SetProcessInfo(GetProcessPath(), GetMainModuleAddress(), GetMainModuleMemorySize());
+}
+
+bool ProcessReader::SaveRecording(const std::string& FilePath)
+{
+    // Make sure we are recording
+    if (Recorder == nullptr)
+        return false;
+    // Save it
+    return Recorder->Save(FilePath);
+}
+
+bool ProcessReader::IsRecording() const
+{
+    // Check
+    return Recorder != nullptr;
+}
+
+bool ProcessReader::IsSnapshot() const
+{
+    // Check
+    return Snapshot != nullptr;
+}
+
+bool ProcessReader::IsAttached() const
+{
+    // Check
+    return ProcessHandle != NULL || Snapshot != nullptr;
+}
+
 uintptr_t ProcessReader::GetMainModuleAddress()
 {
+    // Use the recorded value if replaying
+    if (Snapshot != nullptr)
+        return Snapshot->GetMainModuleAddress();
     // Get the main module if we are attached
     if (ProcessHandle != NULL)
     {
@@ -174,6 +251,9 @@ uintptr_t ProcessReader::GetMainModuleAddress()
 
 uintptr_t ProcessReader::GetMainModuleMemorySize()
 {
+    // Use the recorded value if replaying
+    if (Snapshot != nullptr)
+        return Snapshot->GetMainModuleSize();
     // Get the main module if we are attached
     if (ProcessHandle != NULL)
     {
@@ -218,6 +298,9 @@ uintptr_t ProcessReader::GetMainModuleMemorySize()
 
 uintptr_t ProcessReader::GetModuleAddress(const std::string & ModuleName)
 {
+    // Use the recorded value if replaying
+    if (Snapshot != nullptr)
+        return Snapshot->GetModuleAddress(ModuleName);
     // Get the main module if we are attached
     if (ProcessHandle != NULL)
     {
@@ -252,6 +335,9 @@ uintptr_t ProcessReader::GetModuleAddress(const std::string & ModuleName)
                 }
             }
         }
+        // Keep it for replaying
+        if (Recorder != nullptr)
+            Recorder->AddModule(ModuleName, ModuleAddress);
         // Return it
         return ModuleAddress;
     }
@@ -271,7 +357,7 @@ uintptr_t ProcessReader::GetModuleMemorySize(const std::string & ModuleName)
 uintptr_t ProcessReader::GetSizeOfCode()
 {
     // Get the main module if we are attached
-    if (ProcessHandle != NULL)
+    if (IsAttached())
     {
         // We must read from the main module address
         auto MainModuleAddress = GetMainModuleAddress();
@@ -294,7 +380,7 @@ uintptr_t ProcessReader::GetSizeOfCode()
 uintptr_t ProcessReader::GetSizeOfCode(uintptr_t Address)
 {
     // Get the main module if we are attached
-    if (ProcessHandle != NULL)
+    if (IsAttached())
     {
         // Now we must read the PE information, starting with DOS_Header, NT_Header, then finally the optional entry
         auto DOSHeader = Read<IMAGE_DOS_HEADER>(Address);
@@ -313,6 +399,9 @@ uintptr_t ProcessReader::GetSizeOfCode(uintptr_t Address)
 
 std::string ProcessReader::GetProcessPath()
 {
+    // Use the recorded value if replaying
+    if (Snapshot != nullptr)
+        return Snapshot->GetProcessPath();
     // Get the main module if we are attached
     if (ProcessHandle != NULL)
     {
@@ -342,7 +431,7 @@ HANDLE ProcessReader::GetCurrentProcess() const
 std::string ProcessReader::ReadNullTerminatedString(uintptr_t Offset)
 {
     // Get the string if we are attached
-    if (ProcessHandle != NULL)
+    if (IsAttached())
     {
         // Keep track of address and preallocate our result
         uintptr_t Address = Offset;
@@ -385,18 +474,14 @@ std::string ProcessReader::ReadNullTerminatedString(uintptr_t Offset)
 int8_t* ProcessReader::Read(uintptr_t Offset, uintptr_t Length, uintptr_t& Result)
 {
     // Make sure we're attached
-    if (ProcessHandle != NULL)
+    if (IsAttached())
     {
         // We can read the block
         int8_t* ResultBlock = new int8_t[Length];
         // Zero out the memory
         std::memset(ResultBlock, 0, Length);
-        // Length read
-        SIZE_T LengthRead = 0;
-        // Read it
-        ReadProcessMemory(ProcessHandle, (void*)Offset, ResultBlock, Length, &LengthRead);
-        // Set result
-        Result = LengthRead;
+        // Read it, small blocks come through the cache if it's on
+        Result = ReadCached((uint8_t*)ResultBlock, Offset, Length);
         // Return result
         return ResultBlock;
     }
@@ -408,18 +493,214 @@ size_t ProcessReader::Read(uint8_t * Buffer, uintptr_t Offset, uintptr_t Length)
 {
     size_t Result = 0;
 
-    if (ProcessHandle != NULL)
+    if (IsAttached())
     {
-        ReadProcessMemory(ProcessHandle, (LPCVOID)Offset, Buffer, (SIZE_T)Length, (SIZE_T*)&Result);
+        Result = ReadCached(Buffer, Offset, Length);
     }
 
     return Result;
 }
 
+void ProcessReader::BeginCacheScope()
+{
+    // Open a scope
+    CacheScopes++;
+}
+
+void ProcessReader::EndCacheScope()
+{
+    // Drop the cache once the last scope closes, so a running game is never read stale
+    if (--CacheScopes == 0)
+    {
+        InvalidateCache();
+    }
+}
+
+void ProcessReader::InvalidateCache()
+{
+    // Aquire lock
+    std::unique_lock<std::shared_mutex> Lock(CacheMutex);
+    // Free the pages
+    CachePages.clear();
+}
+
+void ProcessReader::AddPage(uintptr_t PageAddress, std::unique_ptr<uint8_t[]> Page)
+{
+    // Aquire lock
+    std::unique_lock<std::shared_mutex> Lock(CacheMutex);
+
+    // Don't cache if every scope closed while we were reading
+    if (CacheScopes == 0)
+        return;
+
+    // Drop everything once full, exports touch a working set far smaller than this
+    if (CachePages.size() >= ProcessReaderMaxPages)
+        CachePages.clear();
+
+    // Another thread may have beaten us to it, keep theirs
+    CachePages.emplace(PageAddress, std::move(Page));
+}
+
+bool ProcessReader::ReadPage(uintptr_t PageAddress, uintptr_t PageOffset, uint8_t* Buffer, uintptr_t Length)
+{
+    {
+        // Aquire lock
+        std::shared_lock<std::shared_mutex> Lock(CacheMutex);
+
+        // Copy it out if it's cached
+        auto Page = CachePages.find(PageAddress);
+
+        if (Page != CachePages.end())
+        {
+            std::memcpy(Buffer, Page->second.get() + PageOffset, Length);
+            CacheHits++;
+            return true;
+        }
+    }
+
+    // Read the whole page, pages are the protection granularity, so this either all reads or fails
+    auto Page = std::make_unique<uint8_t[]>(ProcessReaderPageSize);
+
+    if (ReadMemory(PageAddress, Page.get(), ProcessReaderPageSize) != ProcessReaderPageSize)
+        return false;
+
+    CacheMisses++;
+
+    // Copy it out, then keep it
+    std::memcpy(Buffer, Page.get() + PageOffset, Length);
+    AddPage(PageAddress, std::move(Page));
+
+    // Success
+    return true;
+}
+
+size_t ProcessReader::ReadCached(uint8_t* Buffer, uintptr_t Offset, uintptr_t Length)
+{
+    // The amount read
+    size_t Result = 0;
+
+    // Large reads are already a single call, so they go straight to the process
+    if (CacheScopes == 0 || Length >= ProcessReaderBlockSize)
+    {
+        return ReadMemory(Offset, Buffer, Length);
+    }
+
+    // Copy page by page
+    while (Result < Length)
+    {
+        auto Address = Offset + Result;
+        auto PageAddress = Address & ~(ProcessReaderPageSize - 1);
+        auto PageOffset = Address - PageAddress;
+        auto Count = std::min<uintptr_t>(Length - Result, ProcessReaderPageSize - PageOffset);
+
+        // If a page can't be read, read the rest directly, so partial reads behave as they did uncached
+        if (!ReadPage(PageAddress, PageOffset, Buffer + Result, Count))
+        {
+            return Result + ReadMemory(Address, Buffer + Result, Length - Result);
+        }
+
+        Result += Count;
+    }
+
+    // Return result
+    return Result;
+}
+
+void ProcessReader::Prefetch(uintptr_t Offset, uintptr_t Length)
+{
+    // Nothing to fill unless a scope is open
+    if (!IsAttached() || CacheScopes == 0 || Length == 0)
+        return;
+
+    // Align to pages, and never more than the cache holds
+    auto Start = Offset & ~(ProcessReaderPageSize - 1);
+    auto End = std::min<uintptr_t>(Offset + Length, Start + ProcessReaderMaxPages * ProcessReaderPageSize);
+    End = (End + ProcessReaderPageSize - 1) & ~(ProcessReaderPageSize - 1);
+
+    // Read in blocks, one call per block rather than one per page
+    auto Block = std::make_unique<uint8_t[]>(ProcessReaderBlockSize);
+
+    for (auto BlockAddress = Start; BlockAddress < End; BlockAddress += ProcessReaderBlockSize)
+    {
+        auto BlockSize = std::min<uintptr_t>(ProcessReaderBlockSize, End - BlockAddress);
+
+        // Skip blocks that don't fully read, their pages are filled on demand
+        if (ReadMemory(BlockAddress, Block.get(), BlockSize) != BlockSize)
+            continue;
+
+        CacheMisses++;
+
+        // Split into pages
+        for (uintptr_t PageOffset = 0; PageOffset < BlockSize; PageOffset += ProcessReaderPageSize)
+        {
+            auto Page = std::make_unique<uint8_t[]>(ProcessReaderPageSize);
+            std::memcpy(Page.get(), Block.get() + PageOffset, ProcessReaderPageSize);
+            AddPage(BlockAddress + PageOffset, std::move(Page));
+        }
+    }
+}
+
+size_t ProcessReader::ReadMemory(uintptr_t Offset, uint8_t* Buffer, uintptr_t Length)
+{
+    // Replay from the snapshot if we have one
+    if (Snapshot != nullptr)
+        return Snapshot->Read(Offset, Buffer, Length);
+
+    // Read from the process
+    SIZE_T Result = 0;
+    ReadProcessMemory(ProcessHandle, (LPCVOID)Offset, Buffer, (SIZE_T)Length, &Result);
+
+    // Keep every page we touched, whole, so the snapshot can serve any read within them
+    if (Recorder != nullptr && Result > 0)
+    {
+        auto Start = Offset & ~(ProcessSnapshotPageSize - 1);
+        auto End = Offset + Result;
+
+        for (auto PageAddress = Start; PageAddress < End; PageAddress += ProcessSnapshotPageSize)
+        {
+            if (Recorder->HasPage(PageAddress))
+                continue;
+
+            // Take it straight from the buffer if it covers the page, otherwise read the whole page
+            if (PageAddress >= Offset && PageAddress + ProcessSnapshotPageSize <= End)
+            {
+                Recorder->AddPage(PageAddress, Buffer + (PageAddress - Offset));
+            }
+            else
+            {
+                uint8_t Page[ProcessSnapshotPageSize];
+                SIZE_T PageRead = 0;
+
+                if (ReadProcessMemory(ProcessHandle, (LPCVOID)PageAddress, Page, ProcessSnapshotPageSize, &PageRead) && PageRead == ProcessSnapshotPageSize)
+                    Recorder->AddPage(PageAddress, Page);
+            }
+        }
+    }
+
+    // Return result
+    return (size_t)Result;
+}
+
+ProcessReaderCacheScope::ProcessReaderCacheScope(ProcessReader* Reader)
+{
+    // Open the scope
+    this->Reader = Reader;
+
+    if (Reader != nullptr)
+        Reader->BeginCacheScope();
+}
+
+ProcessReaderCacheScope::~ProcessReaderCacheScope()
+{
+    // Close the scope
+    if (Reader != nullptr)
+        Reader->EndCacheScope();
+}
+
 intptr_t ProcessReader::Scan(const std::string& Pattern, bool UseExtendedMemoryScan)
 {
     // Make sure we're attached
-    if (ProcessHandle != NULL)
+    if (IsAttached())
     {
         // Get the main module and code segment size, depending on flags
         auto MainModuleAttr = GetMainModuleAddress();
@@ -434,7 +715,7 @@ intptr_t ProcessReader::Scan(const std::string& Pattern, bool UseExtendedMemoryS
 intptr_t ProcessReader::Scan(const std::string& Pattern, uintptr_t Offset, uintptr_t Length)
 {
     // Make sure we're attached
-    if (ProcessHandle != NULL)
+    if (IsAttached())
     {
         // The resulting offset
         intptr_t ResultOffset = 0;
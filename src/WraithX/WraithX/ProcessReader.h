@@ -2,8 +2,25 @@
 
 #include <cstdint>
 #include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 #include <Windows.h>
 
+// The size of a page in the read cache
+constexpr uintptr_t ProcessReaderPageSize = 0x1000;
+// The size of the blocks prefetches are read in, reads this size or larger skip the cache
+constexpr uintptr_t ProcessReaderBlockSize = 0x10000;
+// The most pages the read cache holds before it's dropped (64 MiB)
+constexpr size_t ProcessReaderMaxPages = 0x4000;
+
+// Records the pages read from a process (Defined in ProcessSnapshot.h)
+class ProcessSnapshotRecorder;
+// Replays the pages of a recorded process (Defined in ProcessSnapshot.h)
+class ProcessSnapshot;
+
 // A class that handles reading and scanning a process for data
 class ProcessReader
 {
@@ -11,6 +28,33 @@ private:
     // A handle to the process
     HANDLE ProcessHandle;
 
+    // The cached pages, keyed by their address, only used while a cache scope is open
+    std::unordered_map<uintptr_t, std::unique_ptr<uint8_t[]>> CachePages;
+    // A lock for the cached pages
+    std::shared_mutex CacheMutex;
+    // The number of open cache scopes
+    std::atomic<uint32_t> CacheScopes;
+    // The number of reads served from the cache
+    std::atomic<uint64_t> CacheHits;
+    // The number of pages read from the process
+    std::atomic<uint64_t> CacheMisses;
+
+    // The snapshot being replayed, if any, reads are served from this instead of a process
+    std::unique_ptr<ProcessSnapshot> Snapshot;
+    // The recorder, if any, pages read from the process are kept here
+    std::unique_ptr<ProcessSnapshotRecorder> Recorder;
+
+    // Checks if we have a process or a snapshot to read from
+    bool IsAttached() const;
+    // Reads memory from the process or snapshot, recording the pages touched if recording, returns the amount read
+    size_t ReadMemory(uintptr_t Offset, uint8_t* Buffer, uintptr_t Length);
+    // Copies from a cached page, reading it from the process first if need be, returns false if the page can't be read
+    bool ReadPage(uintptr_t PageAddress, uintptr_t PageOffset, uint8_t* Buffer, uintptr_t Length);
+    // Adds a page to the cache, keeps the existing page if it's already cached
+    void AddPage(uintptr_t PageAddress, std::unique_ptr<uint8_t[]> Page);
+    // Reads through the cache if a scope is open, otherwise straight from the process
+    size_t ReadCached(uint8_t* Buffer, uintptr_t Offset, uintptr_t Length);
+
 public:
     ProcessReader();
     ~ProcessReader();
@@ -21,6 +65,17 @@ public:
     bool Attach(const std::string& ProcessName);
     // Connect this reader to a process with the given handle
     bool Connect(HANDLE ProcessHandleReference);
+    // Open a process snapshot, reads are replayed from it instead of a process
+    bool OpenSnapshot(const std::string& FilePath);
+
+    // Starts recording the pages read from the attached process
+    void StartRecording();
+    // Saves the pages recorded so far to a snapshot
+    bool SaveRecording(const std::string& FilePath);
+    // Checks if we are recording
+    bool IsRecording() const;
+    // Checks if we are replaying a snapshot
+    bool IsSnapshot() const;
 
     // Figure out whether or not the process is still running
     bool IsRunning();
@@ -51,19 +106,33 @@ public:
     // Gets the current handle of the process
     HANDLE GetCurrentProcess() const;
 
+    // Starts caching reads in pages, scopes can be nested and shared between threads, memory is assumed not to change while one is open
+    void BeginCacheScope();
+    // Ends a cache scope, the cache is dropped when the last one ends
+    void EndCacheScope();
+    // Drops all cached pages
+    void InvalidateCache();
+    // Reads a known range into the cache ahead of time, does nothing if no scope is open
+    void Prefetch(uintptr_t Offset, uintptr_t Length);
+
+    // Gets the number of reads served from the cache
+    uint64_t GetCacheHits() const { return CacheHits; }
+    // Gets the number of pages read from the process
+    uint64_t GetCacheMisses() const { return CacheMisses; }
+
     template <class T>
     // Read a block of memory from the process with the given type
     T Read(uintptr_t Offset)
     {
         // Read a block of memory from a process based on the type
-        if (ProcessHandle != NULL)
+        if (IsAttached())
         {
             // We must read the data based on type.
             T ResultValue;
             // Zero out the memory
             std::memset(&ResultValue, 0, sizeof(ResultValue));
-            // Read the value from the process
-            ReadProcessMemory(ProcessHandle, (void*)Offset, &ResultValue, sizeof(ResultValue), 0);
+            // Read the value from the process, through the cache if it's on
+            ReadCached((uint8_t*)&ResultValue, Offset, sizeof(ResultValue));
             // Return the result
             return ResultValue;
         }
@@ -86,4 +155,20 @@ public:
     intptr_t Scan(const std::string& Pattern, bool UseExtendedMemoryScan = false);
     // Scan the process for a pattern with the given offset and length
     intptr_t Scan(const std::string& Pattern, uintptr_t Offset, uintptr_t Length);
-};
\ No newline at end of file
+};
+
+// A class that keeps a process reader's cache open for its lifetime
+class ProcessReaderCacheScope
+{
+public:
+    ProcessReaderCacheScope(ProcessReader* Reader);
+    ~ProcessReaderCacheScope();
+
+    // Scopes can't be copied
+    ProcessReaderCacheScope(const ProcessReaderCacheScope&) = delete;
+    ProcessReaderCacheScope& operator=(const ProcessReaderCacheScope&) = delete;
+
+private:
+    // The reader, if any
+    ProcessReader* Reader;
+};
@@ -0,0 +1,433 @@
+#include "stdafx.h"
+
+// The class we are implementing
+#include "ProcessSnapshot.h"
+
+// We require the following classes
+#include "BinaryWriter.h"
+#include "Compression.h"
+#include "FileSystems.h"
+
+// The header of a snapshot, followed by the modules, the pages, the string table, then the page data
+struct ProcessSnapshotHeader
+{
+    // The magic, 'WPSS'
+    uint32_t Magic;
+    // The version
+    uint32_t Version;
+    // The size of a page
+    uint32_t PageSize;
+    // The number of pages
+    uint32_t PageCount;
+    // The number of modules
+    uint32_t ModuleCount;
+    // The size of the string table
+    uint32_t StringsSize;
+    // The address of the main module
+    uint64_t MainModuleAddress;
+    // The size of the main module
+    uint64_t MainModuleSize;
+    // The offset of the process path in the string table
+    uint32_t ProcessPathOffset;
+    // The length of the process path
+    uint32_t ProcessPathLength;
+};
+
+// A module in a snapshot
+struct ProcessSnapshotModuleRecord
+{
+    // The address of the module
+    uint64_t Address;
+    // The offset of the name in the string table
+    uint32_t NameOffset;
+    // The length of the name
+    uint32_t NameLength;
+};
+
+// A page in a snapshot
+struct ProcessSnapshotPageRecord
+{
+    // The address of the page
+    uint64_t Address;
+    // The offset of the data from the start of the file
+    uint64_t DataOffset;
+    // The size of the data
+    uint32_t DataSize;
+    // Whether or not the data is LZ4 compressed
+    uint32_t Compressed;
+};
+
+// The snapshot magic
+constexpr uint32_t ProcessSnapshotMagic = 0x53535057;
+// The snapshot version
+constexpr uint32_t ProcessSnapshotVersion = 1;
+
+// Verify
+static_assert(sizeof(ProcessSnapshotHeader) == 48, "Invalid Process Snapshot Header Size (Expected 48)");
+static_assert(sizeof(ProcessSnapshotModuleRecord) == 16, "Invalid Process Snapshot Module Record Size (Expected 16)");
+static_assert(sizeof(ProcessSnapshotPageRecord) == 24, "Invalid Process Snapshot Page Record Size (Expected 24)");
+
+ProcessSnapshotRecorder::ProcessSnapshotRecorder()
+{
+    // Defaults
+    MainModuleAddress = 0;
+    MainModuleSize = 0;
+}
+
+void ProcessSnapshotRecorder::SetProcessInfo(const std::string& ProcessPath, uintptr_t MainModuleAddress, uintptr_t MainModuleSize)
+{
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(RecorderMutex);
+
+    // Set
+    this->ProcessPath = ProcessPath;
+    this->MainModuleAddress = MainModuleAddress;
+    this->MainModuleSize = MainModuleSize;
+}
+
+void ProcessSnapshotRecorder::AddModule(const std::string& ModuleName, uintptr_t ModuleAddress)
+{
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(RecorderMutex);
+    // Set
+    Modules[ModuleName] = ModuleAddress;
+}
+
+bool ProcessSnapshotRecorder::HasPage(uintptr_t PageAddress)
+{
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(RecorderMutex);
+    // Check
+    return Pages.find(PageAddress) != Pages.end();
+}
+
+void ProcessSnapshotRecorder::AddPage(uintptr_t PageAddress, const uint8_t* Data)
+{
+    // Copy it first, outside of the lock
+    auto Page = std::make_unique<uint8_t[]>(ProcessSnapshotPageSize);
+    std::memcpy(Page.get(), Data, ProcessSnapshotPageSize);
+
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(RecorderMutex);
+    // Keep the first copy, that's what the export saw
+    Pages.emplace(PageAddress, std::move(Page));
+}
+
+size_t ProcessSnapshotRecorder::GetPageCount()
+{
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(RecorderMutex);
+    // Return result
+    return Pages.size();
+}
+
+bool ProcessSnapshotRecorder::Save(const std::string& FilePath)
+{
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(RecorderMutex);
+
+    // Build the header, the records, and the string table first
+    ProcessSnapshotHeader Header{};
+    Header.Magic = ProcessSnapshotMagic;
+    Header.Version = ProcessSnapshotVersion;
+    Header.PageSize = (uint32_t)ProcessSnapshotPageSize;
+    Header.PageCount = (uint32_t)Pages.size();
+    Header.ModuleCount = (uint32_t)Modules.size();
+    Header.MainModuleAddress = MainModuleAddress;
+    Header.MainModuleSize = MainModuleSize;
+
+    std::string StringTable;
+    std::vector<ProcessSnapshotModuleRecord> ModuleRecords;
+
+    Header.ProcessPathOffset = 0;
+    Header.ProcessPathLength = (uint32_t)ProcessPath.size();
+    StringTable += ProcessPath;
+
+    for (auto& Module : Modules)
+    {
+        ProcessSnapshotModuleRecord Record{};
+
+        Record.Address = Module.second;
+        Record.NameOffset = (uint32_t)StringTable.size();
+        Record.NameLength = (uint32_t)Module.first.size();
+        StringTable += Module.first;
+
+        ModuleRecords.push_back(Record);
+    }
+
+    Header.StringsSize = (uint32_t)StringTable.size();
+
+    // Compress the pages, keeping them raw when it doesn't help
+    std::vector<ProcessSnapshotPageRecord> PageRecords;
+    std::vector<uint8_t> PageData;
+
+    PageRecords.reserve(Pages.size());
+
+    auto CompressedPage = std::make_unique<int8_t[]>(Compression::CompressionSizeLZ4((uint32_t)ProcessSnapshotPageSize));
+    auto DataOffset = sizeof(ProcessSnapshotHeader) + ModuleRecords.size() * sizeof(ProcessSnapshotModuleRecord) + Pages.size() * sizeof(ProcessSnapshotPageRecord) + StringTable.size();
+
+    for (auto& Page : Pages)
+    {
+        ProcessSnapshotPageRecord Record{};
+
+        auto CompressedSize = Compression::CompressLZ4Block((const int8_t*)Page.second.get(), CompressedPage.get(), (int32_t)ProcessSnapshotPageSize, (int32_t)Compression::CompressionSizeLZ4((uint32_t)ProcessSnapshotPageSize));
+
+        Record.Address = Page.first;
+        Record.DataOffset = DataOffset + PageData.size();
+
+        if (CompressedSize > 0 && CompressedSize < ProcessSnapshotPageSize)
+        {
+            Record.DataSize = CompressedSize;
+            Record.Compressed = 1;
+            PageData.insert(PageData.end(), (uint8_t*)CompressedPage.get(), (uint8_t*)CompressedPage.get() + CompressedSize);
+        }
+        else
+        {
+            Record.DataSize = (uint32_t)ProcessSnapshotPageSize;
+            Record.Compressed = 0;
+            PageData.insert(PageData.end(), Page.second.get(), Page.second.get() + ProcessSnapshotPageSize);
+        }
+
+        PageRecords.push_back(Record);
+    }
+
+    // Write to a temporary file, then swap it in, so a crash never leaves a half written snapshot
+    auto TempFilePath = FilePath + ".tmp";
+
+    {
+        BinaryWriter Writer;
+
+        if (!Writer.Create(TempFilePath))
+            return false;
+
+        Writer.Write(Header);
+
+        if (!ModuleRecords.empty())
+            Writer.Write((const int8_t*)ModuleRecords.data(), (uint32_t)(ModuleRecords.size() * sizeof(ProcessSnapshotModuleRecord)));
+        if (!PageRecords.empty())
+            Writer.Write((const int8_t*)PageRecords.data(), (uint32_t)(PageRecords.size() * sizeof(ProcessSnapshotPageRecord)));
+        if (!StringTable.empty())
+            Writer.Write((const int8_t*)StringTable.data(), (uint32_t)StringTable.size());
+        if (!PageData.empty())
+            Writer.Write((const int8_t*)PageData.data(), (uint32_t)PageData.size());
+    }
+
+    if (!MoveFileExA(TempFilePath.c_str(), FilePath.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        FileSystems::DeleteFile(TempFilePath);
+        return false;
+    }
+
+    // Success
+    return true;
+}
+
+ProcessSnapshot::ProcessSnapshot()
+{
+    // Defaults
+    FileHandle = INVALID_HANDLE_VALUE;
+    MappingHandle = NULL;
+    View = nullptr;
+    ViewSize = 0;
+    PageRecords = nullptr;
+    PageCount = 0;
+    MainModuleAddress = 0;
+    MainModuleSize = 0;
+}
+
+ProcessSnapshot::~ProcessSnapshot()
+{
+    // Clean up
+    Close();
+}
+
+bool ProcessSnapshot::Open(const std::string& FilePath)
+{
+    // Close any existing snapshot
+    Close();
+
+    // Open the file
+    FileHandle = CreateFileA(FilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    // Get the size
+    LARGE_INTEGER FileSize{};
+
+    if (!GetFileSizeEx(FileHandle, &FileSize) || (uint64_t)FileSize.QuadPart < sizeof(ProcessSnapshotHeader))
+    {
+        Close();
+        return false;
+    }
+
+    // Map it
+    MappingHandle = CreateFileMappingA(FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (MappingHandle == NULL)
+    {
+        Close();
+        return false;
+    }
+
+    View = (const uint8_t*)MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+    ViewSize = FileSize.QuadPart;
+
+    if (View == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    // Validate the header and that the tables are within the file, page data is checked as it's read
+    auto Header = (const ProcessSnapshotHeader*)View;
+
+    if (Header->Magic != ProcessSnapshotMagic || Header->Version != ProcessSnapshotVersion || Header->PageSize != ProcessSnapshotPageSize)
+    {
+        Close();
+        return false;
+    }
+
+    uint64_t ModulesSize = (uint64_t)Header->ModuleCount * sizeof(ProcessSnapshotModuleRecord);
+    uint64_t PagesSize = (uint64_t)Header->PageCount * sizeof(ProcessSnapshotPageRecord);
+
+    if (sizeof(ProcessSnapshotHeader) + ModulesSize + PagesSize + Header->StringsSize > ViewSize || (uint64_t)Header->ProcessPathOffset + Header->ProcessPathLength > Header->StringsSize)
+    {
+        Close();
+        return false;
+    }
+
+    auto Modules = (const ProcessSnapshotModuleRecord*)(View + sizeof(ProcessSnapshotHeader));
+    auto Strings = (const char*)(View + sizeof(ProcessSnapshotHeader) + ModulesSize + PagesSize);
+
+    // The pages are used in place
+    PageRecords = (const ProcessSnapshotPageRecord*)(View + sizeof(ProcessSnapshotHeader) + ModulesSize);
+    PageCount = Header->PageCount;
+
+    // Copy out the process info
+    ProcessPath.assign(Strings + Header->ProcessPathOffset, Header->ProcessPathLength);
+    MainModuleAddress = (uintptr_t)Header->MainModuleAddress;
+    MainModuleSize = (uintptr_t)Header->MainModuleSize;
+
+    for (uint32_t i = 0; i < Header->ModuleCount; i++)
+    {
+        if ((uint64_t)Modules[i].NameOffset + Modules[i].NameLength <= Header->StringsSize)
+            this->Modules[std::string(Strings + Modules[i].NameOffset, Modules[i].NameLength)] = (uintptr_t)Modules[i].Address;
+    }
+
+    // Success
+    return true;
+}
+
+void ProcessSnapshot::Close()
+{
+    {
+        // Aquire lock
+        std::unique_lock<std::shared_mutex> Lock(PagesMutex);
+        // Free the pages
+        Pages.clear();
+    }
+
+    // Clean up in reverse
+    if (View != nullptr)
+        UnmapViewOfFile(View);
+    if (MappingHandle != NULL)
+        ::CloseHandle(MappingHandle);
+    if (FileHandle != INVALID_HANDLE_VALUE)
+        ::CloseHandle(FileHandle);
+
+    FileHandle = INVALID_HANDLE_VALUE;
+    MappingHandle = NULL;
+    View = nullptr;
+    ViewSize = 0;
+    PageRecords = nullptr;
+    PageCount = 0;
+    ProcessPath.clear();
+    MainModuleAddress = 0;
+    MainModuleSize = 0;
+    Modules.clear();
+}
+
+uintptr_t ProcessSnapshot::GetModuleAddress(const std::string& ModuleName) const
+{
+    // Find it
+    auto Module = Modules.find(ModuleName);
+
+    if (Module != Modules.end())
+        return Module->second;
+
+    // Not recorded
+    return 0;
+}
+
+const uint8_t* ProcessSnapshot::GetPage(uintptr_t PageAddress)
+{
+    {
+        // Aquire lock
+        std::shared_lock<std::shared_mutex> Lock(PagesMutex);
+
+        // Return it if it's already decompressed
+        auto Page = Pages.find(PageAddress);
+
+        if (Page != Pages.end())
+            return Page->second.get();
+    }
+
+    // Binary search the records
+    auto Record = std::lower_bound(PageRecords, PageRecords + PageCount, PageAddress, [](const ProcessSnapshotPageRecord& Lhs, uintptr_t Rhs)
+    {
+        return Lhs.Address < Rhs;
+    });
+
+    if (Record == PageRecords + PageCount || Record->Address != PageAddress || Record->DataOffset + Record->DataSize > ViewSize)
+        return nullptr;
+
+    // Decompress it
+    auto Page = std::make_unique<uint8_t[]>(ProcessSnapshotPageSize);
+
+    if (Record->Compressed != 0)
+    {
+        if (Compression::DecompressLZ4Block((const int8_t*)(View + Record->DataOffset), (int8_t*)Page.get(), (int32_t)Record->DataSize, (int32_t)ProcessSnapshotPageSize) != ProcessSnapshotPageSize)
+            return nullptr;
+    }
+    else if (Record->DataSize == ProcessSnapshotPageSize)
+    {
+        std::memcpy(Page.get(), View + Record->DataOffset, ProcessSnapshotPageSize);
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    // Aquire lock
+    std::unique_lock<std::shared_mutex> Lock(PagesMutex);
+
+    // Another thread may have beaten us to it, pages are never removed while open, so the pointer stays valid
+    return Pages.emplace(PageAddress, std::move(Page)).first->second.get();
+}
+
+size_t ProcessSnapshot::Read(uintptr_t Address, uint8_t* Buffer, size_t Length)
+{
+    // The amount read
+    size_t Result = 0;
+
+    // Copy page by page
+    while (Result < Length)
+    {
+        auto PageAddress = (Address + Result) & ~(ProcessSnapshotPageSize - 1);
+        auto PageOffset = (Address + Result) - PageAddress;
+        auto Count = std::min<size_t>(Length - Result, ProcessSnapshotPageSize - PageOffset);
+
+        auto Page = GetPage(PageAddress);
+
+        // Stop at memory that wasn't recorded
+        if (Page == nullptr)
+            break;
+
+        std::memcpy(Buffer + Result, Page + PageOffset, Count);
+        Result += Count;
+    }
+
+    // Return result
+    return Result;
+}
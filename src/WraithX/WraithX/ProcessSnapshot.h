@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <map>
+#include <unordered_map>
+#include <Windows.h>
+
+// The size of a page in a snapshot
+constexpr uintptr_t ProcessSnapshotPageSize = 0x1000;
+
+// A class that records the pages of a process that were read, so they can be saved to a snapshot
+class ProcessSnapshotRecorder
+{
+public:
+    // Constructors
+    ProcessSnapshotRecorder();
+
+    // Sets the process information the snapshot reports
+    void SetProcessInfo(const std::string& ProcessPath, uintptr_t MainModuleAddress, uintptr_t MainModuleSize);
+    // Adds a module address
+    void AddModule(const std::string& ModuleName, uintptr_t ModuleAddress);
+
+    // Checks if a page was recorded
+    bool HasPage(uintptr_t PageAddress);
+    // Adds a page, keeps the existing page if it was already recorded
+    void AddPage(uintptr_t PageAddress, const uint8_t* Data);
+
+    // Gets the number of recorded pages
+    size_t GetPageCount();
+
+    // Writes the snapshot, compressing each page
+    bool Save(const std::string& FilePath);
+
+private:
+    // The recorded pages, sorted by address
+    std::map<uintptr_t, std::unique_ptr<uint8_t[]>> Pages;
+    // The recorded module addresses
+    std::map<std::string, uintptr_t> Modules;
+    // The path of the process
+    std::string ProcessPath;
+    // The address of the main module
+    uintptr_t MainModuleAddress;
+    // The size of the main module
+    uintptr_t MainModuleSize;
+
+    // A lock for the recorded data
+    std::mutex RecorderMutex;
+};
+
+// A class that replays the memory of a process from a memory mapped snapshot
+class ProcessSnapshot
+{
+public:
+    // Constructors
+    ProcessSnapshot();
+    ~ProcessSnapshot();
+
+    // Maps a snapshot, returns false if it's missing or invalid
+    bool Open(const std::string& FilePath);
+    // Unmaps the snapshot
+    void Close();
+
+    // Reads memory, stopping at the first page that wasn't recorded, returns the amount read
+    size_t Read(uintptr_t Address, uint8_t* Buffer, size_t Length);
+
+    // Gets the path of the recorded process
+    std::string GetProcessPath() const { return ProcessPath; }
+    // Gets the address of the recorded main module
+    uintptr_t GetMainModuleAddress() const { return MainModuleAddress; }
+    // Gets the size of the recorded main module
+    uintptr_t GetMainModuleSize() const { return MainModuleSize; }
+    // Gets the address of a recorded module, 0 if it wasn't recorded
+    uintptr_t GetModuleAddress(const std::string& ModuleName) const;
+
+private:
+    // The open file
+    HANDLE FileHandle;
+    // The file mapping
+    HANDLE MappingHandle;
+    // The mapped view
+    const uint8_t* View;
+    // The size of the mapped view
+    uint64_t ViewSize;
+
+    // The page records, sorted by address (Defined in ProcessSnapshot.cpp)
+    const struct ProcessSnapshotPageRecord* PageRecords;
+    // The number of pages
+    uint32_t PageCount;
+
+    // The path of the process
+    std::string ProcessPath;
+    // The address of the main module
+    uintptr_t MainModuleAddress;
+    // The size of the main module
+    uintptr_t MainModuleSize;
+    // The module addresses
+    std::unordered_map<std::string, uintptr_t> Modules;
+
+    // Pages decompressed so far
+    std::unordered_map<uintptr_t, std::unique_ptr<uint8_t[]>> Pages;
+    // A lock for the decompressed pages
+    std::shared_mutex PagesMutex;
+
+    // Finds and decompresses a page, returns nullptr if it wasn't recorded
+    const uint8_t* GetPage(uintptr_t PageAddress);
+};
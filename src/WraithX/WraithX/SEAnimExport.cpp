@@ -36,6 +36,50 @@ enum class SEAnimDataPresenceFlags : uint8_t
     SEANIM_PRESENCE_CUSTOM = 1 << 7,
 };
 
+template<class T>
+// Writes the keys of a curve, frame indices are sized by the total frames
+void SEAnimWriteCurve(BinaryWriter& Writer, uint32_t FrameCountBuffer, const WraithAnimCurve<T>& Curve)
+{
+    // Write count based on total frames, 0 if there are no keys
+    if (FrameCountBuffer <= 0xFF)
+    {
+        // Write as byte
+        Writer.Write<uint8_t>((uint8_t)Curve.Size());
+    }
+    else if (FrameCountBuffer <= 0xFFFF)
+    {
+        // Write as short
+        Writer.Write<uint16_t>((uint16_t)Curve.Size());
+    }
+    else
+    {
+        // Write as int
+        Writer.Write<uint32_t>((uint32_t)Curve.Size());
+    }
+    // Output keys
+    for (size_t i = 0; i < Curve.Size(); i++)
+    {
+        // Write frame index based on total frames
+        if (FrameCountBuffer <= 0xFF)
+        {
+            // Write as byte
+            Writer.Write<uint8_t>((uint8_t)Curve.Frames[i]);
+        }
+        else if (FrameCountBuffer <= 0xFFFF)
+        {
+            // Write as short
+            Writer.Write<uint16_t>((uint16_t)Curve.Frames[i]);
+        }
+        else
+        {
+            // Write as int
+            Writer.Write<uint32_t>((uint32_t)Curve.Frames[i]);
+        }
+        // Output the value
+        Writer.Write<T>(Curve.Values[i]);
+    }
+}
+
 void SEAnim::ExportSEAnim(const WraithAnim& Animation, const std::string& FileName)
 {
     // Create a new writer
@@ -68,22 +112,26 @@ void SEAnim::ExportSEAnim(const WraithAnim& Animation, const std::string& FileNa
     }
     // Write flags (Looped is the only flag for now)
     Writer.Write<uint8_t>(Animation.Looping ? (1 << 0) : 0);
+    // Check which keys are present, once, since every bone writes them
+    bool HasTranslations = Animation.HasTranslationKeys();
+    bool HasRotations = Animation.HasRotationKeys();
+    bool HasScales = Animation.HasScaleKeys();
     // Build data present flags
     {
         // Buffer
         uint8_t DataPresentFlags = 0x0;
         // Check for translations
-        if (Animation.AnimationPositionKeys.size() > 0)
+        if (HasTranslations)
         {
             DataPresentFlags |= (uint8_t)SEAnimDataPresenceFlags::SEANIM_BONE_LOC;
         }
         // Check for rotations
-        if (Animation.AnimationRotationKeys.size() > 0)
+        if (HasRotations)
         {
             DataPresentFlags |= (uint8_t)SEAnimDataPresenceFlags::SEANIM_BONE_ROT;
         }
         // Check for scales
-        if (Animation.AnimationScaleKeys.size() > 0)
+        if (HasScales)
         {
             DataPresentFlags |= (uint8_t)SEAnimDataPresenceFlags::SEANIM_BONE_SCALE;
         }
@@ -121,19 +169,20 @@ void SEAnim::ExportSEAnim(const WraithAnim& Animation, const std::string& FileNa
     Writer.Write<uint32_t>(NotificationBuffer);
     // Build unique tag data, in the order we need
     {
-        // Get the bone tags present in the animation
-        auto BoneTags = Animation.Bones();
+        // Get the bone table, tags are written in table order
+        auto& BoneTags = Animation.GetBones();
         // Loop and write the tags
         for (auto& Tag : BoneTags)
         {
             // Write it
-            Writer.WriteNullTerminatedString(Tag);
+            Writer.WriteNullTerminatedString(Tag.Name);
         }
         // Loop through modifiers
         for (auto& Modifier : Animation.AnimationBoneModifiers)
         {
-            // Calculate the distance
-            int16_t Index = (uint16_t)std::distance(BoneTags.begin(), BoneTags.find(Modifier.first));
+            // Get the index, modifiers are always in the table
+            uint32_t Index = 0;
+            Animation.TryGetBoneIndex(Modifier.first, Index);
             // Write the modifier
             if (BoneCountBuffer <= 0xFF)
             {
@@ -169,202 +218,14 @@ void SEAnim::ExportSEAnim(const WraithAnim& Animation, const std::string& FileNa
             Writer.Write<uint8_t>(0x0);
 
             // Write translation keys first (if we have any)
-            if (Animation.AnimationPositionKeys.size() > 0)
-            {
-                // Check if this bone has any translations
-                if (Animation.AnimationPositionKeys.find(Tag) != Animation.AnimationPositionKeys.end())
-                {
-                    // We have keys, write count based on total frames
-                    if (FrameCountBuffer <= 0xFF)
-                    {
-                        // Write as byte
-                        Writer.Write<uint8_t>((uint8_t)Animation.AnimationPositionKeys.at(Tag).size());
-                    }
-                    else if (FrameCountBuffer <= 0xFFFF)
-                    {
-                        // Write as short
-                        Writer.Write<uint16_t>((uint16_t)Animation.AnimationPositionKeys.at(Tag).size());
-                    }
-                    else
-                    {
-                        // Write as int
-                        Writer.Write<uint32_t>((uint32_t)Animation.AnimationPositionKeys.at(Tag).size());
-                    }
-                    // Output keys
-                    for (auto& Key : Animation.AnimationPositionKeys.at(Tag))
-                    {
-                        // Write frame index based on total frames
-                        if (FrameCountBuffer <= 0xFF)
-                        {
-                            // Write as byte
-                            Writer.Write<uint8_t>((uint8_t)Key.Frame);
-                        }
-                        else if (FrameCountBuffer <= 0xFFFF)
-                        {
-                            // Write as short
-                            Writer.Write<uint16_t>((uint16_t)Key.Frame);
-                        }
-                        else
-                        {
-                            // Write as int
-                            Writer.Write<uint32_t>((uint32_t)Key.Frame);
-                        }
-                        // Output the vector
-                        Writer.Write<Vector3>(Key.Value);
-                    }
-                }
-                else
-                {
-                    // No keys for this bone, write the count based on total frames
-                    if (FrameCountBuffer <= 0xFF)
-                    {
-                        // Write as byte
-                        Writer.Write<uint8_t>(0x0);
-                    }
-                    else if (FrameCountBuffer <= 0xFFFF)
-                    {
-                        // Write as short
-                        Writer.Write<uint16_t>(0x0);
-                    }
-                    else
-                    {
-                        // Write as int
-                        Writer.Write<uint32_t>(0x0);
-                    }
-                }
-            }
-
+            if (HasTranslations)
+                SEAnimWriteCurve(Writer, FrameCountBuffer, Tag.Translations);
             // Write rotation keys next (if we have any)
-            if (Animation.AnimationRotationKeys.size() > 0)
-            {
-                // Check if this bone has any rotations
-                if (Animation.AnimationRotationKeys.find(Tag) != Animation.AnimationRotationKeys.end())
-                {
-                    // We have keys, write count based on total frames
-                    if (FrameCountBuffer <= 0xFF)
-                    {
-                        // Write as byte
-                        Writer.Write<uint8_t>((uint8_t)Animation.AnimationRotationKeys.at(Tag).size());
-                    }
-                    else if (FrameCountBuffer <= 0xFFFF)
-                    {
-                        // Write as short
-                        Writer.Write<uint16_t>((uint16_t)Animation.AnimationRotationKeys.at(Tag).size());
-                    }
-                    else
-                    {
-                        // Write as int
-                        Writer.Write<uint32_t>((uint32_t)Animation.AnimationRotationKeys.at(Tag).size());
-                    }
-                    // Output keys
-                    for (auto& Key : Animation.AnimationRotationKeys.at(Tag))
-                    {
-                        // Write frame index based on total frames
-                        if (FrameCountBuffer <= 0xFF)
-                        {
-                            // Write as byte
-                            Writer.Write<uint8_t>((uint8_t)Key.Frame);
-                        }
-                        else if (FrameCountBuffer <= 0xFFFF)
-                        {
-                            // Write as short
-                            Writer.Write<uint16_t>((uint16_t)Key.Frame);
-                        }
-                        else
-                        {
-                            // Write as int
-                            Writer.Write<uint32_t>((uint32_t)Key.Frame);
-                        }
-                        // Output the quaternion
-                        Writer.Write<Quaternion>(Key.Value);
-                    }
-                }
-                else
-                {
-                    // No keys for this bone, write the count based on total frames
-                    if (FrameCountBuffer <= 0xFF)
-                    {
-                        // Write as byte
-                        Writer.Write<uint8_t>(0x0);
-                    }
-                    else if (FrameCountBuffer <= 0xFFFF)
-                    {
-                        // Write as short
-                        Writer.Write<uint16_t>(0x0);
-                    }
-                    else
-                    {
-                        // Write as int
-                        Writer.Write<uint32_t>(0x0);
-                    }
-                }
-            }
-
+            if (HasRotations)
+                SEAnimWriteCurve(Writer, FrameCountBuffer, Tag.Rotations);
             // Write scale keys next (if we have any)
-            if (Animation.AnimationScaleKeys.size() > 0)
-            {
-                // Check if this bone has any scales
-                if (Animation.AnimationScaleKeys.find(Tag) != Animation.AnimationScaleKeys.end())
-                {
-                    // We have keys, write count based on total frames
-                    if (FrameCountBuffer <= 0xFF)
-                    {
-                        // Write as byte
-                        Writer.Write<uint8_t>((uint8_t)Animation.AnimationScaleKeys.at(Tag).size());
-                    }
-                    else if (FrameCountBuffer <= 0xFFFF)
-                    {
-                        // Write as short
-                        Writer.Write<uint16_t>((uint16_t)Animation.AnimationScaleKeys.at(Tag).size());
-                    }
-                    else
-                    {
-                        // Write as int
-                        Writer.Write<uint32_t>((uint32_t)Animation.AnimationScaleKeys.at(Tag).size());
-                    }
-                    // Output keys
-                    for (auto& Key : Animation.AnimationScaleKeys.at(Tag))
-                    {
-                        // Write frame index based on total frames
-                        if (FrameCountBuffer <= 0xFF)
-                        {
-                            // Write as byte
-                            Writer.Write<uint8_t>((uint8_t)Key.Frame);
-                        }
-                        else if (FrameCountBuffer <= 0xFFFF)
-                        {
-                            // Write as short
-                            Writer.Write<uint16_t>((uint16_t)Key.Frame);
-                        }
-                        else
-                        {
-                            // Write as int
-                            Writer.Write<uint32_t>((uint32_t)Key.Frame);
-                        }
-                        // Output the vector
-                        Writer.Write<Vector3>(Key.Value);
-                    }
-                }
-                else
-                {
-                    // No keys for this bone, write the count based on total frames
-                    if (FrameCountBuffer <= 0xFF)
-                    {
-                        // Write as byte
-                        Writer.Write<uint8_t>(0x0);
-                    }
-                    else if (FrameCountBuffer <= 0xFFFF)
-                    {
-                        // Write as short
-                        Writer.Write<uint16_t>(0x0);
-                    }
-                    else
-                    {
-                        // Write as int
-                        Writer.Write<uint32_t>(0x0);
-                    }
-                }
-            }
+            if (HasScales)
+                SEAnimWriteCurve(Writer, FrameCountBuffer, Tag.Scales);
         }
     }
     // Output notetracks, if any
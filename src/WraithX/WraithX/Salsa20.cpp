@@ -198,3 +198,59 @@ enum s20_status_t s20_crypt(uint8_t *key,
 
   return S20_SUCCESS;
 }
+
+// Performs encryption or decryption of any range of a message, a keystream
+// block at a time, with a 64-bit block counter
+enum s20_status_t s20_crypt64(uint8_t *key,
+                              enum s20_keylen_t keylen,
+                              uint8_t nonce[8],
+                              uint64_t si,
+                              uint8_t *buf,
+                              size_t buflen)
+{
+  uint8_t keystream[64];
+  uint8_t n[16] = { 0 };
+  uint64_t block;
+  size_t offset, count, i;
+
+  // Pick an expansion function based on key size
+  void (*expand)(uint8_t *, uint8_t *, uint8_t *) = NULL;
+  if (keylen == S20_KEYLEN_256)
+    expand = s20_expand32;
+  if (keylen == S20_KEYLEN_128)
+    expand = s20_expand16;
+
+  // If any of the parameters we received are invalid
+  if (expand == NULL || key == NULL || nonce == NULL || (buf == NULL && buflen > 0))
+    return S20_FAILURE;
+
+  // Set up the low 8 bytes of n with the unique message number
+  for (i = 0; i < 8; ++i)
+    n[i] = nonce[i];
+
+  // The first block may only be partly used
+  block = si / 64;
+  offset = (size_t)(si % 64);
+
+  while (buflen > 0) {
+    // Set the high 8 bytes of n to the block number
+    s20_rev_littleendian(n+8, (uint32_t)block);
+    s20_rev_littleendian(n+12, (uint32_t)(block >> 32));
+    (*expand)(key, n, keystream);
+
+    // xor as much of this block as we need
+    count = 64 - offset;
+    if (count > buflen)
+      count = buflen;
+
+    for (i = 0; i < count; ++i)
+      buf[i] ^= keystream[offset + i];
+
+    buf += count;
+    buflen -= count;
+    offset = 0;
+    ++block;
+  }
+
+  return S20_SUCCESS;
+}
@@ -64,4 +64,17 @@ enum s20_status_t s20_crypt(uint8_t *key,
                             uint8_t *buf,
                             uint32_t buflen);
 
+/**
+ * Same as s20_crypt, but with a 64-bit stream index and length, so any
+ * range of a message larger than 4GB can be encrypted or decrypted on
+ * its own. For stream indices under 2^32 the keystream is identical to
+ * s20_crypt.
+ */
+enum s20_status_t s20_crypt64(uint8_t *key,
+                              enum s20_keylen_t keylen,
+                              uint8_t nonce[8],
+                              uint64_t si,
+                              uint8_t *buf,
+                              size_t buflen);
+
 #endif
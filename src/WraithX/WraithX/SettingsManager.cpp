@@ -19,9 +19,14 @@
 std::unordered_map<std::string, std::string> SettingsManager::SettingsCache;
 // Default name
 std::string SettingsManager::SettingsFileName = "";
+// Settings lock
+std::mutex SettingsManager::SettingsMutex;
 
 void SettingsManager::LoadSettings(const std::string& SettingsName, const std::map<std::string, std::string>& Defaults)
 {
+    // Aquire lock
+    std::unique_lock<std::mutex> Lock(SettingsMutex);
+
     // Reset
     SettingsCache.clear();
 
@@ -95,12 +100,16 @@ void SettingsManager::LoadSettings(const std::string& SettingsName, const std::m
         }
     }
 
-    // Resave
+    // Resave, it takes the lock itself
+    Lock.unlock();
     SaveSettings();
 }
 
 void SettingsManager::SaveSettings()
 {
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(SettingsMutex);
+
     // Make a writer
     TextWriter Writer;
     // Load the file
@@ -115,11 +124,16 @@ void SettingsManager::SaveSettings()
 
 std::string SettingsManager::GetSetting(const std::string& Key, const std::string& Default)
 {
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(SettingsMutex);
+
     // Grab a key if it exists
-    if (SettingsCache.find(Key) != SettingsCache.end())
+    auto Setting = SettingsCache.find(Key);
+
+    if (Setting != SettingsCache.end())
     {
         // Return it
-        return ModifyValue(Key, SettingsCache.at(Key));
+        return ModifyValue(Key, Setting->second);
     }
     // Add it
     SettingsCache.insert(std::make_pair(Key, UnModifyValue(Key, Default)));
@@ -132,6 +146,9 @@ void SettingsManager::SetSetting(const std::string& Key, const std::string& Valu
     // The value to use
     auto NewValue = UnModifyValue(Key, Value);
 
+    // Aquire lock
+    std::unique_lock<std::mutex> Lock(SettingsMutex);
+
     // Check for it
     if (SettingsCache.find(Key) != SettingsCache.end())
     {
@@ -144,7 +161,8 @@ void SettingsManager::SetSetting(const std::string& Key, const std::string& Valu
         SettingsCache.insert(std::make_pair(Key, NewValue));
     }
 
-    // Save
+    // Save, it takes the lock itself
+    Lock.unlock();
     SaveSettings();
 }
 
@@ -5,6 +5,7 @@
 #include <map>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 
 // A class that handles reading and writing settings
 class SettingsManager
@@ -14,6 +15,8 @@ private:
     static std::unordered_map<std::string, std::string> SettingsCache;
     // The settings file name
     static std::string SettingsFileName;
+    // A lock for the settings, they are read from export workers
+    static std::mutex SettingsMutex;
 
     // -- Functions
     
@@ -21,8 +21,10 @@
 
 struct FLACStreamInfo
 {
-    // Basic stream info
-    int8_t* InputBuffer;
+    // Basic stream info, the stream is the header followed by the input
+    const int8_t* HeaderBuffer;
+    uint64_t HeaderBufferSize;
+    const int8_t* InputBuffer;
     uint64_t InputBufferSize;
     uint64_t CurrentPosition;
     FILE* OutputFileHandle;
@@ -32,6 +34,9 @@ struct FLACStreamInfo
     uint32_t SampleRate;
     uint32_t ChannelsCount;
     uint32_t Bps;
+
+    // The interleaved samples of the current frame, written at once
+    std::vector<int16_t> FrameBuffer;
 };
 
 struct WAVStreamInfo
@@ -74,7 +79,7 @@ FLAC__StreamDecoderSeekStatus FLACSeekStream(const FLAC__StreamDecoder *decoder,
     FLACStreamInfo* StreamData = (FLACStreamInfo*)client_data;
 
     // Make sure we are within bounds
-    if (absolute_byte_offset <= StreamData->InputBufferSize)
+    if (absolute_byte_offset <= StreamData->HeaderBufferSize + StreamData->InputBufferSize)
     {
         // Set position
         StreamData->CurrentPosition = absolute_byte_offset;
@@ -93,7 +98,7 @@ FLAC__bool FLACEOFStream(const FLAC__StreamDecoder *decoder, void *client_data)
     // First, grab our stream info
     FLACStreamInfo* StreamData = (FLACStreamInfo*)client_data;
     // Check result
-    if (StreamData->CurrentPosition >= StreamData->InputBufferSize)
+    if (StreamData->CurrentPosition >= StreamData->HeaderBufferSize + StreamData->InputBufferSize)
     {
         // At end
         return true;
@@ -107,7 +112,7 @@ FLAC__StreamDecoderLengthStatus FLACLengthStream(const FLAC__StreamDecoder *deco
     // First, grab our stream info
     FLACStreamInfo* StreamData = (FLACStreamInfo*)client_data;
     // Set result
-    *stream_length = (FLAC__uint64)StreamData->InputBufferSize;
+    *stream_length = (FLAC__uint64)(StreamData->HeaderBufferSize + StreamData->InputBufferSize);
     // Done
     return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
 }
@@ -130,40 +135,48 @@ FLAC__StreamDecoderReadStatus FLACReadFromStream(const FLAC__StreamDecoder *deco
     // Check size to read
     if (*bytes > 0)
     {
-        // Prepare to read the data we need
-        auto DataRequested = *bytes;
+        // The size of the whole stream
+        auto StreamSize = StreamData->HeaderBufferSize + StreamData->InputBufferSize;
+
+        // Check if we're at the end
+        if (StreamData->CurrentPosition >= StreamSize)
+        {
+            // Set
+            *bytes = 0;
+            // We hit end too early, alert reader
+            return FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+        }
 
-        // Remainder
-        auto DataBufferRemainder = (int64_t)((int64_t)StreamData->InputBufferSize - (int64_t)StreamData->CurrentPosition);
+        // Prepare to read the data we need, or the remainder of the stream
+        auto DataRequested = (size_t)std::min<uint64_t>(*bytes, StreamSize - StreamData->CurrentPosition);
+        // The data left to copy
+        auto DataLeft = DataRequested;
 
-        // Ensure we are within our bounds (Full read)
-        if ((StreamData->CurrentPosition + DataRequested) <= StreamData->InputBufferSize)
+        // Copy what's left of the header first
+        if (StreamData->CurrentPosition < StreamData->HeaderBufferSize)
         {
-            // Copy input to buffer
-            std::memcpy(buffer, StreamData->InputBuffer + StreamData->CurrentPosition, DataRequested);
-            // Set current position
-            StreamData->CurrentPosition += DataRequested;
-            // Return continue
-            return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
+            // Copy from the header
+            auto HeaderRemainder = (size_t)std::min<uint64_t>(DataLeft, StreamData->HeaderBufferSize - StreamData->CurrentPosition);
+            std::memcpy(buffer, StreamData->HeaderBuffer + StreamData->CurrentPosition, HeaderRemainder);
+            // Advance
+            buffer += HeaderRemainder;
+            DataLeft -= HeaderRemainder;
+            StreamData->CurrentPosition += HeaderRemainder;
         }
-        else if (DataBufferRemainder > 0)
+
+        // Then from the input
+        if (DataLeft > 0)
         {
-            // Copy the remainder of the buffer
-            *bytes = (FLAC__uint64)DataBufferRemainder;
             // Copy from input
-            std::memcpy(buffer, StreamData->InputBuffer + StreamData->CurrentPosition, DataBufferRemainder);
+            std::memcpy(buffer, StreamData->InputBuffer + (StreamData->CurrentPosition - StreamData->HeaderBufferSize), DataLeft);
             // Set current position
-            StreamData->CurrentPosition += DataBufferRemainder;
-            // Return
-            return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
-        }
-        else
-        {
-            // Set
-            *bytes = 0;
-            // We hit end too early, alert reader
-            return FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+            StreamData->CurrentPosition += DataLeft;
         }
+
+        // Set what we read
+        *bytes = DataRequested;
+        // Return continue
+        return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
     }
     else
     {
@@ -241,17 +254,26 @@ FLAC__StreamDecoderWriteStatus FLACWriteCallback(const FLAC__StreamDecoder *deco
         fwrite(&TotalSize, 4, 1, StreamData->OutputFileHandle);
     }
 
-    // Write the 16bit PCM samples
+    // Make room for the frame's samples
+    const size_t SampleCount = (size_t)frame->header.blocksize * StreamData->ChannelsCount;
+    if (StreamData->FrameBuffer.size() < SampleCount)
+        StreamData->FrameBuffer.resize(SampleCount);
+
+    // Interleave the 16bit PCM samples
+    auto Samples = StreamData->FrameBuffer.data();
     for (size_t i = 0; i < frame->header.blocksize; i++)
     {
         // Loop for channel count
         for (size_t c = 0; c < StreamData->ChannelsCount; c++)
         {
-            // Write it
-            WriteLEUInt16(StreamData->OutputFileHandle, (uint16_t)((int16_t)buffer[c][i]));
+            // Add it
+            *Samples++ = (int16_t)buffer[c][i];
         }
     }
 
+    // Write the whole frame
+    fwrite(StreamData->FrameBuffer.data(), sizeof(int16_t), SampleCount, StreamData->OutputFileHandle);
+
     // We're ready to continue
     return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
 }
@@ -260,7 +282,13 @@ FLAC__StreamDecoderWriteStatus FLACWriteCallback(const FLAC__StreamDecoder *deco
 
 // -- End FLAC callback functions
 
-bool Sound::ConvertSoundMemory(int8_t* SoundBuffer, uint64_t SoundSize, SoundFormat InFormat, const std::string& OutputFile, SoundFormat OutFormat)
+bool Sound::ConvertSoundMemory(int8_t* SoundBuffer, uint64_t SoundSize, SoundFormat InFormat, const std::string& OutputFile, SoundFormat OutFormat, uint32_t CompressionLevel)
+{
+    // The header is part of the buffer
+    return ConvertSoundMemory(nullptr, 0, SoundBuffer, SoundSize, InFormat, OutputFile, OutFormat, CompressionLevel);
+}
+
+bool Sound::ConvertSoundMemory(const int8_t* HeaderBuffer, uint64_t HeaderSize, const int8_t* DataBuffer, uint64_t DataSize, SoundFormat InFormat, const std::string& OutputFile, SoundFormat OutFormat, uint32_t CompressionLevel)
 {
     // Prepare to convert the buffer to the format required
     auto ConversionResult = false;
@@ -274,7 +302,7 @@ bool Sound::ConvertSoundMemory(int8_t* SoundBuffer, uint64_t SoundSize, SoundFor
         if (OutFormat == SoundFormat::Standard_WAV)
         {
             // Transcode to WAV
-            ConversionResult = TranscodeFLACToWav(SoundBuffer, SoundSize, OutputFile);
+            ConversionResult = TranscodeFLACToWav(HeaderBuffer, HeaderSize, DataBuffer, DataSize, OutputFile);
         }
         else if (OutFormat == SoundFormat::Standard_OGG)
         {
@@ -288,7 +316,7 @@ bool Sound::ConvertSoundMemory(int8_t* SoundBuffer, uint64_t SoundSize, SoundFor
         if (OutFormat == SoundFormat::Standard_FLAC)
         {
             // Transcode to FLAC
-            ConversionResult = TranscodeWAVToFlac(SoundBuffer, SoundSize, OutputFile);
+            ConversionResult = TranscodeWAVToFlac(HeaderBuffer, HeaderSize, DataBuffer, DataSize, OutputFile, CompressionLevel);
         }
         else if (OutFormat == SoundFormat::Standard_OGG)
         {
@@ -333,7 +361,7 @@ bool Sound::ConvertSoundFile(const std::string& InputFile, SoundFormat InFormat,
     return false;
 }
 
-bool Sound::TranscodeFLACToWav(int8_t* SoundBuffer, uint64_t SoundSize, const std::string& OutputFile)
+bool Sound::TranscodeFLACToWav(const int8_t* HeaderBuffer, uint64_t HeaderSize, const int8_t* SoundBuffer, uint64_t SoundSize, const std::string& OutputFile)
 {
     // Prepare to transcode the FLAC buffer to a WAV file
     bool IsOk = true;
@@ -352,9 +380,14 @@ bool Sound::TranscodeFLACToWav(int8_t* SoundBuffer, uint64_t SoundSize, const st
         return false;
     }
 
+    // Frames are written whole, so give the file a buffer that fits a few
+    setvbuf(OutputHandle, nullptr, _IOFBF, 0x40000);
+
     // A flac stream info buffer used for transcoding everything
     auto FlacInfo = std::make_unique<FLACStreamInfo>();
     // Set properties
+    FlacInfo->HeaderBuffer = HeaderBuffer;
+    FlacInfo->HeaderBufferSize = (HeaderBuffer != nullptr) ? HeaderSize : 0;
     FlacInfo->InputBuffer = SoundBuffer;
     FlacInfo->InputBufferSize = SoundSize;
     FlacInfo->OutputFileHandle = OutputHandle;
@@ -397,7 +430,7 @@ bool Sound::TranscodeFLACToWav(int8_t* SoundBuffer, uint64_t SoundSize, const st
     return IsOk;
 }
 
-bool Sound::TranscodeWAVToFlac(int8_t* SoundBuffer, uint64_t SoundSize, const std::string& OutputFile)
+bool Sound::TranscodeWAVToFlac(const int8_t* HeaderBuffer, uint64_t HeaderSize, const int8_t* SoundBuffer, uint64_t SoundSize, const std::string& OutputFile, uint32_t CompressionLevel)
 {
     // Prepare to transcode the WAV buffer to a FLAC file
     bool IsOk = true;
@@ -410,8 +443,16 @@ bool Sound::TranscodeWAVToFlac(int8_t* SoundBuffer, uint64_t SoundSize, const st
     WAVInfo->TotalSamples = 0;
     WAVInfo->SeekLength = 0;
 
-    // Read WAV info
-    auto WAVInfoReader = MemoryReader(SoundBuffer, SoundSize, true);
+    // Whether or not the header is apart from the samples
+    bool SeparateHeader = (HeaderBuffer != nullptr);
+
+    // Read WAV info, from the header if we have one, the reader doesn't modify the buffer
+    auto WAVInfoReader = MemoryReader();
+    // Setup the reader
+    if (SeparateHeader)
+        WAVInfoReader.Setup((int8_t*)HeaderBuffer, HeaderSize, true);
+    else
+        WAVInfoReader.Setup((int8_t*)SoundBuffer, SoundSize, true);
     // Whether or not reader is done
     bool KeepReading = true;
     
@@ -484,64 +525,72 @@ bool Sound::TranscodeWAVToFlac(int8_t* SoundBuffer, uint64_t SoundSize, const st
 
     // Configure the encoder
     FLAC__stream_encoder_set_verify(Encoder, false);
-    FLAC__stream_encoder_set_compression_level(Encoder, 5);
+    FLAC__stream_encoder_set_compression_level(Encoder, std::min(CompressionLevel, 8u));
     FLAC__stream_encoder_set_channels(Encoder, WAVInfo->ChannelsCount);
     FLAC__stream_encoder_set_bits_per_sample(Encoder, WAVInfo->Bps);
     FLAC__stream_encoder_set_sample_rate(Encoder, WAVInfo->SampleRate);
+    FLAC__stream_encoder_set_total_samples_estimate(Encoder, WAVInfo->TotalSamples);
+
+    // We only read 16bit samples
+    if (WAVInfo->Bps != 16) { IsOk = false; }
 
     // Setup the encoder
-    InitStatus = FLAC__stream_encoder_init_file(Encoder, OutputFile.c_str(), nullptr, nullptr);
+    if (IsOk)
+    {
+        InitStatus = FLAC__stream_encoder_init_file(Encoder, OutputFile.c_str(), nullptr, nullptr);
 
-    // Check for failed
-    if (InitStatus != FLAC__STREAM_ENCODER_INIT_STATUS_OK) { IsOk = false; }
+        // Check for failed
+        if (InitStatus != FLAC__STREAM_ENCODER_INIT_STATUS_OK) { IsOk = false; }
+    }
 
     // Continue if we're ok
     if (IsOk)
     {
-        // Total size to read
-        size_t Left = (size_t)WAVInfo->TotalSamples;
-        // Buffers
-        auto Buffer = new FLAC__byte[1024 * ((WAVInfo->Bps / 8) * WAVInfo->ChannelsCount)];
-        auto PCMBuffer = new FLAC__int32[1024 * 2];
+        // The number of frames sent to the encoder at once
+        const size_t ChunkFrames = 4096;
+        // The size of a frame, all channels
+        const size_t FrameSize = (size_t)WAVInfo->ChannelsCount * sizeof(int16_t);
+
+        // Samples follow the header, either at the start of the sound buffer, or where we stopped reading
+        auto SampleData = SeparateHeader ? SoundBuffer : (SoundBuffer + WAVInfoReader.GetPosition());
+        // The size of the samples
+        auto SampleDataSize = SeparateHeader ? SoundSize : (SoundSize - WAVInfoReader.GetPosition());
+
+        // Total frames to encode, limited to what the buffer holds
+        size_t Left = (size_t)std::min<uint64_t>(WAVInfo->TotalSamples, SampleDataSize / FrameSize);
+        // Fail if the buffer was cut short, after encoding what we have
+        bool Truncated = (Left < WAVInfo->TotalSamples);
+
+        // Samples are read straight from the input, a chunk at a time, so we never copy the whole sound
+        auto Samples = (const int16_t*)SampleData;
+        // Widened samples for the encoder, one chunk, all channels
+        auto PCMBuffer = std::make_unique<FLAC__int32[]>(ChunkFrames * WAVInfo->ChannelsCount);
 
         // Loop until EOF
         while (IsOk && Left)
         {
             // Calculate what we need
-            size_t Need = (Left > 1024 ? (size_t)1024 : (size_t)Left);
-
-            // Calculate data size to read
-            auto SizeToRead = (WAVInfo->ChannelsCount * (WAVInfo->Bps / 8)) * Need;
+            size_t Need = std::min(Left, ChunkFrames);
+            // The samples in the chunk
+            size_t SampleCount = Need * WAVInfo->ChannelsCount;
 
-            // Ensure we can read it
-            if (WAVInfoReader.GetPosition() + SizeToRead <= WAVInfoReader.GetLength())
-            {
-                // Read
-                WAVInfoReader.Read(SizeToRead, (int8_t*)Buffer);
-
-                // Convert the data to PCM samples
-                for (size_t i = 0; i < (Need * WAVInfo->ChannelsCount); i++)
-                {
-                    // Convert to PCM
-                    PCMBuffer[i] = (FLAC__int32)(((FLAC__int16)(FLAC__int8)Buffer[2 * i + 1] << 8) | (FLAC__int16)Buffer[2 * i]);
-                }
-
-                // Send off to encoder
-                IsOk = (FLAC__stream_encoder_process_interleaved(Encoder, PCMBuffer, (uint32_t)Need) == 1);
-            }
-            else
+            // Convert the data to PCM samples
+            for (size_t i = 0; i < SampleCount; i++)
             {
-                // Failed
-                IsOk = false;
+                // Convert to PCM
+                PCMBuffer[i] = (FLAC__int32)Samples[i];
             }
 
+            // Send off to encoder
+            IsOk = (FLAC__stream_encoder_process_interleaved(Encoder, PCMBuffer.get(), (uint32_t)Need) == 1);
+
             // Advance
+            Samples += SampleCount;
             Left -= Need;
         }
 
-        // Clean up
-        delete[] Buffer;
-        delete[] PCMBuffer;
+        // Check if we got everything
+        if (Truncated) { IsOk = false; }
     }
 
     // Finalize the encoding and clean up
@@ -1056,4 +1105,167 @@ std::unique_ptr<int8_t[]> Sound::BuildMSADPCMHeader(uint32_t FrameRate, uint32_t
     ResultSize = MaximumSize;
     // Return it
     return HeaderBuffer;
-}
\ No newline at end of file
+}
+
+SoundStreamWriter::SoundStreamWriter()
+{
+    // Defaults
+    Format = SoundFormat::Standard_WAV;
+    OutputHandle = nullptr;
+    Encoder = nullptr;
+    ChannelsCount = 0;
+    FrameRate = 0;
+    DataSize = 0;
+    HeaderDataSize = 0;
+    IsOk = false;
+}
+
+SoundStreamWriter::~SoundStreamWriter()
+{
+    // Clean up
+    Close();
+}
+
+bool SoundStreamWriter::Create(const std::string& FileName, SoundFormat OutFormat, uint32_t OutFrameRate, uint32_t OutChannelsCount, uint64_t FrameCount, uint32_t CompressionLevel)
+{
+    // Finish any existing file
+    Close();
+
+    // Set the format
+    Format = OutFormat;
+    FrameRate = OutFrameRate;
+    ChannelsCount = OutChannelsCount;
+    DataSize = 0;
+    HeaderDataSize = FrameCount * ChannelsCount * sizeof(int16_t);
+
+    // Check output format
+    if (Format == SoundFormat::Standard_WAV)
+    {
+        // Open it
+        fopen_s(&OutputHandle, FileName.c_str(), "wb");
+
+        // No throw check
+        if (OutputHandle == NULL)
+            return false;
+
+        // Blocks are small, so give the file a buffer that fits a few
+        setvbuf(OutputHandle, nullptr, _IOFBF, 0x40000);
+
+        // Write the header with the estimate, it's fixed on close if the estimate was off
+        std::vector<int8_t> Header(Sound::GetMaximumWAVHeaderSize());
+        Sound::WriteWAVHeaderToStream(Header.data(), FrameRate, ChannelsCount, (uint32_t)HeaderDataSize);
+        fwrite(Header.data(), 1, Header.size(), OutputHandle);
+    }
+    else if (Format == SoundFormat::Standard_FLAC)
+    {
+        // Initialize the encoder
+        auto FlacEncoder = FLAC__stream_encoder_new();
+
+        // Check for failed
+        if (FlacEncoder == nullptr)
+            return false;
+
+        // Configure the encoder
+        FLAC__stream_encoder_set_verify(FlacEncoder, false);
+        FLAC__stream_encoder_set_compression_level(FlacEncoder, std::min(CompressionLevel, 8u));
+        FLAC__stream_encoder_set_channels(FlacEncoder, ChannelsCount);
+        FLAC__stream_encoder_set_bits_per_sample(FlacEncoder, 16);
+        FLAC__stream_encoder_set_sample_rate(FlacEncoder, FrameRate);
+        FLAC__stream_encoder_set_total_samples_estimate(FlacEncoder, FrameCount);
+
+        // Setup the encoder, the real sample count is written on finish
+        if (FLAC__stream_encoder_init_file(FlacEncoder, FileName.c_str(), nullptr, nullptr) != FLAC__STREAM_ENCODER_INIT_STATUS_OK)
+        {
+            // Clean up
+            FLAC__stream_encoder_delete(FlacEncoder);
+            return false;
+        }
+
+        // Keep it
+        Encoder = FlacEncoder;
+    }
+    else
+    {
+        // Unsupported output
+        return false;
+    }
+
+    // Ready
+    IsOk = true;
+    return true;
+}
+
+bool SoundStreamWriter::Write(const int16_t* Samples, uint32_t FrameCount)
+{
+    // Make sure we're open
+    if (!IsOk)
+        return false;
+
+    // The samples in the block
+    size_t SampleCount = (size_t)FrameCount * ChannelsCount;
+
+    // Check output format
+    if (OutputHandle != nullptr)
+    {
+        // Write it as is
+        IsOk = (fwrite(Samples, sizeof(int16_t), SampleCount, OutputHandle) == SampleCount);
+    }
+    else if (Encoder != nullptr)
+    {
+        // Make room
+        if (WideSamples.size() < SampleCount)
+            WideSamples.resize(SampleCount);
+
+        // Convert the data to PCM samples
+        for (size_t i = 0; i < SampleCount; i++)
+            WideSamples[i] = (int32_t)Samples[i];
+
+        // Send off to encoder
+        IsOk = (FLAC__stream_encoder_process_interleaved((FLAC__StreamEncoder*)Encoder, (const FLAC__int32*)WideSamples.data(), FrameCount) == 1);
+    }
+
+    // Advance
+    DataSize += SampleCount * sizeof(int16_t);
+
+    // Done
+    return IsOk;
+}
+
+bool SoundStreamWriter::Close()
+{
+    // Result
+    bool Result = IsOk;
+
+    // Finish the WAV
+    if (OutputHandle != nullptr)
+    {
+        // Fix the header if the estimate was off
+        if (DataSize != HeaderDataSize)
+        {
+            std::vector<int8_t> Header(Sound::GetMaximumWAVHeaderSize());
+            Sound::WriteWAVHeaderToStream(Header.data(), FrameRate, ChannelsCount, (uint32_t)DataSize);
+
+            // Rewrite it
+            Result &= (fseek(OutputHandle, 0, SEEK_SET) == 0);
+            Result &= (fwrite(Header.data(), 1, Header.size(), OutputHandle) == Header.size());
+        }
+
+        // Clean up file
+        Result &= (fclose(OutputHandle) == 0);
+        OutputHandle = nullptr;
+    }
+
+    // Finalize the encoding and clean up
+    if (Encoder != nullptr)
+    {
+        Result &= (FLAC__stream_encoder_finish((FLAC__StreamEncoder*)Encoder) == 1);
+        FLAC__stream_encoder_delete((FLAC__StreamEncoder*)Encoder);
+        Encoder = nullptr;
+    }
+
+    // Reset
+    IsOk = false;
+
+    // Done
+    return Result;
+}
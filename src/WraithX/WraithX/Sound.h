@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 // We need the binary writer class
 #include "BinaryWriter.h"
@@ -26,8 +27,10 @@ class Sound
 public:
     // -- Conversion functions
 
-    // Converts a sound stream from memory to a file with the specified format
-    static bool ConvertSoundMemory(int8_t* SoundBuffer, uint64_t SoundSize, SoundFormat InFormat, const std::string& OutputFile, SoundFormat OutFormat);
+    // Converts a sound stream from memory to a file with the specified format, FLAC output uses the compression level, 0 is the fastest, 8 the smallest
+    static bool ConvertSoundMemory(int8_t* SoundBuffer, uint64_t SoundSize, SoundFormat InFormat, const std::string& OutputFile, SoundFormat OutFormat, uint32_t CompressionLevel = 5);
+    // Converts a sound stream from memory to a file with the specified format, the header and the data are read from separate buffers
+    static bool ConvertSoundMemory(const int8_t* HeaderBuffer, uint64_t HeaderSize, const int8_t* DataBuffer, uint64_t DataSize, SoundFormat InFormat, const std::string& OutputFile, SoundFormat OutFormat, uint32_t CompressionLevel = 5);
     // Converts a sound file to a file with the specified format
     static bool ConvertSoundFile(const std::string& InputFile, SoundFormat InFormat, const std::string& OutputFile, SoundFormat OutFormat);
 
@@ -72,10 +75,10 @@ public:
 
 private:
 
-    // Transcodes a FLAC file (With header) to a compatible WAV output file
-    static bool TranscodeFLACToWav(int8_t* SoundBuffer, uint64_t SoundSize, const std::string& OutputFile);
-    // Transcodes a WAV file (With header) to a compatible FLAC output file
-    static bool TranscodeWAVToFlac(int8_t* SoundBuffer, uint64_t SoundSize, const std::string& OutputFile);
+    // Transcodes a FLAC file (With header) to a compatible WAV output file, the header buffer is optional
+    static bool TranscodeFLACToWav(const int8_t* HeaderBuffer, uint64_t HeaderSize, const int8_t* SoundBuffer, uint64_t SoundSize, const std::string& OutputFile);
+    // Transcodes a WAV file (With header) to a compatible FLAC output file, the header buffer is optional
+    static bool TranscodeWAVToFlac(const int8_t* HeaderBuffer, uint64_t HeaderSize, const int8_t* SoundBuffer, uint64_t SoundSize, const std::string& OutputFile, uint32_t CompressionLevel);
 
     // Builds a FLAC file header
     static std::unique_ptr<int8_t[]> BuildFLACHeader(uint32_t FrameRate, uint32_t ChannelsCount, uint32_t FrameCount, uint32_t& ResultSize);
@@ -85,4 +88,42 @@ private:
     static std::unique_ptr<int8_t[]> BuildIMAHeader(uint32_t FrameRate, uint32_t ChannelsCount, uint32_t BitsPerSample, uint32_t BlockAlign, uint32_t TotalSize, uint32_t& ResultSize);
     // Builds a MSADPCM file header
     static std::unique_ptr<int8_t[]> BuildMSADPCMHeader(uint32_t FrameRate, uint32_t ChannelsCount, uint32_t TotalSize, uint32_t& ResultSize);
+};
+
+// A class that writes 16bit PCM samples to a WAV or FLAC file as they're produced, so a whole sound is never held in memory
+class SoundStreamWriter
+{
+public:
+    // Constructors
+    SoundStreamWriter();
+    ~SoundStreamWriter();
+
+    // Creates the file, the frame count is an estimate, the real count is written when the file is closed
+    bool Create(const std::string& FileName, SoundFormat Format, uint32_t FrameRate, uint32_t ChannelsCount, uint64_t FrameCount, uint32_t CompressionLevel = 5);
+    // Writes a block of interleaved samples
+    bool Write(const int16_t* Samples, uint32_t FrameCount);
+    // Finishes the file, returns false if anything failed to write
+    bool Close();
+
+private:
+    // The output format
+    SoundFormat Format;
+    // The WAV output file
+    FILE* OutputHandle;
+    // The FLAC encoder
+    void* Encoder;
+
+    // The output channel count
+    uint32_t ChannelsCount;
+    // The output frame rate
+    uint32_t FrameRate;
+    // The size of the samples written so far
+    uint64_t DataSize;
+    // The size the header was written with
+    uint64_t HeaderDataSize;
+    // Whether or not every write succeeded
+    bool IsOk;
+
+    // Widened samples for the FLAC encoder, one block
+    std::vector<int32_t> WideSamples;
 };
\ No newline at end of file
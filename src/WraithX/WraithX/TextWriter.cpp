@@ -6,10 +6,81 @@
 // We require the patterns utility functions
 #include "Patterns.h"
 
+// We need the following std classes
+#include <cmath>
+#include <cstring>
+
+// The default size of the write buffer
+constexpr size_t TextWriterDefaultBufferSize = 0x10000;
+// The largest formatted number, in characters
+constexpr size_t TextWriterMaxNumberLength = 64;
+
+// Formats an unsigned integer, returns the length written
+static size_t FormatUnsigned(uint64_t Value, char* Output)
+{
+    // Build the digits backwards
+    char Digits[24];
+    size_t Length = 0;
+
+    do
+    {
+        // Take the lowest digit
+        Digits[Length++] = (char)('0' + (Value % 10));
+        Value /= 10;
+    } while (Value != 0);
+
+    // Copy them out in order
+    for (size_t i = 0; i < Length; i++)
+        Output[i] = Digits[Length - i - 1];
+
+    // Return it
+    return Length;
+}
+
+// Formats a float the same as %f, returns the length written
+static size_t FormatFloat(float Value, char* Output)
+{
+    // A float has 24 bits of precision, so scaling it by 10^6 in a double is exact,
+    // and rounding it to an integer gives the same 6 digits as printf
+    double Scaled = std::fabs((double)Value * 1000000.0);
+
+    // Leave nan, inf, and huge values to printf
+    if (!(Scaled < 1.0e18))
+        return (size_t)snprintf(Output, TextWriterMaxNumberLength, "%f", (double)Value);
+
+    // Round to nearest, ties to even, like printf
+    auto Fixed = (uint64_t)std::nearbyint(Scaled);
+    size_t Length = 0;
+
+    // printf keeps the sign of negative zero, and of values that round to zero
+    if (std::signbit(Value))
+        Output[Length++] = '-';
+
+    // Whole part
+    Length += FormatUnsigned(Fixed / 1000000, Output + Length);
+    // Decimal point
+    Output[Length++] = '.';
+
+    // Fraction, always 6 digits
+    auto Fraction = (uint32_t)(Fixed % 1000000);
+    for (int32_t i = 5; i >= 0; i--)
+    {
+        // Take the lowest digit
+        Output[Length + i] = (char)('0' + (Fraction % 10));
+        Fraction /= 10;
+    }
+
+    // Return it
+    return Length + 6;
+}
+
 TextWriter::TextWriter()
 {
     // Init the handle
     FileHandle = nullptr;
+    // Init the buffer
+    Buffer.resize(TextWriterDefaultBufferSize);
+    BufferLength = 0;
 }
 
 TextWriter::~TextWriter()
@@ -80,11 +151,41 @@ bool TextWriter::Connect(FILE* FileHandleReference)
 
 void TextWriter::SetWriteBuffer(uint32_t Size)
 {
-    // Set a buffer size for this writer
-    if (FileHandle != nullptr)
+    // Write what we have, then resize the buffer, we need room for at least a number
+    Flush();
+    Buffer.resize(std::max<size_t>(Size, TextWriterMaxNumberLength));
+}
+
+void TextWriter::Flush()
+{
+    // Write the buffer out
+    if (FileHandle != nullptr && BufferLength > 0)
+    {
+        fwrite(Buffer.data(), 1, BufferLength, FileHandle);
+    }
+    // Reset it
+    BufferLength = 0;
+}
+
+char* TextWriter::ReserveBuffer(size_t Length)
+{
+    // Make sure we have a file
+    if (FileHandle == nullptr)
+    {
+        // Failed to perform write
+#ifdef _DEBUG
+        throw new std::exception("No file is open");
+#else
+        throw new std::exception("");
+#endif
+    }
+    // Flush if we don't have room
+    if (BufferLength + Length > Buffer.size())
     {
-        setvbuf(FileHandle, NULL, _IOFBF, (size_t)Size);
+        Flush();
     }
+    // Return where to write
+    return Buffer.data() + BufferLength;
 }
 
 bool TextWriter::IsOpen()
@@ -104,6 +205,8 @@ void TextWriter::Close()
     // Make sure we aren't closed
     if (FileHandle != nullptr)
     {
+        // Write what's left in the buffer
+        Flush();
         // We can close it
         fclose(FileHandle);
         // Set the values
@@ -116,6 +219,8 @@ uint64_t TextWriter::GetPosition()
     // Return the position
     if (FileHandle != nullptr)
     {
+        // Write the buffer so the position includes it
+        Flush();
         // Result
         return _ftelli64(FileHandle);
     }
@@ -128,6 +233,8 @@ void TextWriter::SetPosition(uint64_t Offset)
     // Set the position
     if (FileHandle != nullptr)
     {
+        // Write the buffer before moving
+        Flush();
         // Set it
         _fseeki64(FileHandle, Offset, SEEK_SET);
     }
@@ -135,109 +242,168 @@ void TextWriter::SetPosition(uint64_t Offset)
 
 void TextWriter::Write(const std::string& Value)
 {
-    // Make sure we have a file
-    if (FileHandle != nullptr)
+    // Write the string itself to the buffer
+    Write(Value.c_str(), Value.size());
+}
+
+void TextWriter::Write(const char* Value)
+{
+    // Write the string itself to the buffer
+    Write(Value, strlen(Value));
+}
+
+void TextWriter::Write(const char* Value, size_t Length)
+{
+    // Check if it fits in the buffer at all
+    if (Length > Buffer.size())
     {
-        // Write the string itself to the buffer
-        fputs(Value.c_str(), FileHandle);
+        // Write the buffer, then the value directly
+        ReserveBuffer(0);
+        Flush();
+        fwrite(Value, 1, Length, FileHandle);
     }
     else
     {
-        // Failed to perform write
-#ifdef _DEBUG
-        throw new std::exception("No file is open");
-#else
-        throw new std::exception("");
-#endif
+        // Copy it to the buffer
+        std::memcpy(ReserveBuffer(Length), Value, Length);
+        BufferLength += Length;
     }
 }
 
 void TextWriter::WriteFmt(const char* Format, ...)
 {
-    // Make sure we have a file
-    if (FileHandle != nullptr)
-    {
-        // Parse
-        va_list VarArgs;
-        // Start
-        va_start(VarArgs, Format);
-        // Write it
-        vfprintf_s(FileHandle, Format, VarArgs);
-        // End
-        va_end(VarArgs);
-    }
-    else
-    {
-        // Failed to perform write
-#ifdef _DEBUG
-        throw new std::exception("No file is open");
-#else
-        throw new std::exception("");
-#endif
-    }
+    // Parse
+    va_list VarArgs;
+    // Start
+    va_start(VarArgs, Format);
+    // Write it
+    WriteFormatted(Format, VarArgs);
+    // End
+    va_end(VarArgs);
 }
 
 void TextWriter::WriteLine(const std::string& Value)
 {
-    // Make sure we have a file
-    if (FileHandle != nullptr)
-    {
-        // Write the string itself to the buffer + new line
-        fputs((Value + "\n").c_str(), FileHandle);
-    }
-    else
-    {
-        // Failed to perform write
-#ifdef _DEBUG
-        throw new std::exception("No file is open");
-#else
-        throw new std::exception("");
-#endif
-    }
+    // Write the string itself to the buffer + new line
+    Write(Value.c_str(), Value.size());
+    NewLine();
 }
 
 void TextWriter::WriteLineFmt(const char* Format, ...)
+{
+    // Parse
+    va_list VarArgs;
+    // Start
+    va_start(VarArgs, Format);
+    // Write it
+    WriteFormatted(Format, VarArgs);
+    // End
+    va_end(VarArgs);
+    // Write a new line as well
+    NewLine();
+}
+
+void TextWriter::NewLine()
+{
+    // Write the new line char
+    *ReserveBuffer(1) = '\n';
+    BufferLength++;
+}
+
+void TextWriter::WriteFormatted(const char* Format, va_list VarArgs)
 {
     // Make sure we have a file
-    if (FileHandle != nullptr)
+    ReserveBuffer(0);
+
+    // Keep a copy of the arguments in case we have to format again
+    va_list RetryArgs;
+    va_copy(RetryArgs, VarArgs);
+
+    // Try to format it in place
+    auto Available = Buffer.size() - BufferLength;
+    auto Length = vsnprintf(Buffer.data() + BufferLength, Available, Format, VarArgs);
+
+    // Check if it fit
+    if (Length >= 0 && (size_t)Length < Available)
     {
-        // Parse
-        va_list VarArgs;
-        // Start
-        va_start(VarArgs, Format);
-        // Write it
-        vfprintf_s(FileHandle, Format, VarArgs);
-        // End
-        va_end(VarArgs);
-        // Write a new line as well
-        fprintf(FileHandle, "\n");
+        // It did
+        BufferLength += Length;
     }
-    else
+    else if (Length >= 0)
     {
-        // Failed to perform write
-#ifdef _DEBUG
-        throw new std::exception("No file is open");
-#else
-        throw new std::exception("");
-#endif
+        // Write the buffer, then format again at the start, or straight to the file if it's too big
+        Flush();
+
+        if ((size_t)Length < Buffer.size())
+        {
+            // Format into the buffer
+            vsnprintf(Buffer.data(), Buffer.size(), Format, RetryArgs);
+            BufferLength = Length;
+        }
+        else
+        {
+            // Format to the file
+            vfprintf_s(FileHandle, Format, RetryArgs);
+        }
     }
+
+    // End
+    va_end(RetryArgs);
 }
 
-void TextWriter::NewLine()
+void TextWriter::WriteInteger(int64_t Value)
 {
-    // Make sure we have a file
-    if (FileHandle != nullptr)
+    // Make room for it
+    auto Output = ReserveBuffer(TextWriterMaxNumberLength);
+    size_t Length = 0;
+
+    // Write the sign
+    if (Value < 0)
+        Output[Length++] = '-';
+
+    // Write the digits, negating as unsigned so the smallest value doesn't overflow
+    Length += FormatUnsigned((Value < 0) ? (0 - (uint64_t)Value) : (uint64_t)Value, Output + Length);
+
+    // Advance
+    BufferLength += Length;
+}
+
+void TextWriter::WriteIntegers(const uint32_t* Values, size_t Count, const char* Separator)
+{
+    // Cache the separator size
+    auto SeparatorLength = strlen(Separator);
+
+    // Loop and write
+    for (size_t i = 0; i < Count; i++)
     {
-        // Write the new line char
-        fprintf(FileHandle, "\n");
+        // Separate them
+        if (i > 0)
+            Write(Separator, SeparatorLength);
+
+        // Write it
+        WriteInteger(Values[i]);
     }
-    else
+}
+
+void TextWriter::WriteFloat(float Value)
+{
+    // Make room for it, then format it in place
+    BufferLength += FormatFloat(Value, ReserveBuffer(TextWriterMaxNumberLength));
+}
+
+void TextWriter::WriteFloats(const float* Values, size_t Count, const char* Separator)
+{
+    // Cache the separator size
+    auto SeparatorLength = strlen(Separator);
+
+    // Loop and write
+    for (size_t i = 0; i < Count; i++)
     {
-        // Failed to perform write
-#ifdef _DEBUG
-        throw new std::exception("No file is open");
-#else
-        throw new std::exception("");
-#endif
+        // Separate them
+        if (i > 0)
+            Write(Separator, SeparatorLength);
+
+        // Write it
+        WriteFloat(Values[i]);
     }
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstdint>
+#include <cstdarg>
 #include <string>
+#include <vector>
 #include <cstdio>
 
 // A class that handles writing a text file
@@ -11,6 +13,16 @@ private:
     // A handle to the file
     FILE* FileHandle;
 
+    // The write buffer, written to the file when full, and on close
+    std::vector<char> Buffer;
+    // The amount of the write buffer in use
+    size_t BufferLength;
+
+    // Makes room for a write of the given length, returns where to write, flushes if need be
+    char* ReserveBuffer(size_t Length);
+    // Writes a formatted string to the buffer
+    void WriteFormatted(const char* Format, va_list VarArgs);
+
 public:
     TextWriter();
     ~TextWriter();
@@ -24,6 +36,8 @@ public:
 
     // Set write buffer
     void SetWriteBuffer(uint32_t Size);
+    // Writes the buffer to the file
+    void Flush();
 
     // Whether or not the file is still open
     bool IsOpen();
@@ -39,6 +53,10 @@ public:
 
     // Write a string to the file
     void Write(const std::string& Value);
+    // Write a null terminated string to the file
+    void Write(const char* Value);
+    // Write characters to the file
+    void Write(const char* Value, size_t Length);
     // Write a formatted string to the file
     void WriteFmt(const char* Format, ...);
     // Write a string to the file and end the line
@@ -48,4 +66,13 @@ public:
 
     // Starts a new line in the file
     void NewLine();
+
+    // Write an integer, formatted the same as %d without the format parsing
+    void WriteInteger(int64_t Value);
+    // Write a list of integers, formatted the same as %d, with the separator between each
+    void WriteIntegers(const uint32_t* Values, size_t Count, const char* Separator = " ");
+    // Write a float, formatted the same as %f without the format parsing or locale
+    void WriteFloat(float Value);
+    // Write a list of floats, formatted the same as %f, with the separator between each
+    void WriteFloats(const float* Values, size_t Count, const char* Separator = " ");
 };
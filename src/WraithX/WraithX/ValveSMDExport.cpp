@@ -12,13 +12,28 @@ void ExportVertexInfo(TextWriter& Writer, const WraithVertex& Vertex)
     // Output the base info
     Vector3 NormNormal = Vertex.Normal.GetNormalized();
 
+    // The position, normal, and flipped uv
+    const float Values[8] =
+    {
+        Vertex.Position.X, Vertex.Position.Y, Vertex.Position.Z,
+        NormNormal.X, NormNormal.Y, NormNormal.Z,
+        Vertex.UVLayers[0].U, (1 - Vertex.UVLayers[0].V)
+    };
+
     // Export the SMD settings
-    Writer.WriteFmt("0 %f %f %f %f %f %f %f %f %d ", Vertex.Position.X, Vertex.Position.Y, Vertex.Position.Z, NormNormal.X, NormNormal.Y, NormNormal.Z, Vertex.UVLayers[0].U, (1 - Vertex.UVLayers[0].V), (uint32_t)Vertex.Weights.size());
+    Writer.Write("0 ", 2);
+    Writer.WriteFloats(Values, 8);
+    Writer.Write(" ", 1);
+    Writer.WriteInteger((uint32_t)Vertex.Weights.size());
+    Writer.Write(" ", 1);
     // Iterate and output
     for (auto& Weight : Vertex.Weights)
     {
         // Output
-        Writer.WriteFmt("%d %f ", Weight.BoneIndex, Weight.Weight);
+        Writer.WriteInteger(Weight.BoneIndex);
+        Writer.Write(" ", 1);
+        Writer.WriteFloat(Weight.Weight);
+        Writer.Write(" ", 1);
     }
     // End the line
     Writer.NewLine();
@@ -11,6 +11,7 @@ WraithAnim::WraithAnim()
     Looping = false;
     DeltaTagName = "";
     FrameRate = 30.0f;
+    LargestKeyFrame = 0;
 }
 
 WraithAnim::~WraithAnim()
@@ -20,37 +21,10 @@ WraithAnim::~WraithAnim()
 
 const uint32_t WraithAnim::FrameCount() const
 {
-    // Result buffer
-    uint32_t Result = 0;
+    // Start with the largest bone key, it's kept up to date as keys are added
+    uint32_t Result = LargestKeyFrame;
 
-    // We must iterate through all key types and compare the max keyed frame
-    for (auto& Frames : AnimationPositionKeys)
-    {
-        // Iterate
-        for (auto& Frame : Frames.second)
-        {
-            // Compare
-            Result = std::max(Result, Frame.Frame);
-        }
-    }
-    for (auto& Frames : AnimationRotationKeys)
-    {
-        // Iterate
-        for (auto& Frame : Frames.second)
-        {
-            // Compare
-            Result = std::max(Result, Frame.Frame);
-        }
-    }
-    for (auto& Frames : AnimationScaleKeys)
-    {
-        // Iterate
-        for (auto& Frame : Frames.second)
-        {
-            // Compare
-            Result = std::max(Result, Frame.Frame);
-        }
-    }
+    // Notetracks are few, so compare them here
     for (auto& Frames : AnimationNotetracks)
     {
         // Iterate
@@ -69,8 +43,8 @@ const uint32_t WraithAnim::FrameCount() const
 
 const uint32_t WraithAnim::BoneCount() const
 {
-    // Return the size of the bones result
-    return (uint32_t)Bones().size();
+    // Every bone with keys or a modifier is in the bone table
+    return (uint32_t)AnimationBones.size();
 }
 
 const std::unordered_set<std::string> WraithAnim::Bones() const
@@ -78,30 +52,136 @@ const std::unordered_set<std::string> WraithAnim::Bones() const
     // A hashset of unique names
     std::unordered_set<std::string> UniqueBoneNames;
 
-    // We must append the bone names from all bone type keys (and bone modifiers)
-    for (auto& Frames : AnimationPositionKeys)
+    // Copy the names from the bone table
+    for (auto& Bone : AnimationBones)
     {
         // Iterate
-        UniqueBoneNames.insert(Frames.first);
+        UniqueBoneNames.insert(Bone.Name);
     }
-    for (auto& Frames : AnimationRotationKeys)
+
+    // Return it
+    return UniqueBoneNames;
+}
+
+uint32_t WraithAnim::AddBone(const std::string& Bone)
+{
+    // Check if we already have it
+    auto Existing = AnimationBoneIndices.find(Bone);
+
+    // Return the existing index
+    if (Existing != AnimationBoneIndices.end())
+        return Existing->second;
+
+    // Add it to the end of the table
+    auto Index = (uint32_t)AnimationBones.size();
+
+    // Make it
+    WraithAnimBone NewBone;
+    // Set the name
+    NewBone.Name = Bone;
+
+    // Add it
+    AnimationBones.emplace_back(std::move(NewBone));
+    AnimationBoneIndices.emplace(Bone, Index);
+
+    // Return it
+    return Index;
+}
+
+bool WraithAnim::TryGetBoneIndex(const std::string& Bone, uint32_t& Index) const
+{
+    // Find it
+    auto Existing = AnimationBoneIndices.find(Bone);
+
+    // Check if we had it
+    if (Existing == AnimationBoneIndices.end())
+        return false;
+
+    // Set it
+    Index = Existing->second;
+
+    // Done
+    return true;
+}
+
+const WraithAnimBone* WraithAnim::FindBone(const std::string& Bone) const
+{
+    // Index buffer
+    uint32_t Index = 0;
+
+    // Find it
+    if (!TryGetBoneIndex(Bone, Index))
+        return nullptr;
+
+    // Return it
+    return &AnimationBones[Index];
+}
+
+void WraithAnim::ReserveBones(uint32_t Count)
+{
+    // Reserve both the table and the lookup
+    AnimationBones.reserve(Count);
+    AnimationBoneIndices.reserve(Count);
+}
+
+void WraithAnim::ReserveTranslationKeys(uint32_t BoneIndex, uint32_t Count)
+{
+    // Reserve it
+    AnimationBones[BoneIndex].Translations.Reserve(Count);
+}
+
+void WraithAnim::ReserveRotationKeys(uint32_t BoneIndex, uint32_t Count)
+{
+    // Reserve it
+    AnimationBones[BoneIndex].Rotations.Reserve(Count);
+}
+
+void WraithAnim::ReserveScaleKeys(uint32_t BoneIndex, uint32_t Count)
+{
+    // Reserve it
+    AnimationBones[BoneIndex].Scales.Reserve(Count);
+}
+
+bool WraithAnim::HasTranslationKeys() const
+{
+    // Check each bone
+    for (auto& Bone : AnimationBones)
     {
-        // Iterate
-        UniqueBoneNames.insert(Frames.first);
+        // Check
+        if (!Bone.Translations.Empty())
+            return true;
     }
-    for (auto& Frames : AnimationScaleKeys)
+
+    // None
+    return false;
+}
+
+bool WraithAnim::HasRotationKeys() const
+{
+    // Check each bone
+    for (auto& Bone : AnimationBones)
     {
-        // Iterate
-        UniqueBoneNames.insert(Frames.first);
+        // Check
+        if (!Bone.Rotations.Empty())
+            return true;
     }
-    for (auto& Modifiers : AnimationBoneModifiers)
+
+    // None
+    return false;
+}
+
+bool WraithAnim::HasScaleKeys() const
+{
+    // Check each bone
+    for (auto& Bone : AnimationBones)
     {
-        // Iterate
-        UniqueBoneNames.insert(Modifiers.first);
+        // Check
+        if (!Bone.Scales.Empty())
+            return true;
     }
 
-    // Return it
-    return UniqueBoneNames;
+    // None
+    return false;
 }
 
 const uint32_t WraithAnim::NotificationCount() const
@@ -120,37 +200,46 @@ const uint32_t WraithAnim::NotificationCount() const
     return Result;
 }
 
-void WraithAnim::AddTranslationKey(const std::string Bone, uint32_t Frame, float X, float Y, float Z)
+void WraithAnim::AddTranslationKey(const std::string& Bone, uint32_t Frame, float X, float Y, float Z)
+{
+    // Resolve the bone and add the key itself
+    AddTranslationKey(AddBone(Bone), Frame, X, Y, Z);
+}
+
+void WraithAnim::AddRotationKey(const std::string& Bone, uint32_t Frame, float X, float Y, float Z, float W)
+{
+    // Resolve the bone and add the key itself
+    AddRotationKey(AddBone(Bone), Frame, X, Y, Z, W);
+}
+
+void WraithAnim::AddScaleKey(const std::string& Bone, uint32_t Frame, float X, float Y, float Z)
+{
+    // Resolve the bone and add the key itself
+    AddScaleKey(AddBone(Bone), Frame, X, Y, Z);
+}
+
+void WraithAnim::AddTranslationKey(uint32_t BoneIndex, uint32_t Frame, float X, float Y, float Z)
 {
-    // Make it
-    WraithAnimFrame<Vector3> NewFrame;
-    // Set values
-    NewFrame.Frame = Frame;
-    NewFrame.Value = Vector3(X, Y, Z);
     // Add the key itself
-    AnimationPositionKeys[Bone].push_back(NewFrame);
+    AnimationBones[BoneIndex].Translations.Add(Frame, Vector3(X, Y, Z));
+    // Update the frame count
+    LargestKeyFrame = std::max(LargestKeyFrame, Frame);
 }
 
-void WraithAnim::AddRotationKey(const std::string Bone, uint32_t Frame, float X, float Y, float Z, float W)
+void WraithAnim::AddRotationKey(uint32_t BoneIndex, uint32_t Frame, float X, float Y, float Z, float W)
 {
-    // Make it
-    WraithAnimFrame<Quaternion> NewFrame;
-    // Set values
-    NewFrame.Frame = Frame;
-    NewFrame.Value = Quaternion(X, Y, Z, W);
     // Add the key itself
-    AnimationRotationKeys[Bone].push_back(NewFrame);
+    AnimationBones[BoneIndex].Rotations.Add(Frame, Quaternion(X, Y, Z, W));
+    // Update the frame count
+    LargestKeyFrame = std::max(LargestKeyFrame, Frame);
 }
 
-void WraithAnim::AddScaleKey(const std::string Bone, uint32_t Frame, float X, float Y, float Z)
+void WraithAnim::AddScaleKey(uint32_t BoneIndex, uint32_t Frame, float X, float Y, float Z)
 {
-    // Make it
-    WraithAnimFrame<Vector3> NewFrame;
-    // Set values
-    NewFrame.Frame = Frame;
-    NewFrame.Value = Vector3(X, Y, Z);
     // Add the key itself
-    AnimationScaleKeys[Bone].push_back(NewFrame);
+    AnimationBones[BoneIndex].Scales.Add(Frame, Vector3(X, Y, Z));
+    // Update the frame count
+    LargestKeyFrame = std::max(LargestKeyFrame, Frame);
 }
 
 void WraithAnim::AddBlendShapeKey(const std::string Shape, uint32_t Frame, float X, float Y, float Z)
@@ -172,6 +261,8 @@ void WraithAnim::AddNoteTrack(const std::string Notification, uint32_t Frame)
 
 void WraithAnim::AddBoneModifier(const std::string Bone, WraithAnimationType Modifier)
 {
+    // Modified bones are written even without keys, so add it to the table
+    AddBone(Bone);
     // Add the modifier
     AnimationBoneModifiers[Bone] = Modifier;
 }
@@ -179,60 +270,36 @@ void WraithAnim::AddBoneModifier(const std::string Bone, WraithAnimationType Mod
 void WraithAnim::RemoveTranslationKey(const std::string& Bone, uint32_t Frame)
 {
     // Make sure the bone exists
-    if (AnimationPositionKeys.find(Bone) != AnimationPositionKeys.end())
+    uint32_t Index = 0;
+    if (TryGetBoneIndex(Bone, Index))
     {
-        // It exists, loop and check for the key
-        for (size_t i = 0; i < AnimationPositionKeys[Bone].size(); i++)
-        {
-            // Check
-            if (AnimationPositionKeys[Bone][i].Frame == Frame)
-            {
-                // Remove it
-                AnimationPositionKeys[Bone].erase(AnimationPositionKeys[Bone].begin() + i);
-                // End
-                break;
-            }
-        }
+        // It exists, remove the key and update the frame count if it was removed
+        if (AnimationBones[Index].Translations.Remove(Frame))
+            UpdateLargestKeyFrame();
     }
 }
 
 void WraithAnim::RemoveRotationKey(const std::string& Bone, uint32_t Frame)
 {
     // Make sure the bone exists
-    if (AnimationRotationKeys.find(Bone) != AnimationRotationKeys.end())
+    uint32_t Index = 0;
+    if (TryGetBoneIndex(Bone, Index))
     {
-        // It exists, loop and check for the key
-        for (size_t i = 0; i < AnimationRotationKeys[Bone].size(); i++)
-        {
-            // Check
-            if (AnimationRotationKeys[Bone][i].Frame == Frame)
-            {
-                // Remove it
-                AnimationRotationKeys[Bone].erase(AnimationRotationKeys[Bone].begin() + i);
-                // End
-                break;
-            }
-        }
+        // It exists, remove the key and update the frame count if it was removed
+        if (AnimationBones[Index].Rotations.Remove(Frame))
+            UpdateLargestKeyFrame();
     }
 }
 
 void WraithAnim::RemoveScaleKey(const std::string& Bone, uint32_t Frame)
 {
     // Make sure the bone exists
-    if (AnimationScaleKeys.find(Bone) != AnimationScaleKeys.end())
+    uint32_t Index = 0;
+    if (TryGetBoneIndex(Bone, Index))
     {
-        // It exists, loop and check for the key
-        for (size_t i = 0; i < AnimationScaleKeys[Bone].size(); i++)
-        {
-            // Check
-            if (AnimationScaleKeys[Bone][i].Frame == Frame)
-            {
-                // Remove it
-                AnimationScaleKeys[Bone].erase(AnimationScaleKeys[Bone].begin() + i);
-                // End
-                break;
-            }
-        }
+        // It exists, remove the key and update the frame count if it was removed
+        if (AnimationBones[Index].Scales.Remove(Frame))
+            UpdateLargestKeyFrame();
     }
 }
 
@@ -259,13 +326,28 @@ void WraithAnim::RemoveNotetrack(const std::string& Bone, uint32_t Frame)
 void WraithAnim::ScaleAnimation(float ScaleFactor)
 {
     // We must iterate over all of the frames
-    for (auto& Frames : AnimationPositionKeys)
+    for (auto& Bone : AnimationBones)
     {
         // Iterate
-        for (auto& Frame : Frames.second)
+        for (auto& Value : Bone.Translations.Values)
         {
             // Scale them
-            Frame.Value *= ScaleFactor;
+            Value *= ScaleFactor;
         }
     }
+}
+
+void WraithAnim::UpdateLargestKeyFrame()
+{
+    // Reset it
+    LargestKeyFrame = 0;
+
+    // Compare every curve
+    for (auto& Bone : AnimationBones)
+    {
+        // Compare
+        LargestKeyFrame = std::max(LargestKeyFrame, Bone.Translations.LargestFrame());
+        LargestKeyFrame = std::max(LargestKeyFrame, Bone.Rotations.LargestFrame());
+        LargestKeyFrame = std::max(LargestKeyFrame, Bone.Scales.LargestFrame());
+    }
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -34,6 +36,94 @@ struct WraithAnimFrame
     T Value;
 };
 
+template<class T>
+// A curve of animation keys, the frames and values are kept in separate arrays
+struct WraithAnimCurve
+{
+    // The frame of each key
+    std::vector<uint32_t> Frames;
+    // The value of each key
+    std::vector<T> Values;
+
+    // Gets the count of keys
+    size_t Size() const { return Frames.size(); }
+    // Whether or not the curve has no keys
+    bool Empty() const { return Frames.empty(); }
+    // Reserves room for a count of keys
+    void Reserve(size_t Count) { Frames.reserve(Count); Values.reserve(Count); }
+
+    // Adds a key to the end of the curve
+    void Add(uint32_t Frame, const T& Value) { Frames.push_back(Frame); Values.push_back(Value); }
+    // Removes the first key on the given frame, returns false if there isn't one
+    bool Remove(uint32_t Frame)
+    {
+        // Loop and check for the key
+        for (size_t i = 0; i < Frames.size(); i++)
+        {
+            // Check
+            if (Frames[i] == Frame)
+            {
+                // Remove it
+                Frames.erase(Frames.begin() + i);
+                Values.erase(Values.begin() + i);
+                // Done
+                return true;
+            }
+        }
+
+        // Not found
+        return false;
+    }
+
+    // Gets the largest keyed frame, 0 if there are no keys
+    uint32_t LargestFrame() const
+    {
+        // Result buffer
+        uint32_t Result = 0;
+        // Compare
+        for (auto Frame : Frames)
+            Result = std::max(Result, Frame);
+        // Return it
+        return Result;
+    }
+
+    // Gets a key as a frame and value pair
+    WraithAnimFrame<T> operator[](size_t Index) const { return { Frames[Index], Values[Index] }; }
+
+    // Iterates the keys as frame and value pairs, for code that used the old per-bone key lists
+    class Iterator
+    {
+    public:
+        Iterator(const WraithAnimCurve<T>* Curve, size_t Index) : Curve(Curve), Index(Index) {}
+
+        WraithAnimFrame<T> operator*() const { return (*Curve)[Index]; }
+        Iterator& operator++() { Index++; return *this; }
+        bool operator!=(const Iterator& Rhs) const { return Index != Rhs.Index; }
+
+    private:
+        const WraithAnimCurve<T>* Curve;
+        size_t Index;
+    };
+
+    // Gets an iterator to the first key
+    Iterator begin() const { return Iterator(this, 0); }
+    // Gets an iterator past the last key
+    Iterator end() const { return Iterator(this, Frames.size()); }
+};
+
+// The keys of a single bone in a WraithAnim
+struct WraithAnimBone
+{
+    // The name of the bone
+    std::string Name;
+    // The translation keys of this bone
+    WraithAnimCurve<Vector3> Translations;
+    // The rotation keys of this bone
+    WraithAnimCurve<Quaternion> Rotations;
+    // The scale keys of this bone
+    WraithAnimCurve<Vector3> Scales;
+};
+
 // A class that represents an animation
 class WraithAnim : public WraithAsset
 {
@@ -44,26 +134,47 @@ public:
 
     // -- Animation key data
 
-    // A list of animation keys, by bone, for positions
-    std::unordered_map<std::string, std::vector<WraithAnimFrame<Vector3>>> AnimationPositionKeys;
-    // A list of animation keys, by bone, for rotations
-    std::unordered_map<std::string, std::vector<WraithAnimFrame<Quaternion>>> AnimationRotationKeys;
-    // A list of animation keys, by bone, for scales
-    std::unordered_map<std::string, std::vector<WraithAnimFrame<Vector3>>> AnimationScaleKeys;
     // A list of animation blendshape weight keys per axis
     std::unordered_map<std::string, std::vector<WraithAnimFrame<Vector3>>> AnimationBlendShapeWeightKeys;
     // A list of animation keys, for notetracks
     std::unordered_map<std::string, std::vector<uint32_t>> AnimationNotetracks;
-    // A list of animation modifiers, by bone
+    // A list of animation modifiers, by bone, use AddBoneModifier so the bone is added to the bone table
     std::unordered_map<std::string, WraithAnimationType> AnimationBoneModifiers;
 
+    // -- Bone table functions
+
+    // Adds a bone to the bone table, returns the index of the bone, or the existing index if it was already added
+    uint32_t AddBone(const std::string& Bone);
+    // Gets the index of a bone, returns false if the bone wasn't added
+    bool TryGetBoneIndex(const std::string& Bone, uint32_t& Index) const;
+    // Finds the keys of a bone, returns nullptr if the bone wasn't added
+    const WraithAnimBone* FindBone(const std::string& Bone) const;
+    // Gets the bone table, in the order the bones were added
+    const std::vector<WraithAnimBone>& GetBones() const { return AnimationBones; }
+
+    // Reserves room for a count of bones
+    void ReserveBones(uint32_t Count);
+    // Reserves room for a count of translation keys on a bone
+    void ReserveTranslationKeys(uint32_t BoneIndex, uint32_t Count);
+    // Reserves room for a count of rotation keys on a bone
+    void ReserveRotationKeys(uint32_t BoneIndex, uint32_t Count);
+    // Reserves room for a count of scale keys on a bone
+    void ReserveScaleKeys(uint32_t BoneIndex, uint32_t Count);
+
+    // Whether or not any bone has translation keys
+    bool HasTranslationKeys() const;
+    // Whether or not any bone has rotation keys
+    bool HasRotationKeys() const;
+    // Whether or not any bone has scale keys
+    bool HasScaleKeys() const;
+
     // -- Animation properties
 
     // The count of frames in the animation, this is automatically updated
     const uint32_t FrameCount() const;
     // The count of bones in the animation, this is automatically updated
     const uint32_t BoneCount() const;
-    // A list of bones currently being used in this animation, this is automatically updated
+    // A list of bones currently being used in this animation, this is automatically updated, GetBones avoids the copy
     const std::unordered_set<std::string> Bones() const;
     // The count of notifications in the animation, this is automatically updated
     const uint32_t NotificationCount() const;
@@ -80,11 +191,18 @@ public:
     // -- Adding keys functions
 
     // Add a translation key for the specified bone, on the given frame, with a Vector3
-    void AddTranslationKey(const std::string Bone, uint32_t Frame, float X, float Y, float Z);
+    void AddTranslationKey(const std::string& Bone, uint32_t Frame, float X, float Y, float Z);
     // Add a rotation key for the specified bone, on the given frame, with a Quaternion
-    void AddRotationKey(const std::string Bone, uint32_t Frame, float X, float Y, float Z, float W);
+    void AddRotationKey(const std::string& Bone, uint32_t Frame, float X, float Y, float Z, float W);
     // Add a scale key for the specified bone, on the given frame, with a Vector3
-    void AddScaleKey(const std::string Bone, uint32_t Frame, float X, float Y, float Z);
+    void AddScaleKey(const std::string& Bone, uint32_t Frame, float X, float Y, float Z);
+
+    // Add a translation key for the bone at the specified index, from AddBone
+    void AddTranslationKey(uint32_t BoneIndex, uint32_t Frame, float X, float Y, float Z);
+    // Add a rotation key for the bone at the specified index, from AddBone
+    void AddRotationKey(uint32_t BoneIndex, uint32_t Frame, float X, float Y, float Z, float W);
+    // Add a scale key for the bone at the specified index, from AddBone
+    void AddScaleKey(uint32_t BoneIndex, uint32_t Frame, float X, float Y, float Z);
     // Add a blendshape key for the specified shape, on the given frame, with a Vector3 for weight
     void AddBlendShapeKey(const std::string Shape, uint32_t Frame, float X, float Y, float Z);
 
@@ -109,4 +227,15 @@ public:
 
     // Scales every translation keyframe with the given factor
     void ScaleAnimation(float ScaleFactor);
+
+private:
+    // The bone table, in the order the bones were added
+    std::vector<WraithAnimBone> AnimationBones;
+    // The index of each bone in the bone table
+    std::unordered_map<std::string, uint32_t> AnimationBoneIndices;
+    // The largest frame of all bone keys, updated as keys are added
+    uint32_t LargestKeyFrame;
+
+    // Recalculates the largest frame of all bone keys, after keys are removed
+    void UpdateLargestKeyFrame();
 };
\ No newline at end of file
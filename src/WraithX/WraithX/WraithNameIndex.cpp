@@ -9,6 +9,453 @@
 #include "MemoryReader.h"
 #include "Compression.h"
 #include "FileSystems.h"
+#include "Strings.h"
+
+// The header of a compact index, followed by the sorted hashes, the string offsets, then the strings
+struct WraithNameTableHeader
+{
+    // The magic, 'WNC '
+    uint32_t Magic;
+    // The version
+    uint32_t Version;
+    // The number of names
+    uint32_t EntryCount;
+    // The size of the string arena
+    uint32_t StringsSize;
+    // The size of the .wni this was built from
+    uint64_t SourceSize;
+    // The last write time of the .wni this was built from
+    uint64_t SourceModifiedTime;
+};
+
+// The compact index magic
+constexpr uint32_t WraithNameTableMagic = 0x20434E57;
+// The compact index version
+constexpr uint32_t WraithNameTableVersion = 1;
+
+// Verify
+static_assert(sizeof(WraithNameTableHeader) == 32, "Invalid Name Table Header Size (Expected 32)");
+
+class WraithNameTable
+{
+public:
+    // Constructors
+    WraithNameTable();
+    ~WraithNameTable();
+
+    // Maps a compact index, returns false if it's missing or invalid
+    bool Open(const std::string& FilePath);
+    // Uses a compact index that's already in memory, used when it can't be written next to the source
+    bool Attach(std::unique_ptr<uint8_t[]> Data, uint64_t DataSize);
+
+    // Checks if this table was built from the given source
+    bool IsCurrent(uint64_t SourceSize, uint64_t SourceModifiedTime) const;
+    // Finds a name in place, returns nullptr if it doesn't exist
+    const char* Find(uint64_t Hash, size_t& Length) const;
+
+    // Gets the number of names
+    uint32_t GetEntryCount() const { return EntryCount; }
+    // Gets a name by its position in the table
+    const char* GetEntry(uint32_t Index, uint64_t& Hash, size_t& Length) const;
+
+private:
+    // The open file
+    HANDLE FileHandle;
+    // The file mapping
+    HANDLE MappingHandle;
+    // The mapped view
+    const uint8_t* View;
+    // The buffer, when not mapped
+    std::unique_ptr<uint8_t[]> Buffer;
+
+    // The header
+    const WraithNameTableHeader* Header;
+    // The sorted hashes
+    const uint64_t* Hashes;
+    // The string offsets, one more than the entry count
+    const uint32_t* Offsets;
+    // The string arena
+    const char* Strings;
+    // The number of names
+    uint32_t EntryCount;
+
+    // Validates and sets up the sections
+    bool Setup(const uint8_t* Data, uint64_t DataSize);
+    // Unmaps the file
+    void Close();
+};
+
+WraithNameTable::WraithNameTable()
+{
+    // Defaults
+    FileHandle = INVALID_HANDLE_VALUE;
+    MappingHandle = NULL;
+    View = nullptr;
+    Header = nullptr;
+    Hashes = nullptr;
+    Offsets = nullptr;
+    Strings = nullptr;
+    EntryCount = 0;
+}
+
+WraithNameTable::~WraithNameTable()
+{
+    // Clean up
+    Close();
+}
+
+bool WraithNameTable::Setup(const uint8_t* Data, uint64_t DataSize)
+{
+    // Validate the header
+    if (DataSize < sizeof(WraithNameTableHeader))
+        return false;
+
+    auto Result = (const WraithNameTableHeader*)Data;
+
+    if (Result->Magic != WraithNameTableMagic || Result->Version != WraithNameTableVersion)
+        return false;
+
+    // Validate that every section is within the data
+    uint64_t HashesSize = (uint64_t)Result->EntryCount * sizeof(uint64_t);
+    uint64_t OffsetsSize = ((uint64_t)Result->EntryCount + 1) * sizeof(uint32_t);
+
+    if (sizeof(WraithNameTableHeader) + HashesSize + OffsetsSize + Result->StringsSize != DataSize)
+        return false;
+
+    // Set up the sections, nothing is parsed, everything is used in place
+    Header = Result;
+    Hashes = (const uint64_t*)(Data + sizeof(WraithNameTableHeader));
+    Offsets = (const uint32_t*)(Data + sizeof(WraithNameTableHeader) + HashesSize);
+    Strings = (const char*)(Data + sizeof(WraithNameTableHeader) + HashesSize + OffsetsSize);
+    EntryCount = Result->EntryCount;
+
+    // Success
+    return true;
+}
+
+bool WraithNameTable::Open(const std::string& FilePath)
+{
+    // Close any existing table
+    Close();
+
+    // Open the file
+    FileHandle = CreateFileA(FilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    // Get the size
+    LARGE_INTEGER FileSize{};
+
+    if (!GetFileSizeEx(FileHandle, &FileSize) || (uint64_t)FileSize.QuadPart < sizeof(WraithNameTableHeader))
+    {
+        Close();
+        return false;
+    }
+
+    // Map it
+    MappingHandle = CreateFileMappingA(FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (MappingHandle == NULL)
+    {
+        Close();
+        return false;
+    }
+
+    View = (const uint8_t*)MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+    if (View == nullptr || !Setup(View, (uint64_t)FileSize.QuadPart))
+    {
+        Close();
+        return false;
+    }
+
+    // Success
+    return true;
+}
+
+bool WraithNameTable::Attach(std::unique_ptr<uint8_t[]> Data, uint64_t DataSize)
+{
+    // Close any existing table
+    Close();
+
+    // Take the buffer
+    Buffer = std::move(Data);
+
+    if (Buffer == nullptr || !Setup(Buffer.get(), DataSize))
+    {
+        Close();
+        return false;
+    }
+
+    // Success
+    return true;
+}
+
+void WraithNameTable::Close()
+{
+    // Clean up in reverse
+    if (View != nullptr)
+        UnmapViewOfFile(View);
+    if (MappingHandle != NULL)
+        ::CloseHandle(MappingHandle);
+    if (FileHandle != INVALID_HANDLE_VALUE)
+        ::CloseHandle(FileHandle);
+
+    FileHandle = INVALID_HANDLE_VALUE;
+    MappingHandle = NULL;
+    View = nullptr;
+    Buffer.reset();
+    Header = nullptr;
+    Hashes = nullptr;
+    Offsets = nullptr;
+    Strings = nullptr;
+    EntryCount = 0;
+}
+
+bool WraithNameTable::IsCurrent(uint64_t SourceSize, uint64_t SourceModifiedTime) const
+{
+    // Compare the fingerprint
+    return Header != nullptr && Header->SourceSize == SourceSize && Header->SourceModifiedTime == SourceModifiedTime;
+}
+
+const char* WraithNameTable::GetEntry(uint32_t Index, uint64_t& Hash, size_t& Length) const
+{
+    // Bounds check, offsets are checked here rather than all up front, so opening stays constant time
+    if (Index >= EntryCount || Offsets[Index] >= Offsets[Index + 1] || Offsets[Index + 1] > Header->StringsSize)
+        return nullptr;
+
+    // Names are null terminated in the arena
+    Hash = Hashes[Index];
+    Length = Offsets[Index + 1] - Offsets[Index] - 1;
+
+    // Return result
+    return Strings + Offsets[Index];
+}
+
+const char* WraithNameTable::Find(uint64_t Hash, size_t& Length) const
+{
+    // Binary search the hashes
+    auto Result = std::lower_bound(Hashes, Hashes + EntryCount, Hash);
+
+    if (Result == Hashes + EntryCount || *Result != Hash)
+        return nullptr;
+
+    uint64_t EntryHash = 0;
+
+    // Return result
+    return GetEntry((uint32_t)(Result - Hashes), EntryHash, Length);
+}
+
+// Gets the fingerprint of a source index
+static bool GetSourceInfo(const std::string& FilePath, uint64_t& Size, uint64_t& ModifiedTime)
+{
+    // Get the file attributes
+    WIN32_FILE_ATTRIBUTE_DATA FileAttrs;
+
+    if (!GetFileAttributesExA(FilePath.c_str(), GET_FILEEX_INFO_LEVELS::GetFileExInfoStandard, &FileAttrs))
+        return false;
+
+    // Set the fingerprint
+    Size = ((uint64_t)FileAttrs.nFileSizeHigh << 32) | FileAttrs.nFileSizeLow;
+    ModifiedTime = ((uint64_t)FileAttrs.ftLastWriteTime.dwHighDateTime << 32) | FileAttrs.ftLastWriteTime.dwLowDateTime;
+
+    // Success
+    return true;
+}
+
+// Gets the path of the compact index built next to a source index
+static std::string GetCompactPath(const std::string& FilePath)
+{
+    // Swap the extension
+    return FilePath.substr(0, FilePath.size() - FileSystems::GetExtension(FilePath).size()) + ".wnc";
+}
+
+// A name read from a source index
+struct WraithNameSourceEntry
+{
+    // The hash of the name
+    uint64_t Hash;
+    // The offset of the name in the unpacked data
+    uint32_t Offset;
+    // The length of the name
+    uint32_t Length;
+};
+
+// Reads a .wni file and lays it out in the compact format
+static bool BuildCompactIndex(const std::string& SourcePath, std::unique_ptr<uint8_t[]>& Result, uint64_t& ResultSize)
+{
+    // Get the fingerprint, stored so we know when to rebuild
+    uint64_t SourceSize = 0;
+    uint64_t SourceModifiedTime = 0;
+
+    if (!GetSourceInfo(SourcePath, SourceSize, SourceModifiedTime))
+        return false;
+
+    // Prepare a reader
+    auto Reader = BinaryReader();
+
+    if (!Reader.Open(SourcePath, true))
+        return false;
+
+    // Verify magic ('WNI ')
+    if (Reader.Read<uint32_t>() != 0x20494E57)
+        return false;
+
+    // Skip over version (Should be 0x1)
+    Reader.Advance(2);
+
+    // Read entry count
+    auto EntryCount = Reader.Read<uint32_t>();
+
+    // Read packed sizes
+    auto Packed = Reader.Read<uint32_t>();
+    auto Unpacked = Reader.Read<uint32_t>();
+
+    // Read the compressed data
+    uint64_t CompressedResult = 0;
+    std::unique_ptr<int8_t[]> CompressedBuffer(Reader.Read(Packed, CompressedResult));
+
+    if (CompressedBuffer == nullptr || CompressedResult != Packed)
+        return false;
+
+    // Decompress it
+    std::unique_ptr<int8_t[]> Decompressed(new int8_t[Unpacked]);
+
+    auto DecompressResult = Compression::DecompressLZ4Block(CompressedBuffer.get(), Decompressed.get(), Packed, Unpacked);
+
+    if (DecompressResult == 0)
+        return false;
+
+    // Done with the packed data
+    CompressedBuffer.reset();
+
+    // Walk the entries, only noting where each name is, nothing is copied yet
+    std::vector<WraithNameSourceEntry> Entries;
+    Entries.reserve(EntryCount);
+
+    uint64_t StringsSize = 0;
+    uint32_t Position = 0;
+
+    for (uint32_t i = 0; i < EntryCount && (uint64_t)Position + 8 <= DecompressResult; i++)
+    {
+        WraithNameSourceEntry Entry{};
+
+        // Read key, masked like the old loader
+        std::memcpy(&Entry.Hash, Decompressed.get() + Position, 8);
+        Entry.Hash &= 0xFFFFFFFFFFFFFFF;
+        Position += 8;
+
+        // Find the end of the name
+        auto Start = (const char*)Decompressed.get() + Position;
+        auto End = (const char*)std::memchr(Start, 0, DecompressResult - Position);
+
+        if (End == nullptr)
+            break;
+
+        Entry.Offset = Position;
+        Entry.Length = (uint32_t)(End - Start);
+        Position += Entry.Length + 1;
+
+        // Add the entry
+        Entries.push_back(Entry);
+    }
+
+    // Sort by hash, stable, so that for duplicates the last one in the file wins, like the old map
+    std::stable_sort(Entries.begin(), Entries.end(), [](const WraithNameSourceEntry& Lhs, const WraithNameSourceEntry& Rhs)
+    {
+        return Lhs.Hash < Rhs.Hash;
+    });
+
+    std::vector<WraithNameSourceEntry> Unique;
+    Unique.reserve(Entries.size());
+
+    for (size_t i = 0; i < Entries.size(); i++)
+    {
+        // Skip if a later entry has the same hash
+        if (i + 1 < Entries.size() && Entries[i + 1].Hash == Entries[i].Hash)
+            continue;
+
+        Unique.push_back(Entries[i]);
+        StringsSize += Entries[i].Length + 1;
+    }
+
+    // Done with the unsorted list
+    std::vector<WraithNameSourceEntry>().swap(Entries);
+
+    // Offsets are 32-bit
+    if (StringsSize > 0xFFFFFFFF)
+        return false;
+
+    // Lay it out
+    WraithNameTableHeader Header{};
+    Header.Magic = WraithNameTableMagic;
+    Header.Version = WraithNameTableVersion;
+    Header.EntryCount = (uint32_t)Unique.size();
+    Header.StringsSize = (uint32_t)StringsSize;
+    Header.SourceSize = SourceSize;
+    Header.SourceModifiedTime = SourceModifiedTime;
+
+    uint64_t HashesSize = (uint64_t)Header.EntryCount * sizeof(uint64_t);
+    uint64_t OffsetsSize = ((uint64_t)Header.EntryCount + 1) * sizeof(uint32_t);
+
+    ResultSize = sizeof(WraithNameTableHeader) + HashesSize + OffsetsSize + StringsSize;
+    Result = std::make_unique<uint8_t[]>(ResultSize);
+
+    auto Hashes = (uint64_t*)(Result.get() + sizeof(WraithNameTableHeader));
+    auto Offsets = (uint32_t*)(Result.get() + sizeof(WraithNameTableHeader) + HashesSize);
+    auto Strings = (char*)(Result.get() + sizeof(WraithNameTableHeader) + HashesSize + OffsetsSize);
+
+    std::memcpy(Result.get(), &Header, sizeof(Header));
+
+    uint32_t StringOffset = 0;
+
+    for (uint32_t i = 0; i < Header.EntryCount; i++)
+    {
+        // Copy the hash and name
+        Hashes[i] = Unique[i].Hash;
+        Offsets[i] = StringOffset;
+        std::memcpy(Strings + StringOffset, Decompressed.get() + Unique[i].Offset, Unique[i].Length);
+        Strings[StringOffset + Unique[i].Length] = 0;
+        StringOffset += Unique[i].Length + 1;
+    }
+
+    // Mark the end of the last name
+    Offsets[Header.EntryCount] = StringOffset;
+
+    // Success
+    return true;
+}
+
+// Writes a compact index, through a temporary file so a crash never leaves a half written index
+static bool WriteCompactIndex(const std::string& FilePath, const uint8_t* Data, uint64_t DataSize)
+{
+    // The writer takes 32-bit sizes
+    if (DataSize > 0xFFFFFFFF)
+        return false;
+
+    // Write it
+    auto TempFilePath = FilePath + ".tmp";
+
+    {
+        BinaryWriter Writer;
+
+        if (!Writer.Create(TempFilePath))
+            return false;
+
+        Writer.Write((const int8_t*)Data, (uint32_t)DataSize);
+    }
+
+    // Swap it in
+    if (!MoveFileExA(TempFilePath.c_str(), FilePath.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        FileSystems::DeleteFile(TempFilePath);
+        return false;
+    }
+
+    // Success
+    return true;
+}
 
 WraithNameIndex::WraithNameIndex()
 {
@@ -23,6 +470,26 @@ WraithNameIndex::WraithNameIndex(const std::string& FilePath)
 
 void WraithNameIndex::SaveIndex(const std::string& FilePath)
 {
+    // Merge the loaded tables, oldest first, then the runtime names over the top
+    std::unordered_map<uint64_t, std::string> Merged;
+
+    for (auto& Table : Tables)
+    {
+        for (uint32_t i = 0; i < Table->GetEntryCount(); i++)
+        {
+            uint64_t Hash = 0;
+            size_t Length = 0;
+
+            auto Name = Table->GetEntry(i, Hash, Length);
+
+            if (Name != nullptr)
+                Merged[Hash].assign(Name, Length);
+        }
+    }
+
+    for (auto& KeyValue : NameDatabase)
+        Merged[KeyValue.first] = KeyValue.second;
+
     // Prepare to save
     auto Writer = BinaryWriter();
     // Create it
@@ -33,13 +500,13 @@ void WraithNameIndex::SaveIndex(const std::string& FilePath)
     Writer.Write<uint16_t>(0x1);
 
     // Write entries count
-    Writer.Write<uint32_t>((uint32_t)NameDatabase.size());
+    Writer.Write<uint32_t>((uint32_t)Merged.size());
 
     // Prepare to package up the data
     uint32_t PackageSize = 0;
 
     // Loop and calculate
-    for (auto& KeyValue : NameDatabase)
+    for (auto& KeyValue : Merged)
     {
         // Add 8 for key and then string size
         PackageSize += 8 + (uint32_t)(KeyValue.second.size() + 1);
@@ -52,7 +519,7 @@ void WraithNameIndex::SaveIndex(const std::string& FilePath)
     uint32_t DataOffset = 0;
 
     // Loop and copy over
-    for (auto& KeyValue : NameDatabase)
+    for (auto& KeyValue : Merged)
     {
         // Copy Key
         std::memcpy(UnpackedData + DataOffset, &KeyValue.first, 8);
@@ -91,66 +558,125 @@ void WraithNameIndex::SaveIndex(const std::string& FilePath)
 void WraithNameIndex::LoadIndex(const std::string& LoadIndex)
 {
     // Prepare to load
-    if (FileSystems::FileExists(LoadIndex))
+    if (!FileSystems::FileExists(LoadIndex))
+        return;
+
+    auto Table = std::make_shared<WraithNameTable>();
+
+    // Compact indexes are mapped as is
+    auto Extension = FileSystems::GetExtension(LoadIndex);
+
+    if (Strings::ToLower(Extension) == ".wnc")
     {
-        // Prepare a reader
-        auto Reader = BinaryReader();
-        // Open it
-        Reader.Open(LoadIndex);
+        if (Table->Open(LoadIndex))
+            Tables.push_back(Table);
 
-        // Verify magic ('WNI ')
-        if (Reader.Read<uint32_t>() == 0x20494E57)
-        {
-            // Skip over version (Should be 0x1)
-            Reader.Advance(2);
-
-            // Read entry count
-            auto EntryCount = Reader.Read<uint32_t>();
-
-            // Read packed sizes
-            auto Packed = Reader.Read<uint32_t>();
-            auto Unpacked = Reader.Read<uint32_t>();
-
-            // Result size
-            uint64_t CompressedResult = 0;
-            // Read the compressed data
-            auto CompressedBuffer = Reader.Read(Packed, CompressedResult);
-
-            // Check it
-            if (CompressedBuffer != nullptr)
-            {
-                // Prepare to decompress, then read
-                auto Decompressed = new int8_t[Unpacked];
-
-                // Decompress it
-                auto DecompressResult = Compression::DecompressLZ4Block(CompressedBuffer, Decompressed, Packed, Unpacked);
-
-                // Check
-                if (DecompressResult > 0)
-                {
-                    // Allocate a reader and parse (This will auto clean up)
-                    auto MemReader = MemoryReader(Decompressed, DecompressResult);
-
-                    // Loop and read entries
-                    for (uint32_t i = 0; i < EntryCount; i++)
-                    {
-                        // Read key and name
-                        auto Key = MemReader.Read<uint64_t>() & 0xFFFFFFFFFFFFFFF;
-                        auto Value = MemReader.ReadNullTerminatedString();
-
-                        // Add the entry
-                        NameDatabase[Key] = Value;
-                    }
-                }
-                else
-                {
-                    // Failed
-                    delete[] Decompressed;
-                }
-
-                // Clean up
-                delete[] CompressedBuffer;
-            }
-        }
+        return;
+    }
+
+    // Use the compact copy if it was built from this exact file
+    auto CompactPath = GetCompactPath(LoadIndex);
+
+    uint64_t SourceSize = 0;
+    uint64_t SourceModifiedTime = 0;
+
+    if (GetSourceInfo(LoadIndex, SourceSize, SourceModifiedTime) && Table->Open(CompactPath) && Table->IsCurrent(SourceSize, SourceModifiedTime))
+    {
+        Tables.push_back(Table);
+        return;
+    }
+
+    // Build it, this is the only time the whole index is unpacked
+    std::unique_ptr<uint8_t[]> Data;
+    uint64_t DataSize = 0;
+
+    if (!BuildCompactIndex(LoadIndex, Data, DataSize))
+        return;
+
+    // Save it for next time and map it, if the folder isn't writable, use it from memory
+    if (WriteCompactIndex(CompactPath, Data.get(), DataSize) && Table->Open(CompactPath))
+    {
+        Tables.push_back(Table);
+        return;
     }
-}
\ No newline at end of file
+
+    if (Table->Attach(std::move(Data), DataSize))
+        Tables.push_back(Table);
+}
+
+bool WraithNameIndex::ConvertIndex(const std::string& SourcePath, const std::string& DestinationPath)
+{
+    // Build it
+    std::unique_ptr<uint8_t[]> Data;
+    uint64_t DataSize = 0;
+
+    if (!BuildCompactIndex(SourcePath, Data, DataSize))
+        return false;
+
+    // Write it
+    return WriteCompactIndex(DestinationPath, Data.get(), DataSize);
+}
+
+const char* WraithNameIndex::FindName(uint64_t Hash, size_t& Length) const
+{
+    // Runtime names first
+    auto Result = NameDatabase.find(Hash);
+
+    if (Result != NameDatabase.end())
+    {
+        Length = Result->second.size();
+        return Result->second.c_str();
+    }
+
+    // Then the tables, newest first
+    for (auto Table = Tables.rbegin(); Table != Tables.rend(); Table++)
+    {
+        auto Name = (*Table)->Find(Hash, Length);
+
+        if (Name != nullptr)
+            return Name;
+    }
+
+    // Not found
+    Length = 0;
+    return nullptr;
+}
+
+bool WraithNameIndex::TryGetName(uint64_t Hash, std::string& Result) const
+{
+    // Find it in place
+    size_t Length = 0;
+    auto Name = FindName(Hash, Length);
+
+    if (Name == nullptr)
+        return false;
+
+    // Only now copy it out
+    Result.assign(Name, Length);
+    return true;
+}
+
+bool WraithNameIndex::Contains(uint64_t Hash) const
+{
+    // Find it in place
+    size_t Length = 0;
+    return FindName(Hash, Length) != nullptr;
+}
+
+size_t WraithNameIndex::Size() const
+{
+    // Sum up all sources
+    size_t Result = NameDatabase.size();
+
+    for (auto& Table : Tables)
+        Result += Table->GetEntryCount();
+
+    return Result;
+}
+
+void WraithNameIndex::Clear()
+{
+    // Remove everything
+    NameDatabase.clear();
+    Tables.clear();
+}
@@ -3,8 +3,13 @@
 #include <cstdint>
 #include <string>
 #include <cstdio>
+#include <memory>
+#include <vector>
 #include <unordered_map>
 
+// A sorted, memory mapped table of names, loaded from a compact index (Defined in WraithNameIndex.cpp)
+class WraithNameTable;
+
 // A class that handles reading and writing WraithNameIndex files
 class WraithNameIndex
 {
@@ -12,11 +17,30 @@ public:
     WraithNameIndex();
     WraithNameIndex(const std::string& FilePath);
 
-    // A database of names from their hashes
+    // A database of names added at runtime, these take priority over loaded indexes
     std::unordered_map<uint64_t, std::string> NameDatabase;
 
-    // Save the current database to a file
+    // Save the current database, and all loaded names, to a file
     void SaveIndex(const std::string& FilePath);
-    // Loads an index database
+    // Loads an index database, a compact copy is built next to .wni files and mapped on later loads
     void LoadIndex(const std::string& LoadIndex);
-};
\ No newline at end of file
+
+    // Checks if a name exists for the hash
+    bool Contains(uint64_t Hash) const;
+    // Gets a name for the hash, only this name is copied out, returns false and leaves Result as is if it doesn't exist
+    bool TryGetName(uint64_t Hash, std::string& Result) const;
+    // Finds a name for the hash in place without copying, valid until the index is cleared, returns nullptr if it doesn't exist
+    const char* FindName(uint64_t Hash, size_t& Length) const;
+
+    // Gets the number of names, a hash loaded from more than one source is counted for each
+    size_t Size() const;
+    // Removes all names and unmaps all loaded indexes
+    void Clear();
+
+    // Converts a .wni file to the compact format
+    static bool ConvertIndex(const std::string& SourcePath, const std::string& DestinationPath);
+
+private:
+    // The loaded tables, newest last, newer tables take priority like the old map did
+    std::vector<std::shared_ptr<WraithNameTable>> Tables;
+};
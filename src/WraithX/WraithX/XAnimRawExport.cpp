@@ -64,25 +64,25 @@ static_assert(sizeof(XAnimHeader) == 0xA, "XAnimHeader size mismatch, expected s
 
 // End structures
 
-void XAnimProduceQuaternions(BinaryWriter& Writer, uint32_t FrameSize, uint32_t LoopedFrameCount, const std::vector<WraithAnimFrame<Quaternion>>& QuatFrames, bool SimpleQuaternion = false)
+void XAnimProduceQuaternions(BinaryWriter& Writer, uint32_t FrameSize, uint32_t LoopedFrameCount, const WraithAnimCurve<Quaternion>& QuatFrames, bool SimpleQuaternion = false)
 {
     // Write all the frame indicies first (If we have more than 1 frame)
-    if (QuatFrames.size() > 1 && QuatFrames.size() != LoopedFrameCount)
+    if (QuatFrames.Size() > 1 && QuatFrames.Size() != LoopedFrameCount)
     {
-        for (auto& Key : QuatFrames)
+        for (auto Frame : QuatFrames.Frames)
         {
             switch (FrameSize)
             {
-            case 1: Writer.Write<uint8_t>((uint8_t)Key.Frame); break;
-            case 2: Writer.Write<uint16_t>((uint16_t)Key.Frame); break;
+            case 1: Writer.Write<uint8_t>((uint8_t)Frame); break;
+            case 2: Writer.Write<uint16_t>((uint16_t)Frame); break;
             }
         }
     }
 
     // Loop and write unit (Normalized) quaternions
-    for (auto& Key : QuatFrames)
+    for (auto& Value : QuatFrames.Values)
     {
-        auto QuaternionFrame = Key.Value;
+        auto QuaternionFrame = Value;
         QuaternionFrame.Normalize();
 
         int16_t QuatX = (int16_t)(32767.0 * QuaternionFrame.X);
@@ -105,27 +105,27 @@ void XAnimProduceQuaternions(BinaryWriter& Writer, uint32_t FrameSize, uint32_t
     }
 }
 
-void XAnimProduceTranslations(BinaryWriter& Writer, uint32_t FrameSize, uint32_t LoopedFrameCount, const std::vector<WraithAnimFrame<Vector3>>& PosFrames)
+void XAnimProduceTranslations(BinaryWriter& Writer, uint32_t FrameSize, uint32_t LoopedFrameCount, const WraithAnimCurve<Vector3>& PosFrames)
 {
     // Write all the frame indicies first (If we have more than 1 frame)
-    if (PosFrames.size() > 1 && PosFrames.size() != LoopedFrameCount)
+    if (PosFrames.Size() > 1 && PosFrames.Size() != LoopedFrameCount)
     {
-        for (auto& Key : PosFrames)
+        for (auto Frame : PosFrames.Frames)
         {
             switch (FrameSize)
             {
-            case 1: Writer.Write<uint8_t>((uint8_t)Key.Frame); break;
-            case 2: Writer.Write<uint16_t>((uint16_t)Key.Frame); break;
+            case 1: Writer.Write<uint8_t>((uint8_t)Frame); break;
+            case 2: Writer.Write<uint16_t>((uint16_t)Frame); break;
             }
         }
     }
 
-    if (PosFrames.size() == 1)
+    if (PosFrames.Size() == 1)
     {
         // We just write the translation
-        Writer.Write<float>(PosFrames[0].Value.X);
-        Writer.Write<float>(PosFrames[0].Value.Y);
-        Writer.Write<float>(PosFrames[0].Value.Z);
+        Writer.Write<float>(PosFrames.Values[0].X);
+        Writer.Write<float>(PosFrames.Values[0].Y);
+        Writer.Write<float>(PosFrames.Values[0].Z);
     }
     else
     {
@@ -134,38 +134,38 @@ void XAnimProduceTranslations(BinaryWriter& Writer, uint32_t FrameSize, uint32_t
         float SizeX = 1, SizeY = 1, SizeZ = 1;
 
         // Loop and calculate minimum
-        for (auto& Key : PosFrames)
+        for (auto& Value : PosFrames.Values)
         {
-            if (Key.Value.X < MinX) { MinX = Key.Value.X; }
-            if (Key.Value.Y < MinY) { MinY = Key.Value.Y; }
-            if (Key.Value.Z < MinZ) { MinZ = Key.Value.Z; }
+            if (Value.X < MinX) { MinX = Value.X; }
+            if (Value.Y < MinY) { MinY = Value.Y; }
+            if (Value.Z < MinZ) { MinZ = Value.Z; }
         }
         
         // Loop and calculate size
-        for (auto& Key : PosFrames)
+        for (auto& Value : PosFrames.Values)
         {
-            float CalcX = (Key.Value.X - MinX) / SizeX;
+            float CalcX = (Value.X - MinX) / SizeX;
 
             while ((CalcX * 65535.0) > 65535.0)
             {
                 SizeX += 0.025f;
-                CalcX = (Key.Value.X - MinX) / SizeX;
+                CalcX = (Value.X - MinX) / SizeX;
             }
 
-            float CalcY = (Key.Value.Y - MinY) / SizeY;
+            float CalcY = (Value.Y - MinY) / SizeY;
 
             while ((CalcY * 65535.0) > 65535.0)
             {
                 SizeY += 0.025f;
-                CalcY = (Key.Value.Y - MinY) / SizeY;
+                CalcY = (Value.Y - MinY) / SizeY;
             }
 
-            float CalcZ = (Key.Value.Z - MinZ) / SizeZ;
+            float CalcZ = (Value.Z - MinZ) / SizeZ;
 
             while ((CalcZ * 65535.0) > 65535.0)
             {
                 SizeZ += 0.025f;
-                CalcZ = (Key.Value.Z - MinZ) / SizeZ;
+                CalcZ = (Value.Z - MinZ) / SizeZ;
             }
         }
 
@@ -179,11 +179,11 @@ void XAnimProduceTranslations(BinaryWriter& Writer, uint32_t FrameSize, uint32_t
         Writer.Write<float>(SizeZ);
 
         // Output translations
-        for (auto& Key : PosFrames)
+        for (auto& Value : PosFrames.Values)
         {
-            float CalcX = (Key.Value.X - MinX) / SizeX;
-            float CalcY = (Key.Value.Y - MinY) / SizeY;
-            float CalcZ = (Key.Value.Z - MinZ) / SizeZ;
+            float CalcX = (Value.X - MinX) / SizeX;
+            float CalcY = (Value.Y - MinY) / SizeY;
+            float CalcZ = (Value.Z - MinZ) / SizeZ;
 
             Writer.Write<uint16_t>((uint16_t)(CalcX * 65535.0));
             Writer.Write<uint16_t>((uint16_t)(CalcY * 65535.0));
@@ -211,8 +211,8 @@ void XAnimRaw::ExportXAnimRaw(const WraithAnim& Animation, const std::string& Fi
     // The notification buffer
     uint32_t NotificationBuffer = Animation.NotificationCount();
 
-    // Get the bone tag names
-    auto BoneTagNames = Animation.Bones();
+    // Get the bone table, the delta tag is skipped below
+    auto& BoneTagNames = Animation.GetBones();
 
     // Specific flags
     if (Animation.Looping)
@@ -236,7 +236,6 @@ void XAnimRaw::ExportXAnimRaw(const WraithAnim& Animation, const std::string& Fi
         Header.AssetType = 2;
         Header.Flags.IsDelta = true;
         Header.NumBones--;
-        BoneTagNames.erase(Animation.DeltaTagName);
         break;
     }
 
@@ -262,11 +261,14 @@ void XAnimRaw::ExportXAnimRaw(const WraithAnim& Animation, const std::string& Fi
     // Prepare to write the delta frame data
     if (Header.Flags.IsDelta)
     {
-        if (Animation.AnimationRotationKeys.find(Animation.DeltaTagName) != Animation.AnimationRotationKeys.end())
+        // Find the delta tag
+        auto DeltaBone = Animation.FindBone(Animation.DeltaTagName);
+
+        if (DeltaBone != nullptr && !DeltaBone->Rotations.Empty())
         {
-            auto& BoneRotations = Animation.AnimationRotationKeys.at(Animation.DeltaTagName);
+            auto& BoneRotations = DeltaBone->Rotations;
             // Write count
-            Writer.Write<uint16_t>((uint16_t)BoneRotations.size());
+            Writer.Write<uint16_t>((uint16_t)BoneRotations.Size());
 
             XAnimProduceQuaternions(Writer, FrameSize, LoopedFrameCount, BoneRotations, true);
         }
@@ -276,12 +278,12 @@ void XAnimRaw::ExportXAnimRaw(const WraithAnim& Animation, const std::string& Fi
             Writer.Write<uint16_t>(0);
         }
 
-        if (Animation.AnimationPositionKeys.find(Animation.DeltaTagName) != Animation.AnimationPositionKeys.end())
+        if (DeltaBone != nullptr && !DeltaBone->Translations.Empty())
         {
             // We have translation keys
-            auto& BoneTranslations = Animation.AnimationPositionKeys.at(Animation.DeltaTagName);
+            auto& BoneTranslations = DeltaBone->Translations;
             // Write count
-            Writer.Write<uint16_t>((uint16_t)BoneTranslations.size());
+            Writer.Write<uint16_t>((uint16_t)BoneTranslations.Size());
 
             XAnimProduceTranslations(Writer, FrameSize, LoopedFrameCount, BoneTranslations);
         }
@@ -302,8 +304,12 @@ void XAnimRaw::ExportXAnimRaw(const WraithAnim& Animation, const std::string& Fi
     // Write the bone tags
     for (auto& Bone : BoneTagNames)
     {
+        // Skip the delta tag, it was written above
+        if (Header.Flags.IsDelta && Bone.Name == Animation.DeltaTagName)
+            continue;
+
         // Write the null-term string
-        Writer.Write((uint8_t*)Bone.c_str(), (uint32_t)(Bone.size() + 1));
+        Writer.Write((uint8_t*)Bone.Name.c_str(), (uint32_t)(Bone.Name.size() + 1));
     }
 
     // Store the byte flag index
@@ -312,23 +318,18 @@ void XAnimRaw::ExportXAnimRaw(const WraithAnim& Animation, const std::string& Fi
     // For all real bones, we must loop and write their data
     for (auto& Bone : BoneTagNames)
     {
-        if (Animation.AnimationRotationKeys.find(Bone) != Animation.AnimationRotationKeys.end())
+        // Skip the delta tag, it was written above
+        if (Header.Flags.IsDelta && Bone.Name == Animation.DeltaTagName)
+            continue;
+
+        if (!Bone.Rotations.Empty())
         {
             // We have rotation segment
-            auto& BoneRotations = Animation.AnimationRotationKeys.at(Bone);
+            auto& BoneRotations = Bone.Rotations;
             // Write count
-            Writer.Write<uint16_t>((uint16_t)BoneRotations.size());
+            Writer.Write<uint16_t>((uint16_t)BoneRotations.Size());
 
-            // Determine if we have actual quaternions
-            if (BoneRotations.size() > 0)
-            {
-                XAnimProduceQuaternions(Writer, FrameSize, LoopedFrameCount, BoneRotations);
-            }
-            else
-            {
-                // Mark as a simple quaternion
-                SimpleQuaternionFlags[(SimpleQuaternionByteFlag >> 3)] |= (1 << (SimpleQuaternionByteFlag & 7));
-            }
+            XAnimProduceQuaternions(Writer, FrameSize, LoopedFrameCount, BoneRotations);
         }
         else
         {
@@ -337,12 +338,12 @@ void XAnimRaw::ExportXAnimRaw(const WraithAnim& Animation, const std::string& Fi
             Writer.Write<uint16_t>(0);
         }
 
-        if (Animation.AnimationPositionKeys.find(Bone) != Animation.AnimationPositionKeys.end())
+        if (!Bone.Translations.Empty())
         {
             // We have translation keys
-            auto& BoneTranslations = Animation.AnimationPositionKeys.at(Bone);
+            auto& BoneTranslations = Bone.Translations;
             // Write count
-            Writer.Write<uint16_t>((uint16_t)BoneTranslations.size());
+            Writer.Write<uint16_t>((uint16_t)BoneTranslations.Size());
 
             XAnimProduceTranslations(Writer, FrameSize, LoopedFrameCount, BoneTranslations);
         }
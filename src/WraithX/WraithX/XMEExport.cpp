@@ -78,6 +78,8 @@ void CodXME::ExportXME(const WraithModel& Model, const std::string& FileName)
         // Use integer 16
         Writer.WriteLineFmt("NUMVERTS %d", VertexCount);
     }
+    // The vertex tag, matching the vert count
+    const char* VertexTag = (VertexCount > UINT16_MAX) ? "VERT32 " : "VERT ";
     // A unique list of material indicies
     std::unordered_set<int32_t> MaterialIndicies;
     // The vertex offset
@@ -90,46 +92,35 @@ void CodXME::ExportXME(const WraithModel& Model, const std::string& FileName)
         // Iterate over verts and do positions and weights
         for (auto& Vertex : Submesh.Verticies)
         {
-            // Write vertex and offset
-            if (VertexCount > UINT16_MAX)
-            {
-                // Use integer 32
-                Writer.WriteLineFmt(
-                    "VERT32 %d\n"
-                    "OFFSET %f, %f, %f",
-                    VertexIndex,
-                    Vertex.Position.X, Vertex.Position.Y, Vertex.Position.Z
-                    );
-            }
-            else
-            {
-                // Use integer  16
-                Writer.WriteLineFmt(
-                    "VERT %d\n"
-                    "OFFSET %f, %f, %f",
-                    VertexIndex,
-                    Vertex.Position.X, Vertex.Position.Y, Vertex.Position.Z
-                    );
-            }
+            // Write vertex, using integer 32 if need be, and offset
+            Writer.Write(VertexTag);
+            Writer.WriteInteger(VertexIndex);
+            Writer.Write("\nOFFSET ", 8);
+            Writer.WriteFloats(&Vertex.Position.X, 3, ", ");
+            Writer.NewLine();
             // Handle bone weights
             if (Vertex.WeightCount() == 1)
             {
                 // Only weight one bone
-                Writer.WriteLineFmt(
-                    "BONES 1\n"
-                    "BONE %d 1.000000\n",
-                    Vertex.Weights[0].BoneIndex
-                    );
+                Writer.Write("BONES 1\nBONE ", 13);
+                Writer.WriteInteger(Vertex.Weights[0].BoneIndex);
+                Writer.Write(" 1.000000\n\n", 11);
             }
             else
             {
                 // Loop and weight all weights
-                Writer.WriteLineFmt("BONES %d", (uint32_t)Vertex.WeightCount());
+                Writer.Write("BONES ", 6);
+                Writer.WriteInteger(Vertex.WeightCount());
+                Writer.NewLine();
                 // Loop
                 for (auto& Weight : Vertex.Weights)
                 {
                     // Output
-                    Writer.WriteLineFmt("BONE %d %f", Weight.BoneIndex, Weight.Weight);
+                    Writer.Write("BONE ", 5);
+                    Writer.WriteInteger(Weight.BoneIndex);
+                    Writer.Write(" ", 1);
+                    Writer.WriteFloat(Weight.Weight);
+                    Writer.NewLine();
                 }
                 // New line
                 Writer.NewLine();
@@ -155,42 +146,33 @@ void CodXME::ExportXME(const WraithModel& Model, const std::string& FileName)
         for (auto& Face : Submesh.Faces)
         {
             // Output the face information
-            Writer.WriteLineFmt("TRI %d %d 0 0", SubmeshIndex, IndexOfMaterial);
-            // Output vertex information for the faces (swap for size of verts)
-            Writer.WriteLineFmt((VertexCount > UINT16_MAX) ? "VERT32 %d" : "VERT %d", (Face.Index3 + VertexIndex));
-            // Output vert information
-            Writer.WriteLineFmt(
-                "NORMAL %f %f %f\n"
-                "COLOR %f %f %f %f\n"
-                "UV 1 %f %f",
-                Submesh.Verticies[Face.Index3].Normal.X, Submesh.Verticies[Face.Index3].Normal.Y, Submesh.Verticies[Face.Index3].Normal.Z,
-                Submesh.Verticies[Face.Index3].Color[0] / 255.0f, Submesh.Verticies[Face.Index3].Color[1] / 255.0f, Submesh.Verticies[Face.Index3].Color[2] / 255.0f, Submesh.Verticies[Face.Index3].Color[3] / 255.0f,
-                Submesh.Verticies[Face.Index3].UVLayers[0].U, Submesh.Verticies[Face.Index3].UVLayers[0].V
-                );
-
-            // Output vertex information for the faces (swap for size of verts)
-            Writer.WriteLineFmt((VertexCount > UINT16_MAX) ? "VERT32 %d" : "VERT %d", (Face.Index1 + VertexIndex));
-            // Output vert information
-            Writer.WriteLineFmt(
-                "NORMAL %f %f %f\n"
-                "COLOR %f %f %f %f\n"
-                "UV 1 %f %f",
-                Submesh.Verticies[Face.Index1].Normal.X, Submesh.Verticies[Face.Index1].Normal.Y, Submesh.Verticies[Face.Index1].Normal.Z,
-                Submesh.Verticies[Face.Index1].Color[0] / 255.0f, Submesh.Verticies[Face.Index1].Color[1] / 255.0f, Submesh.Verticies[Face.Index1].Color[2] / 255.0f, Submesh.Verticies[Face.Index1].Color[3] / 255.0f,
-                Submesh.Verticies[Face.Index1].UVLayers[0].U, Submesh.Verticies[Face.Index1].UVLayers[0].V
-                );
+            Writer.Write("TRI ", 4);
+            Writer.WriteInteger(SubmeshIndex);
+            Writer.Write(" ", 1);
+            Writer.WriteInteger(IndexOfMaterial);
+            Writer.Write(" 0 0\n", 5);
+            // The vertices, in the order they are written
+            const uint32_t Indicies[3] = { Face.Index3, Face.Index1, Face.Index2 };
+            // Output each vertex
+            for (auto& Index : Indicies)
+            {
+                // Grab a reference to the vertex
+                const WraithVertex& Vertex = Submesh.Verticies[Index];
+                // The normalized color
+                const float Color[4] = { Vertex.Color[0] / 255.0f, Vertex.Color[1] / 255.0f, Vertex.Color[2] / 255.0f, Vertex.Color[3] / 255.0f };
 
-            // Output vertex information for the faces (swap for size of verts)
-            Writer.WriteLineFmt((VertexCount > UINT16_MAX) ? "VERT32 %d" : "VERT %d", (Face.Index2 + VertexIndex));
-            // Output vert information
-            Writer.WriteLineFmt(
-                "NORMAL %f %f %f\n"
-                "COLOR %f %f %f %f\n"
-                "UV 1 %f %f",
-                Submesh.Verticies[Face.Index2].Normal.X, Submesh.Verticies[Face.Index2].Normal.Y, Submesh.Verticies[Face.Index2].Normal.Z,
-                Submesh.Verticies[Face.Index2].Color[0] / 255.0f, Submesh.Verticies[Face.Index2].Color[1] / 255.0f, Submesh.Verticies[Face.Index2].Color[2] / 255.0f, Submesh.Verticies[Face.Index2].Color[3] / 255.0f,
-                Submesh.Verticies[Face.Index2].UVLayers[0].U, Submesh.Verticies[Face.Index2].UVLayers[0].V
-                );
+                // Output vertex information for the faces (swap for size of verts)
+                Writer.Write(VertexTag);
+                Writer.WriteInteger(Index + VertexIndex);
+                // Output vert information
+                Writer.Write("\nNORMAL ", 8);
+                Writer.WriteFloats(&Vertex.Normal.X, 3);
+                Writer.Write("\nCOLOR ", 7);
+                Writer.WriteFloats(Color, 4);
+                Writer.Write("\nUV 1 ", 6);
+                Writer.WriteFloats(&Vertex.UVLayers[0].U, 2);
+                Writer.NewLine();
+            }
         }
         // Increase
         VertexIndex += Submesh.VertexCount();
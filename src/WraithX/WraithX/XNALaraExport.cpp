@@ -57,15 +57,13 @@ void XNALara::ExportXNA(const WraithModel& Model, const std::string& FileName)
         for (auto& Vertex : Submesh.Verticies)
         {
             // Write positions, normals, RGBA colors, and UVs
-            Writer.WriteLineFmt(
-                "%f %f %f\n"
-                "%f %f %f\n"
-                "255 255 255 255\n"
-                "%f %f",
-                // The data for the vertex
-                Vertex.Position.X, Vertex.Position.Y, Vertex.Position.Z,
-                Vertex.Normal.X, Vertex.Normal.Y, Vertex.Normal.Z,
-                Vertex.UVLayers[0].U, Vertex.UVLayers[0].V);
+            Writer.WriteFloats(&Vertex.Position.X, 3);
+            Writer.NewLine();
+            Writer.WriteFloats(&Vertex.Normal.X, 3);
+            Writer.NewLine();
+            Writer.Write("255 255 255 255\n", 16);
+            Writer.WriteFloats(&Vertex.UVLayers[0].U, 2);
+            Writer.NewLine();
             // Prepare to output weights
             uint32_t WeightIDs[4] = { 0, 0, 0, 0 };
             // Buffer for weight values
@@ -79,11 +77,10 @@ void XNALara::ExportXNA(const WraithModel& Model, const std::string& FileName)
                 WeightValues[w] = Vertex.Weights[w].Weight;
             }
             // Output values
-            Writer.WriteLineFmt(
-                "%d %d %d %d\n"
-                "%f %f %f %f",
-                WeightIDs[0], WeightIDs[1], WeightIDs[2], WeightIDs[3],
-                WeightValues[0], WeightValues[1], WeightValues[2], WeightValues[3]);
+            Writer.WriteIntegers(WeightIDs, 4);
+            Writer.NewLine();
+            Writer.WriteFloats(WeightValues, 4);
+            Writer.NewLine();
         }
         // Write face count
         Writer.WriteLineFmt("%d", Submesh.FacesCount());
@@ -91,7 +88,9 @@ void XNALara::ExportXNA(const WraithModel& Model, const std::string& FileName)
         for (auto& Face : Submesh.Faces)
         {
             // Output indicies
-            Writer.WriteLineFmt("%d %d %d", Face.Index1, Face.Index2, Face.Index3);
+            const uint32_t Indicies[3] = { Face.Index1, Face.Index2, Face.Index3 };
+            Writer.WriteIntegers(Indicies, 3);
+            Writer.NewLine();
         }
         // Advance
         SubmeshIndex++;
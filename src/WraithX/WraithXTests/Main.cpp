@@ -4,6 +4,9 @@
 #include <map>
 #include <array>
 #include <chrono>
+#include <cstring>
+#include <thread>
+#include <functional>
 
 // Wraith application and api (Must be included before additional includes)
 #include "WraithApp.h"
@@ -42,6 +45,7 @@
 #include "Sound.h"
 #include "WraithNameIndex.h"
 #include "InjectionReader.h"
+#include "HalfFloats.h"
 
 // WraithX exporter includes
 #include "SEAnimExport.h"
@@ -50,6 +54,10 @@
 #include "OBJExport.h"
 #include "XNALaraExport.h"
 #include "XMEExport.h"
+#include "CastExport.h"
+
+// Game mesh decoders, built with the tests
+#include "..\..\WraithXCOD\WraithXCOD\CoDXModelMeshHelper.h"
 
 // Macro for debugging tests (No throws)
 #define ASSERT_PRNT(a) if (a) { printf("DONE!\r\n"); TestsCompleted++; } else { printf("FAILED TEST!\r\n"); TestsFailed++; }
@@ -2266,7 +2274,7 @@ int main(int argc, char** argv)
 		WraithNameIndex TestIndex("Tests/Test.wni");
 
 		// Validate
-		ASSERT_PRNT(TestIndex.NameDatabase.size() == 7436);
+		ASSERT_PRNT(TestIndex.Size() == 7436);
 	}
 
 #pragma endregion
@@ -2289,7 +2297,7 @@ int main(int argc, char** argv)
 		WraithNameIndex ResultIndex("Tests/Result1.wni");
 
 		// Validate
-		ASSERT_PRNT(ResultIndex.NameDatabase.size() == 3);
+		ASSERT_PRNT(ResultIndex.Size() == 3);
 	}
 
 #pragma endregion
@@ -2363,6 +2371,945 @@ int main(int argc, char** argv)
 		ASSERT_PRNT(Result->DataBuffer != nullptr && Result->BufferSize > 0);
 	}
 
+#pragma endregion
+	// Compact index test
+#pragma region Compact index test
+
+	printf(":  [75]\t\tCompact index test... ");
+	{
+		// Convert the test file
+		auto Converted = WraithNameIndex::ConvertIndex("Tests/Result1.wni", "Tests/Result1.wnc");
+
+		// Load the compact file directly
+		WraithNameIndex ResultIndex("Tests/Result1.wnc");
+
+		// Look up names
+		std::string Name;
+		auto Found = ResultIndex.TryGetName(0x334454, Name);
+
+		// Validate
+		ASSERT_PRNT(Converted && ResultIndex.Size() == 3 && Found && Name == "Test2" && !ResultIndex.Contains(0x334453));
+	}
+
+#pragma endregion
+	// Process cached read test
+#pragma region Process cached read test
+
+	printf(":  [76]\t\tProcess cached read test... ");
+	{
+		// Make a reader instance
+		std::shared_ptr<ProcessReader> ProcessReadTest = std::make_shared<ProcessReader>();
+
+		// Attach to the test process
+		auto AttachRes = ProcessReadTest->Attach("WraithXTests.exe");
+
+		// Get the address of the main module
+		auto MainModule = ProcessReadTest->GetMainModuleAddress();
+
+		// Prefetch the PE header, then read it, the read should come from the cache
+		int Result = 0;
+		uint64_t Hits = 0;
+		{
+			ProcessReaderCacheScope ReadCache(ProcessReadTest.get());
+
+			ProcessReadTest->Prefetch(MainModule, 0x1000);
+			Result = ProcessReadTest->Read<int>(MainModule);
+			Hits = ProcessReadTest->GetCacheHits();
+		}
+
+		// Validate
+		ASSERT_PRNT(Result == 0x00905a4d && Hits == 1);
+	}
+
+#pragma endregion
+	// Process snapshot test
+#pragma region Process snapshot test
+
+	printf(":  [77]\t\tProcess snapshot test... ");
+	{
+		// Make a reader instance
+		std::shared_ptr<ProcessReader> ProcessReadTest = std::make_shared<ProcessReader>();
+
+		// Attach to the test process, and record the PE header
+		auto AttachRes = ProcessReadTest->Attach("WraithXTests.exe");
+		ProcessReadTest->StartRecording();
+
+		auto MainModule = ProcessReadTest->GetMainModuleAddress();
+		auto Recorded = ProcessReadTest->Read<int>(MainModule);
+		auto Saved = ProcessReadTest->SaveRecording("Tests/Result1.wps");
+
+		// Replay it, the header should read the same without the process
+		std::shared_ptr<ProcessReader> SnapshotTest = std::make_shared<ProcessReader>();
+		auto Opened = SnapshotTest->OpenSnapshot("Tests/Result1.wps");
+
+		// Validate
+		ASSERT_PRNT(Saved && Opened && SnapshotTest->GetMainModuleAddress() == MainModule && SnapshotTest->Read<int>(MainModule) == Recorded && Recorded == 0x00905a4d);
+	}
+
+#pragma endregion
+	// WraithAnim bone table test
+#pragma region WraithAnim bone table test
+
+	printf(":  [78]\t\tWraithAnim bone table test... ");
+	{
+		// Make it
+		WraithAnim Asset;
+
+		// Add a bone by index, and reserve its keys
+		auto BoneIndex = Asset.AddBone("tag_origin");
+		Asset.ReserveRotationKeys(BoneIndex, 2000);
+
+		// Add a long run of keys
+		for (uint32_t i = 0; i < 2000; i++)
+		{
+			Asset.AddRotationKey(BoneIndex, i, 0, 0, 0, 1);
+		}
+
+		// Add keys by name, the existing bone should be reused
+		Asset.AddTranslationKey("tag_origin", 0, 1, 2, 3);
+		Asset.AddTranslationKey("j_mainroot", 5, 4, 5, 6);
+
+		// Add a modifier to a bone without keys
+		Asset.AddBoneModifier("j_gun", WraithAnimationType::Relative);
+
+		// Remove the last key, the frame count should follow
+		Asset.RemoveRotationKey("tag_origin", 1999);
+
+		// Find the bone by name
+		auto Bone = Asset.FindBone("tag_origin");
+
+		// Validate
+		ASSERT_PRNT(Asset.AddBone("tag_origin") == BoneIndex && Asset.BoneCount() == 3 && Asset.FrameCount() == 1999 && Bone != nullptr && Bone->Rotations.Size() == 1999 && Bone->Translations[0].Value.Z == 3.0f && Asset.FindBone("j_gun")->Translations.Empty() && Asset.FindBone("missing") == nullptr);
+	}
+
+#pragma endregion
+	// Write text numbers test
+#pragma region Write text numbers test
+
+	printf(":  [79]\t\tWrite text numbers test... ");
+	{
+		// The values, including rounding ties, negative zero, and large values
+		const float Floats[8] = { 1.2f, -0.0f, 0.0000005f, 0.0000015f, -2.5f, 123456.789f, 1e20f, -0.0000004f };
+		const uint32_t Integers[3] = { 0, 66, 4000000000 };
+
+		// Make a writer instance
+		std::shared_ptr<TextWriter> WriteTest = std::make_shared<TextWriter>();
+
+		// Use a small buffer, so it flushes between writes
+		WriteTest->Create("Tests/TextWriterNumbers.txt");
+		WriteTest->SetWriteBuffer(64);
+
+		// Write the numbers, then the same numbers formatted
+		WriteTest->WriteFloats(Floats, 8);
+		WriteTest->Write(" ");
+		WriteTest->WriteIntegers(Integers, 3, ", ");
+		WriteTest->Write(" ");
+		WriteTest->WriteInteger(-88);
+		WriteTest->NewLine();
+		WriteTest->WriteLineFmt("%f %f %f %f %f %f %f %f %u, %u, %u %d", Floats[0], Floats[1], Floats[2], Floats[3], Floats[4], Floats[5], Floats[6], Floats[7], Integers[0], Integers[1], Integers[2], -88);
+
+		// Close
+		WriteTest->Close();
+
+		// Read it back
+		std::shared_ptr<TextReader> ReadTest = std::make_shared<TextReader>();
+		ReadTest->Open("Tests/TextWriterNumbers.txt");
+
+		// Read both lines
+		auto Fast = ReadTest->ReadLine();
+		auto Formatted = ReadTest->ReadLine();
+
+		// Validate
+		ASSERT_PRNT(Fast == Formatted && Fast.length() > 0);
+	}
+
+#pragma endregion
+	// Half float batch test
+#pragma region Half float batch test
+
+	printf(":  [80]\t\tHalf float batch test... ");
+	{
+		// Every half value, plus a few left over for the scalar tail
+		auto Halfs = std::vector<uint16_t>(0x10000 + 5);
+		for (size_t i = 0; i < Halfs.size(); i++)
+			Halfs[i] = (uint16_t)i;
+
+		// Convert them all at once
+		auto Floats = std::vector<float>(Halfs.size());
+		HalfFloats::ToFloats(Halfs.data(), Halfs.size(), Floats.data());
+
+		// Compare the bits against the single conversion
+		bool Matches = true;
+		for (size_t i = 0; i < Halfs.size(); i++)
+		{
+			auto Single = HalfFloats::ToFloat(Halfs[i]);
+			if (*reinterpret_cast<uint32_t*>(&Single) != *reinterpret_cast<uint32_t*>(&Floats[i]))
+				Matches = false;
+		}
+
+		// Validate
+		ASSERT_PRNT(Matches);
+	}
+
+#pragma endregion
+	// Sound transcode test
+#pragma region Sound transcode test
+
+	printf(":  [81]\t\tSound transcode test... ");
+	{
+		// A synthetic bank of stereo sounds, 1 to 4 seconds each, a tone with some noise so it doesn't compress to nothing
+		std::vector<std::vector<int8_t>> Bank;
+		uint32_t Noise = 0x1234567;
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			// Sizes
+			auto FrameCount = 48000 * (1 + (i % 4));
+			auto DataSize = FrameCount * 4;
+
+			// Make the sound, header first
+			std::vector<int8_t> SoundBuffer(Sound::GetMaximumWAVHeaderSize() + DataSize);
+			Sound::WriteWAVHeaderToStream(SoundBuffer.data(), 48000, 2, DataSize);
+
+			// Then the samples
+			auto Samples = (int16_t*)(SoundBuffer.data() + Sound::GetMaximumWAVHeaderSize());
+			for (uint32_t f = 0; f < FrameCount; f++)
+			{
+				Noise = Noise * 1664525 + 1013904223;
+				auto Tone = (int32_t)((f * (i + 3)) % 200) * 80 - 8000;
+				Samples[f * 2] = (int16_t)(Tone + (int32_t)(Noise >> 24) - 128);
+				Samples[f * 2 + 1] = (int16_t)(Tone / 2);
+			}
+
+			// Add it
+			Bank.emplace_back(std::move(SoundBuffer));
+		}
+
+		// Whether or not every sound made it through both levels unchanged
+		bool Matches = true;
+
+		// Encodes the bank at a compression level, then decodes it and compares it to the source
+		auto TranscodeBank = [&Bank, &Matches](uint32_t CompressionLevel)
+		{
+			for (auto& SoundBuffer : Bank)
+			{
+				// Encode it
+				Matches &= Sound::ConvertSoundMemory(SoundBuffer.data(), SoundBuffer.size(), SoundFormat::WAV_WithHeader, "Tests/SoundTranscode.flac", SoundFormat::Standard_FLAC, CompressionLevel);
+
+				// Read it back
+				auto Reader = BinaryReader();
+				Reader.Open("Tests/SoundTranscode.flac");
+				uint64_t FlacSize = 0;
+				auto FlacBuffer = Reader.Read(Reader.GetLength(), FlacSize);
+				Reader.Close();
+
+				// Decode it
+				Matches &= Sound::ConvertSoundMemory(FlacBuffer, FlacSize, SoundFormat::FLAC_WithHeader, "Tests/SoundTranscode.wav", SoundFormat::Standard_WAV);
+				delete[] FlacBuffer;
+
+				// Compare it
+				Reader.Open("Tests/SoundTranscode.wav");
+				uint64_t WavSize = 0;
+				auto WavBuffer = Reader.Read(Reader.GetLength(), WavSize);
+				Matches &= (WavSize == SoundBuffer.size() && std::equal(SoundBuffer.begin(), SoundBuffer.end(), WavBuffer));
+				delete[] WavBuffer;
+			}
+		};
+
+		// Time the default level against the fast level
+		auto DefaultTime = UnitTestTimer<>::ExecuteFunction(TranscodeBank, 5);
+		auto FastTime = UnitTestTimer<>::ExecuteFunction(TranscodeBank, 0);
+
+		// Report
+		printf("(level 5: %lldms, level 0: %lldms) ", (long long)DefaultTime, (long long)FastTime);
+
+		// Validate
+		ASSERT_PRNT(Matches);
+	}
+
+#pragma endregion
+
+	// Salsa20 range test
+#pragma region Salsa20 range test
+
+	printf(":  [82]\t\tSalsa20 range test... ");
+	{
+		// Key and IV (256)
+		uint8_t Key[32];
+		uint8_t IV[8] = { 0x4A, 0x1B, 0xB1, 0x2, 0x0, 0x0, 0x0, 0x0 };
+
+		for (uint32_t i = 0; i < 32; i++)
+			Key[i] = (uint8_t)(i * 7 + 3);
+
+		// Make key
+		Salsa20Key KeyData;
+		// Set
+		KeyData.Key = &Key[0];
+		KeyData.IV = &IV[0];
+		KeyData.KeyLength = 256;
+
+		// A buffer large enough to be split into parts, and not a multiple of a block
+		std::vector<int8_t> Plain(0x900000 + 37);
+
+		for (size_t i = 0; i < Plain.size(); i++)
+			Plain[i] = (int8_t)(i * 31 + (i >> 9));
+
+		// Encrypt it as a whole
+		auto Cipher = Plain;
+		Encryption::Salsa20Block(Cipher.data(), (uint32_t)Cipher.size(), KeyData);
+
+		// Runs the parts of a range on their own threads
+		auto RunParts = [](uint32_t PartCount, const std::function<void(uint32_t)>& DecryptPart)
+		{
+			std::vector<std::thread> Threads;
+
+			for (uint32_t i = 0; i < PartCount; i++)
+				Threads.emplace_back(DecryptPart, i);
+
+			for (auto& Thread : Threads)
+				Thread.join();
+		};
+
+		// Decrypts a range on its own and compares it
+		auto DecryptRange = [&](uint64_t Start, uint64_t Length, uint32_t MaxParts)
+		{
+			std::vector<int8_t> Range(Cipher.begin() + (size_t)Start, Cipher.begin() + (size_t)(Start + Length));
+			auto Result = Encryption::Salsa20Range(Range.data(), Length, Start, KeyData, MaxParts, RunParts);
+			return Result == Length && std::equal(Range.begin(), Range.end(), Plain.begin() + (size_t)Start);
+		};
+
+		// Ranges on and off block boundaries, whole and split into parts
+		bool Matches = DecryptRange(0, Plain.size(), 1) && DecryptRange(0, Plain.size(), 3) && DecryptRange(61, 0x800003, 4) && DecryptRange(1, 100, 4) && DecryptRange(63, 65, 1) && DecryptRange(4097, 0x300000, 4) && DecryptRange(Plain.size() - 5, 5, 4);
+
+		// Then through a reader
+		auto Writer = BinaryWriter();
+		Writer.Create("Tests/Salsa20Range.bin");
+		Writer.Write(Cipher.data(), (uint32_t)Cipher.size());
+		Writer.Close();
+
+		auto Reader = BinaryReader();
+		Reader.Open("Tests/Salsa20Range.bin");
+		Reader.SetDecryption(KeyData);
+
+		// Small reads
+		Matches &= Reader.Read<uint32_t>(4093) == *(uint32_t*)&Plain[4093];
+		Matches &= Reader.Read<uint64_t>() == *(uint64_t*)&Plain[4097];
+		Matches &= Reader.ReadString(100, 0x1000F) == std::string((const char*)&Plain[0x1000F], 100);
+
+		// Large reads
+		uint64_t ReadSize = 0;
+		auto Block = Reader.Read(0x123457, 0x200000, ReadSize);
+		Matches &= ReadSize == 0x200000 && std::equal(Block, Block + ReadSize, Plain.begin() + 0x123457);
+		delete[] Block;
+
+		Reader.Close();
+
+		// Validate
+		ASSERT_PRNT(Matches);
+	}
+
+#pragma endregion
+
+	// Sound split header test
+#pragma region Sound split header test
+
+	printf(":  [83]\t\tSound split header test... ");
+	{
+		// A stereo sound, with the header kept apart from the samples
+		auto FrameCount = 48000 * 2;
+		auto DataSize = FrameCount * 4;
+		auto HeaderSize = Sound::GetMaximumWAVHeaderSize();
+
+		std::vector<int8_t> Header(HeaderSize);
+		Sound::WriteWAVHeaderToStream(Header.data(), 48000, 2, DataSize);
+
+		std::vector<int8_t> Data(DataSize);
+		auto Samples = (int16_t*)Data.data();
+		for (uint32_t f = 0; f < (uint32_t)FrameCount * 2; f++)
+			Samples[f] = (int16_t)((int32_t)((f * 37) % 4000) - 2000);
+
+		// The same sound in one buffer
+		std::vector<int8_t> Whole(Header);
+		Whole.insert(Whole.end(), Data.begin(), Data.end());
+
+		// Reads a whole file
+		auto ReadFile = [](const std::string& FileName)
+		{
+			auto Reader = BinaryReader();
+			Reader.Open(FileName);
+			uint64_t Size = 0;
+			auto Buffer = Reader.Read(Reader.GetLength(), Size);
+			std::vector<int8_t> Result(Buffer, Buffer + Size);
+			delete[] Buffer;
+			return Result;
+		};
+
+		// Encode both ways, they must match
+		bool Matches = Sound::ConvertSoundMemory(Whole.data(), Whole.size(), SoundFormat::WAV_WithHeader, "Tests/SoundWhole.flac", SoundFormat::Standard_FLAC);
+		Matches &= Sound::ConvertSoundMemory(Header.data(), Header.size(), Data.data(), Data.size(), SoundFormat::WAV_WithHeader, "Tests/SoundSplit.flac", SoundFormat::Standard_FLAC);
+
+		auto Flac = ReadFile("Tests/SoundWhole.flac");
+		Matches &= (Flac == ReadFile("Tests/SoundSplit.flac"));
+
+		// Decode the FLAC split at a few points, reads must cross from the header to the data
+		for (size_t Split : { (size_t)4, (size_t)42, Flac.size() / 2 })
+		{
+			Matches &= Sound::ConvertSoundMemory(Flac.data(), Split, Flac.data() + Split, Flac.size() - Split, SoundFormat::FLAC_WithHeader, "Tests/SoundSplit.wav", SoundFormat::Standard_WAV);
+			Matches &= (ReadFile("Tests/SoundSplit.wav") == Whole);
+		}
+
+		// Validate
+		ASSERT_PRNT(Matches);
+	}
+
+#pragma endregion
+
+	// Sound stream writer test
+#pragma region Sound stream writer test
+
+	printf(":  [84]\t\tSound stream writer test... ");
+	{
+		// A stereo sound, written in blocks that don't divide it evenly
+		uint32_t FrameCount = 48000 * 2 + 123;
+		uint32_t BlockFrames = 960;
+
+		std::vector<int16_t> Samples(FrameCount * 2);
+		uint32_t Noise = 0x7654321;
+		for (uint32_t f = 0; f < FrameCount; f++)
+		{
+			Noise = Noise * 1664525 + 1013904223;
+			Samples[f * 2] = (int16_t)((int32_t)((f * 29) % 3000) - 1500 + (int32_t)(Noise >> 26));
+			Samples[f * 2 + 1] = (int16_t)(Noise >> 16);
+		}
+
+		// What the WAV must look like, the header with the real size then the samples
+		std::vector<int8_t> Expected(Sound::GetMaximumWAVHeaderSize());
+		Sound::WriteWAVHeaderToStream(Expected.data(), 48000, 2, FrameCount * 4);
+		Expected.insert(Expected.end(), (const int8_t*)Samples.data(), (const int8_t*)(Samples.data() + Samples.size()));
+
+		// Reads a whole file
+		auto ReadFile = [](const std::string& FileName)
+		{
+			auto Reader = BinaryReader();
+			Reader.Open(FileName);
+			uint64_t Size = 0;
+			auto Buffer = Reader.Read(Reader.GetLength(), Size);
+			std::vector<int8_t> Result(Buffer, Buffer + Size);
+			delete[] Buffer;
+			return Result;
+		};
+
+		// Streams the sound to a file, with a frame count estimate that's off
+		auto StreamSound = [&](const std::string& FileName, SoundFormat Format, uint64_t EstimatedFrames)
+		{
+			SoundStreamWriter Writer;
+			bool Result = Writer.Create(FileName, Format, 48000, 2, EstimatedFrames);
+
+			for (uint32_t f = 0; f < FrameCount; f += BlockFrames)
+				Result &= Writer.Write(Samples.data() + f * 2, std::min(BlockFrames, FrameCount - f));
+
+			return Writer.Close() && Result;
+		};
+
+		// The WAV header is fixed on close, whether the estimate was under or over
+		bool Matches = StreamSound("Tests/SoundStream.wav", SoundFormat::Standard_WAV, FrameCount - 5000);
+		Matches &= (ReadFile("Tests/SoundStream.wav") == Expected);
+		Matches &= StreamSound("Tests/SoundStream.wav", SoundFormat::Standard_WAV, FrameCount + 5000);
+		Matches &= (ReadFile("Tests/SoundStream.wav") == Expected);
+
+		// The FLAC decodes back to the same samples
+		for (uint64_t EstimatedFrames : { (uint64_t)FrameCount - 5000, (uint64_t)FrameCount + 5000 })
+		{
+			Matches &= StreamSound("Tests/SoundStream.flac", SoundFormat::Standard_FLAC, EstimatedFrames);
+
+			auto Flac = ReadFile("Tests/SoundStream.flac");
+			Matches &= Sound::ConvertSoundMemory(Flac.data(), Flac.size(), SoundFormat::FLAC_WithHeader, "Tests/SoundStream.wav", SoundFormat::Standard_WAV);
+			Matches &= (ReadFile("Tests/SoundStream.wav") == Expected);
+		}
+
+		// Validate
+		ASSERT_PRNT(Matches);
+	}
+
+#pragma endregion
+
+	// Mesh kernel test
+#pragma region Mesh kernel test
+
+	printf(":  [85]\t\tMesh kernel test... ");
+	{
+		// Random inputs, with counts that don't fill a whole batch of any kernel
+		uint32_t Noise = 0x2468ACE;
+		auto NextRandom = [&Noise]()
+		{
+			Noise = Noise * 1664525 + 1013904223;
+			return Noise;
+		};
+
+		const size_t VertexCount = 4099;
+		const size_t NormalStride = 20;
+
+		std::vector<uint64_t> PackedVertices(VertexCount);
+		for (auto& Packed : PackedVertices)
+			Packed = ((uint64_t)NextRandom() << 32) | NextRandom();
+
+		std::vector<uint8_t> PackedNormals(VertexCount * NormalStride);
+		for (auto& Packed : PackedNormals)
+			Packed = (uint8_t)(NextRandom() >> 24);
+
+		// Face tables, each with a random run of faces, index width, and base index
+		const size_t TableCount = 9;
+		std::vector<uint8_t> Tables(TableCount * 40);
+		std::vector<uint8_t> PackedIndices;
+		std::vector<uint16_t> Indices(TableCount * 256);
+		size_t FaceCount = 0;
+
+		for (auto& Index : Indices)
+			Index = (uint16_t)(NextRandom() >> 16);
+
+		for (size_t i = 0; i < TableCount; i++)
+		{
+			auto Table = Tables.data() + i * 40;
+			auto Count = (uint8_t)(1 + NextRandom() % 255);
+
+			*(uint32_t*)(Table + 28) = (uint32_t)(i * 256);
+			Table[34] = (uint8_t)(2 + NextRandom() % 254);
+			Table[35] = Count;
+			*(uint32_t*)(Table + 36) = (uint32_t)PackedIndices.size();
+
+			// Indices are at most 8 bits, with a byte after for reads that cross into it
+			for (size_t b = 0; b < (size_t)Count * 3 + 1; b++)
+				PackedIndices.push_back((uint8_t)(NextRandom() >> 24));
+
+			FaceCount += Count;
+		}
+
+		// Stop short of the last table's end
+		FaceCount -= 7;
+
+		// Everything a kernel decodes
+		struct DecodedMesh
+		{
+			std::vector<Vector3> Vertices;
+			std::vector<Vector3> NormalsA;
+			std::vector<Vector3> NormalsB;
+			std::vector<Vector3> NormalsC;
+			std::vector<uint32_t> Faces;
+		};
+
+		// Decodes the inputs with a kernel, the normals are read from an odd offset
+		auto DecodeMesh = [&](CoDXModelMeshKernel Kernel)
+		{
+			CoDXModelMeshHelper::SetKernel(Kernel);
+
+			DecodedMesh Result;
+			Result.Vertices.resize(VertexCount);
+			Result.NormalsA.resize(VertexCount);
+			Result.NormalsB.resize(VertexCount);
+			Result.NormalsC.resize(VertexCount);
+			Result.Faces.resize(FaceCount * 3);
+
+			CoDXModelMeshHelper::Unpack21BitVertices(PackedVertices.data(), VertexCount, 2.5f, Vector3(1.0f, -2.0f, 3.0f), Result.Vertices.data());
+			CoDXModelMeshHelper::UnpackNormalsA(PackedNormals.data() + 3, NormalStride, VertexCount, Result.NormalsA.data());
+			CoDXModelMeshHelper::UnpackNormalsB(PackedNormals.data() + 3, NormalStride, VertexCount, Result.NormalsB.data());
+			CoDXModelMeshHelper::UnpackNormalsC(PackedNormals.data() + 3, NormalStride, VertexCount, Result.NormalsC.data());
+			CoDXModelMeshHelper::UnpackFaceIndexBuffer(Tables.data(), TableCount, PackedIndices.data(), Indices.data(), FaceCount, Result.Faces.data());
+
+			return Result;
+		};
+
+		// The scalar kernel is the reference
+		auto Expected = DecodeMesh(CoDXModelMeshKernel::Scalar);
+		bool Matches = true;
+
+		// The face buffer must match the single face decoder
+		for (size_t f = 0; f < FaceCount; f++)
+		{
+			uint32_t Face[3];
+			CoDXModelMeshHelper::UnpackFaceIndices(Tables.data(), TableCount, PackedIndices.data(), Indices.data(), f, Face);
+			Matches &= (std::memcmp(Face, &Expected.Faces[f * 3], sizeof(Face)) == 0);
+		}
+
+		// Every kernel this cpu runs must match it bit for bit
+		for (auto Kernel : { CoDXModelMeshKernel::SSE2, CoDXModelMeshKernel::AVX2 })
+		{
+			if (Kernel > CoDXModelMeshHelper::GetSupportedKernel())
+				continue;
+
+			auto Result = DecodeMesh(Kernel);
+
+			Matches &= (std::memcmp(Result.Vertices.data(), Expected.Vertices.data(), VertexCount * sizeof(Vector3)) == 0);
+			Matches &= (std::memcmp(Result.NormalsA.data(), Expected.NormalsA.data(), VertexCount * sizeof(Vector3)) == 0);
+			Matches &= (std::memcmp(Result.NormalsB.data(), Expected.NormalsB.data(), VertexCount * sizeof(Vector3)) == 0);
+			Matches &= (std::memcmp(Result.NormalsC.data(), Expected.NormalsC.data(), VertexCount * sizeof(Vector3)) == 0);
+			Matches &= (std::memcmp(Result.Faces.data(), Expected.Faces.data(), FaceCount * 3 * sizeof(uint32_t)) == 0);
+		}
+
+		// Back to the best kernel
+		CoDXModelMeshHelper::SetKernel(CoDXModelMeshHelper::GetSupportedKernel());
+
+		// Validate
+		ASSERT_PRNT(Matches);
+	}
+
+#pragma endregion
+
+	// Mesh kernel bench
+#pragma region Mesh kernel bench
+
+	printf(":  [86]\t\tMesh kernel bench... ");
+	{
+		// A large mesh, 1M vertices with a 16 byte normal stride
+		const size_t VertexCount = 0x100000 + 3;
+		const size_t NormalStride = 16;
+
+		uint32_t Noise = 0x1357BDF;
+		std::vector<uint64_t> PackedVertices(VertexCount);
+		std::vector<uint8_t> PackedNormals(VertexCount * NormalStride);
+
+		for (auto& Packed : PackedVertices)
+		{
+			Noise = Noise * 1664525 + 1013904223;
+			Packed = ((uint64_t)Noise << 32) | (Noise ^ 0x5A5A5A5A);
+		}
+		for (auto& Packed : PackedNormals)
+		{
+			Noise = Noise * 1664525 + 1013904223;
+			Packed = (uint8_t)(Noise >> 24);
+		}
+
+		// The outputs, one for the reference, one for the kernel being timed
+		std::vector<Vector3> Expected(VertexCount * 2);
+		std::vector<Vector3> Output(VertexCount * 2);
+
+		// Decodes the vertices and normals a number of times
+		auto DecodeMesh = [&](uint32_t Rounds)
+		{
+			for (uint32_t r = 0; r < Rounds; r++)
+			{
+				CoDXModelMeshHelper::Unpack21BitVertices(PackedVertices.data(), VertexCount, 1.5f, Vector3(0.5f, 0.25f, -1.0f), Output.data());
+				CoDXModelMeshHelper::UnpackNormalsC(PackedNormals.data(), NormalStride, VertexCount, Output.data() + VertexCount);
+			}
+		};
+
+		// Times a kernel, then checks it against the reference, kernels this cpu can't run are skipped
+		bool Matches = true;
+		auto TimeKernel = [&](CoDXModelMeshKernel Kernel) -> long long
+		{
+			if (Kernel > CoDXModelMeshHelper::GetSupportedKernel())
+				return -1;
+
+			CoDXModelMeshHelper::SetKernel(Kernel);
+			auto Time = UnitTestTimer<>::ExecuteFunction(DecodeMesh, 8);
+
+			Matches &= (std::memcmp(Output.data(), Expected.data(), Output.size() * sizeof(Vector3)) == 0);
+			return (long long)Time;
+		};
+
+		// Build the reference
+		CoDXModelMeshHelper::SetKernel(CoDXModelMeshKernel::Scalar);
+		DecodeMesh(1);
+		Expected = Output;
+
+		// Time each kernel
+		auto ScalarTime = TimeKernel(CoDXModelMeshKernel::Scalar);
+		auto SSE2Time = TimeKernel(CoDXModelMeshKernel::SSE2);
+		auto AVX2Time = TimeKernel(CoDXModelMeshKernel::AVX2);
+
+		// Back to the best kernel
+		CoDXModelMeshHelper::SetKernel(CoDXModelMeshHelper::GetSupportedKernel());
+
+		// Report
+		printf("(scalar: %lldms, sse2: %lldms, avx2: %lldms) ", ScalarTime, SSE2Time, AVX2Time);
+
+		// Validate
+		ASSERT_PRNT(Matches);
+	}
+
+#pragma endregion
+
+	// Cast writer test
+#pragma region Cast writer test
+
+	printf(":  [87]\t\tCast writer test... ");
+	{
+		// A model with a mesh large enough to flush the writer mid node, and blend shapes first used out of order
+		WraithModel Model;
+		Model.BlendShapes = { "smile", "blink", "frown" };
+
+		for (auto i = 0; i < 3; i++)
+		{
+			auto& Bone = Model.AddBone();
+			Bone.TagName = Strings::Format("bone%d", i);
+			Bone.BoneParent = i - 1;
+		}
+
+		auto& Material = Model.AddMaterial();
+		Material.MaterialName = "cast_material";
+		Material.DiffuseMapName = "cast_diffuse.png";
+
+		uint32_t Noise = 0x1234567;
+		for (uint32_t m = 0; m < 2; m++)
+		{
+			auto& Mesh = Model.AddSubmesh();
+			Mesh.AddMaterial(0);
+
+			uint32_t VertexCount = (m == 0) ? 8 : 70000;
+			for (uint32_t v = 0; v < VertexCount; v++)
+			{
+				Noise = Noise * 1664525 + 1013904223;
+
+				auto& Vertex = Mesh.AddVertex();
+				Vertex.Position = Vector3((float)(Noise >> 20), (float)v, (float)m);
+				Vertex.AddUVLayer(0.0f, 1.0f);
+				Vertex.AddVertexWeight(v % 3, 1.0f);
+			}
+
+			// Every fifth face is degenerate, and skipped
+			for (uint32_t f = 0; f + 2 < VertexCount; f++)
+				Mesh.AddFace(f, f + 1, (f % 5 == 0) ? f : f + 2);
+		}
+
+		// Blink is used first, and frown only has a zero delta, so it isn't written
+		auto& ShapeMesh = Model.Submeshes[0];
+		ShapeMesh.Verticies[1].BlendShapeDeltas.emplace_back(1, Vector3(1, 0, 0));
+		ShapeMesh.Verticies[2].BlendShapeDeltas.emplace_back(0, Vector3(0, 2, 0));
+		ShapeMesh.Verticies[2].BlendShapeDeltas.emplace_back(2, Vector3(0, 0, 0));
+		ShapeMesh.Verticies[5].BlendShapeDeltas.emplace_back(1, Vector3(0, 0, 3));
+		ShapeMesh.Verticies[6].BlendShapeDeltas.emplace_back(0, Vector3(4, 0, 0));
+
+		// An animation with every kind of curve, and frames that need short indices
+		WraithAnim Anim;
+		Anim.FrameRate = 30.0f;
+		Anim.Looping = true;
+
+		for (uint32_t b = 0; b < 4; b++)
+		{
+			for (uint32_t i = 0; i < 20; i++)
+			{
+				if (b % 2 == 0)
+					Anim.AddTranslationKey(Strings::Format("bone%d", b), i * (b + 1) * 10, (float)i, 0, 0);
+				Anim.AddRotationKey(Strings::Format("bone%d", b), i, 0, 0, 0, 1);
+			}
+		}
+
+		Anim.AddBoneModifier("bone1", WraithAnimationType::Additive);
+		Anim.AddNoteTrack("fire", 5);
+		Anim.AddNoteTrack("fire", 9);
+		Anim.AddBlendShapeKey("smile", 300, 1.0f, 0, 0);
+
+		Cast::ExportCastModel(Model, "Tests/CastTest.cast");
+		Cast::ExportCastAnim(Anim, "Tests/CastAnimTest.cast");
+
+		// A node read back from the file, with where each property's elements are
+		struct CastTestProperty
+		{
+			CastPropertyId Id;
+			uint64_t Offset;
+			uint32_t Elements;
+		};
+		struct CastTestNode
+		{
+			CastNodeId Id;
+			uint64_t Hash;
+			uint32_t PropertyCount;
+			uint32_t ChildCount;
+			std::map<std::string, CastTestProperty> Properties;
+		};
+
+		// Gets the size of a single element of a property, strings are sized by their terminator
+		auto GetElementSize = [](CastPropertyId Id) -> uint32_t
+		{
+			switch (Id)
+			{
+			case CastPropertyId::Byte: return 1;
+			case CastPropertyId::Short: return 2;
+			case CastPropertyId::Integer32: case CastPropertyId::Float: return 4;
+			case CastPropertyId::Integer64: case CastPropertyId::Double: case CastPropertyId::Vector2: return 8;
+			case CastPropertyId::Vector3: return 12;
+			case CastPropertyId::Vector4: return 16;
+			default: return 0;
+			}
+		};
+
+		// Reads a file back, walking every property and child, each node must span exactly its size
+		auto ReadCast = [&](const std::string& FileName, std::vector<uint8_t>& Data, std::vector<CastTestNode>& Nodes)
+		{
+			auto Reader = BinaryReader();
+			Reader.Open(FileName);
+			uint64_t Size = 0;
+			auto Buffer = Reader.Read(Reader.GetLength(), Size);
+			Data.assign(Buffer, Buffer + Size);
+			delete[] Buffer;
+
+			if (Data.size() < 16 || *(uint32_t*)Data.data() != 0x74736163 || *(uint32_t*)(Data.data() + 8) != 1)
+				return false;
+
+			std::function<bool(uint64_t&)> ReadNode = [&](uint64_t& Offset)
+			{
+				if (Offset + CastNodeHeaderSize > Data.size())
+					return false;
+
+				auto Start = Offset;
+				auto NodeSize = *(uint32_t*)(Data.data() + Offset + 4);
+
+				CastTestNode Node{};
+				Node.Id = (CastNodeId)*(uint32_t*)(Data.data() + Offset);
+				Node.Hash = *(uint64_t*)(Data.data() + Offset + 8);
+				Node.PropertyCount = *(uint32_t*)(Data.data() + Offset + 16);
+				Node.ChildCount = *(uint32_t*)(Data.data() + Offset + 20);
+				Offset += CastNodeHeaderSize;
+
+				for (uint32_t p = 0; p < Node.PropertyCount; p++)
+				{
+					if (Offset + 8 > Data.size())
+						return false;
+
+					CastTestProperty Property{};
+					Property.Id = (CastPropertyId)*(uint16_t*)(Data.data() + Offset);
+					auto NameLength = *(uint16_t*)(Data.data() + Offset + 2);
+					Property.Elements = *(uint32_t*)(Data.data() + Offset + 4);
+					Offset += 8;
+
+					if (Offset + NameLength > Data.size())
+						return false;
+
+					auto Name = std::string((const char*)Data.data() + Offset, NameLength);
+					Offset += NameLength;
+					Property.Offset = Offset;
+
+					if (Property.Id == CastPropertyId::String)
+						Offset += strnlen((const char*)Data.data() + Offset, (size_t)(Data.size() - Offset)) + 1;
+					else
+						Offset += (uint64_t)GetElementSize(Property.Id) * Property.Elements;
+
+					if (Offset > Data.size())
+						return false;
+
+					Node.Properties[Name] = Property;
+				}
+
+				auto ChildCount = Node.ChildCount;
+				Nodes.push_back(Node);
+
+				for (uint32_t c = 0; c < ChildCount; c++)
+				{
+					if (!ReadNode(Offset))
+						return false;
+				}
+
+				return (Offset - Start) == NodeSize;
+			};
+
+			uint64_t Offset = 16;
+			return ReadNode(Offset) && Offset == Data.size();
+		};
+
+		// Gets a string property
+		auto GetString = [](const std::vector<uint8_t>& Data, const CastTestNode& Node, const char* Name)
+		{
+			auto Property = Node.Properties.find(Name);
+			return (Property == Node.Properties.end()) ? std::string() : std::string((const char*)Data.data() + Property->second.Offset);
+		};
+
+		// Gets an index property, at whatever size it was written
+		auto GetIndices = [&](const std::vector<uint8_t>& Data, const CastTestNode& Node, const char* Name)
+		{
+			std::vector<uint32_t> Result;
+			auto Property = Node.Properties.find(Name);
+
+			if (Property == Node.Properties.end())
+				return Result;
+
+			auto ElementSize = GetElementSize(Property->second.Id);
+			for (uint32_t i = 0; i < Property->second.Elements; i++)
+			{
+				auto Element = Data.data() + Property->second.Offset + (uint64_t)i * ElementSize;
+				Result.push_back((ElementSize == 1) ? *Element : (ElementSize == 2) ? *(uint16_t*)Element : *(uint32_t*)Element);
+			}
+
+			return Result;
+		};
+
+		// Counts the nodes of a type
+		auto CountNodes = [](const std::vector<CastTestNode>& Nodes, CastNodeId Id)
+		{
+			return (uint32_t)std::count_if(Nodes.begin(), Nodes.end(), [Id](const CastTestNode& Node) { return Node.Id == Id; });
+		};
+
+		// The model, every size spans its node, and the counts match what was exported
+		std::vector<uint8_t> ModelData;
+		std::vector<CastTestNode> ModelNodes;
+		bool Matches = ReadCast("Tests/CastTest.cast", ModelData, ModelNodes);
+
+		Matches &= (ModelData.size() > 0x100000);
+		Matches &= (ModelNodes.size() == 14);
+		Matches &= (ModelNodes[0].Id == CastNodeId::Root && ModelNodes[0].ChildCount == 1);
+		Matches &= (ModelNodes[1].Id == CastNodeId::Model && ModelNodes[1].ChildCount == 6 && ModelNodes[1].PropertyCount == 0);
+		Matches &= (ModelNodes[2].Id == CastNodeId::Skeleton && ModelNodes[2].ChildCount == 3);
+		Matches &= (CountNodes(ModelNodes, CastNodeId::Bone) == 3 && ModelNodes[3].PropertyCount == 7);
+		Matches &= (ModelNodes[6].Id == CastNodeId::Material && ModelNodes[6].ChildCount == 3 && ModelNodes[6].PropertyCount == 5);
+		Matches &= (CountNodes(ModelNodes, CastNodeId::File) == 3);
+		Matches &= (ModelNodes[10].Id == CastNodeId::Mesh && ModelNodes[10].PropertyCount == 10);
+		Matches &= (ModelNodes[13].Id == CastNodeId::Mesh && ModelNodes[13].PropertyCount == 10);
+
+		// Faces skip the degenerates, and the large mesh needs 32 bit indices
+		if (Matches)
+		{
+			Matches &= (GetIndices(ModelData, ModelNodes[10], "f").size() == 12);
+			Matches &= (ModelNodes[13].Properties["f"].Id == CastPropertyId::Integer32);
+			Matches &= (ModelNodes[13].Properties["f"].Elements == 55998 * 3);
+		}
+
+		// The blend shapes, in the order they're first used, each vertex paired with its own delta
+		if (Matches)
+		{
+			auto& Blink = ModelNodes[11];
+			auto& Smile = ModelNodes[12];
+
+			Matches &= (Blink.Id == CastNodeId::BlendShape && Smile.Id == CastNodeId::BlendShape);
+			Matches &= (CountNodes(ModelNodes, CastNodeId::BlendShape) == 2);
+			Matches &= (GetString(ModelData, Blink, "n") == "blink" && GetString(ModelData, Smile, "n") == "smile");
+			Matches &= (*(uint64_t*)(ModelData.data() + Blink.Properties["b"].Offset) == ModelNodes[10].Hash);
+			Matches &= (*(uint64_t*)(ModelData.data() + Smile.Properties["b"].Offset) == ModelNodes[10].Hash);
+			Matches &= (GetIndices(ModelData, Blink, "vi") == std::vector<uint32_t>({ 1, 5 }));
+			Matches &= (GetIndices(ModelData, Smile, "vi") == std::vector<uint32_t>({ 2, 6 }));
+
+			auto BlinkPositions = (const Vector3*)(ModelData.data() + Blink.Properties["vp"].Offset);
+			auto SmilePositions = (const Vector3*)(ModelData.data() + Smile.Properties["vp"].Offset);
+
+			Matches &= (Blink.Properties["vp"].Elements == 2 && Smile.Properties["vp"].Elements == 2);
+			Matches &= (BlinkPositions[0] == ShapeMesh.Verticies[1].Position + Vector3(1, 0, 0));
+			Matches &= (BlinkPositions[1] == ShapeMesh.Verticies[5].Position + Vector3(0, 0, 3));
+			Matches &= (SmilePositions[0] == ShapeMesh.Verticies[2].Position + Vector3(0, 2, 0));
+			Matches &= (SmilePositions[1] == ShapeMesh.Verticies[6].Position + Vector3(4, 0, 0));
+		}
+
+		// The animation, two bones with translations, four with rotations, one override, one notetrack, and one blend shape curve
+		std::vector<uint8_t> AnimData;
+		std::vector<CastTestNode> AnimNodes;
+		Matches &= ReadCast("Tests/CastAnimTest.cast", AnimData, AnimNodes);
+
+		if (Matches)
+		{
+			Matches &= (AnimNodes.size() == 15);
+			Matches &= (AnimNodes[1].Id == CastNodeId::Animation && AnimNodes[1].ChildCount == 13 && AnimNodes[1].PropertyCount == 2);
+			Matches &= (CountNodes(AnimNodes, CastNodeId::Curve) == 11);
+			Matches &= (CountNodes(AnimNodes, CastNodeId::CurveModeOverride) == 1);
+			Matches &= (CountNodes(AnimNodes, CastNodeId::NotificationTrack) == 1);
+			Matches &= (GetIndices(AnimData, AnimNodes[13], "kb") == std::vector<uint32_t>({ 5, 9 }));
+
+			for (size_t i = 2; i < 13; i++)
+				Matches &= (AnimNodes[i].Id != CastNodeId::Curve || (AnimNodes[i].PropertyCount == 5 && AnimNodes[i].Properties["kb"].Elements == AnimNodes[i].Properties["kv"].Elements));
+
+			Matches &= (AnimNodes[4].Properties["kb"].Id == CastPropertyId::Byte && AnimNodes[5].Properties["kb"].Id == CastPropertyId::Short);
+			Matches &= (GetString(AnimData, AnimNodes[14], "kp") == "bs" && AnimNodes[14].Properties["kb"].Id == CastPropertyId::Short);
+		}
+
+		// Validate
+		ASSERT_PRNT(Matches);
+	}
+
 #pragma endregion
 
 	// Clean up
@@ -6,6 +6,7 @@
 CascFileSystem::CascFileSystem(const std::string& directory)
 {
     StorageHandle = NULL;
+    Directory = directory;
 
     auto asWStr = Strings::ToUnicodeString(directory);
 
@@ -49,6 +50,8 @@ HANDLE CascFileSystem::OpenFile(const std::string& fileName, const std::string&
     else
     {
         LastErrorCode = 0;
+
+        std::lock_guard<std::mutex> lock(HandleMutex);
         OpenHandles.push_back(result);
     }
 
@@ -146,6 +149,39 @@ size_t CascFileSystem::Size(HANDLE handle)
     return result;
 }
 
+bool CascFileSystem::GetFileInfo(const std::string& fileName, uint64_t& size, uint64_t& modifiedTime)
+{
+    size = 0;
+    modifiedTime = 0;
+
+    CASC_FIND_DATA findData{};
+    HANDLE fileHandle = CascFindFirstFile(StorageHandle, fileName.c_str(), &findData, NULL);
+
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        LastErrorCode = 0x345304;
+        return false;
+    }
+
+    size = findData.FileSize;
+    CascFindClose(fileHandle);
+
+    // Files within the storage have no times of their own, but any update rewrites the build info.
+    WIN32_FILE_ATTRIBUTE_DATA attributes{};
+    auto buildInfoPath = Directory + "\\.build.info";
+
+    if (!GetFileAttributesExA(buildInfoPath.c_str(), GetFileExInfoStandard, &attributes))
+    {
+        LastErrorCode = 0x345304;
+        return false;
+    }
+
+    modifiedTime = (uint64_t)attributes.ftLastWriteTime.dwLowDateTime | ((uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32);
+
+    LastErrorCode = 0;
+    return true;
+}
+
 size_t CascFileSystem::EnumerateFiles(const std::string& pattern, std::function<void(const std::string&, const size_t)> onFileFound)
 {
     size_t entriesConsumed = 0;
@@ -9,6 +9,7 @@ CoDAsset_t::CoDAsset_t() : WraithAsset()
     AssetPointer = 0;
     AssetLoadedIndex = 0;
     IsFileEntry = false;
+    IsArenaAsset = false;
 }
 
 CoDAsset_t::~CoDAsset_t()
@@ -34,18 +35,72 @@ bool CoDAsset_t::Compare(const CoDAsset_t* candidate, const AssetCompareMethod c
     return false;
 }
 
+AssetArena::AssetArena()
+{
+    // Defaults, the first allocation starts a block
+    BlockOffset = AssetArenaBlockSize;
+}
+
+AssetArena::~AssetArena()
+{
+    // Destroy the assets, the blocks are freed after
+    for (auto Asset : Assets)
+    {
+        Asset->~CoDAsset_t();
+    }
+}
+
+void* AssetArena::Allocate(size_t Size, size_t Alignment)
+{
+    // Align within the block
+    auto Offset = (BlockOffset + Alignment - 1) & ~(Alignment - 1);
+
+    // Start a new block if this doesn't fit, assets are far smaller than a block
+    if (Offset + Size > AssetArenaBlockSize)
+    {
+        Blocks.emplace_back(new uint8_t[AssetArenaBlockSize]);
+        Offset = 0;
+    }
+
+    // Bump
+    BlockOffset = Offset + Size;
+
+    // Return it
+    return Blocks.back().get() + Offset;
+}
+
+AssetList::AssetList()
+{
+    // Each list gets its own arena
+    Arena = std::make_unique<AssetArena>();
+}
+
 AssetPool::~AssetPool()
 {
-    // Clean up the assets
+    // Clean up the assets that weren't built in an arena
     for (auto Asset : LoadedAssets)
     {
-        // Clean it up
-        delete Asset;
+        // Clean it up, its arena handles it otherwise
+        if (!Asset->IsArenaAsset)
+            delete Asset;
     }
     // Clear
     LoadedAssets.clear();
     // Reset
     LoadedAssets.shrink_to_fit();
+    // Clean up the arenas, and the assets in them
+    Arenas.clear();
+}
+
+void AssetPool::Merge(AssetList& List)
+{
+    // Append the assets, in order
+    LoadedAssets.insert(LoadedAssets.end(), List.LoadedAssets.begin(), List.LoadedAssets.end());
+    // Take the arena
+    Arenas.push_back(std::move(List.Arena));
+    // The list no longer owns anything
+    List.LoadedAssets.clear();
+    List.Arena = std::make_unique<AssetArena>();
 }
 
 CoDAnim_t::CoDAnim_t()
@@ -480,7 +535,13 @@ XSound::XSound()
     // Defaults
     DataBuffer = nullptr;
     DataSize = 0;
+    DataView = nullptr;
+    HeaderSize = 0;
     DataType = SoundDataTypes::FLAC_WithHeader;
+    FrameRate = 0;
+    ChannelsCount = 0;
+    FrameCount = 0;
+    BlockHeaderSize = 2;
 }
 
 XSound::~XSound()
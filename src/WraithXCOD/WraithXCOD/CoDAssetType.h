@@ -1,6 +1,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <memory>
+#include <new>
 
 // We need the WraithAsset type
 #include "WraithAsset.h"
@@ -43,6 +46,8 @@ public:
 
     // Whether or not this is a file entry
     bool IsFileEntry;
+    // Whether or not this was built in an arena, which cleans it up
+    bool IsArenaAsset;
 
     // A pointer to the asset in memory
     uint64_t AssetPointer;
@@ -56,6 +61,65 @@ public:
     virtual bool Compare(const CoDAsset_t* candidate, const AssetCompareMethod compareMethod) const;
 };
 
+// The size of the blocks an asset arena allocates (1 MiB)
+constexpr size_t AssetArenaBlockSize = 0x100000;
+
+// A bump allocator that assets are built in, the assets are destroyed along with it
+class AssetArena
+{
+public:
+    AssetArena();
+    ~AssetArena();
+
+    // Arenas can't be copied
+    AssetArena(const AssetArena&) = delete;
+    AssetArena& operator=(const AssetArena&) = delete;
+
+    template <class T>
+    // Builds a new asset in the arena
+    T* Create()
+    {
+        // Build it in place
+        auto Result = new (Allocate(sizeof(T), alignof(T))) T();
+        // Mark it, so it's not deleted on its own
+        Result->IsArenaAsset = true;
+        // Keep track of it for clean up
+        Assets.push_back(Result);
+        // Return it
+        return Result;
+    }
+
+private:
+    // The blocks of memory
+    std::vector<std::unique_ptr<uint8_t[]>> Blocks;
+    // The offset within the last block
+    size_t BlockOffset;
+    // The assets built in the arena
+    std::vector<CoDAsset_t*> Assets;
+
+    // Allocates memory from the last block, starting a new one if need be
+    void* Allocate(size_t Size, size_t Alignment);
+};
+
+// A list of assets loaded on a single thread, along with the arena they were built in
+class AssetList
+{
+public:
+    AssetList();
+
+    template <class T>
+    // Builds a new asset in the list's arena, it must still be added to the list
+    T* Create()
+    {
+        return Arena->Create<T>();
+    }
+
+    // A list of loaded assets
+    std::vector<CoDAsset_t*> LoadedAssets;
+    // The arena the assets live in
+    std::unique_ptr<AssetArena> Arena;
+};
+
 // A class that represents an asset pool
 class AssetPool
 {
@@ -64,6 +128,13 @@ public:
 
     // A list of loaded assets
     std::vector<CoDAsset_t*> LoadedAssets;
+
+    // Appends the assets of a list, taking ownership of its arena
+    void Merge(AssetList& List);
+
+private:
+    // The arenas merged into this pool
+    std::vector<std::unique_ptr<AssetArena>> Arenas;
 };
 
 // -- Classes that extend general cod assets (models, animations, sounds, images, fx, etc)
@@ -527,6 +598,9 @@ struct XImageDDS
     ImagePatch ImagePatchType;
 };
 
+// The largest header a sound builds in front of its data, a WAV header (44 bytes), FLAC needs 42
+constexpr uint32_t XSoundMaxHeaderSize = 44;
+
 struct XSound
 {
     // Constructors
@@ -535,11 +609,27 @@ struct XSound
 
     // The sound data buffer
     int8_t* DataBuffer;
-    // The size of the sound buffer
+    // The size of the sound buffer, or of the data view if we have one
     uint32_t DataSize;
 
-    // The sound format, WAV/FLAC
+    // A view of the sound data owned elsewhere, such as a mapped sound bank, used in place of the data buffer
+    const int8_t* DataView;
+    // Keeps the memory behind the data view alive
+    std::shared_ptr<void> DataViewOwner;
+    // The header written before the data view, if the format needs one
+    int8_t HeaderBuffer[XSoundMaxHeaderSize];
+    // The size of the header
+    uint32_t HeaderSize;
+
+    // The sound format, WAV/FLAC/Opus
     SoundDataTypes DataType;
+
+    // The format of sounds decoded as they're written, such as Opus
+    uint32_t FrameRate;
+    uint32_t ChannelsCount;
+    uint32_t FrameCount;
+    // The size of the length before each encoded block, 2 or 4 bytes
+    uint32_t BlockHeaderSize;
 };
 
 // A class that represents a material asset
@@ -1,6 +1,9 @@
 #include "stdafx.h"
 #include "spdlog/spdlog.h"
 
+// We need the following std classes
+#include <chrono>
+
 // The class we are implementing
 #include "CoDAssets.h"
 
@@ -100,6 +103,8 @@ WraithNameIndex CoDAssets::StringCache;
 std::unique_ptr<ProcessReader> CoDAssets::GameInstance = nullptr;
 // Set the default logger pointer
 std::unique_ptr<TextWriter> CoDAssets::XAssetLogWriter = nullptr;
+// The asset log lock
+std::mutex CoDAssets::XAssetLogMutex;
 // The main runtime log
 std::shared_ptr<spdlog::logger> CoDAssets::Log = nullptr;
 
@@ -131,12 +136,24 @@ LoadStringHandler CoDAssets::GameStringHandler = nullptr;
 
 // Setup the cod mutex
 std::mutex CoDAssets::CodMutex;
+// Setup the export settings, parsed on first use
+std::shared_ptr<const CoDExportSettings> CoDAssets::ExportSettings = nullptr;
 
 // Setup counts
 std::atomic<uint32_t> CoDAssets::ExportedAssetsCount;
 std::atomic<uint32_t> CoDAssets::AssetsToExportCount;
 std::atomic<bool> CoDAssets::CanExportContinue;
 
+// Setup the image registry
+CoDImageRegistry CoDAssets::ImageRegistry;
+
+// Setup model format timings
+std::atomic<uint64_t> CoDAssets::ModelFormatTimes[CoDAssets::ModelFormatCount];
+std::atomic<uint32_t> CoDAssets::ModelFormatFiles[CoDAssets::ModelFormatCount];
+
+// The names of the model formats, in bit order
+static const char* ModelFormatNames[] = { "XModelExport", "XModelBin", "SMD", "OBJ", "Maya", "XNALara", "GLTF", "GLB", "SEModel", "Cast", "FBX" };
+
 // Setup export callbacks
 ExportProgressHandler CoDAssets::OnExportProgress = nullptr;
 ExportStatusHandler CoDAssets::OnExportStatus = nullptr;
@@ -488,6 +505,9 @@ FindGameResult CoDAssets::BeginGameMode()
             LoadGamePS();
         else
             LoadGame();
+
+        // Keep what loading read, if recording
+        SaveGameSnapshot();
     }
     else if (GameInstance != nullptr)
     {
@@ -541,6 +561,9 @@ FindGameResult CoDAssets::FindGame()
                     // Loaded set it up
                     GameID = GameInfo.GameID;
                     GameFlags = GameInfo.GameFlags;
+                    // Record the pages we read if requested, so the load and exports can be replayed without the game
+                    if (SettingsManager::GetSetting("recordsnapshot", "false") == "true")
+                        GameInstance->StartRecording();
                     // Attempt to locate game offsets
                     if (LocateGameInfo())
                     {
@@ -577,6 +600,8 @@ LoadGameResult CoDAssets::LoadGame()
         GameAssets.reset(new AssetPool());
         // Whether or not we loaded assets
         bool Success = false;
+        // Cache process reads while the pools are walked, one page read serves many small asset reads
+        ProcessReaderCacheScope ReadCache(GameInstance.get());
 
         // Create log, if desired
         if (SettingsManager::GetSetting("createxassetlog", "false") == "true")
@@ -671,6 +696,8 @@ LoadGameResult CoDAssets::LoadGamePS()
         GameAssets.reset(new AssetPool());
         // Whether or not we loaded assets
         bool Success = false;
+        // Cache process reads while the pools are walked, one page read serves many small asset reads
+        ProcessReaderCacheScope ReadCache(GameInstance.get());
 
         // Create log, if desired
         if (SettingsManager::GetSetting("createxassetlog", "false") == "true")
@@ -830,6 +857,11 @@ ps::XAsset64 CoDAssets::ParasyteRequest(const uint64_t& AssetPointer)
     return CoDAssets::GameInstance->Read<ps::XAsset64>(AssetPointer);
 }
 
+size_t CoDAssets::ParasyteBlockRequest(uint8_t* Buffer, uint64_t Address, size_t Size)
+{
+    return CoDAssets::GameInstance->Read(Buffer, Address, Size);
+}
+
 LoadGameFileResult CoDAssets::LoadFile(const std::string& FilePath)
 {
     // Setup the assets
@@ -920,6 +952,11 @@ LoadGameFileResult CoDAssets::LoadFile(const std::string& FilePath)
             GameFlags = SupportedGameFlags::Files;
         }
     }
+    else if (FileExt == ".wps")
+    {
+        // Replay a recorded game
+        return LoadSnapshot(FilePath);
+    }
     else if (FileExt == ".sabs" || FileExt == ".sabl")
     {
         // Pass off to SAB File Parser
@@ -972,21 +1009,79 @@ LoadGameFileResult CoDAssets::LoadFile(const std::string& FilePath)
     return LoadGameFileResult::InvalidFile;
 }
 
-ExportGameResult CoDAssets::ExportAsset(const CoDAsset_t* Asset)
+LoadGameFileResult CoDAssets::LoadSnapshot(const std::string& FilePath)
+{
+    // Map the snapshot, reads are replayed from it
+    GameInstance = std::make_unique<ProcessReader>();
+
+    if (GameInstance->OpenSnapshot(FilePath))
+    {
+        // Find the game that was recorded
+        auto ProcessName = FileSystems::GetFileName(GameInstance->GetProcessPath());
+
+        for (auto& GameInfo : GameProcessInfo)
+        {
+            // Compare name
+            if (_stricmp(ProcessName.c_str(), GameInfo.ProcessName) == 0)
+            {
+                // Loaded set it up
+                GameID = GameInfo.GameID;
+                GameFlags = GameInfo.GameFlags;
+
+                // Locate the game offsets, then load as we would from the game
+                if (LocateGameInfo() && LoadGame() == LoadGameResult::Success)
+                {
+                    // Success
+                    return LoadGameFileResult::Success;
+                }
+
+                break;
+            }
+        }
+    }
+
+    // Clean up
+    GameInstance.reset();
+    GameAssets.reset();
+
+    // Failed
+    return LoadGameFileResult::InvalidFile;
+}
+
+std::shared_ptr<const CoDExportSettings> CoDAssets::GetExportSettings()
+{
+    // Grab the current settings
+    auto Result = std::atomic_load(&ExportSettings);
+
+    // Parse them if this is the first use
+    if (Result == nullptr)
+        Result = RefreshExportSettings();
+
+    // Return it
+    return Result;
+}
+
+std::shared_ptr<const CoDExportSettings> CoDAssets::RefreshExportSettings()
+{
+    // Parse them, then swap them in, anyone holding the old settings keeps them alive
+    auto Result = CoDExportSettings::Load();
+    std::atomic_store(&ExportSettings, Result);
+
+    // Return it
+    return Result;
+}
+
+ExportGameResult CoDAssets::ExportAsset(const CoDAsset_t* Asset, const CoDExportSettings& Settings)
 {
     // Prepare to export the asset
-    auto ExportPath = BuildExportPath(Asset);
+    auto ExportPath = BuildExportPath(Asset, Settings);
     // Create it, if not exists
     FileSystems::CreateDirectory(ExportPath);
 
     // Build image export path
-    auto ImagesPath = (SettingsManager::GetSetting("global_images", "true") == "true") ? FileSystems::CombinePath(FileSystems::GetDirectoryName(ExportPath), "_images") : FileSystems::CombinePath(ExportPath, "_images");
+    auto ImagesPath = Settings.GlobalImages ? FileSystems::CombinePath(FileSystems::GetDirectoryName(ExportPath), "_images") : FileSystems::CombinePath(ExportPath, "_images");
     // Build images path
-    auto ImageRelativePath = (SettingsManager::GetSetting("global_images", "true") == "true") ? "..\\\\_images\\\\" : "_images\\\\";
-    // Build image ext
-    auto ImageExtension = "." + Strings::ToLower(SettingsManager::GetSetting("exportimg"));
-    // Build sound ext
-    auto SoundExtension = "." + Strings::ToLower(SettingsManager::GetSetting("exportsnd"));
+    auto ImageRelativePath = Settings.GlobalImages ? "..\\\\_images\\\\" : "_images\\\\";
 
     // Result
     auto Result = ExportGameResult::Success;
@@ -999,17 +1094,17 @@ ExportGameResult CoDAssets::ExportAsset(const CoDAsset_t* Asset)
         switch (Asset->AssetType)
         {
             // Export an animation
-            case WraithAssetType::Animation: {Result = ExportAnimationAsset((CoDAnim_t*)Asset, ExportPath); break;}
+            case WraithAssetType::Animation: {Result = ExportAnimationAsset((CoDAnim_t*)Asset, ExportPath, Settings); break;}
             // Export a model, combine the name of the model with the export path!
-            case WraithAssetType::Model: {Result = ExportModelAsset((CoDModel_t*)Asset, ExportPath, ImagesPath, ImageRelativePath, ImageExtension); break;}
+            case WraithAssetType::Model: {Result = ExportModelAsset((CoDModel_t*)Asset, ExportPath, ImagesPath, ImageRelativePath, Settings); break;}
             // Export an image
-            case WraithAssetType::Image: {Result = ExportImageAsset((CoDImage_t*)Asset, ExportPath, ImageExtension); break;}
+            case WraithAssetType::Image: {Result = ExportImageAsset((CoDImage_t*)Asset, ExportPath, Settings); break;}
             // Export a sound
-            case WraithAssetType::Sound: {Result = ExportSoundAsset((CoDSound_t*)Asset, ExportPath, CoDAssets::GameID == SupportedGames::WorldAtWar ? ".wav" : SoundExtension); break;}
+            case WraithAssetType::Sound: {Result = ExportSoundAsset((CoDSound_t*)Asset, ExportPath, CoDAssets::GameID == SupportedGames::WorldAtWar ? ".wav" : Settings.SoundExtension, Settings); break;}
             // Export a rawfile
-            case WraithAssetType::RawFile: {Result = ExportRawfileAsset((CoDRawFile_t*)Asset, ExportPath); break;}
+            case WraithAssetType::RawFile: {Result = ExportRawfileAsset((CoDRawFile_t*)Asset, ExportPath, Settings); break;}
             // Export a material
-            case WraithAssetType::Material: {Result = ExportMaterialAsset((CoDMaterial_t*)Asset, ExportPath, ImagesPath, ImageRelativePath, ImageExtension); break;}
+            case WraithAssetType::Material: {Result = ExportMaterialAsset((CoDMaterial_t*)Asset, ExportPath, ImagesPath, ImageRelativePath, Settings); break;}
         }
 // #ifndef _DEBUG
     }
@@ -1029,12 +1124,15 @@ ExportGameResult CoDAssets::ExportAsset(const CoDAsset_t* Asset)
 
 std::unique_ptr<WraithModel> CoDAssets::GetModelForPreview(const CoDModel_t* Model)
 {
+    // Cache process reads for the model
+    ProcessReaderCacheScope ReadCache(GameInstance.get());
+
     // Attempt to load the model
     auto GenericModel = CoDAssets::LoadGenericModelAsset(Model);
 
-    // If loaded, continue
+    // If loaded, continue, previews read the current settings without replacing the ones in-flight exports use, the streamed mesh is read with the same settings
     if (GenericModel != nullptr)
-        return CoDXModelTranslator::TranslateXModel(GenericModel, CoDXModelTranslator::CalculateBiggestLodIndex(GenericModel));
+        return CoDXModelTranslator::TranslateXModel(GenericModel, CoDXModelTranslator::CalculateBiggestLodIndex(GenericModel), *CoDExportSettings::Load());
 
     // Failed somehow
     return nullptr;
@@ -1042,11 +1140,11 @@ std::unique_ptr<WraithModel> CoDAssets::GetModelForPreview(const CoDModel_t* Mod
 
 std::string CoDAssets::GetHashedName(const std::string& type, const uint64_t hash)
 {
-    auto found = AssetNameCache.NameDatabase.find(hash & 0xFFFFFFFFFFFFFFF);
+    std::string found;
 
-    if (found != AssetNameCache.NameDatabase.end())
+    if (AssetNameCache.TryGetName(hash & 0xFFFFFFFFFFFFFFF, found))
     {
-        return found->second;
+        return found;
     }
 
     return Strings::Format("%s_%llx", type.c_str(), hash & 0xFFFFFFFFFFFFFFF);
@@ -1054,11 +1152,11 @@ std::string CoDAssets::GetHashedName(const std::string& type, const uint64_t has
 
 std::string CoDAssets::GetHashedString(const std::string& type, const uint64_t hash)
 {
-    auto found = StringCache.NameDatabase.find(hash);
+    std::string found;
 
-    if (found != StringCache.NameDatabase.end())
+    if (StringCache.TryGetName(hash, found))
     {
-        return found->second;
+        return found;
     }
 
     return Strings::Format("%s_%llx", type.c_str(), hash);
@@ -1286,7 +1384,7 @@ bool CoDAssets::LocateGameInfo()
     return false;
 }
 
-std::string CoDAssets::BuildExportPath(const CoDAsset_t* Asset)
+std::string CoDAssets::BuildExportPath(const CoDAsset_t* Asset, const CoDExportSettings& Settings)
 {
     // Build the export path
     auto ApplicationPath = FileSystems::CombinePath(FileSystems::GetApplicationPath(), "exported_files");
@@ -1335,7 +1433,7 @@ std::string CoDAssets::BuildExportPath(const CoDAsset_t* Asset)
         // Default directory, OR, Merged with path, check setting
         ApplicationPath = FileSystems::CombinePath(ApplicationPath, "sounds");
         // Check setting for merged paths
-        if (SettingsManager::GetSetting("keepsndpath", "true") == "true")
+        if (Settings.KeepSoundPath)
         {
             // Merge it
             ApplicationPath = FileSystems::CombinePath(ApplicationPath, ((CoDSound_t*)Asset)->FullPath);
@@ -1386,10 +1484,10 @@ std::unique_ptr<XAnim_t> CoDAssets::LoadGenericAnimAsset(const CoDAnim_t* Animat
     return nullptr;
 }
 
-ExportGameResult CoDAssets::ExportAnimationAsset(const CoDAnim_t* Animation, const std::string& ExportPath)
+ExportGameResult CoDAssets::ExportAnimationAsset(const CoDAnim_t* Animation, const std::string& ExportPath, const CoDExportSettings& Settings)
 {
     // Quit if we should not export this model (files already exist)
-    if (!ShouldExportAnim(FileSystems::CombinePath(ExportPath, Animation->AssetName)))
+    if (!ShouldExportAnim(FileSystems::CombinePath(ExportPath, Animation->AssetName), Settings))
         return ExportGameResult::Success;
 
     // Prepare to export the animation
@@ -1407,25 +1505,23 @@ ExportGameResult CoDAssets::ExportAnimationAsset(const CoDAnim_t* Animation, con
             // Prepare to export to the formats specified in settings
 
             // Check for DirectXAnim format
-            if (SettingsManager::GetSetting("export_directxanim") == "true")
+            if (Settings.HasAnimFormat(CoDAnimExportFormat::DirectXAnim))
             {
-                // Determine export file version
-                auto XAnimVer = (SettingsManager::GetSetting("directxanim_ver") == "17") ? XAnimRawVersion::WorldAtWar : XAnimRawVersion::BlackOps;
                 // Export a XAnim Raw
-                XAnimRaw::ExportXAnimRaw(*Result.get(), FileSystems::CombinePath(ExportPath, Result->AssetName), XAnimVer);
+                XAnimRaw::ExportXAnimRaw(*Result.get(), FileSystems::CombinePath(ExportPath, Result->AssetName), Settings.DirectXAnimVersion);
             }
 
             // The following formats are scaled
             Result->ScaleAnimation(2.54f);
 
             // Check for SEAnim format
-            if (SettingsManager::GetSetting("export_seanim") == "true")
+            if (Settings.HasAnimFormat(CoDAnimExportFormat::SEAnim))
             {
                 // Export a SEAnim
                 SEAnim::ExportSEAnim(*Result.get(), FileSystems::CombinePath(ExportPath, Result->AssetName + ".seanim"));
             }
             // Check for Cast format
-            if (SettingsManager::GetSetting("export_castanim") == "true")
+            if (Settings.HasAnimFormat(CoDAnimExportFormat::Cast))
             {
                 // Export a Cast
                 Cast::ExportCastAnim(*Result.get(), FileSystems::CombinePath(ExportPath, Result->AssetName + ".cast"));
@@ -1478,70 +1574,64 @@ std::unique_ptr<XModel_t> CoDAssets::LoadGenericModelAsset(const CoDModel_t* Mod
     return nullptr;
 }
 
-bool CoDAssets::ShouldExportAnim(std::string ExportPath)
+bool CoDAssets::ShouldExportAnim(std::string ExportPath, const CoDExportSettings& Settings)
 {
-    // Check if we want to skip previous anims
-    auto SkipPrevAnims = SettingsManager::GetSetting("skipprevanim") == "true";
-
     // If we don't want to skip previously exported anims, then we will continue
-    if (!SkipPrevAnims)
+    if (!Settings.SkipPreviousAnims)
         return true;
 
     // Initialize result
     bool Result = false;
 
     // Check it
-    if (SettingsManager::GetSetting("export_directxanim") == "true" && !FileSystems::FileExists(ExportPath))
+    if (Settings.HasAnimFormat(CoDAnimExportFormat::DirectXAnim) && !FileSystems::FileExists(ExportPath))
         Result = true;
     // Check it
-    if (SettingsManager::GetSetting("export_seanim") == "true" && !FileSystems::FileExists(ExportPath + ".seanim"))
+    if (Settings.HasAnimFormat(CoDAnimExportFormat::SEAnim) && !FileSystems::FileExists(ExportPath + ".seanim"))
         Result = true;
     // Check it
-    if (SettingsManager::GetSetting("export_castanim") == "true" && !FileSystems::FileExists(ExportPath + ".cast"))
+    if (Settings.HasAnimFormat(CoDAnimExportFormat::Cast) && !FileSystems::FileExists(ExportPath + ".cast"))
         Result = true;
 
     // Done
     return Result;
 }
 
-bool CoDAssets::ShouldExportModel(std::string ExportPath)
+bool CoDAssets::ShouldExportModel(std::string ExportPath, const CoDExportSettings& Settings)
 {
-    // Check if we want to skip previous models
-    auto SkipPrevModels = SettingsManager::GetSetting("skipprevmodel") == "true";
-
     // If we don't want to skip previously exported models, then we will continue
-    if (!SkipPrevModels)
+    if (!Settings.SkipPreviousModels)
         return true;
 
     // Initialize result
     bool Result = false;
 
     // Check it
-    if (SettingsManager::GetSetting("export_xmexport") == "true" && !FileSystems::FileExists(ExportPath + ".XMODEL_EXPORT"))
+    if (Settings.HasModelFormat(CoDModelExportFormat::XModelExport) && !FileSystems::FileExists(ExportPath + ".XMODEL_EXPORT"))
         Result = true;
     // Check it
-    if (SettingsManager::GetSetting("export_smd") == "true" && !FileSystems::FileExists(ExportPath + ".smd"))
+    if (Settings.HasModelFormat(CoDModelExportFormat::SMD) && !FileSystems::FileExists(ExportPath + ".smd"))
         Result = true;
     // Check it
-    if (SettingsManager::GetSetting("export_obj") == "true" && !FileSystems::FileExists(ExportPath + ".obj"))
+    if (Settings.HasModelFormat(CoDModelExportFormat::OBJ) && !FileSystems::FileExists(ExportPath + ".obj"))
         Result = true;
     // Check it
-    if (SettingsManager::GetSetting("export_ma") == "true" && !FileSystems::FileExists(ExportPath + ".ma"))
+    if (Settings.HasModelFormat(CoDModelExportFormat::Maya) && !FileSystems::FileExists(ExportPath + ".ma"))
         Result = true;
     // Check it
-    if (SettingsManager::GetSetting("export_xna") == "true" && !FileSystems::FileExists(ExportPath + ".mesh.ascii"))
+    if (Settings.HasModelFormat(CoDModelExportFormat::XNALara) && !FileSystems::FileExists(ExportPath + ".mesh.ascii"))
         Result = true;
     // Check it
-    if (SettingsManager::GetSetting("export_semodel") == "true" && !FileSystems::FileExists(ExportPath + ".semodel"))
+    if (Settings.HasModelFormat(CoDModelExportFormat::SEModel) && !FileSystems::FileExists(ExportPath + ".semodel"))
         Result = true;
     // Check it
-    if (SettingsManager::GetSetting("export_gltf") == "true" && !FileSystems::FileExists(ExportPath + ".gltf"))
+    if (Settings.HasModelFormat(CoDModelExportFormat::GLTF) && !FileSystems::FileExists(ExportPath + ".gltf"))
         Result = true;
     // Check it
-    if (SettingsManager::GetSetting("export_glb") == "true" && !FileSystems::FileExists(ExportPath + ".glb"))
+    if (Settings.HasModelFormat(CoDModelExportFormat::GLB) && !FileSystems::FileExists(ExportPath + ".glb"))
         Result = true;
     // Check it
-    if (SettingsManager::GetSetting("export_castmdl") == "true" && !FileSystems::FileExists(ExportPath + ".cast"))
+    if (Settings.HasModelFormat(CoDModelExportFormat::Cast) && !FileSystems::FileExists(ExportPath + ".cast"))
         Result = true;
     //// Check it
     //if (SettingsManager::GetSetting("export_fbx") == "true" && !FileSystems::FileExists(ExportPath + ".fbx"))
@@ -1551,46 +1641,24 @@ bool CoDAssets::ShouldExportModel(std::string ExportPath)
     return Result;
 }
 
-ExportGameResult CoDAssets::ExportModelAsset(const CoDModel_t* Model, const std::string& ExportPath, const std::string& ImagesPath, const std::string& ImageRelativePath, const std::string& ImageExtension)
+ExportGameResult CoDAssets::ExportModelAsset(const CoDModel_t* Model, const std::string& ExportPath, const std::string& ImagesPath, const std::string& ImageRelativePath, const CoDExportSettings& Settings)
 {
     // Prepare to export the model
     std::unique_ptr<XModel_t> GenericModel = CoDAssets::LoadGenericModelAsset(Model);
-    // Grab the image format type
-    auto ImageFormatType = ImageFormat::Standard_PNG;
-    // Check setting
-    auto ImageSetting = SettingsManager::GetSetting("exportimg", "PNG");
-    // Check if we even need images
-    auto ExportImages = SettingsManager::GetSetting("exportmodelimg") == "true";
-    // Check if we want image names
-    auto ExportImageNames = SettingsManager::GetSetting("exportimgnames") == "true";
-    // Check if we want material folders
-    auto ExportMaterialFolders = SettingsManager::GetSetting("mdlmtlfolders") == "true";
-
 
     // Only create if Model Images are enabled
-    if (ExportImages)
+    if (Settings.ExportModelImages)
     {
         // Create if not exists
         FileSystems::CreateDirectory(ImagesPath);
     }
 
-    // Check it
-    if (ImageSetting == "DDS")
-    {
-        ImageFormatType = ImageFormat::DDS_WithHeader;
-    }
-    else if (ImageSetting == "TGA")
-    {
-        ImageFormatType = ImageFormat::Standard_TGA;
-    }
-    else if (ImageSetting == "TIFF")
-    {
-        ImageFormatType = ImageFormat::Standard_TIFF;
-    }
-
     // Check
     if (GenericModel != nullptr)
     {
+        // Images are decoded and written while we translate the model, waits before we return
+        CoDXConverterGroup ImageGroup;
+
         // Prepare material images
         for (auto& LOD : GenericModel->ModelLods)
         {
@@ -1601,7 +1669,7 @@ ExportGameResult CoDAssets::ExportModelAsset(const CoDModel_t* Model, const std:
                 auto CompleteImageRelativePath = ImageRelativePath;
 
                 // Check if we want material folders
-                if (ExportMaterialFolders && ExportImages)
+                if (Settings.ModelMaterialFolders && Settings.ExportModelImages)
                 {
                     // Create a new Folder
                     CompleteImagesPath = FileSystems::CombinePath(ImagesPath, Material.MaterialName);
@@ -1611,28 +1679,33 @@ ExportGameResult CoDAssets::ExportModelAsset(const CoDModel_t* Model, const std:
                 }
 
                 // Export image names if needed
-                if (ExportImageNames)
+                if (Settings.ExportImageNames)
                 {
                     // Process Image Names
                     ExportMaterialImageNames(Material, ExportPath);
                 }
-                if (ExportImages)
+                if (Settings.ExportModelImages)
                 {
                     // Process the material
-                    ExportMaterialImages(Material, CompleteImagesPath, ImageExtension, ImageFormatType);
+                    ExportMaterialImages(Material, CompleteImagesPath, Settings, &ImageGroup);
                 }
 
                 // Apply image paths
                 for (auto& Image : Material.Images)
                 {
                     // Append the relative path and image extension here, since we are done with these images
-                    Image.ImageName = CompleteImageRelativePath + Image.ImageName + ImageExtension;
+                    Image.ImageName = CompleteImageRelativePath + Image.ImageName + Settings.ImageExtension;
                 }
             }
         }
 
+        // Lods are translated and each format is written in parallel, waits before we return
+        CoDXConverterGroup ModelGroup;
+        // Whether or not a lod failed to translate
+        std::atomic<bool> TranslateFailed(false);
+
         // Determine lod export type
-        if (SettingsManager::GetSetting("exportalllods") == "true")
+        if (Settings.ExportAllLods)
         {
             // We should export all loaded lods from this xmodel
             auto LodCount = (uint32_t)GenericModel->ModelLods.size();
@@ -1641,25 +1714,38 @@ ExportGameResult CoDAssets::ExportModelAsset(const CoDModel_t* Model, const std:
             for (uint32_t i = 0; i < LodCount; i++)
             {
                 // Continue if we should not export this model (files already exist)
-                if (ShouldExportModel(FileSystems::CombinePath(ExportPath, Model->AssetName + Strings::Format("_LOD%d", i))))
+                if (ShouldExportModel(FileSystems::CombinePath(ExportPath, Model->AssetName + Strings::Format("_LOD%d", i)), Settings))
                 {
-                    // Translate generic model to a WraithModel, then export
-                    auto Result = CoDXModelTranslator::TranslateXModel(GenericModel, i);
-
-                    // Apply lod name
-                    Result->AssetName += Strings::Format("_LOD%d", i);
-
-                    // Check result and export
-                    if (Result != nullptr)
-                    {
-                        // Send off to exporter
-                        ExportWraithModel(Result, ExportPath);
-                    }
-                    else
+                    // Each lod is translated on its own, the generic model is only read from
+                    ModelGroup.Run(CoDXConverterStage::Translate, [i, &GenericModel, &ExportPath, &Settings, &ModelGroup, &TranslateFailed]
                     {
-                        // We failed
-                        return ExportGameResult::UnknownError;
-                    }
+                        // The translated lod, if any
+                        std::shared_ptr<WraithModel> Result = nullptr;
+
+                        // Translate generic model to a WraithModel, workers don't pass errors on, so catch them here
+                        try
+                        {
+                            Result = CoDXModelTranslator::TranslateXModel(GenericModel, i, Settings);
+                        }
+                        catch (std::exception& ex)
+                        {
+                            CoDAssets::Log->error(ex.what());
+                        }
+
+                        // Check result and export
+                        if (Result != nullptr)
+                        {
+                            // Apply lod name
+                            Result->AssetName += Strings::Format("_LOD%d", i);
+                            // Send off to exporter
+                            ExportWraithModel(Result, ExportPath, Settings, &ModelGroup);
+                        }
+                        else
+                        {
+                            // We failed
+                            TranslateFailed = true;
+                        }
+                    });
                 }
             }
         }
@@ -1675,25 +1761,24 @@ ExportGameResult CoDAssets::ExportModelAsset(const CoDModel_t* Model, const std:
                 std::string LodIndexSuffix = "_LOD0";
 
                 // If we are using the "match game lod index" setting
-                if (SettingsManager::GetSetting("match_game_lod_index", "false") == "true")
+                if (Settings.MatchGameLodIndex)
                 {
                     LodIndexSuffix = Strings::Format("_LOD%d", BiggestLodIndex);
                 }
 
                 // Check if we should not export this model (files already exist)
-                if (ShouldExportModel(FileSystems::CombinePath(ExportPath, Model->AssetName + LodIndexSuffix)))
+                if (ShouldExportModel(FileSystems::CombinePath(ExportPath, Model->AssetName + LodIndexSuffix), Settings))
                 {
                     // Translate generic model to a WraithModel, then export
-                    const auto Result = CoDXModelTranslator::TranslateXModel(GenericModel, BiggestLodIndex);
-
-                    // Apply lod name (_LODx)
-                    Result->AssetName += LodIndexSuffix;
+                    std::shared_ptr<WraithModel> Result = CoDXModelTranslator::TranslateXModel(GenericModel, BiggestLodIndex, Settings);
 
                     // Check result and export
                     if (Result != nullptr)
                     {
+                        // Apply lod name (_LODx)
+                        Result->AssetName += LodIndexSuffix;
                         // Send off to exporter
-                        ExportWraithModel(Result, ExportPath);
+                        ExportWraithModel(Result, ExportPath, Settings, &ModelGroup);
                     }
                     else
                     {
@@ -1710,15 +1795,15 @@ ExportGameResult CoDAssets::ExportModelAsset(const CoDModel_t* Model, const std:
         }
 
         // Check whether or not to export the hitbox model
-        if (SettingsManager::GetSetting("exporthitbox") == "true")
+        if (Settings.ExportHitbox)
         {
             // The hitbox result, if any
-            std::unique_ptr<WraithModel> Result = nullptr;
+            std::shared_ptr<WraithModel> Result = nullptr;
             // Check the game
             switch (CoDAssets::GameID)
             {
             case SupportedGames::BlackOps3:
-            case SupportedGames::BlackOps: Result = CoDXModelTranslator::TranslateXModelHitbox(GenericModel); break;
+            case SupportedGames::BlackOps: Result = CoDXModelTranslator::TranslateXModelHitbox(GenericModel, Settings); break;
             }
 
             // Export if we have a reslt
@@ -1726,9 +1811,19 @@ ExportGameResult CoDAssets::ExportModelAsset(const CoDModel_t* Model, const std:
             {
                 // Export it
                 Result->AssetName += "_HITBOX";
-                ExportWraithModel(Result, ExportPath);
+                ExportWraithModel(Result, ExportPath, Settings, &ModelGroup);
             }
         }
+
+        // Wait for every lod and format
+        ModelGroup.Wait();
+
+        // Check if any lod failed
+        if (TranslateFailed)
+        {
+            // We failed
+            return ExportGameResult::UnknownError;
+        }
     }
     else
     {
@@ -1740,15 +1835,13 @@ ExportGameResult CoDAssets::ExportModelAsset(const CoDModel_t* Model, const std:
     return ExportGameResult::Success;
 }
 
-ExportGameResult CoDAssets::ExportImageAsset(const CoDImage_t* Image, const std::string& ExportPath, const std::string& ImageExtension)
+ExportGameResult CoDAssets::ExportImageAsset(const CoDImage_t* Image, const std::string& ExportPath, const CoDExportSettings& Settings)
 {
     // Grab the full image path, if it doesn't exist convert it!
-    auto FullImagePath = FileSystems::CombinePath(ExportPath, Image->AssetName + ImageExtension);
-    // Check if we want to skip previous images
-    auto SkipPrevImages = SettingsManager::GetSetting("skipprevimg") == "true";
+    auto FullImagePath = FileSystems::CombinePath(ExportPath, Image->AssetName + Settings.ImageExtension);
 
     // Check if it exists and if we want to skip it or not
-    if (!FileSystems::FileExists(FullImagePath) || !SkipPrevImages)
+    if (!FileSystems::FileExists(FullImagePath) || !Settings.SkipPreviousImages)
     {
         // Buffer for the image (Loaded via the global game handler)
         std::unique_ptr<XImageDDS> ImageData = nullptr;
@@ -1801,23 +1894,7 @@ ExportGameResult CoDAssets::ExportImageAsset(const CoDImage_t* Image, const std:
         }
 
         // Grab the image format type
-        auto ImageFormatType = ImageFormat::Standard_PNG;
-        // Check setting
-        auto ImageSetting = SettingsManager::GetSetting("exportimg", "PNG");
-
-        // Check it
-        if (ImageSetting == "DDS")
-        {
-            ImageFormatType = ImageFormat::DDS_WithHeader;
-        }
-        else if (ImageSetting == "TGA")
-        {
-            ImageFormatType = ImageFormat::Standard_TGA;
-        }
-        else if (ImageSetting == "TIFF")
-        {
-            ImageFormatType = ImageFormat::Standard_TIFF;
-        }
+        auto ImageFormatType = Settings.ImageFormatType;
 
         // Check if we got it
         if (ImageData != nullptr)
@@ -1852,15 +1929,13 @@ ExportGameResult CoDAssets::ExportImageAsset(const CoDImage_t* Image, const std:
     return ExportGameResult::Success;
 }
 
-ExportGameResult CoDAssets::ExportSoundAsset(const CoDSound_t* Sound, const std::string& ExportPath, const std::string& SoundExtension)
+ExportGameResult CoDAssets::ExportSoundAsset(const CoDSound_t* Sound, const std::string& ExportPath, const std::string& SoundExtension, const CoDExportSettings& Settings)
 {
     // Grab the full sound path, if it doesn't exist convert it!
     auto FullSoundPath = FileSystems::CombinePath(ExportPath, Sound->AssetName + SoundExtension);
-    // Check if we want to skip previous Sounds
-    auto SkipPrevSound = SettingsManager::GetSetting("skipprevsound") == "true";
 
     // Check if it exists
-    if (!FileSystems::FileExists(FullSoundPath) || !SkipPrevSound)
+    if (!FileSystems::FileExists(FullSoundPath) || !Settings.SkipPreviousSounds)
     {
         // Holds universal sound data
         std::unique_ptr<XSound> SoundData = nullptr;
@@ -1911,22 +1986,28 @@ ExportGameResult CoDAssets::ExportSoundAsset(const CoDSound_t* Sound, const std:
             break;
         }
 
-        // Grab the image format type
-        auto SoundFormatType = SoundFormat::Standard_WAV;
-        // Check setting
-        auto SoundSetting = SettingsManager::GetSetting("exportsnd", "WAV");
-
-        // Check it
-        if (SoundSetting == "FLAC")
-        {
-            SoundFormatType = SoundFormat::Standard_FLAC;
-        }
+        // Grab the sound format type, the job takes a copy
+        auto SoundFormatType = Settings.SoundFormatType;
+        auto CompressionLevel = Settings.FlacCompressionLevel;
 
         // Check if we got it
-        if (SoundData != nullptr)
+        if (SoundData == nullptr)
+            return ExportGameResult::Success;
+
+        // Whether or not the sound made it to disk
+        bool Written = false;
+
+        // Writes the sound, decoding or transcoding as needed
+        auto WriteSound = [&SoundData, &Written, &FullSoundPath, SoundFormatType, CompressionLevel]
         {
+            // Opus is decoded block by block straight into the output, on this thread's decoder
+            if (SoundData->DataType == SoundDataTypes::Opus_Interleaved)
+            {
+                // Decode it to the format we want, there's no transcode after
+                Written = SABSupport::WriteOpusInterleaved(*SoundData, FullSoundPath, SoundFormatType, CompressionLevel);
+            }
             // Check what format the DATA is, and see if we need to transcode
-            if (((SoundData->DataType == SoundDataTypes::FLAC_WithHeader && SoundFormatType == SoundFormat::Standard_FLAC) || SoundData->DataType == SoundDataTypes::WAV_WithHeader && SoundFormatType == SoundFormat::Standard_WAV) || CoDAssets::GameID == SupportedGames::WorldAtWar)
+            else if (((SoundData->DataType == SoundDataTypes::FLAC_WithHeader && SoundFormatType == SoundFormat::Standard_FLAC) || SoundData->DataType == SoundDataTypes::WAV_WithHeader && SoundFormatType == SoundFormat::Standard_WAV) || CoDAssets::GameID == SupportedGames::WorldAtWar)
             {
                 // We have an already-prepared sound buffer, just write it
                 // Since this can throw, wrap it in an exception handler
@@ -1936,8 +2017,24 @@ ExportGameResult CoDAssets::ExportSoundAsset(const CoDSound_t* Sound, const std:
                     auto Writer = BinaryWriter();
                     // Make the file
                     Writer.Create(FullSoundPath);
-                    // Write the Sound buffer
-                    Writer.Write((const int8_t*)SoundData->DataBuffer, SoundData->DataSize);
+
+                    // Check if the data is a view, if so, the header is written first
+                    if (SoundData->DataView != nullptr)
+                    {
+                        // Write the header, if we have one
+                        if (SoundData->HeaderSize > 0)
+                            Writer.Write((const int8_t*)SoundData->HeaderBuffer, SoundData->HeaderSize);
+                        // Write the Sound data, straight from the view
+                        Writer.Write(SoundData->DataView, SoundData->DataSize);
+                    }
+                    else
+                    {
+                        // Write the Sound buffer
+                        Writer.Write((const int8_t*)SoundData->DataBuffer, SoundData->DataSize);
+                    }
+
+                    // Done
+                    Written = true;
                 }
                 catch (...)
                 {
@@ -1948,9 +2045,25 @@ ExportGameResult CoDAssets::ExportSoundAsset(const CoDSound_t* Sound, const std:
             {
                 // We must convert it
                 auto InFormat = (SoundData->DataType == SoundDataTypes::FLAC_WithHeader) ? SoundFormat::FLAC_WithHeader : SoundFormat::WAV_WithHeader;
-                // Convert the asset
-                Sound::ConvertSoundMemory(SoundData->DataBuffer, SoundData->DataSize, InFormat, FullSoundPath, SoundFormatType);
+                // Convert the asset, streaming the samples through the encoder, views are read in place after the header
+                if (SoundData->DataView != nullptr)
+                    Written = Sound::ConvertSoundMemory(SoundData->HeaderBuffer, SoundData->HeaderSize, SoundData->DataView, SoundData->DataSize, InFormat, FullSoundPath, SoundFormatType, CompressionLevel);
+                else
+                    Written = Sound::ConvertSoundMemory(SoundData->DataBuffer, SoundData->DataSize, InFormat, FullSoundPath, SoundFormatType, CompressionLevel);
             }
+        };
+
+        // The write is a Write stage job, which workers drain first, so an idle worker can take it while the others keep loading
+        // We wait on it, so the asset's status is only set once the file is on disk
+        CoDXConverterGroup SoundGroup;
+        SoundGroup.Run(CoDXConverterStage::Write, WriteSound);
+        SoundGroup.Wait();
+
+        // Report a sound that failed to write
+        if (!Written)
+        {
+            CoDAssets::Log->error("Failed to write sound: {0}", FullSoundPath);
+            return ExportGameResult::UnknownError;
         }
     }
 
@@ -1958,32 +2071,32 @@ ExportGameResult CoDAssets::ExportSoundAsset(const CoDSound_t* Sound, const std:
     return ExportGameResult::Success;
 }
 
-ExportGameResult CoDAssets::ExportRawfileAsset(const CoDRawFile_t* Rawfile, const std::string& ExportPath)
+ExportGameResult CoDAssets::ExportRawfileAsset(const CoDRawFile_t* Rawfile, const std::string& ExportPath, const CoDExportSettings& Settings)
 {
     // Read from specific handler (By game)
     switch (CoDAssets::GameID)
     {
     case SupportedGames::BlackOps:
         // Send to generic translator, Black Ops does not compress the anim trees, but does compress the GSCs
-        CoDRawfileTranslator::TranslateRawfile(Rawfile, ExportPath, false, true);
+        CoDRawfileTranslator::TranslateRawfile(Rawfile, ExportPath, false, true, Settings);
         break;
     case SupportedGames::BlackOps2:
     case SupportedGames::BlackOps3:
     case SupportedGames::BlackOps4:
         // Send to generic translator, these games compress the anim trees
-        CoDRawfileTranslator::TranslateRawfile(Rawfile, ExportPath, true, false);
+        CoDRawfileTranslator::TranslateRawfile(Rawfile, ExportPath, true, false, Settings);
         break;
     case SupportedGames::ModernWarfare4:
         // Send to MW Raw File Extractor (SAB Files)
-        GameModernWarfare4::TranslateRawfile(Rawfile, ExportPath);
+        GameModernWarfare4::TranslateRawfile(Rawfile, ExportPath, Settings);
         break;
     case SupportedGames::ModernWarfare5:
         // Send to MW Raw File Extractor (SAB Files)
-        GameModernWarfare5::TranslateRawfile(Rawfile, ExportPath);
+        GameModernWarfare5::TranslateRawfile(Rawfile, ExportPath, Settings);
         break;
     case SupportedGames::Vanguard:
         // Send to VG Raw File Extractor (SAB Files)
-        GameVanguard::TranslateRawfile(Rawfile, ExportPath);
+        GameVanguard::TranslateRawfile(Rawfile, ExportPath, Settings);
         break;
     }
 
@@ -1991,27 +2104,8 @@ ExportGameResult CoDAssets::ExportRawfileAsset(const CoDRawFile_t* Rawfile, cons
     return ExportGameResult::Success;
 }
 
-ExportGameResult CoDAssets::ExportMaterialAsset(const CoDMaterial_t* Material, const std::string& ExportPath, const std::string& ImagesPath, const std::string& ImageRelativePath, const std::string& ImageExtension)
+ExportGameResult CoDAssets::ExportMaterialAsset(const CoDMaterial_t* Material, const std::string& ExportPath, const std::string& ImagesPath, const std::string& ImageRelativePath, const CoDExportSettings& Settings)
 {
-    // Grab the image format type
-    auto ImageFormatType = ImageFormat::Standard_PNG;
-    // Check setting
-    auto ImageSetting = SettingsManager::GetSetting("exportimg", "PNG");
-
-    // Check it
-    if (ImageSetting == "DDS")
-    {
-        ImageFormatType = ImageFormat::DDS_WithHeader;
-    }
-    else if (ImageSetting == "TGA")
-    {
-        ImageFormatType = ImageFormat::Standard_TGA;
-    }
-    else if (ImageSetting == "TIFF")
-    {
-        ImageFormatType = ImageFormat::Standard_TIFF;
-    }
-
     XMaterial_t XMaterial(0);
 
     // Attempt to load it based on game
@@ -2046,14 +2140,19 @@ ExportGameResult CoDAssets::ExportMaterialAsset(const CoDMaterial_t* Material, c
     // Process Image Names
     ExportMaterialImageNames(XMaterial, ExportPath);
     // Process the material
-    ExportMaterialImages(XMaterial, ExportPath, ImageExtension, ImageFormatType);
+    ExportMaterialImages(XMaterial, ExportPath, Settings);
 
     // Success, unless specific error
     return ExportGameResult::Success;
 }
 
-void CoDAssets::ExportWraithModel(const std::unique_ptr<WraithModel>& Model, const std::string& ExportPath)
+void CoDAssets::ExportWraithModel(std::shared_ptr<WraithModel> Model, const std::string& ExportPath, const CoDExportSettings& Settings, CoDXConverterGroup* Group)
 {
+    // Use the given group, or our own which waits before we return
+    CoDXConverterGroup LocalGroup;
+    // The group we are writing with
+    auto& WriteGroup = (Group != nullptr) ? *Group : LocalGroup;
+
     // Write Cosmetic List
     TextWriter Cosmetics;
     Cosmetics.Create(FileSystems::CombinePath(ExportPath, Model->AssetName + "_cosmetics.mel"));
@@ -2066,77 +2165,107 @@ void CoDAssets::ExportWraithModel(const std::unique_ptr<WraithModel>& Model, con
         }
     }
 
-    // Prepare to export to the formats specified in settings
+    // Prepare to export to the formats specified in settings, the following formats are written unscaled
+    const CoDModelExportFormat UnscaledFormats[] = { CoDModelExportFormat::XModelExport, CoDModelExportFormat::XModelBin, CoDModelExportFormat::SMD };
+    // The following formats are scaled (FBX is not written yet)
+    const CoDModelExportFormat ScaledFormats[] = { CoDModelExportFormat::OBJ, CoDModelExportFormat::Maya, CoDModelExportFormat::XNALara, CoDModelExportFormat::GLTF, CoDModelExportFormat::GLB, CoDModelExportFormat::SEModel, CoDModelExportFormat::Cast };
 
-    // Check for XME format
-    if (SettingsManager::GetSetting("export_xmexport") == "true")
-    {
-        // Export a XME file
-        CodXME::ExportXME(*Model.get(), FileSystems::CombinePath(ExportPath, Model->AssetName + ".XMODEL_EXPORT"));
-    }
-    // Check for XMB format
-    if (SettingsManager::GetSetting("export_xmbin") == "true")
-    {
-        // Export a XMB file
-        CodXMB::ExportXMB(*Model.get(), FileSystems::CombinePath(ExportPath, Model->AssetName + ".XMODEL_BIN"));
-    }
-    // Check for SMD format
-    if (SettingsManager::GetSetting("export_smd") == "true")
-    {
-        // Export a SMD file
-        ValveSMD::ExportSMD(*Model.get(), FileSystems::CombinePath(ExportPath, Model->AssetName + ".smd"));
-    }
+    // Check which sets we need
+    auto HasUnscaled = std::any_of(std::begin(UnscaledFormats), std::end(UnscaledFormats), [&Settings](CoDModelExportFormat Format) { return Settings.HasModelFormat(Format); });
+    auto HasScaled = std::any_of(std::begin(ScaledFormats), std::end(ScaledFormats), [&Settings](CoDModelExportFormat Format) { return Settings.HasModelFormat(Format); });
 
-    // The following formats are scaled
-    Model->ScaleModel(2.54f);
+    // When we need both sets, the unscaled formats get their own group, the scaled formats wait on it before the model is scaled in place
+    auto UnscaledGroup = (HasUnscaled && HasScaled) ? std::make_shared<CoDXConverterGroup>() : nullptr;
+    // The group the unscaled formats are written with
+    auto& UnscaledWriteGroup = (UnscaledGroup != nullptr) ? *UnscaledGroup : WriteGroup;
 
-    // Check for Obj format
-    if (SettingsManager::GetSetting("export_obj") == "true")
-    {
-        // Export a Obj file
-        WavefrontOBJ::ExportOBJ(*Model.get(), FileSystems::CombinePath(ExportPath, Model->AssetName + ".obj"));
-    }
-    // Check for Maya format
-    if (SettingsManager::GetSetting("export_ma") == "true")
+    // Queue the unscaled formats, the model is never modified while they are written
+    for (auto Format : UnscaledFormats)
     {
-        // Export a Maya file
-        Maya::ExportMaya(*Model.get(), FileSystems::CombinePath(ExportPath, Model->AssetName + ".ma"));
-    }
-    // Check for XNALara format
-    if (SettingsManager::GetSetting("export_xna") == "true")
-    {
-        // Export a XNALara file
-        XNALara::ExportXNA(*Model.get(), FileSystems::CombinePath(ExportPath, Model->AssetName + ".mesh.ascii"));
-    }
-    // Check for GLTF format
-    if (SettingsManager::GetSetting("export_gltf") == "true")
-    {
-        // Export a GLTF file
-        GLTF::ExportGLTF(*Model.get(), FileSystems::CombinePath(ExportPath, Model->AssetName + ".gltf"));
-    }
-    // Check for GLB format
-    if (SettingsManager::GetSetting("export_glb") == "true")
-    {
-        // Export a GLB file
-        GLTF::ExportGLTF(*Model.get(), FileSystems::CombinePath(ExportPath, Model->AssetName + ".glb"), false, true);
-    }
-    // Check for SEModel format
-    if (SettingsManager::GetSetting("export_semodel") == "true")
-    {
-        // Export a SEModel file
-        SEModel::ExportSEModel(*Model.get(), FileSystems::CombinePath(ExportPath, Model->AssetName + ".semodel"));
+        if (Settings.HasModelFormat(Format))
+        {
+            UnscaledWriteGroup.Run(CoDXConverterStage::Write, [Format, Model, ExportPath]
+            {
+                ExportModelFormat(Format, *Model, ExportPath);
+            });
+        }
     }
-    // Check for Cast format
-    if (SettingsManager::GetSetting("export_castmdl") == "true")
+
+    // Queue the scaled formats, the model is scaled in place once the unscaled formats are done reading it
+    if (HasScaled)
     {
-        // Export a Cast file
-        Cast::ExportCastModel(*Model.get(), FileSystems::CombinePath(ExportPath, Model->AssetName + ".cast"));
+        WriteGroup.Run(CoDXConverterStage::Translate, [Model, UnscaledGroup, ExportPath, &Settings, &WriteGroup, ScaledFormats]
+        {
+            // Wait for the unscaled formats, helping write them
+            if (UnscaledGroup != nullptr)
+                UnscaledGroup->Wait();
+
+            // Scale it
+            Model->ScaleModel(2.54f);
+
+            // Queue each format
+            for (auto Format : ScaledFormats)
+            {
+                if (Settings.HasModelFormat(Format))
+                {
+                    WriteGroup.Run(CoDXConverterStage::Write, [Format, Model, ExportPath]
+                    {
+                        ExportModelFormat(Format, *Model, ExportPath);
+                    });
+                }
+            }
+        });
     }
-    // Check for FBX format
-    if (SettingsManager::GetSetting("export_fbx") == "true")
+}
+
+void CoDAssets::ExportModelFormat(CoDModelExportFormat Format, const WraithModel& Model, const std::string& ExportPath)
+{
+    // Time the write
+    auto StartTime = std::chrono::steady_clock::now();
+    // The file name, without extension
+    auto FileName = FileSystems::CombinePath(ExportPath, Model.AssetName);
+
+    // Write the format
+    switch (Format)
+    {
+    case CoDModelExportFormat::XModelExport: CodXME::ExportXME(Model, FileName + ".XMODEL_EXPORT"); break;
+    case CoDModelExportFormat::XModelBin: CodXMB::ExportXMB(Model, FileName + ".XMODEL_BIN"); break;
+    case CoDModelExportFormat::SMD: ValveSMD::ExportSMD(Model, FileName + ".smd"); break;
+    case CoDModelExportFormat::OBJ: WavefrontOBJ::ExportOBJ(Model, FileName + ".obj"); break;
+    case CoDModelExportFormat::Maya: Maya::ExportMaya(Model, FileName + ".ma"); break;
+    case CoDModelExportFormat::XNALara: XNALara::ExportXNA(Model, FileName + ".mesh.ascii"); break;
+    case CoDModelExportFormat::GLTF: GLTF::ExportGLTF(Model, FileName + ".gltf"); break;
+    case CoDModelExportFormat::GLB: GLTF::ExportGLTF(Model, FileName + ".glb", false, true); break;
+    case CoDModelExportFormat::SEModel: SEModel::ExportSEModel(Model, FileName + ".semodel"); break;
+    case CoDModelExportFormat::Cast: Cast::ExportCastModel(Model, FileName + ".cast"); break;
+    // FBX::ExportFBX(Model, FileName + ".fbx");
+    default: return;
+    }
+
+    // Find the format's bit
+    unsigned long FormatIndex = 0;
+    _BitScanForward(&FormatIndex, (uint32_t)Format);
+
+    // Add the time taken
+    ModelFormatTimes[FormatIndex] += (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - StartTime).count();
+    ModelFormatFiles[FormatIndex]++;
+}
+
+void CoDAssets::LogModelFormatTimes()
+{
+    // Log each format we wrote
+    for (uint32_t i = 0; i < ModelFormatCount; i++)
     {
-        // Export an FBX file
-        // FBX::ExportFBX(*Model.get(), FileSystems::CombinePath(ExportPath, Model->AssetName + ".fbx"));
+        // Skip unused formats
+        if (ModelFormatFiles[i] == 0)
+            continue;
+
+        // Log it
+        CoDAssets::Log->info("Model format {0}: {1} files written in {2}ms.", ModelFormatNames[i], ModelFormatFiles[i].load(), ModelFormatTimes[i].load() / 1000);
+
+        // Reset for the next export
+        ModelFormatFiles[i] = 0;
+        ModelFormatTimes[i] = 0;
     }
 }
 
@@ -2161,6 +2290,28 @@ void CoDAssets::CleanupPackageCache()
         // Clean up
         OnDemandCache.reset();
     }
+
+    // Release the mapped sound bank, if any
+    SABSupport::CloseMappedBank();
+}
+
+void CoDAssets::SaveGameSnapshot()
+{
+    // Make sure we are recording
+    if (GameInstance == nullptr || !GameInstance->IsRecording())
+        return;
+
+    // Snapshots are named after the game, a newer recording replaces the last
+    auto SnapshotPath = FileSystems::CombinePath(FileSystems::GetApplicationPath(), "snapshots");
+    FileSystems::CreateDirectory(SnapshotPath);
+
+    auto SnapshotFile = FileSystems::CombinePath(SnapshotPath, FileSystems::GetFileNameWithoutExtension(GameInstance->GetProcessPath()) + ".wps");
+
+    // Save it
+    if (GameInstance->SaveRecording(SnapshotFile))
+        CoDAssets::Log->info("Saved process snapshot: {0}", SnapshotFile);
+    else
+        CoDAssets::Log->error("Failed to save process snapshot: {0}", SnapshotFile);
 }
 
 void CoDAssets::CleanUpGame()
@@ -2182,11 +2333,11 @@ void CoDAssets::CleanUpGame()
     GamePoolSizes.clear();
 
     // Clean up Bo4 Asset Cache
-    GameBlackOps4::AssetNameCache.NameDatabase.clear();
+    GameBlackOps4::AssetNameCache.Clear();
 
     // Clear global lists
-    AssetNameCache.NameDatabase.clear();
-    StringCache.NameDatabase.clear();
+    AssetNameCache.Clear();
+    StringCache.Clear();
 
     // Set load handler
     GameXImageHandler = nullptr;
@@ -2215,10 +2366,46 @@ void CoDAssets::LogXAsset(const std::string& Type, const std::string& Name)
 {
     if (XAssetLogWriter != nullptr && XAssetLogWriter->IsOpen())
     {
+        std::lock_guard<std::mutex> Lock(XAssetLogMutex);
         XAssetLogWriter->WriteLineFmt("%s,%s", Type.c_str(), Name.c_str());
     }
 }
 
+void CoDAssets::LoadAssetPools(const std::vector<CoDAssetPoolLoader>& Pools)
+{
+    // A list and time for each pool, so the merge order doesn't depend on which finishes first
+    std::vector<AssetList> Lists(Pools.size());
+    std::vector<uint64_t> Times(Pools.size());
+
+    // Load them, the converter waits for every pool as it goes out of scope
+    {
+        CoDXConverter Converter(std::max<uint32_t>(1, std::min<uint32_t>(CoDXConverter::CalculateDegreeOfParallelism(), (uint32_t)Pools.size())));
+
+        for (size_t i = 0; i < Pools.size(); i++)
+        {
+            Converter.Submit(CoDXConverterStage::Extract, [i, &Pools, &Lists, &Times]
+            {
+                // Time it
+                auto StartTime = std::chrono::steady_clock::now();
+                // Load it
+                Pools[i].Load(Lists[i]);
+                // Done
+                Times[i] = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - StartTime).count();
+            });
+        }
+    }
+
+    // Add them, in order
+    for (size_t i = 0; i < Pools.size(); i++)
+    {
+        // Log it
+        CoDAssets::Log->info("Loaded {0} {1} in {2}ms.", Lists[i].LoadedAssets.size(), Pools[i].Name, Times[i]);
+
+        // Merge it
+        GameAssets->Merge(Lists[i]);
+    }
+}
+
 void CoDAssets::ExportMaterialImageNames(const XMaterial_t& Material, const std::string& ExportPath)
 {
     // Try write the image name
@@ -2285,48 +2472,88 @@ void CoDAssets::ExportMaterialImageNames(const XMaterial_t& Material, const std:
     }
 }
 
-void CoDAssets::ExportMaterialImages(const XMaterial_t& Material, const std::string& ImagesPath, const std::string& ImageExtension, ImageFormat ImageFormatType)
+void CoDAssets::ExportMaterialImages(const XMaterial_t& Material, const std::string& ImagesPath, const CoDExportSettings& Settings, CoDXConverterGroup* Group)
 {
+    // If we weren't given a group, we use our own and wait for it before returning
+    CoDXConverterGroup LocalGroup;
+    // Resolve the group to use
+    auto& ImageGroup = (Group != nullptr) ? *Group : LocalGroup;
+    // Grab the image format type, the jobs take a copy
+    auto ImageFormatType = Settings.ImageFormatType;
+
     // Prepare to export material images
     for (auto& Image : Material.Images)
     {
         // Grab the full image path, if it doesn't exist convert it!
-        auto FullImagePath = FileSystems::CombinePath(ImagesPath, Image.ImageName + ImageExtension);
-        // Check if we want to skip previous images
-        auto SkipPrevImages = SettingsManager::GetSetting("skipprevimg") == "true";
+        auto FullImagePath = FileSystems::CombinePath(ImagesPath, Image.ImageName + Settings.ImageExtension);
+
+        // Skip it if another asset has already written it, or is writing it, this export
+        if (!ImageRegistry.TryClaim(FullImagePath))
+            continue;
+
         // Check if it exists
-        if (!FileSystems::FileExists(FullImagePath) || !SkipPrevImages)
+        if (!FileSystems::FileExists(FullImagePath) || !Settings.SkipPreviousImages)
         {
-            // Buffer for the image (Loaded via the global game handler)
-            std::unique_ptr<XImageDDS> ImageData = GameXImageHandler(Image);
-
-            // Check if we got it
-            if (ImageData != nullptr)
+            // Each image is independent, so fan them out, the image is copied as the caller may modify it
+            ImageGroup.Run(CoDXConverterStage::Decompress, [Image, FullImagePath, ImageFormatType, &ImageGroup]
             {
-                // Convert it to a file or just write the DDS data raw
-                if (ImageFormatType == ImageFormat::DDS_WithHeader)
+                // Buffer for the image (Loaded via the global game handler)
+                std::shared_ptr<XImageDDS> ImageData = nullptr;
+
+                // Since this can throw, wrap it in an exception handler, so the image can be tried again
+                try
                 {
-                    // Since this can throw, wrap it in an exception handler
-                    try
+                    ImageData = GameXImageHandler(Image);
+                }
+                catch (...)
+                {
+                    // Nothing, treat as not found
+                }
+
+                // Check if we got it
+                if (ImageData == nullptr)
+                {
+                    // Let the next asset that needs it try again
+                    ImageRegistry.Release(FullImagePath);
+                    return;
+                }
+
+                // Writing is queued separately, so decoding the next image can start on this worker
+                ImageGroup.Run(CoDXConverterStage::Write, [ImageData, FullImagePath, ImageFormatType]
+                {
+                    // Convert it to a file or just write the DDS data raw
+                    if (ImageFormatType == ImageFormat::DDS_WithHeader)
                     {
-                        // Just write the buffer
-                        auto Writer = BinaryWriter();
-                        // Make the file
-                        Writer.Create(FullImagePath);
-                        // Write the DDS buffer
-                        Writer.Write((const int8_t*)ImageData->DataBuffer, ImageData->DataSize);
+                        // Since this can throw, wrap it in an exception handler
+                        try
+                        {
+                            // Just write the buffer
+                            auto Writer = BinaryWriter();
+                            // Make the file
+                            Writer.Create(FullImagePath);
+                            // Write the DDS buffer
+                            Writer.Write((const int8_t*)ImageData->DataBuffer, ImageData->DataSize);
+                        }
+                        catch (...)
+                        {
+                            // Nothing, this means that something is already accessing the image
+                        }
                     }
-                    catch (...)
+                    else
                     {
-                        // Nothing, this means that something is already accessing the image
+                        // Convert it, this method is a nothrow
+                        Image::ConvertImageMemory(ImageData->DataBuffer, ImageData->DataSize, ImageFormat::DDS_WithHeader, FullImagePath, ImageFormatType, ImageData->ImagePatchType);
                     }
-                }
-                else
-                {
-                    // Convert it, this method is a nothrow
-                    Image::ConvertImageMemory(ImageData->DataBuffer, ImageData->DataSize, ImageFormat::DDS_WithHeader, FullImagePath, ImageFormatType, ImageData->ImagePatchType);
-                }
-            }
+
+                    // Done, nobody else needs to write it
+                    ImageRegistry.Complete(FullImagePath);
+                });
+            });
+        }
+        else
+        {
+            // Already on disk from a previous export
+            ImageRegistry.Complete(FullImagePath);
         }
     }
 }
@@ -2403,13 +2630,19 @@ void CoDAssets::ExportSelection(const std::vector<uint32_t>& Indicies, void* Cal
 
 void CoDAssets::ExportSelectedAssets(void* Caller, const std::unique_ptr<std::vector<CoDAsset_t*>>& Assets)
 {
-    // We must wait until the package cache is fully loaded before exporting
-    if (GamePackageCache != nullptr)
+    // Exports can start while the package cache is loading, objects from packages that aren't indexed yet wait on the load
+    if (GamePackageCache != nullptr && !GamePackageCache->HasCacheLoaded())
     {
-        // Wait for it to finish
-        GamePackageCache->WaitForPackageCacheLoad();
+        auto Progress = GamePackageCache->GetLoadProgress();
+        CoDAssets::Log->info("Package cache still loading, {0} of {1} packages parsed, {2} objects indexed.", Progress.PackagesParsed, Progress.PackagesTotal, Progress.EntriesIndexed);
     }
 
+    // Parse the settings once for the whole batch, workers share them without touching the settings manager
+    auto Settings = RefreshExportSettings();
+
+    // Images are only shared within an export, the next export checks the disk again
+    ImageRegistry.Clear();
+
     // At this point, all of the assets are loaded into the queue, we can do this in async
     // We are gonna set the popup directory here, either the game's export path, or single export path.
 
@@ -2417,7 +2650,7 @@ void CoDAssets::ExportSelectedAssets(void* Caller, const std::unique_ptr<std::ve
     if (Assets->size() == 1)
     {
         // Set from this one asset
-        LatestExportPath = BuildExportPath(Assets->at(0));
+        LatestExportPath = BuildExportPath(Assets->at(0), *Settings);
     }
     else if (Assets->size() > 0)
     {
@@ -2425,87 +2658,67 @@ void CoDAssets::ExportSelectedAssets(void* Caller, const std::unique_ptr<std::ve
         if (Assets->at(0)->AssetType == WraithAssetType::Model)
         {
             // Go back two
-            LatestExportPath = FileSystems::GetDirectoryName(FileSystems::GetDirectoryName(BuildExportPath(Assets->at(0))));
+            LatestExportPath = FileSystems::GetDirectoryName(FileSystems::GetDirectoryName(BuildExportPath(Assets->at(0), *Settings)));
         }
         else
         {
             // Go back one
-            LatestExportPath = FileSystems::GetDirectoryName(BuildExportPath(Assets->at(0)));
+            LatestExportPath = FileSystems::GetDirectoryName(BuildExportPath(Assets->at(0), *Settings));
         }
     }
 
-    // The asset index we're on
-    std::atomic<uint32_t> AssetIndex = 0;
-    // The assets we need to convert
-    uint32_t AssetsToConvert = (uint32_t)Assets->size();
-
-    // Detect the number of conversion threads
-    SYSTEM_INFO SystemInfo;
-    // Fetch system info
-    GetSystemInfo(&SystemInfo);
-    // Get count
-    auto NumberOfCores = SystemInfo.dwNumberOfProcessors;
-    
-#if _DEBUG
-    // Clamp it, no less than 1, no more than 3
-    auto DegreeOfConverter = 1;
-#else
-    // Clamp it, no less than 1, no more than 3
-    auto DegreeOfConverter = VectorMath::Clamp<uint32_t>(NumberOfCores, 1, 3);
-#endif
-    // Prepare to convert the assets in async
-    CoDXConverter([&AssetIndex, &Caller, &Assets, &AssetsToConvert]
-    {
-        // Begin the image thread
-        Image::SetupConversionThread();
-
-        // Loop until we've done all assets or, until we cancel
-        while (AssetIndex < AssetsToConvert && CoDAssets::CanExportContinue)
-        {
-            // Grab our index
-            auto AssetToConvert = AssetIndex++;
+    // Cache process reads for the whole batch, the cache is dropped when it finishes
+    ProcessReaderCacheScope ReadCache(GameInstance.get());
+    auto CacheHits = GameInstance != nullptr ? GameInstance->GetCacheHits() : 0;
+    auto CacheMisses = GameInstance != nullptr ? GameInstance->GetCacheMisses() : 0;
 
-            // Ensure still valid
-            if (AssetToConvert >= Assets->size())
-                continue;
+    // Spin up the converter, each worker sets up the image conversion thread state
+    CoDXConverter Converter(CoDXConverter::CalculateDegreeOfParallelism(), Image::SetupConversionThread, Image::DisableConversionThread);
 
-            // Get the asset we need
-            auto& Asset = Assets->at(AssetToConvert);
-            // Make sure it's not a placeholder
+    // Queue each asset, workers steal from each other so large assets don't stall the rest
+    for (auto& Asset : *Assets)
+    {
+        Converter.Submit(CoDXConverterStage::Extract, [Asset, Caller, Settings]
+        {
+            // Skip if we've been canceled, the job still counts towards progress
+            if (CoDAssets::CanExportContinue)
+            {
+                // Make sure it's not a placeholder
 #ifndef DEBUG
-            if (Asset->AssetStatus != WraithAssetStatus::Placeholder)
+                if (Asset->AssetStatus != WraithAssetStatus::Placeholder)
 #endif
-            {
-                // Set the status
-                Asset->AssetStatus = WraithAssetStatus::Processing;
-                // Report asset status
-                if (OnExportStatus != nullptr)
                 {
-                    OnExportStatus(Caller, Asset->AssetLoadedIndex);
-                }
+                    // Set the status
+                    Asset->AssetStatus = WraithAssetStatus::Processing;
+                    // Report asset status
+                    if (OnExportStatus != nullptr)
+                    {
+                        OnExportStatus(Caller, Asset->AssetLoadedIndex);
+                    }
 
-                // Export it
-                auto Result = ExportGameResult::UnknownError;
+                    // Export it
+                    auto Result = ExportGameResult::UnknownError;
 
-                // Export it
-                try
-                {
-                    CoDAssets::Log->info("Exporting: {0}...", Asset->AssetName);
-                    Result = CoDAssets::ExportAsset(Asset);
-                    CoDAssets::Log->info("Successfully exported: {0}", Asset->AssetName);
-                }
-                catch (std::exception& ex)
-                {
-                    CoDAssets::Log->error(ex.what());
-                }
+                    // Export it
+                    try
+                    {
+                        CoDAssets::Log->info("Exporting: {0}...", Asset->AssetName);
+                        Result = CoDAssets::ExportAsset(Asset, *Settings);
+                        CoDAssets::Log->info("Successfully exported: {0}", Asset->AssetName);
+                    }
+                    catch (std::exception& ex)
+                    {
+                        CoDAssets::Log->error(ex.what());
+                    }
 
 
-                // Set the status
-                Asset->AssetStatus = (Result == ExportGameResult::Success) ? WraithAssetStatus::Exported : WraithAssetStatus::Error;
-                // Report asset status
-                if (OnExportStatus != nullptr)
-                {
-                    OnExportStatus(Caller, Asset->AssetLoadedIndex);
+                    // Set the status
+                    Asset->AssetStatus = (Result == ExportGameResult::Success) ? WraithAssetStatus::Exported : WraithAssetStatus::Error;
+                    // Report asset status
+                    if (OnExportStatus != nullptr)
+                    {
+                        OnExportStatus(Caller, Asset->AssetLoadedIndex);
+                    }
                 }
             }
 
@@ -2517,11 +2730,34 @@ void CoDAssets::ExportSelectedAssets(void* Caller, const std::unique_ptr<std::ve
             {
                 OnExportProgress(Caller, (uint32_t)(((float)CoDAssets::ExportedAssetsCount / (float)CoDAssets::AssetsToExportCount) * 100.f));
             }
-        }
+        });
+    }
+
+    // Wait for everything, including any jobs the assets fanned out
+    Converter.WaitForIdle();
+
+    // Log how the work was spread
+    CoDAssets::Log->info("Export finished on {0} workers, {1} jobs stolen.", Converter.GetDegreeOfParallelism(), Converter.GetStolenJobs());
+
+    // Log where the model writing time went
+    LogModelFormatTimes();
 
-        // End image conversion thread
-        Image::DisableConversionThread();
+    // Log how many images were shared between assets
+    CoDAssets::Log->info("Images: {0} unique, {1} requests shared between assets.", ImageRegistry.GetClaimed(), ImageRegistry.GetSkipped());
 
-        // We are spinning up a maximum of 3 threads for conversion
-    }, DegreeOfConverter);
+    // Log how well the read cache did
+    if (GameInstance != nullptr)
+    {
+        CoDAssets::Log->info("Read cache: {0} hits, {1} pages read.", GameInstance->GetCacheHits() - CacheHits, GameInstance->GetCacheMisses() - CacheMisses);
+    }
+
+    // Keep what the export read, if recording
+    SaveGameSnapshot();
+
+    // Log how well the object cache did
+    if (CoDAssets::GamePackageCache != nullptr)
+    {
+        auto& ObjectCache = CoDAssets::GamePackageCache->GetObjectCache();
+        CoDAssets::Log->info("Object cache: {0} hits, {1} misses, {2} evicted.", ObjectCache.GetHits(), ObjectCache.GetMisses(), ObjectCache.GetEvictions());
+    }
 }
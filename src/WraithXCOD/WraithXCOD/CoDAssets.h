@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <memory>
 #include <atomic>
+#include <functional>
 
 // We need the following WraithX classes
 #include "ProcessReader.h"
@@ -15,8 +16,10 @@
 #include "CoDAssetType.h"
 #include "CoDPackageCache.h"
 #include "CoDXConverter.h"
+#include "CoDImageRegistry.h"
 #include "CoDCDNCache.h"
 #include "CoDCDNDownloader.h"
+#include "CoDExportSettings.h"
 
 // Parasyte
 #include "Parasyte.h"
@@ -125,6 +128,22 @@ struct CoDGameProcess
     }
 };
 
+// Represents a pool of assets to load, each pool is loaded in parallel with the others
+struct CoDAssetPoolLoader
+{
+    // The name of the assets in the pool, for logging
+    const char* Name;
+    // Loads the pool into the list
+    std::function<void(AssetList&)> Load;
+
+    CoDAssetPoolLoader(const char* PoolName, std::function<void(AssetList&)> LoadPool)
+    {
+        // Set data
+        Name = PoolName;
+        Load = std::move(LoadPool);
+    }
+};
+
 // A class that handles reading assets from COD games
 class CoDAssets
 {
@@ -138,6 +157,8 @@ public:
     static std::unique_ptr<ProcessReader> GameInstance;
     // The asset log, if any
     static std::unique_ptr<TextWriter> XAssetLogWriter;
+    // A lock for the asset log, pools are loaded in parallel
+    static std::mutex XAssetLogMutex;
     // The main runtime log
     static std::shared_ptr<spdlog::logger> Log;
     // The running game ID, if any
@@ -189,13 +210,19 @@ public:
     static LoadGameResult LoadGamePS();
     // Requests next XAsset
     static ps::XAsset64 ParasyteRequest(const uint64_t& AssetPointer);
+    // Reads a block of memory for batched pool parsing
+    static size_t ParasyteBlockRequest(uint8_t* Buffer, uint64_t Address, size_t Size);
     // Attempts to load assets from a file
     static LoadGameFileResult LoadFile(const std::string& FilePath);
+    // Attempts to load assets from a recorded process snapshot, as if the game were running
+    static LoadGameFileResult LoadSnapshot(const std::string& FilePath);
     // Cleans up a game if attached
     static void CleanUpGame();
 
     // Logs XAsset on LoadGame
     static void LogXAsset(const std::string& Type, const std::string& Name);
+    // Loads the pools in parallel, then adds their assets to the game assets in the order given, logging the time each took
+    static void LoadAssetPools(const std::vector<CoDAssetPoolLoader>& Pools);
 
     // -- Exporting functions
 
@@ -219,8 +246,13 @@ public:
     // The latest export path
     static std::string LatestExportPath;
 
+    // Gets the current export settings, parsing them if they haven't been yet
+    static std::shared_ptr<const CoDExportSettings> GetExportSettings();
+    // Parses the export settings again, exports already running keep the settings they started with
+    static std::shared_ptr<const CoDExportSettings> RefreshExportSettings();
+
     // Exports the game asset
-    static ExportGameResult ExportAsset(const CoDAsset_t* Asset);
+    static ExportGameResult ExportAsset(const CoDAsset_t* Asset, const CoDExportSettings& Settings);
 
     // Gets a model asset for previewing
     static std::unique_ptr<WraithModel> GetModelForPreview(const CoDModel_t* Model);
@@ -238,6 +270,9 @@ private:
     // Safely clean up the package cache if need be
     static void CleanupPackageCache();
 
+    // Saves the pages read from the game so far, if recording
+    static void SaveGameSnapshot();
+
     // Game generics, load generic assets of types
 
     // Loads a generic XAnim
@@ -248,38 +283,55 @@ private:
     // -- Game export utility functions, internal
 
     // Builds the export path for the asset
-    static std::string BuildExportPath(const CoDAsset_t* Asset);
+    static std::string BuildExportPath(const CoDAsset_t* Asset, const CoDExportSettings& Settings);
 
     // Determines whether we should continue with exporting this anim based off if it exists
-    static bool ShouldExportAnim(std::string ExportPath);
+    static bool ShouldExportAnim(std::string ExportPath, const CoDExportSettings& Settings);
     // Determines whether we should continue with exporting this model based off if it exists
-    static bool ShouldExportModel(std::string ExportPath);
+    static bool ShouldExportModel(std::string ExportPath, const CoDExportSettings& Settings);
 
     // Exports a game animation asset
-    static ExportGameResult ExportAnimationAsset(const CoDAnim_t* Animation, const std::string& ExportPath);
+    static ExportGameResult ExportAnimationAsset(const CoDAnim_t* Animation, const std::string& ExportPath, const CoDExportSettings& Settings);
     // Exports a game model asset
-    static ExportGameResult ExportModelAsset(const CoDModel_t* Model, const std::string& ExportPath, const std::string& ImagesPath, const std::string& ImageRelativePath, const std::string& ImageExtension);
+    static ExportGameResult ExportModelAsset(const CoDModel_t* Model, const std::string& ExportPath, const std::string& ImagesPath, const std::string& ImageRelativePath, const CoDExportSettings& Settings);
     // Exports a game image asset
-    static ExportGameResult ExportImageAsset(const CoDImage_t* Image, const std::string& ExportPath, const std::string& ImageExtension);
+    static ExportGameResult ExportImageAsset(const CoDImage_t* Image, const std::string& ExportPath, const CoDExportSettings& Settings);
     // Exports a game sound asset
-    static ExportGameResult ExportSoundAsset(const CoDSound_t* Sound, const std::string& ExportPath, const std::string& SoundExtension);
+    static ExportGameResult ExportSoundAsset(const CoDSound_t* Sound, const std::string& ExportPath, const std::string& SoundExtension, const CoDExportSettings& Settings);
     // Exports a game rawfile asset
-    static ExportGameResult ExportRawfileAsset(const CoDRawFile_t* Rawfile, const std::string& ExportPath);
+    static ExportGameResult ExportRawfileAsset(const CoDRawFile_t* Rawfile, const std::string& ExportPath, const CoDExportSettings& Settings);
     // Exports a game rawfile asset
-    static ExportGameResult ExportMaterialAsset(const CoDMaterial_t* Material, const std::string& ExportPath, const std::string& ImagesPath, const std::string& ImageRelativePath, const std::string& ImageExtension);
+    static ExportGameResult ExportMaterialAsset(const CoDMaterial_t* Material, const std::string& ExportPath, const std::string& ImagesPath, const std::string& ImageRelativePath, const CoDExportSettings& Settings);
 
     // Exports Material Image Names
     static void ExportMaterialImageNames(const XMaterial_t& Material, const std::string& ExportPath);
 
-    // Exports images from a specific game material
-    static void ExportMaterialImages(const XMaterial_t& Material, const std::string& ImagesPath, const std::string& ImageExtension, ImageFormat ImageFormatType);
+    // Exports images from a specific game material, queued on the group if given, otherwise waits for them
+    static void ExportMaterialImages(const XMaterial_t& Material, const std::string& ImagesPath, const CoDExportSettings& Settings, CoDXConverterGroup* Group = nullptr);
 
-    // Export a WraithModel to the various formats specified in settings
-    static void ExportWraithModel(const std::unique_ptr<WraithModel>& Model, const std::string& ExportPath);
+    // Export a WraithModel to the various formats specified in settings, each format is written in parallel, queued on the group if given, otherwise waits for them
+    static void ExportWraithModel(std::shared_ptr<WraithModel> Model, const std::string& ExportPath, const CoDExportSettings& Settings, CoDXConverterGroup* Group = nullptr);
+    // Writes a WraithModel in a single format, timing the write
+    static void ExportModelFormat(CoDModelExportFormat Format, const WraithModel& Model, const std::string& ExportPath);
+    // Logs the time spent writing each model format since the export began
+    static void LogModelFormatTimes();
 
     // Exports the asset in the list provided, in async
     static void ExportSelectedAssets(void* Caller, const std::unique_ptr<std::vector<CoDAsset_t*>>& Assets);
 
     // A locking mutex for proper async operations
     static std::mutex CodMutex;
+
+    // The current export settings, only swapped as a whole, through atomic loads and stores
+    static std::shared_ptr<const CoDExportSettings> ExportSettings;
+
+    // The images written during the current export, shared between all assets
+    static CoDImageRegistry ImageRegistry;
+
+    // The number of model formats, one per bit of the format mask
+    static const uint32_t ModelFormatCount = 11;
+    // The time spent writing each model format during the export, in microseconds
+    static std::atomic<uint64_t> ModelFormatTimes[ModelFormatCount];
+    // The number of files written in each model format during the export
+    static std::atomic<uint32_t> ModelFormatFiles[ModelFormatCount];
 };
\ No newline at end of file
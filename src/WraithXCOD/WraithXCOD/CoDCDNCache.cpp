@@ -8,13 +8,124 @@
 #include "BinaryWriter.h"
 #include "BinaryReader.h"
 
+// The magic of the CDN info file.
+constexpr uint32_t CoDCDNCacheMagic = 0x494E4443;
+// The original version, a full snapshot of the entries.
+constexpr uint32_t CoDCDNCacheSnapshotVersion = 1;
+// The current version, an append-only journal of entries.
+constexpr uint32_t CoDCDNCacheJournalVersion = 2;
+// The minimum number of journal records before we consider compacting.
+constexpr uint64_t CoDCDNCacheCompactThreshold = 4096;
+
+// Reads from the given offset without relying on the shared file pointer.
+static bool ReadAt(HANDLE handle, uint64_t offset, uint8_t* buffer, size_t size)
+{
+	OVERLAPPED overlapped{};
+	overlapped.Offset = (DWORD)offset;
+	overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+	DWORD sizeRead = 0;
+
+	if (!ReadFile(handle, buffer, (DWORD)size, &sizeRead, &overlapped))
+		return false;
+
+	return sizeRead == size;
+}
+
+// Writes to the given offset without relying on the shared file pointer.
+static bool WriteAt(HANDLE handle, uint64_t offset, const uint8_t* buffer, size_t size)
+{
+	OVERLAPPED overlapped{};
+	overlapped.Offset = (DWORD)offset;
+	overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+	DWORD sizeWritten = 0;
+
+	if (!WriteFile(handle, buffer, (DWORD)size, &sizeWritten, &overlapped))
+		return false;
+
+	return sizeWritten == size;
+}
+
 CoDCDNCache::CoDCDNCache()
 {
+	DataHandle = INVALID_HANDLE_VALUE;
+	JournalHandle = INVALID_HANDLE_VALUE;
+	DataFileSize = 0;
+	JournalRecords = 0;
 	Loaded = false;
 }
 
+CoDCDNCache::~CoDCDNCache()
+{
+	CloseHandles();
+}
+
+uint64_t CoDCDNCache::CalculateCheck(const CoDCDNCacheEntry& entry)
+{
+	// Doesn't need to be strong, just enough to catch a partially written record.
+	return (entry.Hash ^ 0x9E3779B97F4A7C15) + (entry.Offset * 31) + (entry.Size * 131);
+}
+
+bool CoDCDNCache::OpenHandles()
+{
+	CloseHandles();
+
+	DataHandle = CreateFileA(
+		DataFilePath.c_str(),
+		GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL);
+
+	if (DataHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	// Append only access, so every record lands at the end, even across processes.
+	JournalHandle = CreateFileA(
+		InfoFilePath.c_str(),
+		FILE_APPEND_DATA,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL);
+
+	if (JournalHandle == INVALID_HANDLE_VALUE)
+	{
+		CloseHandles();
+		return false;
+	}
+
+	LARGE_INTEGER size{};
+
+	if (!GetFileSizeEx(DataHandle, &size))
+	{
+		CloseHandles();
+		return false;
+	}
+
+	DataFileSize = size.QuadPart;
+	return true;
+}
+
+void CoDCDNCache::CloseHandles()
+{
+	if (DataHandle != INVALID_HANDLE_VALUE)
+		::CloseHandle(DataHandle);
+	if (JournalHandle != INVALID_HANDLE_VALUE)
+		::CloseHandle(JournalHandle);
+
+	DataHandle = INVALID_HANDLE_VALUE;
+	JournalHandle = INVALID_HANDLE_VALUE;
+}
+
 bool CoDCDNCache::Load(const std::string& name)
 {
+	std::unique_lock<std::shared_mutex> lock(Mutex);
+
 	std::string cdnDir = FileSystems::CombinePath(FileSystems::GetApplicationPath(), "cdn_cache");
 
 	// Set up CDN Cache file paths for future use.
@@ -23,87 +134,207 @@ bool CoDCDNCache::Load(const std::string& name)
 
 	FileSystems::CreateDirectory(cdnDir);
 
-	// At this point we are loaded, we've created the required information for
-	// the build methods to work with.
-	Loaded = true;
+	Entries.clear();
+	JournalRecords = 0;
 
-	BinaryReader reader;
+	// Whether or not the info file needs rewriting once loaded, either
+	// it's missing, in the old format or it has a torn record at the end.
+	bool needsCompact = true;
 
-	// Verify our info file can be opened and is valid, not necessarily a fatal
-	// issue as we'll generate it later.
-	if (!reader.Open(InfoFilePath))
-		return false;
-	if (reader.Read<uint32_t>() != 0x494E4443)
-		return false;
-	if (reader.Read<uint32_t>() != 1)
-		return false;
+	{
+		BinaryReader reader;
+
+		// Verify our info file can be opened and is valid, not necessarily a fatal
+		// issue as we'll generate it later.
+		if (reader.Open(InfoFilePath) && reader.Read<uint32_t>() == CoDCDNCacheMagic)
+		{
+			auto version = reader.Read<uint32_t>();
+			auto length = reader.GetLength();
+
+			if (version == CoDCDNCacheSnapshotVersion)
+			{
+				auto numEntries = reader.Read<uint32_t>();
+
+				Entries.reserve(numEntries);
+
+				for (uint32_t i = 0; i < numEntries; i++)
+				{
+					auto entry = reader.Read<CoDCDNCacheEntry>();
+					Entries[entry.Hash] = entry;
+				}
+			}
+			else if (version == CoDCDNCacheJournalVersion)
+			{
+				Entries.reserve((size_t)(length / sizeof(CoDCDNCacheJournalRecord)));
+				needsCompact = false;
+
+				// Replay the journal, later records replace earlier ones.
+				while (reader.GetPosition() + sizeof(CoDCDNCacheJournalRecord) <= length)
+				{
+					auto record = reader.Read<CoDCDNCacheJournalRecord>();
+
+					// A bad record means we crashed mid-write, nothing after it can be trusted.
+					if (record.Check != CalculateCheck(record.Entry))
+					{
+						needsCompact = true;
+						break;
+					}
+
+					Entries[record.Entry.Hash] = record.Entry;
+					JournalRecords++;
+				}
+
+				// Trailing bytes are a partially written record.
+				if (reader.GetPosition() != length)
+					needsCompact = true;
+			}
+		}
+	}
 
-	auto numEntries = reader.Read<uint32_t>();
+	if (!OpenHandles())
+		return false;
 
-	for (uint32_t i = 0; i < numEntries; i++)
+	// Drop anything that points past the data we actually have, this can
+	// happen if we were killed before the data write completed.
+	for (auto it = Entries.begin(); it != Entries.end(); )
 	{
-		auto entry = reader.Read<CoDCDNCacheEntry>();
-		Entries[entry.Hash] = entry;
+		if (it->second.Offset + it->second.Size > DataFileSize)
+		{
+			it = Entries.erase(it);
+			needsCompact = true;
+		}
+		else
+		{
+			it++;
+		}
 	}
 
+	// At this point we are loaded, we've created the required information for
+	// the build methods to work with.
+	Loaded = true;
+
+	if (needsCompact || JournalRecords > Entries.size() * 2)
+		return Compact();
+
 	return true;
 }
 
-bool CoDCDNCache::Save()
+bool CoDCDNCache::Compact()
 {
 	if (!Loaded)
 		return false;
 
-	BinaryWriter writer;
+	// Write the live entries to a new journal first, then swap it in, so
+	// a crash during compaction leaves the old journal intact.
+	auto tempFilePath = InfoFilePath + ".tmp";
 
-	if (!writer.Create(InfoFilePath))
-		return false;
+	{
+		BinaryWriter writer;
+
+		if (!writer.Create(tempFilePath))
+			return false;
 
-	writer.Write<uint32_t>(0x494E4443);
-	writer.Write<uint32_t>(1);
-	writer.Write<uint32_t>((uint32_t)Entries.size());
+		writer.Write<uint32_t>(CoDCDNCacheMagic);
+		writer.Write<uint32_t>(CoDCDNCacheJournalVersion);
 
-	for (auto& entry : Entries)
+		for (auto& entry : Entries)
+		{
+			CoDCDNCacheJournalRecord record{};
+
+			record.Entry = entry.second;
+			record.Check = CalculateCheck(entry.second);
+
+			writer.Write(record);
+		}
+	}
+
+	if (JournalHandle != INVALID_HANDLE_VALUE)
 	{
-		writer.Write(entry.second);
+		::CloseHandle(JournalHandle);
+		JournalHandle = INVALID_HANDLE_VALUE;
 	}
 
-	return true;
+	if (!MoveFileExA(tempFilePath.c_str(), InfoFilePath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+	{
+		FileSystems::DeleteFile(tempFilePath);
+	}
+
+	JournalHandle = CreateFileA(
+		InfoFilePath.c_str(),
+		FILE_APPEND_DATA,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL);
+
+	JournalRecords = Entries.size();
+
+	return JournalHandle != INVALID_HANDLE_VALUE;
+}
+
+bool CoDCDNCache::Save()
+{
+	std::unique_lock<std::shared_mutex> lock(Mutex);
+
+	// The journal is always up to date, saving just compacts it.
+	return Compact();
 }
 
 bool CoDCDNCache::Add(const uint64_t hash, const uint8_t* buffer, const size_t bufferSize)
 {
-	if (!Loaded)
+	std::unique_lock<std::shared_mutex> lock(Mutex);
+
+	if (!Loaded || DataHandle == INVALID_HANDLE_VALUE || JournalHandle == INVALID_HANDLE_VALUE)
 		return false;
 
-	BinaryWriter writer;
+	// Another worker may have beaten us to it.
+	auto find = Entries.find(hash);
 
-	if (!writer.Open(DataFilePath))
-		return false;
+	if (find != Entries.end() && find->second.Size == bufferSize)
+		return true;
 
 	CoDCDNCacheEntry entry{};
 
 	entry.Hash = hash;
-	entry.Offset = writer.GetLength();;
+	entry.Offset = DataFileSize;
 	entry.Size = bufferSize;
 
-	Entries[entry.Hash] = entry;
+	// Deliver the payload to the data file first, the journal record is
+	// only written once the data it points to is in place.
+	if (!WriteAt(DataHandle, entry.Offset, buffer, bufferSize))
+		return false;
 
-	if (!Save())
-	{
+	DataFileSize += bufferSize;
+
+	CoDCDNCacheJournalRecord record{};
+
+	record.Entry = entry;
+	record.Check = CalculateCheck(entry);
+
+	DWORD sizeWritten = 0;
+
+	if (!WriteFile(JournalHandle, &record, sizeof(record), &sizeWritten, NULL) || sizeWritten != sizeof(record))
 		return false;
-	}
 
-	// Deliver the payload to the data file.
-	writer.SetPosition(entry.Offset);
-	writer.Write(buffer, (uint32_t)bufferSize);
+	Entries[entry.Hash] = entry;
+	JournalRecords++;
+
+	// Periodically drop replaced records so the journal doesn't grow forever.
+	if (JournalRecords > CoDCDNCacheCompactThreshold && JournalRecords > Entries.size() * 2)
+		Compact();
+
 	return true;
 }
 
 std::unique_ptr<uint8_t[]> CoDCDNCache::Extract(const uint64_t hash, size_t expectedSize, size_t& bufferSize)
 {
-	if (!Loaded)
-		return false;
+	bufferSize = 0;
+
+	std::shared_lock<std::shared_mutex> lock(Mutex);
+
+	if (!Loaded || DataHandle == INVALID_HANDLE_VALUE)
+		return nullptr;
 
 	auto find = Entries.find(hash);
 
@@ -117,22 +348,11 @@ std::unique_ptr<uint8_t[]> CoDCDNCache::Extract(const uint64_t hash, size_t expe
 	if (expectedSize != 0 && entry.Size != expectedSize)
 		return nullptr;
 
-	BinaryReader reader;
-
-	if (!reader.Open(DataFilePath))
-		return false;
-
 	auto result = std::make_unique<uint8_t[]>(entry.Size);
 
-	reader.SetPosition(entry.Offset);
-
-	reader.Read(result.get(), entry.Size, bufferSize);
-
-	if (bufferSize != entry.Size)
-	{
-		bufferSize = 0;
+	if (!ReadAt(DataHandle, entry.Offset, result.get(), entry.Size))
 		return nullptr;
-	}
 
+	bufferSize = entry.Size;
 	return result;
-}
\ No newline at end of file
+}
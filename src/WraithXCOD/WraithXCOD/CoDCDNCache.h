@@ -1,4 +1,5 @@
 #pragma once
+#include <shared_mutex>
 
 struct CoDCDNCacheEntry
 {
@@ -6,30 +7,58 @@ struct CoDCDNCacheEntry
 	uint64_t Hash;
 	// The offset within the data file.
 	uint64_t Offset;
-	// The size of the object 
+	// The size of the object
 	uint64_t Size;
 };
 
+// A single record within the CDN info journal.
+struct CoDCDNCacheJournalRecord
+{
+	// The entry being added.
+	CoDCDNCacheEntry Entry;
+	// A check value used to detect torn writes.
+	uint64_t Check;
+};
+
 // A class to hold a generic CDN Cache.
 class CoDCDNCache
 {
 private:
-	// A mutex for read/write operations.
-	std::mutex Mutex;
+	// A mutex for read/write operations, readers share it.
+	std::shared_mutex Mutex;
 	// The full path of the CDN info file.
 	std::string InfoFilePath;
 	// The full path of the CDN data file.
 	std::string DataFilePath;
 	// The cached entries.
-	std::map<uint64_t, CoDCDNCacheEntry> Entries;
+	std::unordered_map<uint64_t, CoDCDNCacheEntry> Entries;
+	// The open data file, kept for the life of the cache.
+	HANDLE DataHandle;
+	// The open info journal, kept for the life of the cache.
+	HANDLE JournalHandle;
+	// The end of the data file, where new objects are appended.
+	uint64_t DataFileSize;
+	// The number of records in the journal, including replaced ones.
+	uint64_t JournalRecords;
 	// Whether or not the cache has loaded.
 	bool Loaded;
+
+	// Computes the check value for a journal record.
+	static uint64_t CalculateCheck(const CoDCDNCacheEntry& entry);
+	// Opens the data file and journal handles.
+	bool OpenHandles();
+	// Closes the data file and journal handles.
+	void CloseHandles();
+	// Rewrites the journal with only the live entries, the lock must be held.
+	bool Compact();
 public:
 	// Initializes the CDN Cache.
 	CoDCDNCache();
+	// Closes the CDN Cache.
+	~CoDCDNCache();
 	// Loads the CDN cache info file.
 	bool Load(const std::string& name);
-	// Saves the CDN cache info file.
+	// Saves the CDN cache info file, compacting the journal.
 	bool Save();
 	// Adds an object to the CDN cache.
 	bool Add(const uint64_t hash, const uint8_t* buffer, const size_t bufferSize);
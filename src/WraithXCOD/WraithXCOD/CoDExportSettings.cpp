@@ -0,0 +1,107 @@
+#include "stdafx.h"
+
+// We need the following std classes
+#include <cstdlib>
+
+// The class we are implementing
+#include "CoDExportSettings.h"
+
+// We need the following WraithX classes
+#include "SettingsManager.h"
+#include "Strings.h"
+
+// Gets a boolean setting
+static bool GetBoolSetting(const std::string& Key, const std::string& Default)
+{
+    // Compare it
+    return SettingsManager::GetSetting(Key, Default) == "true";
+}
+
+std::shared_ptr<const CoDExportSettings> CoDExportSettings::Load()
+{
+    // The result
+    auto Result = std::make_shared<CoDExportSettings>();
+
+    // Model formats
+    Result->ModelFormats = 0;
+
+    if (GetBoolSetting("export_xmexport", "false"))
+        Result->ModelFormats |= (uint32_t)CoDModelExportFormat::XModelExport;
+    if (GetBoolSetting("export_xmbin", "false"))
+        Result->ModelFormats |= (uint32_t)CoDModelExportFormat::XModelBin;
+    if (GetBoolSetting("export_smd", "false"))
+        Result->ModelFormats |= (uint32_t)CoDModelExportFormat::SMD;
+    if (GetBoolSetting("export_obj", "false"))
+        Result->ModelFormats |= (uint32_t)CoDModelExportFormat::OBJ;
+    if (GetBoolSetting("export_ma", "false"))
+        Result->ModelFormats |= (uint32_t)CoDModelExportFormat::Maya;
+    if (GetBoolSetting("export_xna", "false"))
+        Result->ModelFormats |= (uint32_t)CoDModelExportFormat::XNALara;
+    if (GetBoolSetting("export_gltf", "false"))
+        Result->ModelFormats |= (uint32_t)CoDModelExportFormat::GLTF;
+    if (GetBoolSetting("export_glb", "false"))
+        Result->ModelFormats |= (uint32_t)CoDModelExportFormat::GLB;
+    if (GetBoolSetting("export_semodel", "false"))
+        Result->ModelFormats |= (uint32_t)CoDModelExportFormat::SEModel;
+    if (GetBoolSetting("export_castmdl", "false"))
+        Result->ModelFormats |= (uint32_t)CoDModelExportFormat::Cast;
+    if (GetBoolSetting("export_fbx", "false"))
+        Result->ModelFormats |= (uint32_t)CoDModelExportFormat::FBX;
+
+    // Animation formats
+    Result->AnimFormats = 0;
+
+    if (GetBoolSetting("export_directxanim", "false"))
+        Result->AnimFormats |= (uint32_t)CoDAnimExportFormat::DirectXAnim;
+    if (GetBoolSetting("export_seanim", "false"))
+        Result->AnimFormats |= (uint32_t)CoDAnimExportFormat::SEAnim;
+    if (GetBoolSetting("export_castanim", "false"))
+        Result->AnimFormats |= (uint32_t)CoDAnimExportFormat::Cast;
+
+    // Image format, lowering the extension modifies the string, so it's copied first
+    auto ImageSetting = SettingsManager::GetSetting("exportimg", "PNG");
+
+    auto ImageExtension = ImageSetting;
+    Result->ImageExtension = "." + Strings::ToLower(ImageExtension);
+    Result->ImageFormatType = ImageFormat::Standard_PNG;
+
+    if (ImageSetting == "DDS")
+        Result->ImageFormatType = ImageFormat::DDS_WithHeader;
+    else if (ImageSetting == "TGA")
+        Result->ImageFormatType = ImageFormat::Standard_TGA;
+    else if (ImageSetting == "TIFF")
+        Result->ImageFormatType = ImageFormat::Standard_TIFF;
+
+    // Sound format
+    auto SoundSetting = SettingsManager::GetSetting("exportsnd", "WAV");
+
+    auto SoundExtension = SoundSetting;
+    Result->SoundExtension = "." + Strings::ToLower(SoundExtension);
+    Result->SoundFormatType = (SoundSetting == "FLAC") ? SoundFormat::Standard_FLAC : SoundFormat::Standard_WAV;
+    Result->FlacCompressionLevel = (uint32_t)std::min(std::strtoul(SettingsManager::GetSetting("flaclevel", "5").c_str(), nullptr, 10), 8ul);
+
+    // XAnim version
+    Result->DirectXAnimVersion = (SettingsManager::GetSetting("directxanim_ver") == "17") ? XAnimRawVersion::WorldAtWar : XAnimRawVersion::BlackOps;
+
+    // Flags
+    Result->GlobalImages = GetBoolSetting("global_images", "true");
+    Result->KeepSoundPath = GetBoolSetting("keepsndpath", "true");
+    Result->KeepRawfilePath = GetBoolSetting("keeprawpath", "true");
+    Result->ExportModelImages = GetBoolSetting("exportmodelimg", "true");
+    Result->ExportImageNames = GetBoolSetting("exportimgnames", "false");
+    Result->ModelMaterialFolders = GetBoolSetting("mdlmtlfolders", "true");
+    Result->ExportAllLods = GetBoolSetting("exportalllods", "false");
+    Result->MatchGameLodIndex = GetBoolSetting("match_game_lod_index", "false");
+    Result->ExportHitbox = GetBoolSetting("exporthitbox", "false");
+    Result->ExportVertexColors = GetBoolSetting("exportvtxcolor", "true");
+    Result->PatchNormals = GetBoolSetting("patchnormals", "true");
+    Result->PatchColor = GetBoolSetting("patchcolor", "true");
+    Result->SkipBlankAudio = GetBoolSetting("skipblankaudio", "false");
+    Result->SkipPreviousModels = GetBoolSetting("skipprevmodel", "true");
+    Result->SkipPreviousAnims = GetBoolSetting("skipprevanim", "true");
+    Result->SkipPreviousImages = GetBoolSetting("skipprevimg", "true");
+    Result->SkipPreviousSounds = GetBoolSetting("skipprevsound", "true");
+
+    // Done
+    return Result;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// We need the following WraithX classes
+#include "Image.h"
+#include "Sound.h"
+#include "XAnimRawExport.h"
+
+// The model formats that can be exported, as bits of a mask
+enum class CoDModelExportFormat : uint32_t
+{
+    None = 0,
+    XModelExport = 1 << 0,
+    XModelBin = 1 << 1,
+    SMD = 1 << 2,
+    OBJ = 1 << 3,
+    Maya = 1 << 4,
+    XNALara = 1 << 5,
+    GLTF = 1 << 6,
+    GLB = 1 << 7,
+    SEModel = 1 << 8,
+    Cast = 1 << 9,
+    FBX = 1 << 10,
+};
+
+// The animation formats that can be exported, as bits of a mask
+enum class CoDAnimExportFormat : uint32_t
+{
+    None = 0,
+    DirectXAnim = 1 << 0,
+    SEAnim = 1 << 1,
+    Cast = 1 << 2,
+};
+
+// The export settings, parsed once per export and never modified, so it can be shared between workers without locking
+struct CoDExportSettings
+{
+    // The model formats to export
+    uint32_t ModelFormats;
+    // The animation formats to export
+    uint32_t AnimFormats;
+
+    // The image format to export
+    ImageFormat ImageFormatType;
+    // The image extension, with a leading dot
+    std::string ImageExtension;
+    // The sound format to export
+    SoundFormat SoundFormatType;
+    // The sound extension, with a leading dot
+    std::string SoundExtension;
+    // The FLAC compression level, 0 is the fastest, 8 the smallest
+    uint32_t FlacCompressionLevel;
+    // The XAnim version to write
+    XAnimRawVersion DirectXAnimVersion;
+
+    // Whether or not images are shared between all models
+    bool GlobalImages;
+    // Whether or not sounds keep their game path
+    bool KeepSoundPath;
+    // Whether or not rawfiles keep their game path
+    bool KeepRawfilePath;
+    // Whether or not model images are exported
+    bool ExportModelImages;
+    // Whether or not material image names are exported
+    bool ExportImageNames;
+    // Whether or not model images are put in material folders
+    bool ModelMaterialFolders;
+    // Whether or not all lods are exported
+    bool ExportAllLods;
+    // Whether or not the lod suffix matches the game's lod index
+    bool MatchGameLodIndex;
+    // Whether or not hitbox models are exported
+    bool ExportHitbox;
+    // Whether or not vertex colors are exported
+    bool ExportVertexColors;
+    // Whether or not normal maps are patched
+    bool PatchNormals;
+    // Whether or not color maps are patched
+    bool PatchColor;
+    // Whether or not blank sounds are skipped
+    bool SkipBlankAudio;
+    // Whether or not models that were exported before are skipped
+    bool SkipPreviousModels;
+    // Whether or not animations that were exported before are skipped
+    bool SkipPreviousAnims;
+    // Whether or not images that were exported before are skipped
+    bool SkipPreviousImages;
+    // Whether or not sounds that were exported before are skipped
+    bool SkipPreviousSounds;
+
+    // Checks if a model format should be exported
+    bool HasModelFormat(CoDModelExportFormat Format) const { return (ModelFormats & (uint32_t)Format) != 0; }
+    // Checks if an animation format should be exported
+    bool HasAnimFormat(CoDAnimExportFormat Format) const { return (AnimFormats & (uint32_t)Format) != 0; }
+
+    // Parses the current settings
+    static std::shared_ptr<const CoDExportSettings> Load();
+};
@@ -7,6 +7,8 @@ CoDFileSystem::~CoDFileSystem()
 
 void CoDFileSystem::CloseFile(HANDLE handle)
 {
+	std::unique_lock<std::mutex> lock(HandleMutex);
+
 	for (auto it = OpenHandles.begin(); it != OpenHandles.end(); )
 	{
 		if (*it == handle)
@@ -19,6 +21,8 @@ void CoDFileSystem::CloseFile(HANDLE handle)
 		}
 	}
 
+	lock.unlock();
+
 	CloseHandle(handle);
 }
 
@@ -34,11 +38,44 @@ std::unique_ptr<uint8_t[]> CoDFileSystem::Read(HANDLE handle, const size_t size)
 	return result;
 }
 
+size_t CoDFileSystem::ReadAt(HANDLE handle, uint8_t* buffer, const size_t position, const size_t size)
+{
+	// Fall back to seek + read, serialized so callers never see each other's file pointer.
+	std::lock_guard<std::mutex> lock(PositionMutex);
+
+	if (Seek(handle, position, SEEK_SET) != position)
+	{
+		return 0;
+	}
+
+	return Read(handle, buffer, 0, size);
+}
+
+std::unique_ptr<uint8_t[]> CoDFileSystem::ReadAt(HANDLE handle, const size_t position, const size_t size)
+{
+	auto result = std::make_unique<uint8_t[]>(size);
+
+	if (ReadAt(handle, result.get(), position, size) != size)
+	{
+		return nullptr;
+	}
+
+	return result;
+}
+
 size_t CoDFileSystem::Write(HANDLE handle, const uint8_t* buffer, const size_t size)
 {
 	return Write(handle, buffer, 0, size);
 }
 
+bool CoDFileSystem::GetFileInfo(const std::string& fileName, uint64_t& size, uint64_t& modifiedTime)
+{
+	// Not supported by default, so files are always treated as changed.
+	size = 0;
+	modifiedTime = 0;
+	return false;
+}
+
 const size_t CoDFileSystem::GetLastError() const
 {
 	return LastErrorCode;
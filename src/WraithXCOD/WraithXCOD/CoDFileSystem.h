@@ -7,9 +7,13 @@ protected:
 	// The directory where we are loading from.
 	std::string Directory;
 	// The last error code.
-	size_t LastErrorCode = 0;
+	std::atomic<size_t> LastErrorCode{ 0 };
 	// Open file handles.
 	std::vector<HANDLE> OpenHandles;
+	// A mutex for the open file handles, packages are opened from many threads.
+	std::mutex HandleMutex;
+	// A mutex for positioned reads on file systems without native support.
+	std::mutex PositionMutex;
 public:
 	// Opens a file with the given name and mode.
 	virtual HANDLE OpenFile(const std::string& fileName, const std::string& mode) = 0;
@@ -25,6 +29,10 @@ public:
 	virtual std::unique_ptr<uint8_t[]> Read(HANDLE handle, const size_t size);
 	// Reads data from the file.
 	virtual size_t Read(HANDLE handle, uint8_t* buffer, const size_t offset, const size_t size) = 0;
+	// Reads data from the given position without using the file pointer, safe to call from multiple threads.
+	virtual size_t ReadAt(HANDLE handle, uint8_t* buffer, const size_t position, const size_t size);
+	// Reads data from the given position without using the file pointer, safe to call from multiple threads.
+	std::unique_ptr<uint8_t[]> ReadAt(HANDLE handle, const size_t position, const size_t size);
 	// Reads data from the file.
 	template <class T>
 	T Read(HANDLE handle)
@@ -43,6 +51,8 @@ public:
 	virtual size_t Seek(HANDLE handle, size_t position, size_t direction) = 0;
 	// Gets the size of the file.
 	virtual size_t Size(HANDLE handle) = 0;
+	// Gets the size and last write time of the file, used to tell if a file has changed.
+	virtual bool GetFileInfo(const std::string& fileName, uint64_t& size, uint64_t& modifiedTime);
 	// Gets the list of files matching the provided pattern.
 	virtual size_t EnumerateFiles(const std::string& pattern, std::function<void(const std::string&, const size_t)> onFileFound) = 0;
 	// Gets the last error.
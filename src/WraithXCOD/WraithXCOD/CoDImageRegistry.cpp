@@ -0,0 +1,86 @@
+#include "stdafx.h"
+
+// The class we are implementing
+#include "CoDImageRegistry.h"
+
+// We need the following WraithX classes
+#include "Strings.h"
+#include "Hashing.h"
+
+CoDImageRegistry::CoDImageRegistry()
+{
+    // Defaults
+    Claimed = 0;
+    Skipped = 0;
+}
+
+bool CoDImageRegistry::TryClaim(const std::string& ImagePath)
+{
+    // The key we're after
+    auto Key = HashImagePath(ImagePath);
+
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(RegistryMutex);
+
+    // Add it as in flight, unless someone has it already
+    auto Result = Images.emplace(Key, ImageState::InFlight);
+
+    // Someone has it, skip it, we never wait as the owner may be waiting on a job we've taken
+    if (!Result.second)
+    {
+        Skipped++;
+        return false;
+    }
+
+    // It's ours
+    Claimed++;
+    return true;
+}
+
+void CoDImageRegistry::Complete(const std::string& ImagePath)
+{
+    // The key we're after
+    auto Key = HashImagePath(ImagePath);
+
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(RegistryMutex);
+
+    // Mark it as written
+    Images[Key] = ImageState::Completed;
+}
+
+void CoDImageRegistry::Release(const std::string& ImagePath)
+{
+    // The key we're after
+    auto Key = HashImagePath(ImagePath);
+
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(RegistryMutex);
+
+    // Remove it, only if it's still in flight
+    auto Entry = Images.find(Key);
+
+    if (Entry != Images.end() && Entry->second == ImageState::InFlight)
+        Images.erase(Entry);
+}
+
+void CoDImageRegistry::Clear()
+{
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(RegistryMutex);
+
+    // Clean up
+    Images.clear();
+    Claimed = 0;
+    Skipped = 0;
+}
+
+uint64_t CoDImageRegistry::HashImagePath(const std::string& ImagePath)
+{
+    // Copy and lower it, windows paths aren't case sensitive
+    auto Path = ImagePath;
+    Strings::ToLower(Path);
+
+    // Hash it
+    return Hashing::HashXXHashString(Path);
+}
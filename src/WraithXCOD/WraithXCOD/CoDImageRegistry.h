@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
+// A class that tracks the images written during an export, so an image shared between assets is only converted once
+class CoDImageRegistry
+{
+public:
+    // Creates a new, empty registry
+    CoDImageRegistry();
+
+    // Claims an image for writing, returns false if it's already being written or was written this export
+    bool TryClaim(const std::string& ImagePath);
+    // Marks a claimed image as written
+    void Complete(const std::string& ImagePath);
+    // Gives up a claimed image that failed, so the next asset that needs it tries again
+    void Release(const std::string& ImagePath);
+
+    // Removes all images, done as each export begins
+    void Clear();
+
+    // Gets the number of images claimed for writing
+    uint64_t GetClaimed() const { return Claimed; }
+    // Gets the number of requests skipped as the image was already claimed
+    uint64_t GetSkipped() const { return Skipped; }
+
+private:
+    // The state of an image
+    enum class ImageState : uint8_t
+    {
+        // The image is being fetched, decoded and written
+        InFlight,
+        // The image has been written
+        Completed,
+    };
+
+    // The images, by hash of their path
+    std::unordered_map<uint64_t, ImageState> Images;
+    // A mutex for registry operations
+    std::mutex RegistryMutex;
+
+    // Counters
+    std::atomic<uint64_t> Claimed;
+    std::atomic<uint64_t> Skipped;
+
+    // Hashes an image path, paths differing by case are the same file
+    static uint64_t HashImagePath(const std::string& ImagePath);
+};
@@ -6,18 +6,59 @@
 #include "FileSystems.h"
 #include "WinFileSystem.h"
 #include "CascFileSystem.h"
+#include "Compression.h"
+#include "Siren.h"
+#include "CoDXConverter.h"
+#include "SettingsManager.h"
+#include "Strings.h"
+#include "Hashing.h"
+#include "CoDPackageIndexSnapshot.h"
 
-CoDPackageCache::CoDPackageCache()
+// Objects smaller than this are always decompressed on the calling thread
+constexpr size_t PackageParallelDecompressSize = 0x200000;
+// The amount of decompressed data each parallel job handles
+constexpr size_t PackageBlockJobSize = 0x100000;
+
+CoDPackageCache::CoDPackageCache() : ObjectCache(CalculateObjectCacheCapacity())
 {
     // Defaults
     HasLoaded = false;
     CacheLoading = false;
+    IndexPublishing = false;
+    PackagesParsed = 0;
+    PackagesTotal = 0;
+}
+
+size_t CoDPackageCache::CalculateObjectCacheCapacity()
+{
+    // The capacity in megabytes, 0 disables the cache
+    size_t Result = 0;
+
+    // Attempt to parse it
+    try
+    {
+        Result = (size_t)std::stoull(SettingsManager::GetSetting("objectcachesize", "256"));
+    }
+    catch (...)
+    {
+        Result = 256;
+    }
+
+    // Return result
+    return Result * 1024 * 1024;
 }
 
 CoDPackageCache::~CoDPackageCache()
 {
+    // Never let the loader outlive us, owners should wait before destroying a cache that is loading
+    if (LoadThread.joinable())
+        LoadThread.join();
+
+    // Close handles while the file system is still alive
+    ClosePackageHandles();
+
     // Clean up if need be
-    CacheObjects.clear();
+    CacheObjects.Clear();
     PackageFilePaths.clear();
     PackageFilePaths.shrink_to_fit();
 }
@@ -52,6 +93,21 @@ void CoDPackageCache::LoadPackageCache(const std::string& BasePath)
 
     // Set that we are loading
     CacheLoading = true;
+    HasLoaded = false;
+
+    // Nothing can be looked up until packages are added again
+    IndexPublishing = false;
+    PackagesParsed = 0;
+    PackagesTotal = 0;
+
+    // Any pooled handles and objects belong to the old file system
+    ClosePackageHandles();
+    ObjectCache.Clear();
+
+    // Index snapshots are kept per cache type and install
+    auto SnapshotDirectory = FileSystems::CombinePath(FileSystems::GetApplicationPath(), "package_cache");
+    FileSystems::CreateDirectory(SnapshotDirectory);
+    IndexSnapshotPath = FileSystems::CombinePath(SnapshotDirectory, Strings::Format("%llx.pkgidx", Hashing::HashXXHashString(std::string(typeid(*this).name()) + "|" + BasePath)));
 
     // Open the file system, check for build info, if build info exists
     // we'll use Casc, otherwise use raw directory.
@@ -73,12 +129,199 @@ void CoDPackageCache::LoadPackageCache(const std::string& BasePath)
 
 bool CoDPackageCache::LoadPackage(const std::string& FilePath)
 {
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+
     // Nothing, default, but ensure status is loading
     CacheLoading = true;
     HasLoaded = false;
     return true;
 }
 
+void CoDPackageCache::AddPackage(const PackageIndex& Index)
+{
+    // Packages without data aren't added
+    if (Index.FilePath.empty())
+        return;
+
+    // Aquire lock, lookups wait until the whole package is in
+    std::unique_lock<std::shared_mutex> Lock(IndexMutex);
+
+    // The index of this package
+    auto PackageFileIndex = (uint32_t)PackageFilePaths.size();
+
+    // Make room up front
+    CacheObjects.Reserve(CacheObjects.Size() + Index.Entries.size());
+
+    // Append to database
+    for (auto& Entry : Index.Entries)
+    {
+        PackageCacheObject NewObject{};
+        NewObject.Offset = Entry.Offset;
+        NewObject.CompressedSize = Entry.CompressedSize;
+        NewObject.UncompressedSize = Entry.UncompressedSize;
+        NewObject.PackageFileIndex = PackageFileIndex;
+
+        CacheObjects.Insert(Entry.Key, NewObject);
+    }
+
+    // Append the file path
+    PackageFilePaths.push_back(Index.FilePath);
+}
+
+void CoDPackageCache::LoadPackages(const std::vector<std::string>& FilePaths)
+{
+    // Map the snapshot from the last run, if any
+    CoDPackageIndexSnapshot Snapshot;
+    auto HasSnapshot = !IndexSnapshotPath.empty() && Snapshot.Open(IndexSnapshotPath);
+
+    // The parsed packages, in enumeration order, each package is parsed into its own slot
+    std::vector<PackageIndex> Indices(FilePaths.size());
+    std::vector<uint8_t> Parsed(FilePaths.size());
+    // The fingerprints of each package
+    std::vector<uint64_t> Sizes(FilePaths.size());
+    std::vector<uint64_t> ModifiedTimes(FilePaths.size());
+    // The number of packages reused from the snapshot and parsed
+    std::atomic<uint32_t> Reused(0);
+    std::atomic<uint32_t> Reparsed(0);
+
+    // The packages that have finished, and the next one to add, packages are added in enumeration order
+    // as soon as everything before them is done, so lookups can start without changing package indices
+    std::vector<uint8_t> Completed(FilePaths.size());
+    size_t NextToAdd = 0;
+    std::mutex AddMutex;
+
+    {
+        // Aquire lock
+        std::unique_lock<std::shared_mutex> Lock(IndexMutex);
+
+        // Paths are never moved while lookups are reading them
+        PackageFilePaths.reserve(PackageFilePaths.size() + FilePaths.size());
+
+        // We know roughly how big the index will be if we have a snapshot
+        if (HasSnapshot)
+            CacheObjects.Reserve(CacheObjects.Size() + (size_t)Snapshot.GetEntryCount());
+    }
+
+    // Lookups may now run alongside us
+    PackagesTotal += (uint32_t)FilePaths.size();
+    IndexPublishing = true;
+
+    // Loads a single package, only touches its own slot, so packages can load in any order
+    auto LoadSlot = [&](size_t i)
+    {
+        // Fingerprint the package
+        if (FileSystem != nullptr)
+            FileSystem->GetFileInfo(FilePaths[i], Sizes[i], ModifiedTimes[i]);
+
+        // Reuse it if it hasn't changed, otherwise parse it
+        auto Record = HasSnapshot ? Snapshot.FindPackage(FilePaths[i], Sizes[i], ModifiedTimes[i]) : nullptr;
+
+        if (Record != nullptr)
+        {
+            Parsed[i] = Snapshot.ReadPackage(Record, Indices[i]);
+            Reused++;
+        }
+        else
+        {
+            try
+            {
+                Parsed[i] = ParsePackage(FilePaths[i], Indices[i]);
+            }
+            catch (...)
+            {
+                Parsed[i] = false;
+            }
+
+            Reparsed++;
+        }
+
+        PackagesParsed++;
+
+        // Aquire lock
+        std::lock_guard<std::mutex> Lock(AddMutex);
+
+        // Add everything that's ready
+        Completed[i] = true;
+
+        while (NextToAdd < FilePaths.size() && Completed[NextToAdd])
+        {
+            if (Parsed[NextToAdd])
+                AddPackage(Indices[NextToAdd]);
+
+            NextToAdd++;
+        }
+    };
+
+    // Spread the packages over a converter, a handful of packages isn't worth the threads
+    auto Workers = std::min<uint32_t>(CoDXConverter::CalculateDegreeOfParallelism(), (uint32_t)FilePaths.size());
+
+    if (Workers > 1)
+    {
+        CoDXConverter Loader(Workers);
+
+        for (size_t i = 0; i < FilePaths.size(); i++)
+            Loader.Submit(CoDXConverterStage::Extract, [&LoadSlot, i] { LoadSlot(i); });
+
+        Loader.WaitForIdle();
+    }
+    else
+    {
+        for (size_t i = 0; i < FilePaths.size(); i++)
+            LoadSlot(i);
+    }
+
+    // The packages to write to the next snapshot, only packages we can fingerprint are worth keeping,
+    // packages that failed to parse are kept too, so blank packages aren't parsed again every run
+    std::vector<PackageSnapshotSource> Sources;
+
+    for (size_t i = 0; i < FilePaths.size(); i++)
+    {
+        if (ModifiedTimes[i] != 0)
+            Sources.push_back({ FilePaths[i], Sizes[i], ModifiedTimes[i], Parsed[i] ? &Indices[i] : nullptr });
+    }
+
+    // Whether or not the snapshot needs rewriting
+    auto SnapshotChanged = !HasSnapshot || Reparsed > 0;
+
+    // Removed packages also need a new snapshot
+    if (HasSnapshot && Reused != Snapshot.GetPackageCount())
+        SnapshotChanged = true;
+
+    Snapshot.Close();
+
+#ifdef _DEBUG
+    printf("LoadPackages(): Reused %d of %d packages from the index snapshot on %d workers.\n", (uint32_t)Reused, (uint32_t)FilePaths.size(), Workers);
+#endif
+
+    // Save for the next run
+    if (SnapshotChanged && !IndexSnapshotPath.empty())
+        CoDPackageIndexSnapshot::Save(IndexSnapshotPath, Sources);
+}
+
+bool CoDPackageCache::FindCacheObject(uint64_t CacheID, PackageCacheObject& Result)
+{
+    // Packages that have already been added can be used while the rest load
+    if (IndexPublishing)
+    {
+        // Aquire lock
+        std::shared_lock<std::shared_mutex> Lock(IndexMutex);
+
+        // Check if it's in yet
+        if (CacheObjects.TryGetValue(CacheID, Result))
+            return true;
+    }
+
+    // Anything else may be in a package we haven't reached, so wait for the full index
+    WaitForPackageCacheLoad();
+
+    // Aquire lock
+    std::shared_lock<std::shared_mutex> Lock(IndexMutex);
+
+    // Return result
+    return CacheObjects.TryGetValue(CacheID, Result);
+}
+
 void CoDPackageCache::SetLoadedState()
 {
     // Aquire lock
@@ -86,12 +329,157 @@ void CoDPackageCache::SetLoadedState()
 
     // DEBUG
 #ifdef _DEBUG
-    printf("SetLoadedState(): Cache loaded %d objects.\n", (uint32_t)CacheObjects.size());
+    printf("SetLoadedState(): Cache loaded %d objects.\n", (uint32_t)CacheObjects.Size());
 #endif
 
     // Set loading complete
     HasLoaded = true;
     CacheLoading = false;
+
+    // Wake anyone waiting
+    LoadedSignal.notify_all();
+}
+
+std::unique_ptr<uint8_t[]> CoDPackageCache::ExtractPackageObjectCached(uint64_t CacheID, uint32_t& ResultSize)
+{
+    // Use the object cache, the loader is only called on a miss
+    return ObjectCache.GetOrLoad(CacheID, -1, ResultSize, [this, CacheID](uint32_t& LoadedSize)
+    {
+        return this->ExtractPackageObject(CacheID, LoadedSize);
+    });
+}
+
+std::unique_ptr<uint8_t[]> CoDPackageCache::ExtractPackageObjectCached(uint64_t CacheID, int32_t Size, uint32_t& ResultSize)
+{
+    // Use the object cache, the loader is only called on a miss
+    return ObjectCache.GetOrLoad(CacheID, Size, ResultSize, [this, CacheID, Size](uint32_t& LoadedSize)
+    {
+        return this->ExtractPackageObject(CacheID, Size, LoadedSize);
+    });
+}
+
+HANDLE CoDPackageCache::GetPackageHandle(uint32_t PackageFileIndex)
+{
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(PackageHandleMutex);
+    // Packages may still be being added
+    std::shared_lock<std::shared_mutex> IndexLock(IndexMutex);
+
+    // Make sure we can open it
+    if (FileSystem == nullptr || PackageFileIndex >= PackageFilePaths.size())
+        return NULL;
+
+    // Make room for the package
+    if (PackageFileIndex >= PackageHandles.size())
+        PackageHandles.resize(PackageFilePaths.size(), NULL);
+
+    // Open it on first use, it stays open until the cache is destroyed or reloaded
+    if (PackageHandles[PackageFileIndex] == NULL)
+        PackageHandles[PackageFileIndex] = FileSystem->OpenFile(PackageFilePaths[PackageFileIndex], "r");
+
+    // Return result
+    return PackageHandles[PackageFileIndex];
+}
+
+std::unique_ptr<uint8_t[]> CoDPackageCache::ReadPackageData(uint32_t PackageFileIndex, uint64_t Offset, size_t Size)
+{
+    // Get the pooled handle
+    auto Handle = GetPackageHandle(PackageFileIndex);
+
+    // Check if it opened
+    if (Handle == NULL)
+        return nullptr;
+
+    // Positioned read, so workers can share the handle
+    return FileSystem->ReadAt(Handle, (size_t)Offset, Size);
+}
+
+void CoDPackageCache::ClosePackageHandles()
+{
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(PackageHandleMutex);
+
+    // Close each open handle
+    for (auto& Handle : PackageHandles)
+    {
+        if (Handle != NULL && FileSystem != nullptr)
+            FileSystem->CloseFile(Handle);
+
+        Handle = NULL;
+    }
+
+    // Clean up
+    PackageHandles.clear();
+}
+
+void CoDPackageCache::DecompressPackageBlocks(const std::vector<PackageObjectBlock>& Blocks, uint8_t* Result, size_t ResultSize)
+{
+    // Decompresses a range of blocks, the offsets are already known, so ranges never overlap
+    auto DecompressRange = [&Blocks, Result, ResultSize](size_t Begin, size_t End)
+    {
+        for (size_t i = Begin; i < End; i++)
+        {
+            auto& Block = Blocks[i];
+
+            // Never write outside of the result
+            if (Block.DecompressedOffset + Block.DecompressedSize > ResultSize)
+                continue;
+
+            // Check the block type
+            switch (Block.Compression)
+            {
+            case 0x3:
+                // Decompress the LZ4 block
+                Compression::DecompressLZ4Block((const int8_t*)Block.CompressedData, (int8_t*)Result + Block.DecompressedOffset, (int32_t)Block.CompressedSize, (int32_t)Block.DecompressedSize);
+                break;
+            case 0x6:
+                // Decompress the Oodle block
+                Siren::Decompress(Block.CompressedData, Block.CompressedSize, Result + Block.DecompressedOffset, Block.DecompressedSize);
+                break;
+            case 0x0:
+                // We just need to copy it
+                std::memcpy(Result + Block.DecompressedOffset, Block.CompressedData, std::min(Block.CompressedSize, Block.DecompressedSize));
+                break;
+            }
+        }
+    };
+
+    // Calculate the total size
+    size_t TotalSize = 0;
+
+    for (auto& Block : Blocks)
+        TotalSize += Block.DecompressedSize;
+
+    // Small objects, or callers outside of a converter, aren't worth splitting
+    if (Blocks.size() < 2 || TotalSize < PackageParallelDecompressSize || CoDXConverter::Current() == nullptr)
+    {
+        DecompressRange(0, Blocks.size());
+        return;
+    }
+
+    // Split the blocks into jobs, the waiting worker helps out
+    CoDXConverterGroup Group;
+
+    size_t Begin = 0;
+    size_t JobSize = 0;
+
+    for (size_t i = 0; i < Blocks.size(); i++)
+    {
+        JobSize += Blocks[i].DecompressedSize;
+
+        if (JobSize >= PackageBlockJobSize || i + 1 == Blocks.size())
+        {
+            Group.Run(CoDXConverterStage::Decompress, [DecompressRange, Begin, End = i + 1]
+            {
+                DecompressRange(Begin, End);
+            });
+
+            Begin = i + 1;
+            JobSize = 0;
+        }
+    }
+
+    Group.Wait();
 }
 
 CoDFileSystem* CoDPackageCache::GetFileSystem()
@@ -99,40 +487,94 @@ CoDFileSystem* CoDPackageCache::GetFileSystem()
     return FileSystem.get();
 }
 
-void CoDPackageCache::LoadPackageCacheAsync(const std::string& BasePath)
+void CoDPackageCache::StartLoadThread(std::function<void(void)> Load)
 {
+    // Only one load at a time, wait on any previous one
+    if (LoadThread.joinable())
+        LoadThread.join();
+
+    {
+        // Aquire lock
+        std::lock_guard<std::mutex> Lock(CacheMutex);
+
+        // Set that we are loading now, otherwise a wait right after this could return before the thread starts
+        CacheLoading = true;
+        HasLoaded = false;
+    }
+
     // Start a new thread for loading
-    std::thread LoadThread([BasePath, this]
+    LoadThread = std::thread([this, Load]
+    {
+        try
+        {
+            // Send it off
+            Load();
+        }
+        catch (...)
+        {
+            // Never leave waiters hanging on a failed load
+            this->SetLoadedState();
+        }
+    });
+}
+
+void CoDPackageCache::LoadPackageCacheAsync(const std::string& BasePath)
+{
+    // Load on our thread
+    StartLoadThread([BasePath, this]
     {
         // Send it off
         this->LoadPackageCache(BasePath);
     });
-
-    // Detatch while we load
-    LoadThread.detach();
 }
 
 void CoDPackageCache::LoadPackageAsync(const std::string& FilePath)
 {
-    // Start a new thread for loading
-    std::thread LoadThread([FilePath, this]
+    // Load on our thread
+    StartLoadThread([FilePath, this]
     {
         // Send it off
         this->LoadPackage(FilePath);
         // Set the loaded state, this is only called on single entries
         this->SetLoadedState();
     });
-
-    // Detatch while we load
-    LoadThread.detach();
 }
 
 void CoDPackageCache::WaitForPackageCacheLoad()
 {
+    // Aquire lock
+    std::unique_lock<std::mutex> Lock(CacheMutex);
+
     // Wait for us to load
-    while (this->IsCacheLoading())
+    LoadedSignal.wait(Lock, [this] { return !CacheLoading; });
+}
+
+bool CoDPackageCache::WaitForPackageCacheLoad(uint32_t Timeout)
+{
+    // Aquire lock
+    std::unique_lock<std::mutex> Lock(CacheMutex);
+
+    // Wait for us to load, or for the timeout
+    return LoadedSignal.wait_for(Lock, std::chrono::milliseconds(Timeout), [this] { return !CacheLoading; });
+}
+
+PackageCacheLoadProgress CoDPackageCache::GetLoadProgress()
+{
+    // The resulting progress
+    PackageCacheLoadProgress Result{};
+
+    Result.PackagesParsed = PackagesParsed;
+    Result.PackagesTotal = PackagesTotal;
+    Result.Loaded = HasCacheLoaded();
+
     {
-        // Sleep to make sure the CPU isn't being over worked
-        Sleep(100);
+        // Aquire lock
+        std::shared_lock<std::shared_mutex> Lock(IndexMutex);
+
+        // Get the indexed count
+        Result.EntriesIndexed = CacheObjects.Size();
     }
-}
\ No newline at end of file
+
+    // Return result
+    return Result;
+}
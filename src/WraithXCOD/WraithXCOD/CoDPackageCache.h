@@ -3,24 +3,69 @@
 #include <string>
 #include <cstdint>
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <functional>
 #include <vector>
 #include <unordered_map>
 
 // We need the file system class
 #include "CoDFileSystem.h"
+// We need the object cache class
+#include "CoDPackageObjectCache.h"
+// We need the object map class
+#include "CoDPackageObjectMap.h"
 
-// A structure that represents a package cache object, this is generic and is used in all of the assets
-struct PackageCacheObject
+// A structure that represents a single entry in a package's hash table, before it is assigned a package index
+struct PackageIndexEntry
 {
+    // The hash of the object
+    uint64_t Key;
     // The data offset of this object
     uint64_t Offset;
     // The size of this object
     uint64_t CompressedSize;
     // The size of this object uncompressed
     uint64_t UncompressedSize;
+};
+
+// A structure that represents the parsed hash table of a single package file
+struct PackageIndex
+{
+    // The path objects are read from, empty if the package has no data
+    std::string FilePath;
+    // The entries within the package
+    std::vector<PackageIndexEntry> Entries;
+};
 
-    // The index of the package file used for this
-    uint32_t PackageFileIndex;
+// A structure that represents the progress of a package cache load
+struct PackageCacheLoadProgress
+{
+    // The number of packages parsed or reused from the snapshot
+    uint32_t PackagesParsed;
+    // The number of packages found
+    uint32_t PackagesTotal;
+    // The number of objects indexed and ready for use
+    uint64_t EntriesIndexed;
+    // Whether or not loading has finished
+    bool Loaded;
+};
+
+// A structure that represents a block of a package object that can be decompressed on its own
+struct PackageObjectBlock
+{
+    // The compression of this block (0 = raw, 3 = lz4, 6 = oodle)
+    uint32_t Compression;
+    // The compressed data
+    const uint8_t* CompressedData;
+    // The size of the compressed data
+    size_t CompressedSize;
+    // The offset of this block within the decompressed object
+    size_t DecompressedOffset;
+    // The size of this block decompressed
+    size_t DecompressedSize;
 };
 
 // A class that handles reading and indexing game package files for later extraction of data
@@ -47,8 +92,12 @@ public:
 
     // Waits for the package cache to load, blocking the current thread
     void WaitForPackageCacheLoad();
-    // Returns if a cache object exists
-    virtual bool Exists(uint64_t CacheID) { return CacheObjects.find(CacheID) != CacheObjects.end(); }
+    // Waits for the package cache to load for up to the given milliseconds, returns true if it has finished
+    bool WaitForPackageCacheLoad(uint32_t Timeout);
+    // Gets the progress of the current load
+    PackageCacheLoadProgress GetLoadProgress();
+    // Returns if a cache object exists, waiting on the load if it isn't indexed yet
+    virtual bool Exists(uint64_t CacheID) { PackageCacheObject CacheInfo; return FindCacheObject(CacheID, CacheInfo); }
     // Returns the literal cache object with no /decompression applied (nullptr if not found)
     virtual std::unique_ptr<uint8_t[]> ExtractPackageObjectRaw(uint64_t CacheID, uint32_t& ResultSize) { return nullptr; }
     // Returns a cache object (nullptr if not found)
@@ -57,16 +106,26 @@ public:
     virtual std::unique_ptr<uint8_t[]> ExtractPackageObject(uint64_t CacheID, int32_t Size, uint32_t& ResultSize) { return nullptr; }
     // Returns a cache object (nullptr if not found)
     virtual std::unique_ptr<uint8_t[]> ExtractPackageObject(const std::string& PackageName, uint64_t AssetOffset, uint64_t AssetSize, size_t& ResultSize) { return nullptr; }
+    // Returns a cache object, served from the object cache if recently extracted (nullptr if not found)
+    std::unique_ptr<uint8_t[]> ExtractPackageObjectCached(uint64_t CacheID, uint32_t& ResultSize);
+    // Returns a cache object, served from the object cache if recently extracted (nullptr if not found)
+    std::unique_ptr<uint8_t[]> ExtractPackageObjectCached(uint64_t CacheID, int32_t Size, uint32_t& ResultSize);
+
+    // Gets the cache of recently extracted objects
+    CoDPackageObjectCache& GetObjectCache() { return ObjectCache; }
 
     // Hashes a cache object id if needed
     virtual uint64_t HashPackageID(const std::string& Value) { return 0; }
 
     // Returns the current packages path
-    std::string GetPackagesPath() { return PackageFilesPath; }
+    std::string GetPackagesPath() { WaitForPackageCacheLoad(); return PackageFilesPath; }
 
     // Sets the cache state to loaded
     virtual void SetLoadedState();
 
+    // Decompresses the blocks of a package object into the result, large objects are spread over the current converter
+    static void DecompressPackageBlocks(const std::vector<PackageObjectBlock>& Blocks, uint8_t* Result, size_t ResultSize);
+
     // Gets the current file system
     virtual CoDFileSystem* GetFileSystem();
 
@@ -77,10 +136,30 @@ protected:
     // Loads the package file
     virtual bool LoadPackage(const std::string& FilePath);    
 
+    // Finds a cache object, objects from packages already indexed are returned while the rest load, anything else waits on the load
+    bool FindCacheObject(uint64_t CacheID, PackageCacheObject& Result);
+
+    // Parses the hash table of a package file without adding it to the cache
+    virtual bool ParsePackage(const std::string& FilePath, PackageIndex& Index) { return false; }
+    // Adds a parsed package to the cache, assigning it the next package index
+    void AddPackage(const PackageIndex& Index);
+    // Loads the given package files in order, reusing the index snapshot for any that haven't changed
+    void LoadPackages(const std::vector<std::string>& FilePaths);
+
+    // Gets a pooled handle for the given package file, opening it on first use
+    HANDLE GetPackageHandle(uint32_t PackageFileIndex);
+    // Reads data from the given package file with a positioned read, safe to call from multiple threads
+    std::unique_ptr<uint8_t[]> ReadPackageData(uint32_t PackageFileIndex, uint64_t Offset, size_t Size);
+    // Closes all pooled package handles
+    void ClosePackageHandles();
+
+    // Calculates the object cache capacity from settings
+    static size_t CalculateObjectCacheCapacity();
+
     // -- Cache data
 
     // A list of cached objects in this package cache
-    std::unordered_map<uint64_t, PackageCacheObject> CacheObjects;
+    CoDPackageObjectMap CacheObjects;
     // A list of cached package file paths
     std::vector<std::string> PackageFilePaths;
 
@@ -98,9 +177,36 @@ private:
 
     // A mutex for read operations
     std::mutex CacheMutex;
+    // Signalled when loading finishes
+    std::condition_variable LoadedSignal;
+    // The thread performing an async load, owned so it never outlives the cache
+    std::thread LoadThread;
+
+    // A mutex for the objects and package paths, held shared for lookups and exclusively while adding packages
+    std::shared_mutex IndexMutex;
+    // Whether or not packages are being added under the index mutex, lookups may run alongside the load while set
+    std::atomic<bool> IndexPublishing;
+    // The number of packages parsed or reused
+    std::atomic<uint32_t> PackagesParsed;
+    // The number of packages found
+    std::atomic<uint32_t> PackagesTotal;
+
+    // The pooled package handles, indexed by package file index
+    std::vector<HANDLE> PackageHandles;
+    // A mutex for the pooled package handles
+    std::mutex PackageHandleMutex;
+
+    // The recently extracted objects
+    CoDPackageObjectCache ObjectCache;
+
+    // The path of the index snapshot for this cache
+    std::string IndexSnapshotPath;
 
     // Whether or not this package is loaded
     bool HasLoaded;
     // Whether or not this package is loading
     bool CacheLoading;
+
+    // Starts an async load, marking the cache as loading before the thread starts so waiters never miss it
+    void StartLoadThread(std::function<void(void)> Load);
 };
\ No newline at end of file
@@ -0,0 +1,273 @@
+#include "stdafx.h"
+
+// The class we are implementing
+#include "CoDPackageIndexSnapshot.h"
+
+// We need the following classes
+#include "FileSystems.h"
+#include "BinaryWriter.h"
+
+// The header of a snapshot, followed by the packages, the entries, then the string table
+struct PackageSnapshotHeader
+{
+    // The magic, PIDX
+    uint32_t Magic;
+    // The version
+    uint32_t Version;
+    // The number of packages
+    uint32_t PackageCount;
+    // Padding
+    uint32_t Reserved;
+    // The number of entries
+    uint64_t EntryCount;
+    // The size of the string table
+    uint64_t StringsSize;
+};
+
+// The snapshot magic
+constexpr uint32_t PackageSnapshotMagic = 0x58444950;
+// The snapshot version, bump when the layout or the package parsers change
+constexpr uint32_t PackageSnapshotVersion = 2;
+
+// Verify
+static_assert(sizeof(PackageSnapshotHeader) == 32, "Invalid Package Snapshot Header Size (Expected 32)");
+static_assert(sizeof(PackageSnapshotRecord) == 56, "Invalid Package Snapshot Record Size (Expected 56)");
+static_assert(sizeof(PackageIndexEntry) == 32, "Invalid Package Index Entry Size (Expected 32)");
+
+CoDPackageIndexSnapshot::CoDPackageIndexSnapshot()
+{
+    // Defaults
+    FileHandle = INVALID_HANDLE_VALUE;
+    MappingHandle = NULL;
+    View = nullptr;
+    ViewSize = 0;
+    Packages = nullptr;
+    PackageCount = 0;
+    Entries = nullptr;
+    EntryCount = 0;
+    Strings = nullptr;
+    StringsSize = 0;
+}
+
+CoDPackageIndexSnapshot::~CoDPackageIndexSnapshot()
+{
+    // Clean up
+    Close();
+}
+
+bool CoDPackageIndexSnapshot::Open(const std::string& FileName)
+{
+    // Close any existing snapshot
+    Close();
+
+    // Open the file
+    FileHandle = CreateFileA(FileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    // Get the size
+    LARGE_INTEGER FileSize{};
+
+    if (!GetFileSizeEx(FileHandle, &FileSize) || (uint64_t)FileSize.QuadPart < sizeof(PackageSnapshotHeader))
+    {
+        Close();
+        return false;
+    }
+
+    // Map it
+    MappingHandle = CreateFileMappingA(FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (MappingHandle == NULL)
+    {
+        Close();
+        return false;
+    }
+
+    View = (const uint8_t*)MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+    ViewSize = FileSize.QuadPart;
+
+    if (View == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    // Validate the header and that every section is within the file
+    auto Header = (const PackageSnapshotHeader*)View;
+
+    if (Header->Magic != PackageSnapshotMagic || Header->Version != PackageSnapshotVersion)
+    {
+        Close();
+        return false;
+    }
+
+    uint64_t PackagesSize = (uint64_t)Header->PackageCount * sizeof(PackageSnapshotRecord);
+    uint64_t EntriesSize = Header->EntryCount * sizeof(PackageIndexEntry);
+
+    if (sizeof(PackageSnapshotHeader) + PackagesSize + EntriesSize + Header->StringsSize != ViewSize)
+    {
+        Close();
+        return false;
+    }
+
+    // Set up the sections, nothing is parsed, everything is used in place
+    Packages = (const PackageSnapshotRecord*)(View + sizeof(PackageSnapshotHeader));
+    PackageCount = Header->PackageCount;
+    Entries = (const PackageIndexEntry*)(View + sizeof(PackageSnapshotHeader) + PackagesSize);
+    EntryCount = Header->EntryCount;
+    Strings = (const char*)(View + sizeof(PackageSnapshotHeader) + PackagesSize + EntriesSize);
+    StringsSize = Header->StringsSize;
+
+    // Success
+    return true;
+}
+
+void CoDPackageIndexSnapshot::Close()
+{
+    // Clean up in reverse
+    if (View != nullptr)
+        UnmapViewOfFile(View);
+    if (MappingHandle != NULL)
+        ::CloseHandle(MappingHandle);
+    if (FileHandle != INVALID_HANDLE_VALUE)
+        ::CloseHandle(FileHandle);
+
+    FileHandle = INVALID_HANDLE_VALUE;
+    MappingHandle = NULL;
+    View = nullptr;
+    ViewSize = 0;
+    Packages = nullptr;
+    PackageCount = 0;
+    Entries = nullptr;
+    EntryCount = 0;
+    Strings = nullptr;
+    StringsSize = 0;
+}
+
+std::string CoDPackageIndexSnapshot::GetString(uint32_t Offset, uint32_t Length) const
+{
+    // Bounds check
+    if ((uint64_t)Offset + Length > StringsSize)
+        return "";
+
+    return std::string(Strings + Offset, Length);
+}
+
+const PackageSnapshotRecord* CoDPackageIndexSnapshot::FindPackage(const std::string& SourcePath, uint64_t Size, uint64_t ModifiedTime) const
+{
+    // Nothing known about packages we can't fingerprint
+    if (ModifiedTime == 0)
+        return nullptr;
+
+    for (uint32_t i = 0; i < PackageCount; i++)
+    {
+        auto& Record = Packages[i];
+
+        // Cheap checks first
+        if (Record.Size != Size || Record.ModifiedTime != ModifiedTime || Record.SourcePathLength != SourcePath.size())
+            continue;
+        if ((uint64_t)Record.SourcePathOffset + Record.SourcePathLength > StringsSize)
+            continue;
+        if (Record.EntryIndex + Record.EntryCount > EntryCount)
+            continue;
+
+        // Compare the path in place
+        if (std::memcmp(Strings + Record.SourcePathOffset, SourcePath.c_str(), SourcePath.size()) == 0)
+            return &Record;
+    }
+
+    // Changed or new
+    return nullptr;
+}
+
+bool CoDPackageIndexSnapshot::ReadPackage(const PackageSnapshotRecord* Record, PackageIndex& Index) const
+{
+    // Packages that failed last time will fail again, there's nothing to copy
+    if (Record->Flags & (uint32_t)PackageSnapshotFlags::ParseFailed)
+        return false;
+
+    // Copy the path and the entries
+    Index.FilePath = GetString(Record->FilePathOffset, Record->FilePathLength);
+    Index.Entries.assign(Entries + Record->EntryIndex, Entries + Record->EntryIndex + Record->EntryCount);
+
+    // Success
+    return true;
+}
+
+bool CoDPackageIndexSnapshot::Save(const std::string& FileName, const std::vector<PackageSnapshotSource>& Packages)
+{
+    // Build the header, records, and string table first
+    PackageSnapshotHeader Header{};
+    Header.Magic = PackageSnapshotMagic;
+    Header.Version = PackageSnapshotVersion;
+    Header.PackageCount = (uint32_t)Packages.size();
+
+    std::vector<PackageSnapshotRecord> Records;
+    std::string StringTable;
+
+    Records.reserve(Packages.size());
+
+    for (auto& Package : Packages)
+    {
+        PackageSnapshotRecord Record{};
+
+        Record.Size = Package.Size;
+        Record.ModifiedTime = Package.ModifiedTime;
+        Record.EntryIndex = Header.EntryCount;
+        Record.SourcePathOffset = (uint32_t)StringTable.size();
+        Record.SourcePathLength = (uint32_t)Package.SourcePath.size();
+        StringTable += Package.SourcePath;
+        Record.FilePathOffset = (uint32_t)StringTable.size();
+
+        // Failed packages are kept by fingerprint only, so they aren't parsed again until they change
+        if (Package.Index != nullptr)
+        {
+            Record.EntryCount = Package.Index->Entries.size();
+            Record.FilePathLength = (uint32_t)Package.Index->FilePath.size();
+            StringTable += Package.Index->FilePath;
+        }
+        else
+        {
+            Record.Flags = (uint32_t)PackageSnapshotFlags::ParseFailed;
+        }
+
+        Header.EntryCount += Record.EntryCount;
+        Records.push_back(Record);
+    }
+
+    Header.StringsSize = StringTable.size();
+
+    // Write to a temporary file, then swap it in, so a crash never leaves a half written snapshot
+    auto TempFileName = FileName + ".tmp";
+
+    {
+        BinaryWriter Writer;
+
+        if (!Writer.Create(TempFileName))
+            return false;
+
+        Writer.Write(Header);
+
+        if (!Records.empty())
+            Writer.Write((const int8_t*)Records.data(), (uint32_t)(Records.size() * sizeof(PackageSnapshotRecord)));
+
+        for (auto& Package : Packages)
+        {
+            if (Package.Index != nullptr && !Package.Index->Entries.empty())
+                Writer.Write((const int8_t*)Package.Index->Entries.data(), (uint32_t)(Package.Index->Entries.size() * sizeof(PackageIndexEntry)));
+        }
+
+        if (!StringTable.empty())
+            Writer.Write((const int8_t*)StringTable.data(), (uint32_t)StringTable.size());
+    }
+
+    if (!MoveFileExA(TempFileName.c_str(), FileName.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        FileSystems::DeleteFile(TempFileName);
+        return false;
+    }
+
+    // Success
+    return true;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <vector>
+
+// We need the package cache structures
+#include "CoDPackageCache.h"
+
+// Flags for a package in the snapshot
+enum class PackageSnapshotFlags : uint32_t
+{
+    // The package failed to parse, and has no entries
+    ParseFailed = 1,
+};
+
+// A package as stored in the snapshot, everything is fixed size so the file can be used in place
+struct PackageSnapshotRecord
+{
+    // The size of the package file when indexed
+    uint64_t Size;
+    // The last write time of the package file when indexed
+    uint64_t ModifiedTime;
+    // The index of the first entry
+    uint64_t EntryIndex;
+    // The number of entries
+    uint64_t EntryCount;
+    // The offset of the enumerated path in the string table
+    uint32_t SourcePathOffset;
+    // The length of the enumerated path
+    uint32_t SourcePathLength;
+    // The offset of the path objects are read from in the string table
+    uint32_t FilePathOffset;
+    // The length of the path objects are read from
+    uint32_t FilePathLength;
+    // The package flags
+    uint32_t Flags;
+    // Padding
+    uint32_t Reserved;
+};
+
+// A package to write to a snapshot
+struct PackageSnapshotSource
+{
+    // The path the package was enumerated as
+    std::string SourcePath;
+    // The size of the package file
+    uint64_t Size;
+    // The last write time of the package file
+    uint64_t ModifiedTime;
+    // The parsed package, nullptr if it failed to parse
+    const PackageIndex* Index;
+};
+
+// A class that reads and writes a memory mapped snapshot of a package cache index
+class CoDPackageIndexSnapshot
+{
+public:
+    // Constructors
+    CoDPackageIndexSnapshot();
+    ~CoDPackageIndexSnapshot();
+
+    // Maps an existing snapshot, returns false if it's missing or invalid
+    bool Open(const std::string& FileName);
+    // Unmaps the snapshot
+    void Close();
+
+    // Gets the number of packages in the snapshot
+    uint32_t GetPackageCount() const { return PackageCount; }
+    // Gets the number of entries in the snapshot
+    uint64_t GetEntryCount() const { return EntryCount; }
+    // Finds a package whose fingerprint still matches, nullptr if it changed or isn't in the snapshot
+    const PackageSnapshotRecord* FindPackage(const std::string& SourcePath, uint64_t Size, uint64_t ModifiedTime) const;
+    // Copies a package from the snapshot into the given index, returns false if it failed to parse when indexed
+    bool ReadPackage(const PackageSnapshotRecord* Record, PackageIndex& Index) const;
+
+    // Writes a new snapshot, replacing any existing one
+    static bool Save(const std::string& FileName, const std::vector<PackageSnapshotSource>& Packages);
+
+private:
+    // The open file
+    HANDLE FileHandle;
+    // The file mapping
+    HANDLE MappingHandle;
+    // The mapped view
+    const uint8_t* View;
+    // The size of the mapped view
+    uint64_t ViewSize;
+
+    // The package records
+    const PackageSnapshotRecord* Packages;
+    // The number of package records
+    uint32_t PackageCount;
+    // The entries
+    const PackageIndexEntry* Entries;
+    // The number of entries
+    uint64_t EntryCount;
+    // The string table
+    const char* Strings;
+    // The size of the string table
+    uint64_t StringsSize;
+
+    // Gets a string from the string table
+    std::string GetString(uint32_t Offset, uint32_t Length) const;
+};
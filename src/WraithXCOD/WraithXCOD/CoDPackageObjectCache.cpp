@@ -0,0 +1,246 @@
+#include "stdafx.h"
+
+// The class we are implementing
+#include "CoDPackageObjectCache.h"
+
+// The number of loads the current thread is performing, a thread that is loading never waits on
+// another load, as the other load may be waiting on a job this thread has taken while helping
+static thread_local uint32_t ActiveLoads = 0;
+
+CoDPackageObjectCache::CoDPackageObjectCache(size_t Capacity)
+{
+    // Defaults
+    this->Capacity = Capacity;
+    CurrentSize = 0;
+    Hits = 0;
+    Misses = 0;
+    Evictions = 0;
+}
+
+std::unique_ptr<uint8_t[]> CoDPackageObjectCache::GetOrLoad(uint64_t CacheID, int32_t Size, uint32_t& ResultSize, const std::function<std::unique_ptr<uint8_t[]>(uint32_t&)>& Loader)
+{
+    // The key we're after
+    ObjectKey Key{ CacheID, Size };
+    // The object we found in the cache, if any
+    CachedObject Found{};
+    // The load we'll be waiting on, if any
+    std::shared_future<CachedObject> Pending;
+    // The load we'll be performing, if any
+    std::promise<CachedObject> Promise;
+    // Whether or not we're the one loading
+    bool ShouldLoad = false;
+
+    {
+        // Aquire lock
+        std::lock_guard<std::mutex> Lock(CacheMutex);
+
+        // Check the cache first
+        auto Entry = Entries.find(Key);
+
+        if (Entry != Entries.end())
+        {
+            // Move it to the front
+            RecentlyUsed.splice(RecentlyUsed.begin(), RecentlyUsed, Entry->second.Position);
+            Hits++;
+
+            // Take a reference, it's copied out once we've let go of the lock
+            Found = Entry->second.Object;
+        }
+        else
+        {
+            // Check if someone is loading it
+            auto Load = Loading.find(Key);
+
+            if (Load != Loading.end() && ActiveLoads == 0)
+            {
+                // Wait on them
+                Pending = Load->second.Object;
+                Load->second.Waiters++;
+                Hits++;
+            }
+            else if (Load == Loading.end())
+            {
+                // We'll load it
+                Loading[Key] = { Promise.get_future().share(), 0 };
+                ShouldLoad = true;
+                Misses++;
+            }
+            else
+            {
+                // We can't safely wait, so load our own copy
+                Misses++;
+            }
+        }
+    }
+
+    // Copy out what we found
+    if (Found.Data != nullptr)
+    {
+        return CopyObject(Found, Size, ResultSize);
+    }
+
+    // Wait for the other load
+    if (Pending.valid())
+    {
+        return CopyObject(Pending.get(), Size, ResultSize);
+    }
+
+    // Load the object
+    std::unique_ptr<uint8_t[]> Data;
+    uint32_t LoadedSize = 0;
+
+    ActiveLoads++;
+
+    try
+    {
+        // Send it off
+        Data = Loader(LoadedSize);
+    }
+    catch (...)
+    {
+        // Nothing, treat as not found
+        Data = nullptr;
+    }
+
+    ActiveLoads--;
+
+    // Check if it loaded
+    if (Data == nullptr)
+        LoadedSize = 0;
+
+    // If we aren't publishing it, it's ours
+    if (!ShouldLoad)
+    {
+        ResultSize = LoadedSize;
+        return Data;
+    }
+
+    // The object, shared only if someone else needs it
+    CachedObject Object{};
+
+    {
+        // Aquire lock
+        std::lock_guard<std::mutex> Lock(CacheMutex);
+
+        // No longer loading, anyone after this loads their own
+        auto Load = Loading.find(Key);
+        auto IsWaited = (Load->second.Waiters > 0);
+        Loading.erase(Load);
+
+        // Share it if the cache keeps it, or someone is waiting on it
+        if (Data != nullptr && (IsWaited || ShouldKeep(LoadedSize)))
+        {
+            Object.Data = std::shared_ptr<uint8_t>(Data.release(), std::default_delete<uint8_t[]>());
+            Object.DataSize = LoadedSize;
+
+            // Keep it if it's worth it
+            Insert(Key, Object);
+        }
+    }
+
+    // Wake any waiters
+    Promise.set_value(Object);
+
+    // Nobody else has it, hand it over as is
+    if (Object.Data == nullptr)
+    {
+        ResultSize = LoadedSize;
+        return Data;
+    }
+
+    // Copy it out
+    return CopyObject(Object, Size, ResultSize);
+}
+
+void CoDPackageObjectCache::Clear()
+{
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+
+    // Clean up, anything loading will still be handed to its waiters
+    Entries.clear();
+    RecentlyUsed.clear();
+    CurrentSize = 0;
+}
+
+void CoDPackageObjectCache::SetCapacity(size_t Capacity)
+{
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+
+    // Set and trim
+    this->Capacity = Capacity;
+    EvictTo(Capacity);
+}
+
+size_t CoDPackageObjectCache::GetSize()
+{
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+
+    // Return result
+    return CurrentSize;
+}
+
+bool CoDPackageObjectCache::ShouldKeep(uint32_t DataSize) const
+{
+    // Objects that would push out most of the cache aren't worth keeping
+    return (Capacity > 0 && DataSize <= Capacity / 4);
+}
+
+void CoDPackageObjectCache::Insert(const ObjectKey& Key, const CachedObject& Object)
+{
+    // Skip objects we shouldn't keep
+    if (!ShouldKeep(Object.DataSize))
+        return;
+
+    // Replace it if it somehow already exists
+    auto Existing = Entries.find(Key);
+
+    if (Existing != Entries.end())
+    {
+        CurrentSize -= Existing->second.Object.DataSize;
+        RecentlyUsed.erase(Existing->second.Position);
+        Entries.erase(Existing);
+    }
+
+    // Make room
+    EvictTo(Capacity - Object.DataSize);
+
+    // Add it to the front
+    RecentlyUsed.push_front(Key);
+    Entries[Key] = { Object, RecentlyUsed.begin() };
+    CurrentSize += Object.DataSize;
+}
+
+void CoDPackageObjectCache::EvictTo(size_t TargetSize)
+{
+    // Drop the least recently used until we fit
+    while (CurrentSize > TargetSize && !RecentlyUsed.empty())
+    {
+        auto Entry = Entries.find(RecentlyUsed.back());
+
+        CurrentSize -= Entry->second.Object.DataSize;
+        Entries.erase(Entry);
+        RecentlyUsed.pop_back();
+        Evictions++;
+    }
+}
+
+std::unique_ptr<uint8_t[]> CoDPackageObjectCache::CopyObject(const CachedObject& Object, int32_t Size, uint32_t& ResultSize)
+{
+    // Check if it loaded
+    if (Object.Data == nullptr)
+    {
+        ResultSize = 0;
+        return nullptr;
+    }
+
+    // Callers may read up to the size they asked for, which can be beyond what was decompressed
+    auto Result = std::make_unique<uint8_t[]>(std::max<size_t>(Object.DataSize, Size > 0 ? (size_t)Size : 0));
+    std::memcpy(Result.get(), Object.Data.get(), Object.DataSize);
+
+    // Set result size
+    ResultSize = Object.DataSize;
+    return Result;
+}
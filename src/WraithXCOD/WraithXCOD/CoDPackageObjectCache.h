@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <unordered_map>
+
+// A class that keeps recently decompressed package objects in memory, bounded by size, least recently used are evicted first
+class CoDPackageObjectCache
+{
+public:
+    // Creates a new cache with the given capacity in bytes
+    CoDPackageObjectCache(size_t Capacity);
+
+    // Gets an object from the cache, calling the loader on a miss, callers asking for an object that is loading wait on it
+    std::unique_ptr<uint8_t[]> GetOrLoad(uint64_t CacheID, int32_t Size, uint32_t& ResultSize, const std::function<std::unique_ptr<uint8_t[]>(uint32_t&)>& Loader);
+
+    // Removes all objects from the cache
+    void Clear();
+    // Sets the capacity in bytes, evicting objects if needed
+    void SetCapacity(size_t Capacity);
+
+    // Gets the number of requests served from the cache
+    uint64_t GetHits() const { return Hits; }
+    // Gets the number of requests that had to be loaded
+    uint64_t GetMisses() const { return Misses; }
+    // Gets the number of objects evicted to make room
+    uint64_t GetEvictions() const { return Evictions; }
+    // Gets the number of bytes currently held
+    size_t GetSize();
+
+private:
+    // The key of an object, the same object can be extracted with different sizes
+    struct ObjectKey
+    {
+        // The id of the object
+        uint64_t CacheID;
+        // The size requested
+        int32_t Size;
+
+        // Compares two keys
+        bool operator==(const ObjectKey& Rhs) const { return CacheID == Rhs.CacheID && Size == Rhs.Size; }
+    };
+
+    // Hashes an object key
+    struct ObjectKeyHash
+    {
+        size_t operator()(const ObjectKey& Key) const { return (size_t)(Key.CacheID ^ ((uint64_t)(uint32_t)Key.Size * 0x9E3779B97F4A7C15)); }
+    };
+
+    // A loaded object, shared between the cache and anyone copying it out
+    struct CachedObject
+    {
+        // The decompressed data
+        std::shared_ptr<uint8_t> Data;
+        // The size of the data
+        uint32_t DataSize;
+    };
+
+    // An object held by the cache
+    struct CacheEntry
+    {
+        // The object
+        CachedObject Object;
+        // The position in the recently used list
+        std::list<ObjectKey>::iterator Position;
+    };
+
+    // The objects, most recently used at the front
+    std::list<ObjectKey> RecentlyUsed;
+    // The objects, by key
+    std::unordered_map<ObjectKey, CacheEntry, ObjectKeyHash> Entries;
+    // An object being loaded
+    struct LoadingObject
+    {
+        // The object, once loaded
+        std::shared_future<CachedObject> Object;
+        // The number of callers waiting on it
+        uint32_t Waiters;
+    };
+
+    // The objects currently being loaded
+    std::unordered_map<ObjectKey, LoadingObject, ObjectKeyHash> Loading;
+
+    // A mutex for cache operations
+    std::mutex CacheMutex;
+
+    // The maximum number of bytes to hold
+    size_t Capacity;
+    // The number of bytes held
+    size_t CurrentSize;
+
+    // Counters
+    std::atomic<uint64_t> Hits;
+    std::atomic<uint64_t> Misses;
+    std::atomic<uint64_t> Evictions;
+
+    // Whether or not an object of this size is worth keeping, the lock must be held
+    bool ShouldKeep(uint32_t DataSize) const;
+    // Adds an object, evicting old ones as needed, the lock must be held
+    void Insert(const ObjectKey& Key, const CachedObject& Object);
+    // Evicts objects until we're under the given size, the lock must be held
+    void EvictTo(size_t TargetSize);
+    // Copies an object out for the caller
+    static std::unique_ptr<uint8_t[]> CopyObject(const CachedObject& Object, int32_t Size, uint32_t& ResultSize);
+};
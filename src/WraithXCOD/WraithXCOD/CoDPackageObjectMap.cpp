@@ -0,0 +1,152 @@
+#include "stdafx.h"
+
+// The class we are implementing
+#include "CoDPackageObjectMap.h"
+
+// The smallest table we'll allocate
+constexpr size_t PackageObjectMapMinSlots = 16;
+
+// Verify
+static_assert(sizeof(PackageCacheObject) == 32, "Invalid Package Cache Object Size (Expected 32)");
+
+CoDPackageObjectMap::CoDPackageObjectMap()
+{
+    // Defaults
+    Count = 0;
+    Shift = 64;
+    ZeroObject = PackageCacheObject{};
+    HasZeroObject = false;
+}
+
+size_t CoDPackageObjectMap::FindSlot(uint64_t Key) const
+{
+    // Keys are already hashes, but the low bits aren't always well spread, so mix them once with a multiply
+    auto Mask = Slots.size() - 1;
+    auto Index = (size_t)((Key * 0x9E3779B97F4A7C15) >> Shift);
+
+    // Walk until we find the key or a gap, the table is never full, so this always ends
+    while (Slots[Index].Key != Key && Slots[Index].Key != 0)
+        Index = (Index + 1) & Mask;
+
+    // Return result
+    return Index;
+}
+
+void CoDPackageObjectMap::Rehash(size_t SlotCount)
+{
+    // Round up to a power of two
+    size_t NewSize = PackageObjectMapMinSlots;
+    uint32_t NewShift = 60;
+
+    while (NewSize < SlotCount)
+    {
+        NewSize <<= 1;
+        NewShift--;
+    }
+
+    // Nothing to do if we're already this big
+    if (NewSize <= Slots.size())
+        return;
+
+    // Swap in the new table and move everything over
+    std::vector<ObjectSlot> OldSlots(NewSize, ObjectSlot{});
+    OldSlots.swap(Slots);
+    Shift = NewShift;
+
+    for (auto& Slot : OldSlots)
+    {
+        if (Slot.Key != 0)
+            Slots[FindSlot(Slot.Key)] = Slot;
+    }
+}
+
+void CoDPackageObjectMap::Reserve(size_t Count)
+{
+    // Keep the load under 75%
+    Rehash(Count + Count / 3 + 1);
+}
+
+bool CoDPackageObjectMap::Insert(uint64_t Key, const PackageCacheObject& Object)
+{
+    // Zero is kept on the side
+    if (Key == 0)
+    {
+        if (HasZeroObject)
+            return false;
+
+        ZeroObject = Object;
+        HasZeroObject = true;
+        Count++;
+        return true;
+    }
+
+    // Grow if this would push us past 75%
+    auto SlotCount = Count - (HasZeroObject ? 1 : 0);
+
+    if ((SlotCount + 1) * 4 > Slots.size() * 3)
+        Rehash(std::max<size_t>(Slots.size() * 2, PackageObjectMapMinSlots));
+
+    // Find the slot
+    auto& Slot = Slots[FindSlot(Key)];
+
+    // Keep the first object added, same as the old map
+    if (Slot.Key == Key)
+        return false;
+
+    Slot.Key = Key;
+    Slot.Object = Object;
+    Count++;
+
+    // Success
+    return true;
+}
+
+bool CoDPackageObjectMap::TryGetValue(uint64_t Key, PackageCacheObject& Result) const
+{
+    // Check the side slot
+    if (Key == 0)
+    {
+        if (HasZeroObject)
+            Result = ZeroObject;
+
+        return HasZeroObject;
+    }
+
+    // Nothing loaded
+    if (Slots.empty())
+        return false;
+
+    // Find the slot
+    auto& Slot = Slots[FindSlot(Key)];
+
+    if (Slot.Key != Key)
+        return false;
+
+    // Copy it out
+    Result = Slot.Object;
+    return true;
+}
+
+bool CoDPackageObjectMap::Contains(uint64_t Key) const
+{
+    // Check the side slot
+    if (Key == 0)
+        return HasZeroObject;
+
+    // Nothing loaded
+    if (Slots.empty())
+        return false;
+
+    // Return result
+    return Slots[FindSlot(Key)].Key == Key;
+}
+
+void CoDPackageObjectMap::Clear()
+{
+    // Free the table, caches are large, so don't hold on to it
+    std::vector<ObjectSlot>().swap(Slots);
+    Count = 0;
+    Shift = 64;
+    ZeroObject = PackageCacheObject{};
+    HasZeroObject = false;
+}
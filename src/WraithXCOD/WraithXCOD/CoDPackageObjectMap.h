@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// A structure that represents a package cache object, this is generic and is used in all of the assets
+struct PackageCacheObject
+{
+    // The data offset of this object
+    uint64_t Offset;
+    // The size of this object
+    uint64_t CompressedSize;
+    // The size of this object uncompressed
+    uint64_t UncompressedSize;
+
+    // The index of the package file used for this
+    uint32_t PackageFileIndex;
+};
+
+// A flat open addressing map of package objects, keyed by their pre-hashed 64-bit ids, objects are stored inline with linear probing
+class CoDPackageObjectMap
+{
+public:
+    // Constructors
+    CoDPackageObjectMap();
+
+    // Makes room for the given number of objects without growing
+    void Reserve(size_t Count);
+    // Adds an object, returns false and keeps the existing object if the key already exists
+    bool Insert(uint64_t Key, const PackageCacheObject& Object);
+    // Gets an object by key, returns false if it doesn't exist
+    bool TryGetValue(uint64_t Key, PackageCacheObject& Result) const;
+    // Checks if an object exists
+    bool Contains(uint64_t Key) const;
+
+    // Gets the number of objects
+    size_t Size() const { return Count; }
+    // Removes all objects and frees the table
+    void Clear();
+
+private:
+    // A slot in the table, a zero key marks an empty slot
+    struct ObjectSlot
+    {
+        // The key of the object
+        uint64_t Key;
+        // The object
+        PackageCacheObject Object;
+    };
+
+    // The slots, always a power of two in size
+    std::vector<ObjectSlot> Slots;
+    // The number of objects in the slots
+    size_t Count;
+    // The shift applied to a hashed key to get its slot
+    uint32_t Shift;
+
+    // Zero can't be stored in a slot, so it's kept on the side
+    PackageCacheObject ZeroObject;
+    // Whether or not the zero key exists
+    bool HasZeroObject;
+
+    // Finds the slot for a key, either the one holding it, or the empty one it would go in
+    size_t FindSlot(uint64_t Key) const;
+    // Rebuilds the table with the given number of slots
+    void Rehash(size_t SlotCount);
+};
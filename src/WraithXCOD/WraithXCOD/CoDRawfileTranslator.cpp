@@ -12,7 +12,7 @@
 #include "SettingsManager.h"
 #include "Compression.h"
 
-void CoDRawfileTranslator::TranslateRawfile(const CoDRawFile_t* Rawfile, const std::string& ExportPath, const bool ATRCompressed, const bool GSCCompressed)
+void CoDRawfileTranslator::TranslateRawfile(const CoDRawFile_t* Rawfile, const std::string& ExportPath, const bool ATRCompressed, const bool GSCCompressed, const CoDExportSettings& Settings)
 {
     // If the asset size is > 0, continue...
     if (Rawfile->AssetSize > 0)
@@ -21,7 +21,7 @@ void CoDRawfileTranslator::TranslateRawfile(const CoDRawFile_t* Rawfile, const s
         std::string ExportFolder = ExportPath;
 
         // Check to preserve the paths
-        if (SettingsManager::GetSetting("keeprawpath", "true") == "true")
+        if (Settings.KeepRawfilePath)
         {
             // Apply the base path
             ExportFolder = FileSystems::CombinePath(ExportFolder, Rawfile->RawFilePath);
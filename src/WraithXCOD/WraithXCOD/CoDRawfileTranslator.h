@@ -13,5 +13,5 @@ public:
     // -- Translation functions
 
     // Translates a Rawfile asset
-    static void TranslateRawfile(const CoDRawFile_t* Rawfile, const std::string& ExportPath, const bool ATRCompressed, const bool GSCCompressed);
+    static void TranslateRawfile(const CoDRawFile_t* Rawfile, const std::string& ExportPath, const bool ATRCompressed, const bool GSCCompressed, const CoDExportSettings& Settings);
 };
\ No newline at end of file
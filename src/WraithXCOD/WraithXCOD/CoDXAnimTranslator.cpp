@@ -108,8 +108,13 @@ std::unique_ptr<WraithAnim> CoDXAnimTranslator::TranslateXAnim(const std::unique
         // Override the bone_t size if need be for various games
         if (Animation->BoneTypeSize > 0) { BoneTypeSize = Animation->BoneTypeSize; }
 
+        // The ids are read one at a time below, so pull the table into the read cache first
+        CoDAssets::GameInstance->Prefetch(Animation->BoneIDsPtr, (uint64_t)Animation->TotalBoneCount * Animation->BoneIndexSize);
+
         // A list of bone tag names
         std::vector<std::string> TagNames;
+        // Every bone will likely be keyed, so size the bone table once
+        Anim->ReserveBones(Animation->TotalBoneCount);
         // Loop and read bone tag names
         for (uint32_t i = 0; i < Animation->TotalBoneCount; i++)
         {
@@ -170,6 +175,10 @@ std::unique_ptr<WraithAnim> CoDXAnimTranslator::TranslateXAnim(const std::unique
             // Continue if we read it
             if (ResultSize == DataSize && KeyData != nullptr)
             {
+                // Resolve the bone once and size its keys
+                auto BoneIndex = Anim->AddBone(TagNames[i]);
+                Anim->ReserveRotationKeys(BoneIndex, FrameCount + 1);
+
                 // Loop for count + 1
                 for (uint32_t f = 0; f < (FrameCount + 1); f++)
                 {
@@ -207,19 +216,19 @@ std::unique_ptr<WraithAnim> CoDXAnimTranslator::TranslateXAnim(const std::unique
                     if (Animation->RotationType == AnimationKeyTypes::DivideBySize)
                     {
                         // Add
-                        Anim->AddRotationKey(TagNames[i], FrameIndex, 0, 0, ((float)KeyData[f * 2] / 32768.f), ((float)KeyData[(f * 2) + 1] / 32768.f));
+                        Anim->AddRotationKey(BoneIndex, FrameIndex, 0, 0, ((float)KeyData[f * 2] / 32768.f), ((float)KeyData[(f * 2) + 1] / 32768.f));
                     }
                     else if (Animation->RotationType == AnimationKeyTypes::HalfFloat)
                     {
                         // Add
-                        Anim->AddRotationKey(TagNames[i], FrameIndex, 0, 0, HalfFloats::ToFloat((uint16_t)KeyData[f * 2]), HalfFloats::ToFloat((uint16_t)KeyData[(f * 2) + 1]));
+                        Anim->AddRotationKey(BoneIndex, FrameIndex, 0, 0, HalfFloats::ToFloat((uint16_t)KeyData[f * 2]), HalfFloats::ToFloat((uint16_t)KeyData[(f * 2) + 1]));
                     }
                     else if (Animation->RotationType == AnimationKeyTypes::QuatPackingA)
                     {
                         // Calculate
                         auto Rotation = VectorPacking::QuatPacking2DA(*(uint32_t*)&KeyData[f * 2]);
                         // Add it
-                        Anim->AddRotationKey(TagNames[i], FrameIndex, Rotation.X, Rotation.Y, Rotation.Z, Rotation.W);
+                        Anim->AddRotationKey(BoneIndex, FrameIndex, Rotation.X, Rotation.Y, Rotation.Z, Rotation.W);
                     }
                 }
             }
@@ -256,6 +265,10 @@ std::unique_ptr<WraithAnim> CoDXAnimTranslator::TranslateXAnim(const std::unique
             // Continue if we read it
             if (ResultSize == DataSize && KeyData != nullptr)
             {
+                // Resolve the bone once and size its keys
+                auto BoneIndex = Anim->AddBone(TagNames[i]);
+                Anim->ReserveRotationKeys(BoneIndex, FrameCount + 1);
+
                 // Loop for count + 1
                 for (uint32_t f = 0; f < (FrameCount + 1); f++)
                 {
@@ -293,19 +306,19 @@ std::unique_ptr<WraithAnim> CoDXAnimTranslator::TranslateXAnim(const std::unique
                     if (Animation->RotationType == AnimationKeyTypes::DivideBySize)
                     {
                         // Add
-                        Anim->AddRotationKey(TagNames[i], FrameIndex, ((float)KeyData[f * 4] / 32768.f), ((float)KeyData[(f * 4) + 1] / 32768.f), ((float)KeyData[(f * 4) + 2] / 32768.f), ((float)KeyData[(f * 4) + 3] / 32768.f));
+                        Anim->AddRotationKey(BoneIndex, FrameIndex, ((float)KeyData[f * 4] / 32768.f), ((float)KeyData[(f * 4) + 1] / 32768.f), ((float)KeyData[(f * 4) + 2] / 32768.f), ((float)KeyData[(f * 4) + 3] / 32768.f));
                     }
                     else if (Animation->RotationType == AnimationKeyTypes::HalfFloat)
                     {
                         // Add
-                        Anim->AddRotationKey(TagNames[i], FrameIndex, HalfFloats::ToFloat((uint16_t)KeyData[f * 4]), HalfFloats::ToFloat((uint16_t)KeyData[(f * 4) + 1]), HalfFloats::ToFloat((uint16_t)KeyData[(f * 4) + 2]), HalfFloats::ToFloat((uint16_t)KeyData[(f * 4) + 3]));
+                        Anim->AddRotationKey(BoneIndex, FrameIndex, HalfFloats::ToFloat((uint16_t)KeyData[f * 4]), HalfFloats::ToFloat((uint16_t)KeyData[(f * 4) + 1]), HalfFloats::ToFloat((uint16_t)KeyData[(f * 4) + 2]), HalfFloats::ToFloat((uint16_t)KeyData[(f * 4) + 3]));
                     }
                     else if (Animation->RotationType == AnimationKeyTypes::QuatPackingA)
                     {
                         // Calculate
                         auto Rotation = VectorPacking::QuatPackingA(*(uint64_t*)&KeyData[f * 4]);
                         // Add it
-                        Anim->AddRotationKey(TagNames[i], FrameIndex, Rotation.X, Rotation.Y, Rotation.Z, Rotation.W);
+                        Anim->AddRotationKey(BoneIndex, FrameIndex, Rotation.X, Rotation.Y, Rotation.Z, Rotation.W);
                     }
                 }
             }
@@ -428,6 +441,10 @@ std::unique_ptr<WraithAnim> CoDXAnimTranslator::TranslateXAnim(const std::unique
             // Continue if we read it
             if (ResultSize == DataSize && KeyData != nullptr)
             {
+                // Resolve the bone once and size its keys
+                auto BoneIndex = Anim->AddBone(TagNames[BoneID]);
+                Anim->ReserveTranslationKeys(BoneIndex, FrameCount + 1);
+
                 // Loop for count + 1
                 for (uint32_t f = 0; f < (FrameCount + 1); f++)
                 {
@@ -469,7 +486,7 @@ std::unique_ptr<WraithAnim> CoDXAnimTranslator::TranslateXAnim(const std::unique
                         float TranslationY = (SizeVec.Y * (float)KeyData[(f * 3) + 1]) + MinVec.Y;
                         float TranslationZ = (SizeVec.Z * (float)KeyData[(f * 3) + 2]) + MinVec.Z;
                         // Add
-                        Anim->AddTranslationKey(TagNames[BoneID], FrameIndex, TranslationX, TranslationY, TranslationZ);
+                        Anim->AddTranslationKey(BoneIndex, FrameIndex, TranslationX, TranslationY, TranslationZ);
                     }
                 }
             }
@@ -535,6 +552,10 @@ std::unique_ptr<WraithAnim> CoDXAnimTranslator::TranslateXAnim(const std::unique
             // Continue if we read it
             if (ResultSize == DataSize && KeyData != nullptr)
             {
+                // Resolve the bone once and size its keys
+                auto BoneIndex = Anim->AddBone(TagNames[BoneID]);
+                Anim->ReserveTranslationKeys(BoneIndex, FrameCount + 1);
+
                 // Loop for count + 1
                 for (uint32_t f = 0; f < (FrameCount + 1); f++)
                 {
@@ -576,7 +597,7 @@ std::unique_ptr<WraithAnim> CoDXAnimTranslator::TranslateXAnim(const std::unique
                         float TranslationY = (SizeVec.Y * (float)KeyData[(f * 3) + 1]) + MinVec.Y;
                         float TranslationZ = (SizeVec.Z * (float)KeyData[(f * 3) + 2]) + MinVec.Z;
                         // Add
-                        Anim->AddTranslationKey(TagNames[BoneID], FrameIndex, TranslationX, TranslationY, TranslationZ);
+                        Anim->AddTranslationKey(BoneIndex, FrameIndex, TranslationX, TranslationY, TranslationZ);
                     }
                 }
             }
@@ -0,0 +1,386 @@
+#include "stdafx.h"
+
+// The class we are implementing
+#include "CoDXConverter.h"
+
+// We need the following classes
+#include "SettingsManager.h"
+
+// The converter the current thread is working for, if any
+static thread_local CoDXConverter* CurrentConverter = nullptr;
+// The worker index the current thread is using, if any
+static thread_local uint32_t CurrentWorkerIndex = 0;
+// The number of group waits the current thread is nested in
+static thread_local uint32_t CurrentHelpDepth = 0;
+
+CoDXConverter::CoDXConverter(uint32_t DegreeOfParallelism, const std::function<void(void)>& OnWorkerBegin, const std::function<void(void)>& OnWorkerEnd)
+{
+    // Defaults
+    PendingJobs = 0;
+    QueuedJobs = 0;
+    StolenJobs = 0;
+    EnqueuedJobs = 0;
+    GroupWaiters = 0;
+    ShuttingDown = false;
+
+    // Reset the stage counters
+    for (auto& Completed : CompletedJobs)
+        Completed = 0;
+
+    // Set the hooks
+    WorkerBegin = OnWorkerBegin;
+    WorkerEnd = OnWorkerEnd;
+
+    // We need at least one worker
+    if (DegreeOfParallelism == 0)
+        DegreeOfParallelism = 1;
+
+    // Make the queues first, workers may steal from any of them as soon as they start
+    for (uint32_t i = 0; i < DegreeOfParallelism; i++)
+    {
+        Queues.emplace_back(std::make_unique<WorkerQueue>());
+    }
+
+    // Start the workers
+    for (uint32_t i = 0; i < DegreeOfParallelism; i++)
+    {
+        Workers.emplace_back(&CoDXConverter::WorkerMain, this, i);
+    }
+}
+
+CoDXConverter::~CoDXConverter()
+{
+    // Let all jobs finish first
+    WaitForIdle();
+
+    // Tell the workers to stop
+    {
+        std::lock_guard<std::mutex> Lock(SignalMutex);
+        ShuttingDown = true;
+    }
+    WorkAvailable.notify_all();
+
+    // Wait for all workers to end
+    for (auto& Worker : Workers)
+    {
+        // Wait for the worker
+        try
+        {
+            // Join it
+            Worker.join();
+        }
+        catch (...)
+        {
+            // Nothing, thread already exited
+        }
+    }
+}
+
+CoDXConverter* CoDXConverter::Current()
+{
+    // Return the converter for this thread
+    return CurrentConverter;
+}
+
+uint32_t CoDXConverter::CalculateDegreeOfParallelism()
+{
+#if _DEBUG
+    // Single worker for debugging
+    return 1;
+#else
+    // Check for a user value, 0 means use the hardware
+    auto Setting = SettingsManager::GetSetting("exportthreads", "0");
+    // The resulting count
+    uint32_t Result = 0;
+
+    // Attempt to parse it
+    try
+    {
+        Result = (uint32_t)std::stoul(Setting);
+    }
+    catch (...)
+    {
+        Result = 0;
+    }
+
+    // Use the hardware if not set
+    if (Result == 0)
+        Result = std::thread::hardware_concurrency();
+
+    // Make sure we have at least one
+    return std::max<uint32_t>(Result, 1);
+#endif
+}
+
+void CoDXConverter::Submit(CoDXConverterStage Stage, std::function<void(void)> Job)
+{
+    // Queue with no group
+    Enqueue(Stage, { std::move(Job), nullptr });
+}
+
+void CoDXConverter::WaitForIdle()
+{
+    // Wait until the pending count reaches zero
+    std::unique_lock<std::mutex> Lock(SignalMutex);
+    WorkCompleted.wait(Lock, [this] { return PendingJobs == 0; });
+}
+
+void CoDXConverter::Enqueue(CoDXConverterStage Stage, CoDXConverterJob&& Job)
+{
+    // Count it as pending before it can possibly run
+    PendingJobs++;
+
+    // Jobs from our own workers stay local, others are spread over the shared queue
+    auto& Queue = (CurrentConverter == this) ? *Queues[CurrentWorkerIndex] : SharedQueue;
+
+    // Push it
+    {
+        std::lock_guard<std::mutex> Lock(Queue.QueueMutex);
+        Queue.Jobs[(uint32_t)Stage].emplace_back(std::move(Job));
+        // Count while locked so it never goes below zero on pop
+        QueuedJobs++;
+    }
+
+    // Let waiting groups know there's something new to check
+    EnqueuedJobs++;
+
+    // Wake a worker
+    bool WakeGroups = false;
+    {
+        std::lock_guard<std::mutex> Lock(SignalMutex);
+        WakeGroups = (GroupWaiters > 0);
+    }
+    WorkAvailable.notify_one();
+
+    // Wake waiting groups, the job may be theirs
+    if (WakeGroups)
+        WorkCompleted.notify_all();
+}
+
+bool CoDXConverter::CanHelp(const CoDXConverterJob& Job, CoDXConverterStage Stage, const CoDXConverterGroup* Helping)
+{
+    // Anything goes when we're not waiting
+    if (Helping == nullptr || Job.Group == Helping)
+        return true;
+
+    // Never start an unrelated asset or translation, those open and wait on groups of their own
+    if (Stage != CoDXConverterStage::Decompress && Stage != CoDXConverterStage::Write)
+        return false;
+
+    // Limit how deep the waits nest
+    return CurrentHelpDepth < CoDXConverterMaxHelpDepth;
+}
+
+bool CoDXConverter::PopJob(WorkerQueue& Queue, bool FromBack, CoDXConverterJob& Result, CoDXConverterStage& Stage, const CoDXConverterGroup* Helping)
+{
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(Queue.QueueMutex);
+
+    // Check later stages first, so buffers from earlier stages are released sooner
+    for (int32_t i = (int32_t)CoDXConverterStage::Count - 1; i >= 0; i--)
+    {
+        auto& Jobs = Queue.Jobs[i];
+
+        // Skip empty queues
+        if (Jobs.empty())
+            continue;
+
+        // Take the first job we may run, from the right end
+        for (size_t j = 0; j < Jobs.size(); j++)
+        {
+            auto Job = FromBack ? (Jobs.end() - 1 - j) : (Jobs.begin() + j);
+
+            // Skip jobs a waiting group shouldn't run
+            if (!CanHelp(*Job, (CoDXConverterStage)i, Helping))
+                continue;
+
+            // Take it
+            Result = std::move(*Job);
+            Jobs.erase(Job);
+
+            // Set the stage
+            Stage = (CoDXConverterStage)i;
+
+            // Success
+            return true;
+        }
+    }
+
+    // Nothing found
+    return false;
+}
+
+bool CoDXConverter::FindJob(uint32_t WorkerIndex, CoDXConverterJob& Result, CoDXConverterStage& Stage, const CoDXConverterGroup* Helping)
+{
+    // Our own queue first, newest job first as it's likely still in cache
+    if (PopJob(*Queues[WorkerIndex], true, Result, Stage, Helping))
+    {
+        QueuedJobs--;
+        return true;
+    }
+
+    // Next, the shared queue, oldest first
+    if (PopJob(SharedQueue, false, Result, Stage, Helping))
+    {
+        QueuedJobs--;
+        return true;
+    }
+
+    // Finally, steal from the other workers, starting after us
+    auto WorkerCount = (uint32_t)Queues.size();
+
+    for (uint32_t i = 1; i < WorkerCount; i++)
+    {
+        if (PopJob(*Queues[(WorkerIndex + i) % WorkerCount], false, Result, Stage, Helping))
+        {
+            QueuedJobs--;
+            StolenJobs++;
+            return true;
+        }
+    }
+
+    // Nothing to do
+    return false;
+}
+
+void CoDXConverter::RunJob(CoDXConverterJob& Job, CoDXConverterStage Stage)
+{
+    // Run it, jobs should handle their own errors, but never let one kill a worker
+    try
+    {
+        Job.Work();
+    }
+    catch (...)
+    {
+        // Nothing, the job failed
+    }
+
+    // Release the job's state before signalling
+    Job.Work = nullptr;
+
+    // Advance the stage counter
+    CompletedJobs[(uint32_t)Stage]++;
+
+    // Check if anyone is waiting on this
+    bool GroupCompleted = (Job.Group != nullptr) && (--Job.Group->OutstandingJobs == 0);
+    bool AllCompleted = (--PendingJobs == 0);
+
+    // Signal waiters
+    if (GroupCompleted || AllCompleted)
+    {
+        {
+            std::lock_guard<std::mutex> Lock(SignalMutex);
+        }
+        WorkCompleted.notify_all();
+    }
+}
+
+void CoDXConverter::WorkerMain(uint32_t WorkerIndex)
+{
+    // Set the thread state
+    CurrentConverter = this;
+    CurrentWorkerIndex = WorkerIndex;
+
+    // Run the begin hook
+    if (WorkerBegin != nullptr)
+        WorkerBegin();
+
+    // The job we're working on
+    CoDXConverterJob Job{};
+    CoDXConverterStage Stage = CoDXConverterStage::Extract;
+
+    // Loop until we're told to stop
+    while (true)
+    {
+        // Run anything we can find
+        if (FindJob(WorkerIndex, Job, Stage))
+        {
+            RunJob(Job, Stage);
+            continue;
+        }
+
+        // Wait for more work
+        std::unique_lock<std::mutex> Lock(SignalMutex);
+        WorkAvailable.wait(Lock, [this] { return ShuttingDown || QueuedJobs > 0; });
+
+        // Only stop once the queues are drained
+        if (ShuttingDown && QueuedJobs == 0)
+            break;
+    }
+
+    // Run the end hook
+    if (WorkerEnd != nullptr)
+        WorkerEnd();
+
+    // Reset the thread state
+    CurrentConverter = nullptr;
+}
+
+CoDXConverterGroup::CoDXConverterGroup()
+{
+    // Use the converter for this thread
+    Converter = CoDXConverter::Current();
+    OutstandingJobs = 0;
+}
+
+CoDXConverterGroup::~CoDXConverterGroup()
+{
+    // Never leave jobs referencing us
+    Wait();
+}
+
+void CoDXConverterGroup::Run(CoDXConverterStage Stage, std::function<void(void)> Job)
+{
+    // If we're not on a converter, just run it here
+    if (Converter == nullptr)
+    {
+        try
+        {
+            Job();
+        }
+        catch (...)
+        {
+            // Nothing, the job failed
+        }
+
+        return;
+    }
+
+    // Queue it on our converter
+    OutstandingJobs++;
+    Converter->Enqueue(Stage, { std::move(Job), this });
+}
+
+void CoDXConverterGroup::Wait()
+{
+    // Nothing to do if inline
+    if (Converter == nullptr)
+        return;
+
+    // The job we're helping with
+    CoDXConverterJob Job{};
+    CoDXConverterStage Stage = CoDXConverterStage::Extract;
+
+    // Help run jobs until ours are done, this keeps workers from deadlocking on nested groups
+    while (OutstandingJobs > 0)
+    {
+        // Note what's been queued so far, so we notice anything queued while we look
+        auto Enqueued = Converter->EnqueuedJobs.load();
+
+        // Run anything we may help with
+        if (Converter->FindJob(CurrentWorkerIndex, Job, Stage, this))
+        {
+            // Jobs we run may wait on groups of their own
+            CurrentHelpDepth++;
+            Converter->RunJob(Job, Stage);
+            CurrentHelpDepth--;
+            continue;
+        }
+
+        // Our remaining jobs are running elsewhere, wait for a completion or new work
+        std::unique_lock<std::mutex> Lock(Converter->SignalMutex);
+        Converter->GroupWaiters++;
+        Converter->WorkCompleted.wait(Lock, [this, Enqueued] { return OutstandingJobs == 0 || Converter->EnqueuedJobs != Enqueued; });
+        Converter->GroupWaiters--;
+    }
+}
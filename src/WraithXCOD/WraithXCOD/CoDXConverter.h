@@ -4,38 +4,147 @@
 #include <memory>
 #include <thread>
 #include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
 
-// A class that handles parallel operations
+// The stages a converter job can belong to, later stages are drained first
+enum class CoDXConverterStage : uint32_t
+{
+    // Reading asset data from the game or packages
+    Extract,
+    // Decompressing and decoding package objects
+    Decompress,
+    // Translating generic assets to Wraith assets
+    Translate,
+    // Writing the final files to disk
+    Write,
+
+    // The total number of stages
+    Count
+};
+
+// A job that has been queued on a converter
+struct CoDXConverterJob
+{
+    // The work to run
+    std::function<void(void)> Work;
+    // The group this job belongs to, if any
+    class CoDXConverterGroup* Group;
+};
+
+// A class that handles parallel operations, using per-worker deques and work stealing
 class CoDXConverter
 {
 public:
+    // Spawns a new converter with the given number of workers, the hooks are run on each worker as it starts and stops
+    CoDXConverter(uint32_t DegreeOfParallelism, const std::function<void(void)>& OnWorkerBegin = nullptr, const std::function<void(void)>& OnWorkerEnd = nullptr);
+    // Waits for all outstanding jobs, then shuts down the workers
+    ~CoDXConverter();
+
+    // Queues a job on the converter, jobs queued from a worker stay on that worker until stolen
+    void Submit(CoDXConverterStage Stage, std::function<void(void)> Job);
+    // Blocks the calling thread until every queued job has completed
+    void WaitForIdle();
 
-    // Spawns a new converter, then waits for it to finish execution before continuing
-    CoDXConverter(const std::function<void(void)> Job, uint32_t DegreeOfParallelism)
+    // Gets the number of workers
+    uint32_t GetDegreeOfParallelism() const { return (uint32_t)Workers.size(); }
+    // Gets the number of jobs completed for the given stage
+    uint64_t GetCompletedJobs(CoDXConverterStage Stage) const { return CompletedJobs[(uint32_t)Stage]; }
+    // Gets the number of jobs that were stolen from another worker
+    uint64_t GetStolenJobs() const { return StolenJobs; }
+
+    // Gets the converter the calling thread is working for, if any
+    static CoDXConverter* Current();
+    // Calculates the number of workers to use from settings and the hardware
+    static uint32_t CalculateDegreeOfParallelism();
+
+private:
+    // Allow groups to queue and run jobs
+    friend class CoDXConverterGroup;
+
+    // A worker's local job queues, one per stage
+    struct WorkerQueue
     {
-        // The workers for this instance
-        std::vector<std::thread> Workers;
-        
-        // Loop and add the jobs
-        for (uint32_t i = 0; i < DegreeOfParallelism; i++)
-        {
-            // Add the job, start the thread
-            Workers.emplace_back(Job);
-        }
-
-        // Wait for all workers to end
-        for (auto& Worker : Workers)
-        {
-            // Wait for the worker
-            try
-            {
-                // Join it
-                Worker.join();
-            }
-            catch (...)
-            {
-                // Nothing, thread already exited
-            }
-        }
-    }
-};
\ No newline at end of file
+        // The queues, the owner pops from the back, thieves steal from the front
+        std::deque<CoDXConverterJob> Jobs[(uint32_t)CoDXConverterStage::Count];
+        // A mutex for queue operations
+        std::mutex QueueMutex;
+    };
+
+    // The worker threads
+    std::vector<std::thread> Workers;
+    // The per-worker queues
+    std::vector<std::unique_ptr<WorkerQueue>> Queues;
+    // The queue for jobs submitted from outside of the workers
+    WorkerQueue SharedQueue;
+
+    // The number of jobs queued and not yet completed
+    std::atomic<uint64_t> PendingJobs;
+    // The number of jobs queued and not yet started
+    std::atomic<uint64_t> QueuedJobs;
+    // Whether or not the workers should stop
+    std::atomic<bool> ShuttingDown;
+
+    // Per-stage completion counters
+    std::atomic<uint64_t> CompletedJobs[(uint32_t)CoDXConverterStage::Count];
+    // Number of stolen jobs
+    std::atomic<uint64_t> StolenJobs;
+    // The number of jobs ever queued, waiting groups use it to notice new work
+    std::atomic<uint64_t> EnqueuedJobs;
+    // The number of groups blocked waiting on their jobs
+    std::atomic<uint32_t> GroupWaiters;
+
+    // Signalled when work is queued
+    std::condition_variable WorkAvailable;
+    // Signalled when the pending count or a group reaches zero, and on queue while groups are waiting
+    std::condition_variable WorkCompleted;
+    // A mutex for the condition variables
+    std::mutex SignalMutex;
+
+    // The hooks for each worker
+    std::function<void(void)> WorkerBegin;
+    std::function<void(void)> WorkerEnd;
+
+    // The main loop for a worker
+    void WorkerMain(uint32_t WorkerIndex);
+    // Queues a job for the given stage
+    void Enqueue(CoDXConverterStage Stage, CoDXConverterJob&& Job);
+    // Attempts to find a job, checking the local queue, the shared queue, then stealing, a waiting group only takes jobs it may help with
+    bool FindJob(uint32_t WorkerIndex, CoDXConverterJob& Result, CoDXConverterStage& Stage, const CoDXConverterGroup* Helping = nullptr);
+    // Attempts to pop a job from a queue, newest first for the owner, oldest first for thieves
+    static bool PopJob(WorkerQueue& Queue, bool FromBack, CoDXConverterJob& Result, CoDXConverterStage& Stage, const CoDXConverterGroup* Helping);
+    // Checks if a waiting group may help with a job, its own jobs always, or short Decompress/Write jobs while not nested too deep
+    static bool CanHelp(const CoDXConverterJob& Job, CoDXConverterStage Stage, const CoDXConverterGroup* Helping);
+    // Runs a job and updates counters
+    void RunJob(CoDXConverterJob& Job, CoDXConverterStage Stage);
+};
+
+// The number of nested group waits after which a worker only helps with its own group's jobs
+constexpr uint32_t CoDXConverterMaxHelpDepth = 4;
+
+// A class that fans out a set of jobs and waits on them, the waiting worker helps run its own jobs, and Decompress/Write jobs
+class CoDXConverterGroup
+{
+public:
+    // Creates a group on the current converter, if there is none, jobs run inline
+    CoDXConverterGroup();
+    // Waits for all jobs in the group
+    ~CoDXConverterGroup();
+
+    // Runs a job as part of this group
+    void Run(CoDXConverterStage Stage, std::function<void(void)> Job);
+    // Waits for all jobs in the group to complete
+    void Wait();
+
+private:
+    // Allow the converter to signal completion
+    friend class CoDXConverter;
+
+    // The converter we are running on
+    CoDXConverter* Converter;
+    // The number of jobs outstanding
+    std::atomic<uint32_t> OutstandingJobs;
+};
@@ -1,6 +1,12 @@
 #include <stdafx.h>
 #include "CoDXModelMeshHelper.h"
 
+// The scale of a 21Bit component
+static const float PackedVertexScale = (1.0f / 0x1FFFFF) * 2.0f;
+
+// The kernel used by the batch decoders
+static CoDXModelMeshKernel MeshKernel = CoDXModelMeshHelper::GetSupportedKernel();
+
 const Vector3 CoDXModelMeshHelper::Unpack21BitVertex(const uint64_t Packed, const float Scale, const Vector3 Offset)
 {
     // Read and assign position
@@ -59,3 +65,506 @@ void CoDXModelMeshHelper::UnpackFaceIndices(const uint8_t* tables, const size_t
         currentFaceIndex -= count;
     }
 }
+
+const Vector3 CoDXModelMeshHelper::UnpackNormalA(const uint32_t Normal)
+{
+    // Decode the scale of the vector
+    float DecodeScale = (float)((float)(uint8_t)(Normal >> 24) - -192.0) / 32385.0f;
+
+    // Make the vector
+    return Vector3(
+        (float)((float)(uint8_t)(Normal >> 0) - 127.0) * DecodeScale,
+        (float)((float)(uint8_t)(Normal >> 8) - 127.0) * DecodeScale,
+        (float)((float)(uint8_t)(Normal >> 16) - 127.0) * DecodeScale);
+}
+
+const Vector3 CoDXModelMeshHelper::UnpackNormalB(const uint32_t Normal)
+{
+    // Rebuild the float (As an integer value)
+    uint32_t RBuiltX = ((Normal & 0x3FF) - 2 * (Normal & 0x200) + 0x40400000);
+    uint32_t RBuiltY = (((Normal >> 10) & 0x3FF) - 2 * ((Normal >> 10) & 0x200) + 0x40400000);
+    uint32_t RBuiltZ = (((Normal >> 20) & 0x3FF) - 2 * ((Normal >> 20) & 0x200) + 0x40400000);
+
+    // Make the vector
+    return Vector3(
+        (float)(*reinterpret_cast<float*>(&RBuiltX) - 3.0) * 8208.0312f,
+        (float)(*reinterpret_cast<float*>(&RBuiltY) - 3.0) * 8208.0312f,
+        (float)(*reinterpret_cast<float*>(&RBuiltZ) - 3.0) * 8208.0312f);
+}
+
+const Vector3 CoDXModelMeshHelper::UnpackNormalC(const uint32_t Normal)
+{
+    // Make the vector
+    return Vector3(
+        (float)((float)((float)(Normal & 0x3FF) / 1023.0) * 2.0) - 1.0f,
+        (float)((float)((float)((Normal >> 10) & 0x3FF) / 1023.0) * 2.0) - 1.0f,
+        (float)((float)((float)((Normal >> 20) & 0x3FF) / 1023.0) * 2.0) - 1.0f);
+}
+
+// -- SSE2 kernels
+
+// Extracts a 21Bit component from 4 packed vertices
+template<int Shift>
+static __m128 Extract21BitSSE2(const __m128i Packed01, const __m128i Packed23)
+{
+    const __m128i Mask = _mm_set1_epi64x(0x1FFFFF);
+
+    // Each component lands in the low half of its 64bit lane, move them to the low 64bits
+    __m128i Lo = _mm_shuffle_epi32(_mm_and_si128(_mm_srli_epi64(Packed01, Shift), Mask), _MM_SHUFFLE(3, 1, 2, 0));
+    __m128i Hi = _mm_shuffle_epi32(_mm_and_si128(_mm_srli_epi64(Packed23, Shift), Mask), _MM_SHUFFLE(3, 1, 2, 0));
+
+    // Convert them, the components are below 2^24, so the conversion is exact
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi64(Lo, Hi));
+}
+
+// Unpacks 4 21Bit components at a time
+static size_t Unpack21BitVerticesSSE2(const uint64_t* Packed, const size_t Count, const float Scale, const Vector3 Offset, Vector3* Output)
+{
+    const __m128 VertexScale = _mm_set1_ps(PackedVertexScale);
+    const __m128 One = _mm_set1_ps(1.0f);
+    const __m128 MeshScale = _mm_set1_ps(Scale);
+    const __m128 OffsetX = _mm_set1_ps(Offset.X);
+    const __m128 OffsetY = _mm_set1_ps(Offset.Y);
+    const __m128 OffsetZ = _mm_set1_ps(Offset.Z);
+
+    alignas(16) float X[4], Y[4], Z[4];
+    size_t i = 0;
+
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128i Packed01 = _mm_loadu_si128((const __m128i*)(Packed + i));
+        __m128i Packed23 = _mm_loadu_si128((const __m128i*)(Packed + i + 2));
+
+        // Same operations, in the same order, as the single decoder
+        _mm_store_ps(X, _mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(Extract21BitSSE2<0>(Packed01, Packed23), VertexScale), One), MeshScale), OffsetX));
+        _mm_store_ps(Y, _mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(Extract21BitSSE2<21>(Packed01, Packed23), VertexScale), One), MeshScale), OffsetY));
+        _mm_store_ps(Z, _mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(Extract21BitSSE2<42>(Packed01, Packed23), VertexScale), One), MeshScale), OffsetZ));
+
+        for (size_t j = 0; j < 4; j++)
+        {
+            Output[i + j].X = X[j];
+            Output[i + j].Y = Y[j];
+            Output[i + j].Z = Z[j];
+        }
+    }
+
+    // Return the amount unpacked
+    return i;
+}
+
+// Loads 4 normals that are Stride bytes apart
+static __m128i LoadNormalsSSE2(const uint8_t* Packed, const size_t Stride)
+{
+    return _mm_set_epi32(*(const int32_t*)(Packed + Stride * 3), *(const int32_t*)(Packed + Stride * 2), *(const int32_t*)(Packed + Stride), *(const int32_t*)Packed);
+}
+
+// Stores 4 normals
+static void StoreNormalsSSE2(const __m128 X, const __m128 Y, const __m128 Z, Vector3* Output)
+{
+    alignas(16) float Components[3][4];
+
+    _mm_store_ps(Components[0], X);
+    _mm_store_ps(Components[1], Y);
+    _mm_store_ps(Components[2], Z);
+
+    for (size_t j = 0; j < 4; j++)
+    {
+        Output[j].X = Components[0][j];
+        Output[j].Y = Components[1][j];
+        Output[j].Z = Components[2][j];
+    }
+}
+
+// Unpacks 4 normals with method A at a time
+static size_t UnpackNormalsASSE2(const uint8_t* Packed, const size_t Stride, const size_t Count, Vector3* Output)
+{
+    const __m128i ByteMask = _mm_set1_epi32(0xFF);
+    const __m128 Bias = _mm_set1_ps(127.0f);
+    const __m128 ScaleBias = _mm_set1_ps(192.0f);
+    const __m128 ScaleDivisor = _mm_set1_ps(32385.0f);
+
+    size_t i = 0;
+
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128i Normals = LoadNormalsSSE2(Packed + i * Stride, Stride);
+
+        // Decode the scale of the vectors
+        __m128 DecodeScale = _mm_div_ps(_mm_add_ps(_mm_cvtepi32_ps(_mm_srli_epi32(Normals, 24)), ScaleBias), ScaleDivisor);
+
+        StoreNormalsSSE2(
+            _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_and_si128(Normals, ByteMask)), Bias), DecodeScale),
+            _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(Normals, 8), ByteMask)), Bias), DecodeScale),
+            _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(Normals, 16), ByteMask)), Bias), DecodeScale),
+            Output + i);
+    }
+
+    // Return the amount unpacked
+    return i;
+}
+
+// Rebuilds a 10Bit normal B component as a float
+static __m128 RebuildNormalBSSE2(const __m128i Component)
+{
+    const __m128i SignBit = _mm_set1_epi32(0x200);
+    const __m128i Exponent = _mm_set1_epi32(0x40400000);
+
+    // (Value - 2 * (Value & 0x200) + 0x40400000)
+    return _mm_castsi128_ps(_mm_add_epi32(_mm_sub_epi32(Component, _mm_slli_epi32(_mm_and_si128(Component, SignBit), 1)), Exponent));
+}
+
+// Unpacks 4 normals with method B at a time
+static size_t UnpackNormalsBSSE2(const uint8_t* Packed, const size_t Stride, const size_t Count, Vector3* Output)
+{
+    const __m128i ComponentMask = _mm_set1_epi32(0x3FF);
+    const __m128 Bias = _mm_set1_ps(3.0f);
+    const __m128 Scale = _mm_set1_ps(8208.0312f);
+
+    size_t i = 0;
+
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128i Normals = LoadNormalsSSE2(Packed + i * Stride, Stride);
+
+        StoreNormalsSSE2(
+            _mm_mul_ps(_mm_sub_ps(RebuildNormalBSSE2(_mm_and_si128(Normals, ComponentMask)), Bias), Scale),
+            _mm_mul_ps(_mm_sub_ps(RebuildNormalBSSE2(_mm_and_si128(_mm_srli_epi32(Normals, 10), ComponentMask)), Bias), Scale),
+            _mm_mul_ps(_mm_sub_ps(RebuildNormalBSSE2(_mm_and_si128(_mm_srli_epi32(Normals, 20), ComponentMask)), Bias), Scale),
+            Output + i);
+    }
+
+    // Return the amount unpacked
+    return i;
+}
+
+// Unpacks 4 normals with method C at a time
+static size_t UnpackNormalsCSSE2(const uint8_t* Packed, const size_t Stride, const size_t Count, Vector3* Output)
+{
+    const __m128i ComponentMask = _mm_set1_epi32(0x3FF);
+    const __m128 Divisor = _mm_set1_ps(1023.0f);
+    const __m128 Two = _mm_set1_ps(2.0f);
+    const __m128 One = _mm_set1_ps(1.0f);
+
+    size_t i = 0;
+
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128i Normals = LoadNormalsSSE2(Packed + i * Stride, Stride);
+
+        // The single decoder divides in double, for 10Bit integers the float result is identical
+        StoreNormalsSSE2(
+            _mm_sub_ps(_mm_mul_ps(_mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(Normals, ComponentMask)), Divisor), Two), One),
+            _mm_sub_ps(_mm_mul_ps(_mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(Normals, 10), ComponentMask)), Divisor), Two), One),
+            _mm_sub_ps(_mm_mul_ps(_mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(Normals, 20), ComponentMask)), Divisor), Two), One),
+            Output + i);
+    }
+
+    // Return the amount unpacked
+    return i;
+}
+
+// -- AVX2 kernels
+
+// Extracts a 21Bit component from 8 packed vertices
+template<int Shift>
+static __m256 Extract21BitAVX2(const __m256i Packed0123, const __m256i Packed4567)
+{
+    const __m256i Mask = _mm256_set1_epi64x(0x1FFFFF);
+    const __m256i LowHalves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+    // Each component lands in the low half of its 64bit lane, move them to the low 128bits
+    __m256i Lo = _mm256_permutevar8x32_epi32(_mm256_and_si256(_mm256_srli_epi64(Packed0123, Shift), Mask), LowHalves);
+    __m256i Hi = _mm256_permutevar8x32_epi32(_mm256_and_si256(_mm256_srli_epi64(Packed4567, Shift), Mask), LowHalves);
+
+    // Convert them, the components are below 2^24, so the conversion is exact
+    return _mm256_cvtepi32_ps(_mm256_permute2x128_si256(Lo, Hi, 0x20));
+}
+
+// Unpacks 8 21Bit components at a time
+static size_t Unpack21BitVerticesAVX2(const uint64_t* Packed, const size_t Count, const float Scale, const Vector3 Offset, Vector3* Output)
+{
+    const __m256 VertexScale = _mm256_set1_ps(PackedVertexScale);
+    const __m256 One = _mm256_set1_ps(1.0f);
+    const __m256 MeshScale = _mm256_set1_ps(Scale);
+    const __m256 OffsetX = _mm256_set1_ps(Offset.X);
+    const __m256 OffsetY = _mm256_set1_ps(Offset.Y);
+    const __m256 OffsetZ = _mm256_set1_ps(Offset.Z);
+
+    alignas(32) float X[8], Y[8], Z[8];
+    size_t i = 0;
+
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m256i Packed0123 = _mm256_loadu_si256((const __m256i*)(Packed + i));
+        __m256i Packed4567 = _mm256_loadu_si256((const __m256i*)(Packed + i + 4));
+
+        // Same operations, in the same order, as the single decoder, they must not be fused
+        _mm256_store_ps(X, _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(Extract21BitAVX2<0>(Packed0123, Packed4567), VertexScale), One), MeshScale), OffsetX));
+        _mm256_store_ps(Y, _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(Extract21BitAVX2<21>(Packed0123, Packed4567), VertexScale), One), MeshScale), OffsetY));
+        _mm256_store_ps(Z, _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(Extract21BitAVX2<42>(Packed0123, Packed4567), VertexScale), One), MeshScale), OffsetZ));
+
+        for (size_t j = 0; j < 8; j++)
+        {
+            Output[i + j].X = X[j];
+            Output[i + j].Y = Y[j];
+            Output[i + j].Z = Z[j];
+        }
+    }
+
+    // Leave the upper halves clean for SSE code
+    _mm256_zeroupper();
+
+    // Return the amount unpacked
+    return i;
+}
+
+// Loads 8 normals that are Stride bytes apart
+static __m256i LoadNormalsAVX2(const uint8_t* Packed, const size_t Stride)
+{
+    return _mm256_setr_epi32(
+        *(const int32_t*)Packed, *(const int32_t*)(Packed + Stride), *(const int32_t*)(Packed + Stride * 2), *(const int32_t*)(Packed + Stride * 3),
+        *(const int32_t*)(Packed + Stride * 4), *(const int32_t*)(Packed + Stride * 5), *(const int32_t*)(Packed + Stride * 6), *(const int32_t*)(Packed + Stride * 7));
+}
+
+// Stores 8 normals
+static void StoreNormalsAVX2(const __m256 X, const __m256 Y, const __m256 Z, Vector3* Output)
+{
+    alignas(32) float Components[3][8];
+
+    _mm256_store_ps(Components[0], X);
+    _mm256_store_ps(Components[1], Y);
+    _mm256_store_ps(Components[2], Z);
+
+    for (size_t j = 0; j < 8; j++)
+    {
+        Output[j].X = Components[0][j];
+        Output[j].Y = Components[1][j];
+        Output[j].Z = Components[2][j];
+    }
+}
+
+// Unpacks 8 normals with method A at a time
+static size_t UnpackNormalsAAVX2(const uint8_t* Packed, const size_t Stride, const size_t Count, Vector3* Output)
+{
+    const __m256i ByteMask = _mm256_set1_epi32(0xFF);
+    const __m256 Bias = _mm256_set1_ps(127.0f);
+    const __m256 ScaleBias = _mm256_set1_ps(192.0f);
+    const __m256 ScaleDivisor = _mm256_set1_ps(32385.0f);
+
+    size_t i = 0;
+
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m256i Normals = LoadNormalsAVX2(Packed + i * Stride, Stride);
+
+        // Decode the scale of the vectors
+        __m256 DecodeScale = _mm256_div_ps(_mm256_add_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(Normals, 24)), ScaleBias), ScaleDivisor);
+
+        StoreNormalsAVX2(
+            _mm256_mul_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_and_si256(Normals, ByteMask)), Bias), DecodeScale),
+            _mm256_mul_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(Normals, 8), ByteMask)), Bias), DecodeScale),
+            _mm256_mul_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(Normals, 16), ByteMask)), Bias), DecodeScale),
+            Output + i);
+    }
+
+    // Leave the upper halves clean for SSE code
+    _mm256_zeroupper();
+
+    // Return the amount unpacked
+    return i;
+}
+
+// Rebuilds a 10Bit normal B component as a float
+static __m256 RebuildNormalBAVX2(const __m256i Component)
+{
+    const __m256i SignBit = _mm256_set1_epi32(0x200);
+    const __m256i Exponent = _mm256_set1_epi32(0x40400000);
+
+    // (Value - 2 * (Value & 0x200) + 0x40400000)
+    return _mm256_castsi256_ps(_mm256_add_epi32(_mm256_sub_epi32(Component, _mm256_slli_epi32(_mm256_and_si256(Component, SignBit), 1)), Exponent));
+}
+
+// Unpacks 8 normals with method B at a time
+static size_t UnpackNormalsBAVX2(const uint8_t* Packed, const size_t Stride, const size_t Count, Vector3* Output)
+{
+    const __m256i ComponentMask = _mm256_set1_epi32(0x3FF);
+    const __m256 Bias = _mm256_set1_ps(3.0f);
+    const __m256 Scale = _mm256_set1_ps(8208.0312f);
+
+    size_t i = 0;
+
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m256i Normals = LoadNormalsAVX2(Packed + i * Stride, Stride);
+
+        StoreNormalsAVX2(
+            _mm256_mul_ps(_mm256_sub_ps(RebuildNormalBAVX2(_mm256_and_si256(Normals, ComponentMask)), Bias), Scale),
+            _mm256_mul_ps(_mm256_sub_ps(RebuildNormalBAVX2(_mm256_and_si256(_mm256_srli_epi32(Normals, 10), ComponentMask)), Bias), Scale),
+            _mm256_mul_ps(_mm256_sub_ps(RebuildNormalBAVX2(_mm256_and_si256(_mm256_srli_epi32(Normals, 20), ComponentMask)), Bias), Scale),
+            Output + i);
+    }
+
+    // Leave the upper halves clean for SSE code
+    _mm256_zeroupper();
+
+    // Return the amount unpacked
+    return i;
+}
+
+// Unpacks 8 normals with method C at a time
+static size_t UnpackNormalsCAVX2(const uint8_t* Packed, const size_t Stride, const size_t Count, Vector3* Output)
+{
+    const __m256i ComponentMask = _mm256_set1_epi32(0x3FF);
+    const __m256 Divisor = _mm256_set1_ps(1023.0f);
+    const __m256 Two = _mm256_set1_ps(2.0f);
+    const __m256 One = _mm256_set1_ps(1.0f);
+
+    size_t i = 0;
+
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m256i Normals = LoadNormalsAVX2(Packed + i * Stride, Stride);
+
+        // The single decoder divides in double, for 10Bit integers the float result is identical
+        StoreNormalsAVX2(
+            _mm256_sub_ps(_mm256_mul_ps(_mm256_div_ps(_mm256_cvtepi32_ps(_mm256_and_si256(Normals, ComponentMask)), Divisor), Two), One),
+            _mm256_sub_ps(_mm256_mul_ps(_mm256_div_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(Normals, 10), ComponentMask)), Divisor), Two), One),
+            _mm256_sub_ps(_mm256_mul_ps(_mm256_div_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(Normals, 20), ComponentMask)), Divisor), Two), One),
+            Output + i);
+    }
+
+    // Leave the upper halves clean for SSE code
+    _mm256_zeroupper();
+
+    // Return the amount unpacked
+    return i;
+}
+
+// -- Batch decoders
+
+void CoDXModelMeshHelper::Unpack21BitVertices(const uint64_t* Packed, const size_t Count, const float Scale, const Vector3 Offset, Vector3* Output)
+{
+    size_t i = 0;
+
+    // Unpack as many as we can with the kernel
+    switch (MeshKernel)
+    {
+    case CoDXModelMeshKernel::AVX2: i = Unpack21BitVerticesAVX2(Packed, Count, Scale, Offset, Output); break;
+    case CoDXModelMeshKernel::SSE2: i = Unpack21BitVerticesSSE2(Packed, Count, Scale, Offset, Output); break;
+    }
+
+    // Unpack the rest
+    for (; i < Count; i++)
+        Output[i] = Unpack21BitVertex(Packed[i], Scale, Offset);
+}
+
+void CoDXModelMeshHelper::UnpackFaceIndexBuffer(const uint8_t* tables, const size_t tableCount, const uint8_t* localPackedIndices, const uint16_t* indices, const size_t faceCount, uint32_t* output)
+{
+    size_t currentFaceIndex = 0;
+
+    // Each table holds the next run of faces, so they are only visited once
+    for (size_t i = 0; i < tableCount && currentFaceIndex < faceCount; i++)
+    {
+        const uint8_t* table = tables + i * 40;
+        const uint8_t* tableIndices = localPackedIndices + *(unsigned int*)(table + 36);
+        const size_t count = *(unsigned __int8*)(table + 35);
+        const size_t bits = *(unsigned __int8*)(table + 34) - 1i64;
+        const size_t faceIndex = *(uint32_t*)(table + 28);
+
+        for (size_t f = 0; f < count && currentFaceIndex < faceCount; f++, currentFaceIndex++)
+        {
+            output[currentFaceIndex * 3 + 0] = indices[FindFaceIndex(tableIndices, f * 3 + 0, bits) + faceIndex];
+            output[currentFaceIndex * 3 + 1] = indices[FindFaceIndex(tableIndices, f * 3 + 1, bits) + faceIndex];
+            output[currentFaceIndex * 3 + 2] = indices[FindFaceIndex(tableIndices, f * 3 + 2, bits) + faceIndex];
+        }
+    }
+}
+
+void CoDXModelMeshHelper::UnpackNormalsA(const uint8_t* Packed, const size_t Stride, const size_t Count, Vector3* Output)
+{
+    size_t i = 0;
+
+    // Unpack as many as we can with the kernel
+    switch (MeshKernel)
+    {
+    case CoDXModelMeshKernel::AVX2: i = UnpackNormalsAAVX2(Packed, Stride, Count, Output); break;
+    case CoDXModelMeshKernel::SSE2: i = UnpackNormalsASSE2(Packed, Stride, Count, Output); break;
+    }
+
+    // Unpack the rest
+    for (; i < Count; i++)
+        Output[i] = UnpackNormalA(*(const uint32_t*)(Packed + i * Stride));
+}
+
+void CoDXModelMeshHelper::UnpackNormalsB(const uint8_t* Packed, const size_t Stride, const size_t Count, Vector3* Output)
+{
+    size_t i = 0;
+
+    // Unpack as many as we can with the kernel
+    switch (MeshKernel)
+    {
+    case CoDXModelMeshKernel::AVX2: i = UnpackNormalsBAVX2(Packed, Stride, Count, Output); break;
+    case CoDXModelMeshKernel::SSE2: i = UnpackNormalsBSSE2(Packed, Stride, Count, Output); break;
+    }
+
+    // Unpack the rest
+    for (; i < Count; i++)
+        Output[i] = UnpackNormalB(*(const uint32_t*)(Packed + i * Stride));
+}
+
+void CoDXModelMeshHelper::UnpackNormalsC(const uint8_t* Packed, const size_t Stride, const size_t Count, Vector3* Output)
+{
+    size_t i = 0;
+
+    // Unpack as many as we can with the kernel
+    switch (MeshKernel)
+    {
+    case CoDXModelMeshKernel::AVX2: i = UnpackNormalsCAVX2(Packed, Stride, Count, Output); break;
+    case CoDXModelMeshKernel::SSE2: i = UnpackNormalsCSSE2(Packed, Stride, Count, Output); break;
+    }
+
+    // Unpack the rest
+    for (; i < Count; i++)
+        Output[i] = UnpackNormalC(*(const uint32_t*)(Packed + i * Stride));
+}
+
+CoDXModelMeshKernel CoDXModelMeshHelper::GetSupportedKernel()
+{
+    // The CPU info buffer
+    int CpuInfo[4];
+
+    // SSE2 is always available on x64
+    auto Result = CoDXModelMeshKernel::SSE2;
+
+    // Check the highest leaf
+    __cpuid(CpuInfo, 0);
+
+    if (CpuInfo[0] >= 7)
+    {
+        __cpuidex(CpuInfo, 1, 0);
+
+        // AVX, and the OS saving the AVX registers
+        bool HasAVX = (CpuInfo[2] & (1 << 28)) != 0 && (CpuInfo[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+
+        __cpuidex(CpuInfo, 7, 0);
+
+        // AVX2
+        if (HasAVX && (CpuInfo[1] & (1 << 5)) != 0)
+            Result = CoDXModelMeshKernel::AVX2;
+    }
+
+    // Return it
+    return Result;
+}
+
+CoDXModelMeshKernel CoDXModelMeshHelper::GetKernel()
+{
+    // Return it
+    return MeshKernel;
+}
+
+void CoDXModelMeshHelper::SetKernel(const CoDXModelMeshKernel Kernel)
+{
+    // Limit it to what's supported
+    MeshKernel = std::min(Kernel, GetSupportedKernel());
+}
@@ -1,14 +1,48 @@
 #pragma once
 #include "VectorMath.h"
 
+// The instruction sets the batch decoders can use
+enum class CoDXModelMeshKernel : uint8_t
+{
+	Scalar,
+	SSE2,
+	AVX2,
+};
+
 class CoDXModelMeshHelper
 {
 public:
-	// Unpacks a 21Bit Vertex 
+	// Unpacks a 21Bit Vertex
 	static const Vector3 Unpack21BitVertex(const uint64_t Packed, const float Scale, const Vector3 Offset);
 	// Finds the absolute index from a given table and packed buffer.
 	static const uint8_t FindFaceIndex(const uint8_t* a1, const size_t a2, const size_t a3);
 	// Unpacks the 3 vertex indices for the given face.
 	static void UnpackFaceIndices(const uint8_t* tables, const size_t tableCount, const uint8_t* packedInfos, const uint16_t* indices, const size_t faceIndex, uint32_t (&output)[3]);
-};
 
+	// Normal unpack method A, used in [WAW, BO, MW, MW2, MW3, QS]
+	static const Vector3 UnpackNormalA(const uint32_t Normal);
+	// Normal unpack method B, used in [BO2]
+	static const Vector3 UnpackNormalB(const uint32_t Normal);
+	// Normal unpack method C, used in [Ghosts, AW, MWR, IW]
+	static const Vector3 UnpackNormalC(const uint32_t Normal);
+
+	// -- Batch decoders, these produce the same values as the single decoders, bit for bit
+
+	// Unpacks a list of 21Bit Vertices
+	static void Unpack21BitVertices(const uint64_t* Packed, const size_t Count, const float Scale, const Vector3 Offset, Vector3* Output);
+	// Unpacks the vertex indices of a list of faces, starting from the first face, in a single pass over the tables
+	static void UnpackFaceIndexBuffer(const uint8_t* tables, const size_t tableCount, const uint8_t* packedInfos, const uint16_t* indices, const size_t faceCount, uint32_t* output);
+	// Unpacks a list of normals with method A, each normal is Stride bytes after the last
+	static void UnpackNormalsA(const uint8_t* Packed, const size_t Stride, const size_t Count, Vector3* Output);
+	// Unpacks a list of normals with method B, each normal is Stride bytes after the last
+	static void UnpackNormalsB(const uint8_t* Packed, const size_t Stride, const size_t Count, Vector3* Output);
+	// Unpacks a list of normals with method C, each normal is Stride bytes after the last
+	static void UnpackNormalsC(const uint8_t* Packed, const size_t Stride, const size_t Count, Vector3* Output);
+
+	// Gets the best kernel this cpu supports
+	static CoDXModelMeshKernel GetSupportedKernel();
+	// Gets the kernel used by the batch decoders, the best supported one by default
+	static CoDXModelMeshKernel GetKernel();
+	// Sets the kernel used by the batch decoders, limited to the best supported one
+	static void SetKernel(const CoDXModelMeshKernel Kernel);
+};
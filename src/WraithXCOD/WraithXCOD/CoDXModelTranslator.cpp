@@ -23,6 +23,9 @@
 #include "DBGameGenerics.h"
 #include "SettingsManager.h"
 
+// We need the mesh helper for the normal decoders
+#include "CoDXModelMeshHelper.h"
+
 struct QSGfxVertexBuffer
 {
     Vector3 Position;
@@ -35,10 +38,10 @@ struct QSGfxVertexBuffer
     uint32_t Normal;
 };
 
-std::unique_ptr<WraithModel> CoDXModelTranslator::TranslateXModel(const std::unique_ptr<XModel_t>& Model, uint32_t LodIndex, bool JustBones)
+std::unique_ptr<WraithModel> CoDXModelTranslator::TranslateXModel(const std::unique_ptr<XModel_t>& Model, uint32_t LodIndex, const CoDExportSettings& Settings, bool JustBones)
 {
     // Check if we want Vertex Colors
-    bool ExportColors = (SettingsManager::GetSetting("exportvtxcolor", "true") == "true");
+    bool ExportColors = Settings.ExportVertexColors;
     // Prepare to generate a WraithModel
     auto ModelResult = std::make_unique<WraithModel>();
 
@@ -69,6 +72,11 @@ std::unique_ptr<WraithModel> CoDXModelTranslator::TranslateXModel(const std::uni
         // Grab the bone parent pointer
         auto BoneParents = Model->BoneParentsPtr;
 
+        // The ids and parents are read one at a time below, so pull both tables into the read cache first
+        CoDAssets::GameInstance->Prefetch(BoneIDs, ((uint64_t)Model->BoneCount + Model->CosmeticBoneCount) * Model->BoneIndexSize);
+        if ((uint64_t)Model->BoneCount + Model->CosmeticBoneCount > Model->RootBoneCount)
+            CoDAssets::GameInstance->Prefetch(BoneParents, ((uint64_t)Model->BoneCount + Model->CosmeticBoneCount - Model->RootBoneCount) * Model->BoneParentSize);
+
         // Prepare the model for bones
         ModelResult->PrepareBones(Model->BoneCount + Model->CosmeticBoneCount);
 
@@ -290,14 +298,14 @@ std::unique_ptr<WraithModel> CoDXModelTranslator::TranslateXModel(const std::uni
         // We have a streamed model, this is handled on a per-game basis, some information is already in the structures
         switch (CurrentGame)
         {
-        case SupportedGames::BlackOps3:             GameBlackOps3::LoadXModel(LodReference, ModelResult); break;
-        case SupportedGames::BlackOps4:             GameBlackOps4::LoadXModel(LodReference, ModelResult); break;
-        case SupportedGames::BlackOpsCW:            GameBlackOpsCW::LoadXModel(LodReference, ModelResult); break;
-        case SupportedGames::WorldWar2:             GameWorldWar2::LoadXModel(Model, LodReference, ModelResult); break;
-        case SupportedGames::ModernWarfare4:        GameModernWarfare4::LoadXModel(LodReference, ModelResult); break;
-        case SupportedGames::ModernWarfare5:        GameModernWarfare5::LoadXModel(Model, LodReference, ModelResult); break;
-        case SupportedGames::ModernWarfare6:        GameModernWarfare6::LoadXModel(Model, LodReference, ModelResult); break;
-        case SupportedGames::Vanguard:              GameVanguard::LoadXModel(Model, LodReference, ModelResult); break;
+        case SupportedGames::BlackOps3:             GameBlackOps3::LoadXModel(LodReference, ModelResult, Settings); break;
+        case SupportedGames::BlackOps4:             GameBlackOps4::LoadXModel(LodReference, ModelResult, Settings); break;
+        case SupportedGames::BlackOpsCW:            GameBlackOpsCW::LoadXModel(LodReference, ModelResult, Settings); break;
+        case SupportedGames::WorldWar2:             GameWorldWar2::LoadXModel(Model, LodReference, ModelResult, Settings); break;
+        case SupportedGames::ModernWarfare4:        GameModernWarfare4::LoadXModel(LodReference, ModelResult, Settings); break;
+        case SupportedGames::ModernWarfare5:        GameModernWarfare5::LoadXModel(Model, LodReference, ModelResult, Settings); break;
+        case SupportedGames::ModernWarfare6:        GameModernWarfare6::LoadXModel(Model, LodReference, ModelResult, Settings); break;
+        case SupportedGames::Vanguard:              GameVanguard::LoadXModel(Model, LodReference, ModelResult, Settings); break;
         }
     }
     else
@@ -354,6 +362,32 @@ std::unique_ptr<WraithModel> CoDXModelTranslator::TranslateXModel(const std::uni
                 auto VertexData = MemoryReader(CoDAssets::GameInstance->Read(Submesh.VertexPtr, VerticiesLength, ReadDataSize), VerticiesLength);
                 auto FaceData = MemoryReader(CoDAssets::GameInstance->Read(Submesh.FacesPtr, FacesLength, ReadDataSize), FacesLength);
 
+                // Unpack all normals of the submesh in one go (Game specific)
+                auto Normals = std::vector<Vector3>(Submesh.VertexCount);
+                auto PackedNormals = (const uint8_t*)VertexData.GetCurrentStream() + offsetof(GfxVertexBuffer, Normal);
+
+                // Check game
+                switch (CurrentGame)
+                {
+                case SupportedGames::WorldAtWar:
+                case SupportedGames::BlackOps:
+                case SupportedGames::ModernWarfare:
+                case SupportedGames::ModernWarfare2:
+                case SupportedGames::ModernWarfare3:
+                    CoDXModelMeshHelper::UnpackNormalsA(PackedNormals, sizeof(GfxVertexBuffer), Submesh.VertexCount, Normals.data());
+                    break;
+                case SupportedGames::BlackOps2:
+                    CoDXModelMeshHelper::UnpackNormalsB(PackedNormals, sizeof(GfxVertexBuffer), Submesh.VertexCount, Normals.data());
+                    break;
+                case SupportedGames::Ghosts:
+                case SupportedGames::AdvancedWarfare:
+                case SupportedGames::ModernWarfareRemastered:
+                case SupportedGames::ModernWarfare2Remastered:
+                case SupportedGames::InfiniteWarfare:
+                    CoDXModelMeshHelper::UnpackNormalsC(PackedNormals, sizeof(GfxVertexBuffer), Submesh.VertexCount, Normals.data());
+                    break;
+                }
+
                 // Iterate over verticies
                 for (uint32_t i = 0; i < Submesh.VertexCount; i++)
                 {
@@ -364,8 +398,9 @@ std::unique_ptr<WraithModel> CoDXModelTranslator::TranslateXModel(const std::uni
                     auto VertexInfo = VertexData.Read<GfxVertexBuffer>();
                     // Assign data
                     Vertex.Position = VertexInfo.Position;
+                    Vertex.Normal = Normals[i];
 
-                    // Unpack normal (Game specific)
+                    // Apply UV layer (Game specific)
                     switch (CurrentGame)
                     {
                     case SupportedGames::WorldAtWar:
@@ -375,14 +410,10 @@ std::unique_ptr<WraithModel> CoDXModelTranslator::TranslateXModel(const std::uni
                     case SupportedGames::ModernWarfare3:
                         // Apply UV layer (These games seems to have UVV before UVU) this works on all models
                         Vertex.AddUVLayer(HalfFloats::ToFloat(VertexInfo.UVVPos), HalfFloats::ToFloat(VertexInfo.UVUPos));
-                        // Unpack vertex normal
-                        Vertex.Normal = UnpackNormalA(VertexInfo.Normal);
                         break;
                     case SupportedGames::BlackOps2:
                         // Apply UV layer
                         Vertex.AddUVLayer(HalfFloats::ToFloat(VertexInfo.UVUPos), HalfFloats::ToFloat(VertexInfo.UVVPos));
-                        // Unpack vertex normal
-                        Vertex.Normal = UnpackNormalB(VertexInfo.Normal);
                         break;
                     case SupportedGames::Ghosts:
                     case SupportedGames::AdvancedWarfare:
@@ -391,8 +422,6 @@ std::unique_ptr<WraithModel> CoDXModelTranslator::TranslateXModel(const std::uni
                     case SupportedGames::InfiniteWarfare:
                         // Apply UV layer
                         Vertex.AddUVLayer(HalfFloats::ToFloat(VertexInfo.UVUPos), HalfFloats::ToFloat(VertexInfo.UVVPos));
-                        // Unpack vertex normal
-                        Vertex.Normal = UnpackNormalC(VertexInfo.Normal);
                         break;
                     }
 
@@ -443,6 +472,10 @@ std::unique_ptr<WraithModel> CoDXModelTranslator::TranslateXModel(const std::uni
                 auto VertexData = MemoryReader(CoDAssets::GameInstance->Read(Submesh.VertexPtr, VerticiesLength, ReadDataSize), VerticiesLength);
                 auto FaceData = MemoryReader(CoDAssets::GameInstance->Read(Submesh.FacesPtr, FacesLength, ReadDataSize), FacesLength);
 
+                // Unpack all normals of the submesh in one go
+                auto Normals = std::vector<Vector3>(Submesh.VertexCount);
+                CoDXModelMeshHelper::UnpackNormalsA((const uint8_t*)VertexData.GetCurrentStream() + offsetof(QSGfxVertexBuffer, Tangent), sizeof(QSGfxVertexBuffer), Submesh.VertexCount, Normals.data());
+
                 // Iterate over verticies
                 for (uint32_t i = 0; i < Submesh.VertexCount; i++)
                 {
@@ -453,7 +486,7 @@ std::unique_ptr<WraithModel> CoDXModelTranslator::TranslateXModel(const std::uni
                     auto VertexInfo = VertexData.Read<QSGfxVertexBuffer>();
                     // Assign data
                     Vertex.Position = VertexInfo.Position;
-                    Vertex.Normal = UnpackNormalA(VertexInfo.Tangent);
+                    Vertex.Normal = Normals[i];
                     Vertex.AddUVLayer(VertexInfo.UV.X, VertexInfo.UV.Y);
 
                     // Add Colors if we want them
@@ -526,56 +559,6 @@ int32_t CoDXModelTranslator::CalculateBiggestLodIndex(const std::unique_ptr<XMod
     return 0;
 }
 
-Vector3 CoDXModelTranslator::UnpackNormalA(uint32_t Normal)
-{
-    // Unpack a normal, used in [WAW, BO, MW, MW2, MW3]
-
-    // Convert to packed structure
-    auto PackedNormal = (GfxPackedUnitVec*)&Normal;
-
-    // Decode the scale of the vector
-    float DecodeScale = (float)((float)(uint8_t)PackedNormal->PackedBytes[3] - -192.0) / 32385.0f;
-
-    // Make the vector
-    return Vector3(
-        (float)((float)(uint8_t)PackedNormal->PackedBytes[0] - 127.0) * DecodeScale,
-        (float)((float)(uint8_t)PackedNormal->PackedBytes[1] - 127.0) * DecodeScale,
-        (float)((float)(uint8_t)PackedNormal->PackedBytes[2] - 127.0) * DecodeScale);
-}
-
-Vector3 CoDXModelTranslator::UnpackNormalB(uint32_t Normal)
-{
-    // Unpack a normal, used in [BO2]
-
-    // Convert to packed structure
-    auto PackedNormal = (GfxPackedUnitVec*)&Normal;
-
-    // Rebuild the float (As an integer value)
-    uint32_t RBuiltX = ((PackedNormal->PackedInteger & 0x3FF) - 2 * (PackedNormal->PackedInteger & 0x200) + 0x40400000);
-    uint32_t RBuiltY = (((PackedNormal->PackedInteger >> 10) & 0x3FF) - 2 * ((PackedNormal->PackedInteger >> 10) & 0x200) + 0x40400000);
-    uint32_t RBuiltZ = (((PackedNormal->PackedInteger >> 20) & 0x3FF) - 2 * ((PackedNormal->PackedInteger >> 20) & 0x200) + 0x40400000);
-
-    // Make the vector
-    return Vector3(
-        (float)(*reinterpret_cast<float*>(&RBuiltX) - 3.0) * 8208.0312f,
-        (float)(*reinterpret_cast<float*>(&RBuiltY) - 3.0) * 8208.0312f,
-        (float)(*reinterpret_cast<float*>(&RBuiltZ) - 3.0) * 8208.0312f);
-}
-
-Vector3 CoDXModelTranslator::UnpackNormalC(uint32_t Normal)
-{
-    // Unpack a normal, used in [Ghosts, AW, MWR, IW]
-
-    // Convert to packed structure
-    auto PackedNormal = (GfxPackedUnitVec*)&Normal;
-
-    // Make the vector
-    return Vector3(
-        (float)((float)((float)(PackedNormal->PackedInteger & 0x3FF) / 1023.0) * 2.0) - 1.0f,
-        (float)((float)((float)((PackedNormal->PackedInteger >> 10) & 0x3FF) / 1023.0) * 2.0) - 1.0f,
-        (float)((float)((float)((PackedNormal->PackedInteger >> 20) & 0x3FF) / 1023.0) * 2.0) - 1.0f);
-}
-
 void CoDXModelTranslator::PrepareVertexWeightsA(std::vector<WeightsData>& Weights, const XModelSubmesh_t& Submesh)
 {
     // Prepare weights, used in [WAW, BO, BO2, MW, MW2, MW3]
@@ -1216,13 +1199,13 @@ void CoDXModelTranslator::PrepareVertexWeightsC(std::vector<WeightsData>& Weight
     }
 }
 
-std::unique_ptr<WraithModel> CoDXModelTranslator::TranslateXModelHitbox(const std::unique_ptr<XModel_t>& Model)
+std::unique_ptr<WraithModel> CoDXModelTranslator::TranslateXModelHitbox(const std::unique_ptr<XModel_t>& Model, const CoDExportSettings& Settings)
 {
     // Ensure we have a hitbox loaded
     if (Model->BoneInfoPtr == 0) { return nullptr; }
 
     // Prepare to translate the model hitbox
-    auto Result = TranslateXModel(Model, 0, true);
+    auto Result = TranslateXModel(Model, 0, Settings, true);
 
     // Ensure we translated it
     if (Result != nullptr)
@@ -1230,6 +1213,9 @@ std::unique_ptr<WraithModel> CoDXModelTranslator::TranslateXModelHitbox(const st
         // Grab the info ptr
         auto BoneInfoPtr = Model->BoneInfoPtr;
 
+        // Pull the info table into the read cache
+        CoDAssets::GameInstance->Prefetch(BoneInfoPtr, Result->Bones.size() * sizeof(GfxBoneInfo));
+
         // Iterate over bones and generate meshes
         for (size_t i = 0; i < (Result->Bones.size()); i++)
         {
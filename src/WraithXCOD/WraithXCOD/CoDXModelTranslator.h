@@ -53,9 +53,9 @@ public:
     // -- Translation functions
 
     // Translates an in-game XModel to a WraithModel
-    static std::unique_ptr<WraithModel> TranslateXModel(const std::unique_ptr<XModel_t>& Model, uint32_t LodIndex, bool JustBones = false);
+    static std::unique_ptr<WraithModel> TranslateXModel(const std::unique_ptr<XModel_t>& Model, uint32_t LodIndex, const CoDExportSettings& Settings, bool JustBones = false);
     // Translates an in-game XModel's hitbox to a WraithModel
-    static std::unique_ptr<WraithModel> TranslateXModelHitbox(const std::unique_ptr<XModel_t>& Model);
+    static std::unique_ptr<WraithModel> TranslateXModelHitbox(const std::unique_ptr<XModel_t>& Model, const CoDExportSettings& Settings);
 
     // -- Utility functions
 
@@ -65,13 +65,6 @@ public:
 private:
     // -- Translation utilities
 
-    // Normal unpack method A
-    static Vector3 UnpackNormalA(uint32_t Normal);
-    // Normal unpack method B
-    static Vector3 UnpackNormalB(uint32_t Normal);
-    // Normal unpack method C
-    static Vector3 UnpackNormalC(uint32_t Normal);
-
     // Prepares vertex weights A
     static void PrepareVertexWeightsA(std::vector<WeightsData>& Weights, const XModelSubmesh_t& Submesh);
     // Prepares vertex weights B
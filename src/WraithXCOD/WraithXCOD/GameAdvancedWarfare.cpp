@@ -1061,7 +1061,7 @@ std::unique_ptr<XImageDDS> GameAdvancedWarfare::LoadXImage(const XImage_t& Image
         auto Result = CoDRawImageTranslator::TranslateBC(ImageData, ResultSize, LargestWidth, LargestHeight, ImageInfo.ImageFormat, 1, (ImageInfo.MapType == (uint8_t)GfxImageMapType::MAPTYPE_CUBE));
 
         // Check for, and apply patch if required, if we got a raw result
-        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && (SettingsManager::GetSetting("patchnormals", "true") == "true"))
+        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && CoDAssets::GetExportSettings()->PatchNormals)
         {
             // Set normal map patch
             Result->ImagePatchType = ImagePatch::Normal_Expand;
@@ -1168,7 +1168,7 @@ std::unique_ptr<XImageDDS> GameAdvancedWarfare::LoadXImagePS(const XImage_t& Ima
         auto Result = CoDRawImageTranslator::TranslateBC(ImageData, ResultSize, LargestWidth, LargestHeight, ImageInfo.ImageFormat, 1, (ImageInfo.MapType == (uint8_t)GfxImageMapType::MAPTYPE_CUBE));
 
         // Check for, and apply patch if required, if we got a raw result
-        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && (SettingsManager::GetSetting("patchnormals", "true") == "true"))
+        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && CoDAssets::GetExportSettings()->PatchNormals)
         {
             // Set normal map patch
             Result->ImagePatchType = ImagePatch::Normal_Expand;
@@ -537,7 +537,7 @@ std::unique_ptr<XImageDDS> GameBlackOps2::LoadXImage(const XImage_t& Image)
     if (ImageInfo.Streamed <= 0) { return nullptr; }
 
     // Attempt to load it (The key is actually the upper and lower half combined, as a single uint64_t)
-    auto ImageData = CoDAssets::GamePackageCache->ExtractPackageObject((((uint64_t)ImageInfo.KeyUpper) << 32 | ImageInfo.KeyLower), ResultSize);
+    auto ImageData = CoDAssets::GamePackageCache->ExtractPackageObjectCached((((uint64_t)ImageInfo.KeyUpper) << 32 | ImageInfo.KeyLower), ResultSize);
 
     // Check
     if (ImageData != nullptr)
@@ -546,7 +546,7 @@ std::unique_ptr<XImageDDS> GameBlackOps2::LoadXImage(const XImage_t& Image)
         auto Result = CoDIWITranslator::TranslateIWI(ImageData, ResultSize);
 
         // Check for, and apply patch if required, if we got an IWI result
-        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && (SettingsManager::GetSetting("patchnormals", "true") == "true"))
+        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && CoDAssets::GetExportSettings()->PatchNormals)
         {
             // Set normal map patch
             Result->ImagePatchType = ImagePatch::Normal_Expand;
@@ -699,7 +699,7 @@ std::unique_ptr<XImageDDS> GameBlackOps3::LoadXImage(const XImage_t& Image)
     else
     {
         // We have a streamed image, prepare to extract
-        ImageData = CoDAssets::GamePackageCache->ExtractPackageObject(LargestHash, LargestSize, ResultSize);
+        ImageData = CoDAssets::GamePackageCache->ExtractPackageObjectCached(LargestHash, LargestSize, ResultSize);
     }
 
     // Prepare if we have it
@@ -709,7 +709,7 @@ std::unique_ptr<XImageDDS> GameBlackOps3::LoadXImage(const XImage_t& Image)
         auto Result = CoDRawImageTranslator::TranslateBC(ImageData, ResultSize, LargestWidth, LargestHeight, ImageInfo.ImageFormat);
 
         // Check for, and apply patch if required, if we got a raw result
-        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && (SettingsManager::GetSetting("patchnormals", "true") == "true"))
+        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && CoDAssets::GetExportSettings()->PatchNormals)
         {
             // Set normal map patch
             Result->ImagePatchType = ImagePatch::Normal_Expand;
@@ -723,10 +723,10 @@ std::unique_ptr<XImageDDS> GameBlackOps3::LoadXImage(const XImage_t& Image)
     return nullptr;
 }
 
-void GameBlackOps3::LoadXModel(const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel)
+void GameBlackOps3::LoadXModel(const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel, const CoDExportSettings& Settings)
 {
     // Check if we want Vertex Colors
-    bool ExportColors = (SettingsManager::GetSetting("exportvtxcolor", "true") == "true");
+    bool ExportColors = Settings.ExportVertexColors;
     // Read the mesh information
     auto MeshInfo = CoDAssets::GameInstance->Read<BO3XModelMeshInfo>(ModelLOD.LODStreamInfoPtr);
 
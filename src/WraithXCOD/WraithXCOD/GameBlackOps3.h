@@ -8,6 +8,7 @@
 // We need the DBGameAssets and CoDAssetType classes
 #include "DBGameAssets.h"
 #include "CoDAssetType.h"
+#include "CoDExportSettings.h"
 #include "WraithModel.h"
 
 // Handles reading from Black Ops 3
@@ -31,7 +32,7 @@ public:
     // Reads an XImageDDS from a image reference from Black Ops 3
     static std::unique_ptr<XImageDDS> LoadXImage(const XImage_t& Image);
     // Loads a streamed XModel lod, streaming from cache if need be
-    static void LoadXModel(const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel);
+    static void LoadXModel(const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel, const CoDExportSettings& Settings);
 
     // Reads a string via it's string index for Black Ops 3
     static std::string LoadStringEntry(uint64_t Index);
@@ -779,10 +779,10 @@ bool GameBlackOps4::LoadAssets()
             Asset.NamePtr &= 0xFFFFFFFFFFFFFFF;
 
             // Check for filters
-            if (Filters.NameDatabase.size() > 0)
+            if (Filters.Size() > 0)
             {
                 // Check for this asset in DB
-                if (Filters.NameDatabase.find(Asset.NamePtr) != Filters.NameDatabase.end())
+                if (Filters.Contains(Asset.NamePtr))
                 {
                     // Skip this asset
                     return;
@@ -793,10 +793,10 @@ bool GameBlackOps4::LoadAssets()
             auto AnimName = Strings::Format("xanim_%llx", Asset.NamePtr);
 
             // Check for an override in the name DB
-            if (AssetNameCache.NameDatabase.find(Asset.NamePtr) != AssetNameCache.NameDatabase.end())
-            {
-                auto& NewName = AssetNameCache.NameDatabase[Asset.NamePtr];
+            std::string NewName;
 
+            if (AssetNameCache.TryGetName(Asset.NamePtr, NewName))
+            {
                 if (CoDAssets::VerifiedHashes)
                 {
                     if (BO4CalculateHash(NewName) == Asset.NamePtr)
@@ -849,10 +849,10 @@ bool GameBlackOps4::LoadAssets()
             Asset.NamePtr &= 0xFFFFFFFFFFFFFFF;
 
             // Check for filters
-            if (Filters.NameDatabase.size() > 0)
+            if (Filters.Size() > 0)
             {
                 // Check for this asset in DB
-                if (Filters.NameDatabase.find(Asset.NamePtr) != Filters.NameDatabase.end())
+                if (Filters.Contains(Asset.NamePtr))
                 {
                     // Skip this asset
                     return;
@@ -863,10 +863,10 @@ bool GameBlackOps4::LoadAssets()
             auto ModelName = Strings::Format("xmodel_%llx", Asset.NamePtr);
 
             // Check for an override in the name DB
-            if (AssetNameCache.NameDatabase.find(Asset.NamePtr) != AssetNameCache.NameDatabase.end())
-            {
-                auto& NewName = AssetNameCache.NameDatabase[Asset.NamePtr];
+            std::string NewName;
 
+            if (AssetNameCache.TryGetName(Asset.NamePtr, NewName))
+            {
                 if (CoDAssets::VerifiedHashes)
                 {
                     if (BO4CalculateHash(NewName) == Asset.NamePtr)
@@ -918,10 +918,10 @@ bool GameBlackOps4::LoadAssets()
             Asset.NamePtr &= 0xFFFFFFFFFFFFFFF;
 
             // Check for filters
-            if (Filters.NameDatabase.size() > 0)
+            if (Filters.Size() > 0)
             {
                 // Check for this asset in DB
-                if (Filters.NameDatabase.find(Asset.NamePtr) != Filters.NameDatabase.end())
+                if (Filters.Contains(Asset.NamePtr))
                 {
                     // Skip this asset
                     return;
@@ -932,10 +932,10 @@ bool GameBlackOps4::LoadAssets()
             auto ImageName = Strings::Format("ximage_%llx", Asset.NamePtr);
 
             // Check for an override in the name DB
-            if (AssetNameCache.NameDatabase.find(Asset.NamePtr) != AssetNameCache.NameDatabase.end())
-            {
-                auto& NewName = AssetNameCache.NameDatabase[Asset.NamePtr];
+            std::string NewName;
 
+            if (AssetNameCache.TryGetName(Asset.NamePtr, NewName))
+            {
                 if (CoDAssets::VerifiedHashes)
                 {
                     if (BO4CalculateHash(NewName) == Asset.NamePtr)
@@ -979,10 +979,10 @@ bool GameBlackOps4::LoadAssets()
             Asset.NamePtr &= 0xFFFFFFFFFFFFFFF;
 
             // Check for filters
-            if (Filters.NameDatabase.size() > 0)
+            if (Filters.Size() > 0)
             {
                 // Check for this asset in DB
-                if (Filters.NameDatabase.find(Asset.NamePtr) != Filters.NameDatabase.end())
+                if (Filters.Contains(Asset.NamePtr))
                 {
                     // Skip this asset
                     return;
@@ -993,10 +993,10 @@ bool GameBlackOps4::LoadAssets()
             auto MaterialName = Strings::Format("xmaterial_%llx", Asset.NamePtr);
 
             // Check for an override in the name DB
-            if (AssetNameCache.NameDatabase.find(Asset.NamePtr) != AssetNameCache.NameDatabase.end())
-            {
-                auto& NewName = AssetNameCache.NameDatabase[Asset.NamePtr];
+            std::string NewName;
 
+            if (AssetNameCache.TryGetName(Asset.NamePtr, NewName))
+            {
                 if (CoDAssets::VerifiedHashes)
                 {
                     if (BO4CalculateHash(NewName) == Asset.NamePtr)
@@ -1236,8 +1236,10 @@ const XMaterial_t GameBlackOps4::ReadXMaterial(uint64_t MaterialPointer)
     Result.MaterialName = Strings::Format("xmaterial_%llx", MaterialData.NamePtr);
 
     // Check for an override in the name DB
-    if (AssetNameCache.NameDatabase.find(MaterialData.NamePtr) != AssetNameCache.NameDatabase.end())
-        Result.MaterialName = FileSystems::GetFileNamePurgeExtensions(AssetNameCache.NameDatabase[MaterialData.NamePtr]);
+    std::string MaterialName;
+
+    if (AssetNameCache.TryGetName(MaterialData.NamePtr, MaterialName))
+        Result.MaterialName = FileSystems::GetFileNamePurgeExtensions(MaterialName);
 
     // Iterate over material images, assign proper references if available
     for (uint32_t m = 0; m < MaterialData.ImageCount; m++)
@@ -1252,8 +1254,7 @@ const XMaterial_t GameBlackOps4::ReadXMaterial(uint64_t MaterialPointer)
         auto ImageName = Strings::Format("ximage_%llx", ImageHash);
 
         // Check for an override in the name DB
-        if (AssetNameCache.NameDatabase.find(ImageHash) != AssetNameCache.NameDatabase.end())
-            ImageName = AssetNameCache.NameDatabase[ImageHash];
+        AssetNameCache.TryGetName(ImageHash, ImageName);
 
         // Default type
         auto DefaultUsage = ImageUsageType::Unknown;
@@ -1365,7 +1366,7 @@ std::unique_ptr<XImageDDS> GameBlackOps4::LoadXImage(const XImage_t& Image)
     else
     {
         // We have a streamed image, prepare to extract
-        ImageData = CoDAssets::GamePackageCache->ExtractPackageObject(LargestHash, LargestSize, ResultSize);
+        ImageData = CoDAssets::GamePackageCache->ExtractPackageObjectCached(LargestHash, LargestSize, ResultSize);
     }
 
     // Prepare if we have it
@@ -1375,7 +1376,7 @@ std::unique_ptr<XImageDDS> GameBlackOps4::LoadXImage(const XImage_t& Image)
         auto Result = CoDRawImageTranslator::TranslateBC(ImageData, ResultSize, LargestWidth, LargestHeight, ImageInfo.ImageFormat);
 
         // Check for, and apply patch if required, if we got a raw result
-        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && (SettingsManager::GetSetting("patchnormals", "true") == "true"))
+        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && CoDAssets::GetExportSettings()->PatchNormals)
         {
             // Set normal map patch
             Result->ImagePatchType = ImagePatch::Normal_Expand;
@@ -1440,10 +1441,10 @@ struct Bo4BlendShapeInfo
 };
 
 
-void GameBlackOps4::LoadXModel(const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel)
+void GameBlackOps4::LoadXModel(const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel, const CoDExportSettings& Settings)
 {
     // Check if we want Vertex Colors
-    bool ExportColors = (SettingsManager::GetSetting("exportvtxcolor", "true") == "true");
+    bool ExportColors = Settings.ExportVertexColors;
     // Read the mesh information
     auto MeshInfo = CoDAssets::GameInstance->Read<BO4XModelMeshInfoEx>(ModelLOD.LODStreamInfoPtr);
 
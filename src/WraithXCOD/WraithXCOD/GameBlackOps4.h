@@ -8,6 +8,7 @@
 // We need the DBGameAssets and CoDAssetType classes
 #include "DBGameAssets.h"
 #include "CoDAssetType.h"
+#include "CoDExportSettings.h"
 #include "WraithModel.h"
 #include "WraithNameIndex.h"
 
@@ -36,7 +37,7 @@ public:
     // Reads an XImageDDS from a image reference from Black Ops 4
     static std::unique_ptr<XImageDDS> LoadXImage(const XImage_t& Image);
     // Loads a streamed XModel lod, streaming from cache if need be
-    static void LoadXModel(const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel);
+    static void LoadXModel(const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel, const CoDExportSettings& Settings);
 
     // String Handlers for Black Ops 4
     static std::string DecryptString(uint8_t* InputBuffer, uint8_t InputLength, uint8_t EncryptionID, uint64_t StringHash);
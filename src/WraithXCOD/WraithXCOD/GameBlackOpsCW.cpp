@@ -7,6 +7,7 @@
 #include "CoDAssets.h"
 #include "CoDRawImageTranslator.h"
 #include "CoDXPoolParser.h"
+#include "SABSupport.h"
 
 // We need the following WraithX classes
 #include "Strings.h"
@@ -17,9 +18,6 @@
 #include "HalfFloats.h"
 #include "Sound.h"
 
-// We need Opus
-#include "../../External/Opus/include/opus.h"
-
 // We need DirectXShaderCompiler for reflection
 #include <wrl/client.h>
 #include <d3d12.h>
@@ -316,10 +314,10 @@ bool GameBlackOpsCW::LoadAssets()
             Asset.NamePtr &= 0xFFFFFFFFFFFFFFF;
 
             // Check for filters
-            if (Filters.NameDatabase.size() > 0)
+            if (Filters.Size() > 0)
             {
                 // Check for this asset in DB
-                if (Filters.NameDatabase.find(Asset.NamePtr) != Filters.NameDatabase.end())
+                if (Filters.Contains(Asset.NamePtr))
                 {
                     // Skip this asset
                     return;
@@ -330,10 +328,10 @@ bool GameBlackOpsCW::LoadAssets()
             auto AnimName = Strings::Format("xanim_%llx", Asset.NamePtr);
 
             // Check for an override in the name DB
-            if (AssetNameCache.NameDatabase.find(Asset.NamePtr) != AssetNameCache.NameDatabase.end())
-            {
-                auto& NewName = AssetNameCache.NameDatabase[Asset.NamePtr];
+            std::string NewName;
 
+            if (AssetNameCache.TryGetName(Asset.NamePtr, NewName))
+            {
                 if (CoDAssets::VerifiedHashes)
                 {
                     if (CWCalculateHash(NewName) == Asset.NamePtr)
@@ -386,10 +384,10 @@ bool GameBlackOpsCW::LoadAssets()
             Asset.NamePtr &= 0xFFFFFFFFFFFFFFF;
 
             // Check for filters
-            if (Filters.NameDatabase.size() > 0)
+            if (Filters.Size() > 0)
             {
                 // Check for this asset in DB
-                if (Filters.NameDatabase.find(Asset.NamePtr) != Filters.NameDatabase.end())
+                if (Filters.Contains(Asset.NamePtr))
                 {
                     // Skip this asset
                     return;
@@ -403,10 +401,10 @@ bool GameBlackOpsCW::LoadAssets()
             auto& ModelName = Strings::Format("xmodel_%llx", Asset.NamePtr);
 
             // Check for an override in the name DB
-            if (AssetNameCache.NameDatabase.find(Asset.NamePtr) != AssetNameCache.NameDatabase.end())
-            {
-                auto& NewName = AssetNameCache.NameDatabase[Asset.NamePtr];
+            std::string NewName;
 
+            if (AssetNameCache.TryGetName(Asset.NamePtr, NewName))
+            {
                 if (CoDAssets::VerifiedHashes)
                 {
                     if (CWCalculateHash(NewName) == Asset.NamePtr)
@@ -456,10 +454,10 @@ bool GameBlackOpsCW::LoadAssets()
             Asset.NamePtr &= 0xFFFFFFFFFFFFFFF;
 
             // Check for filters
-            if (Filters.NameDatabase.size() > 0)
+            if (Filters.Size() > 0)
             {
                 // Check for this asset in DB
-                if (Filters.NameDatabase.find(Asset.NamePtr) != Filters.NameDatabase.end())
+                if (Filters.Contains(Asset.NamePtr))
                 {
                     // Skip this asset
                     return;
@@ -470,10 +468,10 @@ bool GameBlackOpsCW::LoadAssets()
             auto ImageName = Strings::Format("ximage_%llx", Asset.NamePtr);
 
             // Check for an override in the name DB
-            if (AssetNameCache.NameDatabase.find(Asset.NamePtr) != AssetNameCache.NameDatabase.end())
-            {
-                auto& NewName = AssetNameCache.NameDatabase[Asset.NamePtr];
+            std::string NewName;
 
+            if (AssetNameCache.TryGetName(Asset.NamePtr, NewName))
+            {
                 if (CoDAssets::VerifiedHashes)
                 {
                     if (CWCalculateHash(NewName) == Asset.NamePtr)
@@ -518,10 +516,10 @@ bool GameBlackOpsCW::LoadAssets()
             Asset.NamePtr &= 0xFFFFFFFFFFFFFFF;
 
             // Check for filters
-            if (Filters.NameDatabase.size() > 0)
+            if (Filters.Size() > 0)
             {
                 // Check for this asset in DB
-                if (Filters.NameDatabase.find(Asset.NamePtr) != Filters.NameDatabase.end())
+                if (Filters.Contains(Asset.NamePtr))
                 {
                     // Skip this asset
                     return;
@@ -532,10 +530,10 @@ bool GameBlackOpsCW::LoadAssets()
             auto MaterialName = Strings::Format("xmaterial_%llx", Asset.NamePtr);
 
             // Check for an override in the name DB
-            if (AssetNameCache.NameDatabase.find(Asset.NamePtr) != AssetNameCache.NameDatabase.end())
-            {
-                auto& NewName = AssetNameCache.NameDatabase[Asset.NamePtr];
+            std::string NewName;
 
+            if (AssetNameCache.TryGetName(Asset.NamePtr, NewName))
+            {
                 if (CoDAssets::VerifiedHashes)
                 {
                     if (CWCalculateHash(NewName) == Asset.NamePtr)
@@ -576,10 +574,10 @@ bool GameBlackOpsCW::LoadAssets()
             auto SoundName = Strings::Format("xsound_%llx", Asset.NamePtr);
 
             // Check for an override in the name DB
-            if (AssetNameCache.NameDatabase.find(Asset.NamePtr) != AssetNameCache.NameDatabase.end())
-            {
-                auto& NewName = AssetNameCache.NameDatabase[Asset.NamePtr];
+            std::string NewName;
 
+            if (AssetNameCache.TryGetName(Asset.NamePtr, NewName))
+            {
                 if (CoDAssets::VerifiedHashes)
                 {
                     if (CWCalculateHash(NewName) == Asset.NamePtr)
@@ -827,8 +825,6 @@ std::unique_ptr<XSound> GameBlackOpsCW::ReadXSound(const CoDSound_t * Sound)
     // Offset to the data, depending on the buffer
     uint32_t OpusDataSize       = 0;
     uint32_t OpusDataOffset     = 0;
-    uint32_t OpusConsumed       = 0;
-    uint32_t PCMDataSize        = 0;
 
     // Check if we need raw data or standard xpak
     if (SoundData.StreamKey != 0)
@@ -859,66 +855,8 @@ std::unique_ptr<XSound> GameBlackOpsCW::ReadXSound(const CoDSound_t * Sound)
     if(SoundBuffer == nullptr)
         return nullptr;
 
-    // Initialize Opus
-    int ErrorCode;
-    auto Decoder = opus_decoder_create(GetFrameRate(SoundData.FrameRateIndex), SoundData.ChannelCount, &ErrorCode);
-
-    if (ErrorCode != OPUS_OK)
-        return nullptr;
-
-    // Create new buffer for each 960 frame block
-    auto PCMBuffer = std::make_unique<opus_int16[]>(960 * 2 * (size_t)SoundData.ChannelCount);
-
-    // Output Writer (Note: Frame Count in Asset isn't 100% accurate, so we add on some padding
-    //                      to account for 960 frame split so that we can avoid realloc)
-    MemoryWriter TempWriter((SoundData.FrameCount + 4096) * 2 * SoundData.ChannelCount);
-
-    // Consume Opus Data
-    while (OpusConsumed < OpusDataSize)
-    {
-        uint32_t BlockSize = *(uint32_t*)(SoundBuffer.get() + OpusConsumed + OpusDataOffset);
-        OpusConsumed += 4;
-
-        auto DecoderResult = opus_decode(
-            Decoder,
-            (SoundBuffer.get() + OpusConsumed + OpusDataOffset),
-            BlockSize,
-            PCMBuffer.get(),
-            960,
-            0);
-
-        // Any negative is a failure in Opus
-        if (DecoderResult < 0)
-            return nullptr;
-
-        // Output to Buffer
-        TempWriter.Write((uint8_t*)PCMBuffer.get(), 960 * 2 * SoundData.ChannelCount);
-
-        // Advance Info
-        OpusConsumed       += BlockSize;
-        PCMDataSize        += 960 * 2 * SoundData.ChannelCount;
-    }
-
-    // Prepare to read the sound data, for WAV, we must include a WAV header...
-    auto Result = std::make_unique<XSound>();
-
-    // The offset of which to store the data
-    uint32_t DataOffset = 0;
-
-    // We'll convert all BOCW sounds to 16bit PCM WAV
-    Result->DataBuffer = new int8_t[PCMDataSize + (size_t)Sound::GetMaximumWAVHeaderSize()];
-    Result->DataType = SoundDataTypes::WAV_WithHeader;
-    Result->DataSize = (uint32_t)(PCMDataSize + Sound::GetMaximumWAVHeaderSize());
-
-    DataOffset += Sound::GetMaximumWAVHeaderSize();
-
-    // Make the header
-    Sound::WriteWAVHeaderToStream(Result->DataBuffer, (uint32_t)Sound->FrameRate, (uint32_t)Sound->ChannelsCount, PCMDataSize);
-
-    // Copy output
-    std::memcpy(Result->DataBuffer + DataOffset, TempWriter.GetCurrentStream(), PCMDataSize);
-
-    return Result;
+    // The sound is decoded as it's written, each block has a 4 byte length
+    return SABSupport::LoadOpusInterleaved(std::move(SoundBuffer), OpusDataSize, OpusDataOffset, GetFrameRate(SoundData.FrameRateIndex), SoundData.ChannelCount, SoundData.FrameCount, 4);
 }
 
 #pragma pack(push, 1)
@@ -985,8 +923,10 @@ const XMaterial_t GameBlackOpsCW::ReadXMaterial(uint64_t MaterialPointer)
     Result.TechsetName = Strings::Format("xtechset_%llx", CoDAssets::GameInstance->Read<uint64_t>(MaterialData.TechsetPtr));
 
     // Check for an override in the name DB
-    if (AssetNameCache.NameDatabase.find(MaterialData.NamePtr) != AssetNameCache.NameDatabase.end())
-        Result.MaterialName = FileSystems::GetFileNamePurgeExtensions(AssetNameCache.NameDatabase[MaterialData.NamePtr]);
+    std::string MaterialName;
+
+    if (AssetNameCache.TryGetName(MaterialData.NamePtr, MaterialName))
+        Result.MaterialName = FileSystems::GetFileNamePurgeExtensions(MaterialName);
 
     // Iterate over material images, assign proper references if available
     for (uint32_t m = 0; m < MaterialData.ImageCount; m++)
@@ -1001,8 +941,7 @@ const XMaterial_t GameBlackOpsCW::ReadXMaterial(uint64_t MaterialPointer)
         auto ImageName = Strings::Format("ximage_%llx", ImageHash);
 
         // Check for an override in the name DB
-        if (AssetNameCache.NameDatabase.find(ImageHash) != AssetNameCache.NameDatabase.end())
-            ImageName = AssetNameCache.NameDatabase[ImageHash];
+        AssetNameCache.TryGetName(ImageHash, ImageName);
 
         // Default type
         auto DefaultUsage = ImageUsageType::Unknown;
@@ -1227,7 +1166,7 @@ std::unique_ptr<XImageDDS> GameBlackOpsCW::LoadXImage(const XImage_t& Image)
     else
     {
         // We have a streamed image, prepare to extract
-        ImageData = CoDAssets::GamePackageCache->ExtractPackageObject(LargestHash, ResultSize);
+        ImageData = CoDAssets::GamePackageCache->ExtractPackageObjectCached(LargestHash, ResultSize);
     }
 
     // Prepare if we have it
@@ -1237,7 +1176,7 @@ std::unique_ptr<XImageDDS> GameBlackOpsCW::LoadXImage(const XImage_t& Image)
         auto Result = CoDRawImageTranslator::TranslateBC(ImageData, ResultSize, LargestWidth, LargestHeight, ImageInfo.ImageFormat);
 
         // Check for, and apply patch if required, if we got a raw result
-        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && (SettingsManager::GetSetting("patchnormals", "true") == "true"))
+        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && CoDAssets::GetExportSettings()->PatchNormals)
         {
             // Set normal map patch
             Result->ImagePatchType = ImagePatch::Normal_Expand;
@@ -1271,10 +1210,10 @@ struct BlendShapeVertex
     uint16_t Z;
 };
 
-void GameBlackOpsCW::LoadXModel(const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel)
+void GameBlackOpsCW::LoadXModel(const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel, const CoDExportSettings& Settings)
 {
     // Check if we want Vertex Colors
-    bool ExportColors = (SettingsManager::GetSetting("exportvtxcolor", "true") == "true");
+    bool ExportColors = Settings.ExportVertexColors;
     // Read the mesh information
     auto MeshInfo = CoDAssets::GameInstance->Read<BOCWXModelMeshInfo>(ModelLOD.LODStreamInfoPtr);
 
@@ -1494,11 +1433,11 @@ std::string GameBlackOpsCW::LoadStringEntry(uint64_t Index)
     auto StringHash = CoDAssets::GameInstance->Read<uint64_t>(Offset + 16) & 0xFFFFFFFFFFFFFFF;
 
     // Attempt to locate string
-    auto StringEntry = StringCache.NameDatabase.find(StringHash);
+    std::string StringEntry;
 
     // Not Encrypted
-    if (StringEntry != StringCache.NameDatabase.end())
-        return StringEntry->second;
+    if (StringCache.TryGetName(StringHash, StringEntry))
+        return StringEntry;
     else
         return Strings::Format("xstring_%llx", StringHash);
 }
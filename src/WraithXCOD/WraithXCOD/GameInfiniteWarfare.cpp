@@ -759,12 +759,12 @@ std::unique_ptr<XImageDDS> GameInfiniteWarfare::LoadXImage(const XImage_t& Image
         auto Result = CoDRawImageTranslator::TranslateBC(ImageData, ResultSize, LargestWidth, LargestHeight, ImageInfo.ImageFormat, 1, (ImageInfo.MapType == (uint8_t)GfxImageMapType::MAPTYPE_CUBE));
 
         // Check for, and apply patch if required, if we got a raw result
-        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && (SettingsManager::GetSetting("patchnormals", "true") == "true"))
+        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && CoDAssets::GetExportSettings()->PatchNormals)
         {
             // Set normal map patch
             Result->ImagePatchType = ImagePatch::Normal_COD_NOG;
         }
-        else if (Result != nullptr && Image.ImageUsage == ImageUsageType::DiffuseMap && (SettingsManager::GetSetting("patchcolor", "true") == "true"))
+        else if (Result != nullptr && Image.ImageUsage == ImageUsageType::DiffuseMap && CoDAssets::GetExportSettings()->PatchColor)
         {
             // Set color patch
             Result->ImagePatchType = ImagePatch::Color_StripAlpha;
@@ -847,12 +847,12 @@ std::unique_ptr<XImageDDS> GameInfiniteWarfare::LoadXImagePS(const XImage_t& Ima
             (ImageInfo.MapType == (uint8_t)GfxImageMapType::MAPTYPE_CUBE));
 
         // Check for, and apply patch if required, if we got a raw result
-        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && (SettingsManager::GetSetting("patchnormals", "true") == "true"))
+        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && CoDAssets::GetExportSettings()->PatchNormals)
         {
             // Set normal map patch
             Result->ImagePatchType = ImagePatch::Normal_COD_NOG;
         }
-        else if (Result != nullptr && Image.ImageUsage == ImageUsageType::DiffuseMap && (SettingsManager::GetSetting("patchcolor", "true") == "true"))
+        else if (Result != nullptr && Image.ImageUsage == ImageUsageType::DiffuseMap && CoDAssets::GetExportSettings()->PatchColor)
         {
             // Set color patch
             Result->ImagePatchType = ImagePatch::Color_StripAlpha;
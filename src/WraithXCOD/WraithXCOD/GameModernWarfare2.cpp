@@ -527,7 +527,7 @@ std::unique_ptr<XImageDDS> GameModernWarfare2::LoadXImage(const XImage_t& Image)
     // Prepare to load an image, we only support IWD images from the image cache
     uint32_t ResultSize = 0;
     // Attempt to load it
-    auto ImageData = CoDAssets::GamePackageCache->ExtractPackageObject(CoDAssets::GamePackageCache->HashPackageID(Image.ImageName), ResultSize);
+    auto ImageData = CoDAssets::GamePackageCache->ExtractPackageObjectCached(CoDAssets::GamePackageCache->HashPackageID(Image.ImageName), ResultSize);
 
     // Check
     if (ImageData != nullptr)
@@ -536,7 +536,7 @@ std::unique_ptr<XImageDDS> GameModernWarfare2::LoadXImage(const XImage_t& Image)
         auto Result = CoDIWITranslator::TranslateIWI(ImageData, ResultSize);
 
         // Check for, and apply patch if required, if we got an IWI result
-        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && (SettingsManager::GetSetting("patchnormals", "true") == "true"))
+        if (Result != nullptr && Image.ImageUsage == ImageUsageType::NormalMap && CoDAssets::GetExportSettings()->PatchNormals)
         {
             // Set normal map patch
             Result->ImagePatchType = ImagePatch::Normal_Bumpmap;
@@ -588,13 +588,13 @@ std::unique_ptr<XImageDDS> GameModernWarfare4::ReadXImage(const CoDImage_t* Imag
     return LoadXImage(XImage_t(ImageUsageType::DiffuseMap, 0, Image->AssetPointer, Image->AssetName));
 }
 
-void GameModernWarfare4::TranslateRawfile(const CoDRawFile_t * Rawfile, const std::string & ExportPath)
+void GameModernWarfare4::TranslateRawfile(const CoDRawFile_t * Rawfile, const std::string & ExportPath, const CoDExportSettings& Settings)
 {
     // Build the export path
     std::string ExportFolder = ExportPath;
 
     // Check to preserve the paths
-    if (SettingsManager::GetSetting("keeprawpath", "true") == "true")
+    if (Settings.KeepRawfilePath)
     {
         // Apply the base path
         ExportFolder = FileSystems::CombinePath(ExportFolder, Rawfile->RawFilePath);
@@ -818,7 +818,7 @@ std::unique_ptr<XImageDDS> GameModernWarfare4::LoadXImage(const XImage_t& Image)
         if (HighestIndex != Fallback)
         {
             // First see if it's in the users local cache on their PC
-            ImageData = CoDAssets::OnDemandCache->ExtractPackageObject(ImageInfo.Mips.Levels[HighestIndex].HashID, ImageInfo.Mips.GetImageSize(HighestIndex), ResultSize);
+            ImageData = CoDAssets::OnDemandCache->ExtractPackageObjectCached(ImageInfo.Mips.Levels[HighestIndex].HashID, ImageInfo.Mips.GetImageSize(HighestIndex), ResultSize);
 
             // No dice, time for the CDN
             if (ImageData == nullptr && CoDAssets::CDNDownloader != nullptr)
@@ -832,7 +832,7 @@ std::unique_ptr<XImageDDS> GameModernWarfare4::LoadXImage(const XImage_t& Image)
         // Now that we've gotten here, we can make the assumption for whatever reason, we cannot access a CDN version of this image.
         if (ImageData == nullptr)
         {
-            ImageData = CoDAssets::GamePackageCache->ExtractPackageObject(ImageInfo.Mips.Levels[Fallback].HashID, ImageInfo.Mips.GetImageSize(Fallback), ResultSize);
+            ImageData = CoDAssets::GamePackageCache->ExtractPackageObjectCached(ImageInfo.Mips.Levels[Fallback].HashID, ImageInfo.Mips.GetImageSize(Fallback), ResultSize);
             HighestIndex = Fallback;
         }
 
@@ -947,12 +947,12 @@ Vector3 UnpackNormalQuat(uint32_t packedQuat)
     }
 }
 
-void GameModernWarfare4::LoadXModel(const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel)
+void GameModernWarfare4::LoadXModel(const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel, const CoDExportSettings& Settings)
 {
     // Scale to use
     auto ScaleConstant = (1.0f / 0x1FFFFF) * 2.0f;
     // Check if we want Vertex Colors
-    bool ExportColors = (SettingsManager::GetSetting("exportvtxcolor", "true") == "true");
+    bool ExportColors = Settings.ExportVertexColors;
     // Read the mesh information
     auto MeshInfo = CoDAssets::GameInstance->Read<MW4XModelMesh>(ModelLOD.LODStreamInfoPtr);
     // Read Buffer Info
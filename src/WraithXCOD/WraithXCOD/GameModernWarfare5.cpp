@@ -21,6 +21,7 @@
 #include "Sound.h"
 
 #include "CoDXModelBonesHelper.h"
+#include "CoDXModelMeshHelper.h"
 
 #include "SABSupport.h"
 
@@ -105,209 +106,278 @@ bool GameModernWarfare5::LoadAssets()
     // bool NeedsRawFiles  = (SettingsManager::GetSetting("showxrawfiles", "false") == "true");
     bool NeedsMaterials = (SettingsManager::GetSetting("showxmtl", "false") == "true");
 
+    // The pools to load, each is loaded in parallel with the others
+    std::vector<CoDAssetPoolLoader> Pools;
+
     if (NeedsModels)
     {
-        auto RemoveMdlBasename = SettingsManager::GetSetting("remove_mdl_basename", "false") == "true";
-        auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 9 * sizeof(ps::XAssetPool64));
-        ps::PoolParser64(Pool.Root, CoDAssets::ParasyteRequest, [&RemoveMdlBasename](ps::XAsset64& Asset)
+        Pools.emplace_back("models", [](AssetList& List)
         {
-            // Read
-            auto ModelResult = CoDAssets::GameInstance->Read<MW5XModel>(Asset.Header);
+            auto RemoveMdlBasename = SettingsManager::GetSetting("remove_mdl_basename", "false") == "true";
+            auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 9 * sizeof(ps::XAssetPool64));
+            ps::PoolParserBatched64<MW5XModel>(Pool.Root, CoDAssets::ParasyteBlockRequest, [&List, &RemoveMdlBasename](std::vector<ps::XAsset64>& Assets, std::vector<MW5XModel>& Models)
+            {
+                // Read the names of the batch together
+                std::vector<uint64_t> NamePtrs;
+                std::vector<std::string> Names;
 
-            std::string ModelName;
+                for (auto& Header : Models)
+                    NamePtrs.push_back(Header.NamePtr);
 
-            // Check if the asset actually has a name.
-            if (ModelResult.NamePtr > 0)
-            {
-                ModelName = CoDAssets::GameInstance->ReadNullTerminatedString(ModelResult.NamePtr);
+                ps::ReadStrings64(NamePtrs, CoDAssets::ParasyteBlockRequest, Names);
 
-                if (RemoveMdlBasename)
+                for (size_t i = 0; i < Assets.size(); i++)
                 {
-                    const size_t DoubleColonPos = ModelName.find("::");
-                    if (DoubleColonPos != std::string::npos)
+                    auto& Asset = Assets[i];
+                    auto& ModelResult = Models[i];
+
+                    std::string ModelName;
+
+                    // Check if the asset actually has a name.
+                    if (ModelResult.NamePtr > 0)
                     {
-                        ModelName = ModelName.substr(0, DoubleColonPos);
+                        ModelName = Names[i];
+
+                        if (RemoveMdlBasename)
+                        {
+                            const size_t DoubleColonPos = ModelName.find("::");
+                            if (DoubleColonPos != std::string::npos)
+                            {
+                                ModelName = ModelName.substr(0, DoubleColonPos);
+                            }
+                        }
+                        else
+                        {
+                            ModelName = Strings::Replace(ModelName, "::", "_");
+                        }
+
+                        ModelName = FileSystems::GetFileName(ModelName);
+                    }
+                    else
+                    {
+                        ModelName = CoDAssets::GetHashedName("xmodel", ModelResult.Hash);
                     }
-                }
-                else
-                {
-                    ModelName = Strings::Replace(ModelName, "::", "_");
-                }
-
-                ModelName = FileSystems::GetFileName(ModelName);
-            }
-            else
-            {
-                ModelName = CoDAssets::GetHashedName("xmodel", ModelResult.Hash);
-            }
 
-            // Make and add
-            auto LoadedModel = new CoDModel_t();
-            // Set
-            LoadedModel->AssetName = ModelName;
-            LoadedModel->AssetPointer = Asset.Header;
-            // Bone counts (check counts, since there's some weird models that we don't want, they have thousands of bones with no info)
-            if ((ModelResult.NumBones + ModelResult.UnkBoneCount) > 1 && ModelResult.ParentListPtr == 0)
-                LoadedModel->BoneCount = 0;
-            else
-                LoadedModel->BoneCount = ModelResult.NumBones + ModelResult.UnkBoneCount;
-            LoadedModel->LodCount = ModelResult.NumLods;
-            LoadedModel->AssetStatus = Asset.Temp == 1 ? WraithAssetStatus::Placeholder : WraithAssetStatus::Loaded;
-            // Log it
-            CoDAssets::LogXAsset("Model", ModelName);
-            // Add
-            CoDAssets::GameAssets->LoadedAssets.push_back(LoadedModel);
+                    // Make and add
+                    auto LoadedModel = List.Create<CoDModel_t>();
+                    // Set
+                    LoadedModel->AssetName = ModelName;
+                    LoadedModel->AssetPointer = Asset.Header;
+                    // Bone counts (check counts, since there's some weird models that we don't want, they have thousands of bones with no info)
+                    if ((ModelResult.NumBones + ModelResult.UnkBoneCount) > 1 && ModelResult.ParentListPtr == 0)
+                        LoadedModel->BoneCount = 0;
+                    else
+                        LoadedModel->BoneCount = ModelResult.NumBones + ModelResult.UnkBoneCount;
+                    LoadedModel->LodCount = ModelResult.NumLods;
+                    LoadedModel->AssetStatus = Asset.Temp == 1 ? WraithAssetStatus::Placeholder : WraithAssetStatus::Loaded;
+                    // Log it
+                    CoDAssets::LogXAsset("Model", ModelName);
+                    // Add
+                    List.LoadedAssets.push_back(LoadedModel);
+                }
+            });
         });
     }
 
     if (NeedsImages)
     {
-        auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 19 * sizeof(ps::XAssetPool64));
-        ps::PoolParser64(Pool.Root, CoDAssets::ParasyteRequest, [](ps::XAsset64& Asset)
+        Pools.emplace_back("images", [](AssetList& List)
         {
-            // Read
-            auto ImageResult = CoDAssets::GameInstance->Read<MW5GfxImage>(Asset.Header);
-            // Mask the name as hashes are 60Bit (Actually 63Bit but maintain with our existing tables)
-            ImageResult.Hash &= 0xFFFFFFFFFFFFFFF;
-            // Validate and load if need be
-            auto ImageName = CoDAssets::GetHashedName("ximage", ImageResult.Hash);
-            // Log it
-            CoDAssets::LogXAsset("Image", ImageName);
-            // Make and add
-            auto LoadedImage = new CoDImage_t();
-            // Set
-            LoadedImage->AssetName = ImageName;
-            LoadedImage->AssetPointer = Asset.Header;
-            LoadedImage->Width = (uint16_t)ImageResult.Width;
-            LoadedImage->Height = (uint16_t)ImageResult.Height;
-            LoadedImage->Format = ImageResult.ImageFormat;
-            LoadedImage->AssetStatus = WraithAssetStatus::Loaded;
-            LoadedImage->Streamed = ImageResult.LoadedImagePtr == 0;
-            // Add
-            CoDAssets::GameAssets->LoadedAssets.push_back(LoadedImage);
+            auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 19 * sizeof(ps::XAssetPool64));
+            ps::PoolParserBatched64<MW5GfxImage>(Pool.Root, CoDAssets::ParasyteBlockRequest, [&List](std::vector<ps::XAsset64>& Assets, std::vector<MW5GfxImage>& Images)
+            {
+                for (size_t i = 0; i < Assets.size(); i++)
+                {
+                    auto& Asset = Assets[i];
+                    auto& ImageResult = Images[i];
+                    // Mask the name as hashes are 60Bit (Actually 63Bit but maintain with our existing tables)
+                    ImageResult.Hash &= 0xFFFFFFFFFFFFFFF;
+                    // Validate and load if need be
+                    auto ImageName = CoDAssets::GetHashedName("ximage", ImageResult.Hash);
+                    // Log it
+                    CoDAssets::LogXAsset("Image", ImageName);
+                    // Make and add
+                    auto LoadedImage = List.Create<CoDImage_t>();
+                    // Set
+                    LoadedImage->AssetName = ImageName;
+                    LoadedImage->AssetPointer = Asset.Header;
+                    LoadedImage->Width = (uint16_t)ImageResult.Width;
+                    LoadedImage->Height = (uint16_t)ImageResult.Height;
+                    LoadedImage->Format = ImageResult.ImageFormat;
+                    LoadedImage->AssetStatus = WraithAssetStatus::Loaded;
+                    LoadedImage->Streamed = ImageResult.LoadedImagePtr == 0;
+                    // Add
+                    List.LoadedAssets.push_back(LoadedImage);
+                }
+            });
         });
     }
 
     if (NeedsAnims)
     {
-        auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 7 * sizeof(ps::XAssetPool64));
-        ps::PoolParser64(Pool.Root, CoDAssets::ParasyteRequest, [](ps::XAsset64& Asset)
+        Pools.emplace_back("anims", [](AssetList& List)
         {
-            // Read
-            auto AnimResult = CoDAssets::GameInstance->Read<MW5XAnim>(Asset.Header);
-            // Validate and load if need be
-            auto AnimName = CoDAssets::GameInstance->ReadNullTerminatedString(AnimResult.NamePtr);
-
-            // Log it
-            CoDAssets::LogXAsset("Anim", AnimName);
-
-            // Make and add
-            auto LoadedAnim = new CoDAnim_t();
-            // Set
-            LoadedAnim->AssetName = AnimName;
-            LoadedAnim->AssetPointer = Asset.Header;
-            LoadedAnim->Framerate = AnimResult.Framerate;
-            LoadedAnim->FrameCount = AnimResult.FrameCount;
-            LoadedAnim->AssetStatus = Asset.Temp == 1 ? WraithAssetStatus::Placeholder : WraithAssetStatus::Loaded;
-            LoadedAnim->BoneCount = AnimResult.TotalBoneCount;
-            // Add
-            CoDAssets::GameAssets->LoadedAssets.push_back(LoadedAnim);
+            auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 7 * sizeof(ps::XAssetPool64));
+            ps::PoolParserBatched64<MW5XAnim>(Pool.Root, CoDAssets::ParasyteBlockRequest, [&List](std::vector<ps::XAsset64>& Assets, std::vector<MW5XAnim>& Anims)
+            {
+                // Read the names of the batch together
+                std::vector<uint64_t> NamePtrs;
+                std::vector<std::string> Names;
+
+                for (auto& Header : Anims)
+                    NamePtrs.push_back(Header.NamePtr);
+
+                ps::ReadStrings64(NamePtrs, CoDAssets::ParasyteBlockRequest, Names);
+
+                for (size_t i = 0; i < Assets.size(); i++)
+                {
+                    auto& Asset = Assets[i];
+                    auto& AnimResult = Anims[i];
+                    // Validate and load if need be
+                    auto AnimName = Names[i];
+
+                    // Log it
+                    CoDAssets::LogXAsset("Anim", AnimName);
+
+                    // Make and add
+                    auto LoadedAnim = List.Create<CoDAnim_t>();
+                    // Set
+                    LoadedAnim->AssetName = AnimName;
+                    LoadedAnim->AssetPointer = Asset.Header;
+                    LoadedAnim->Framerate = AnimResult.Framerate;
+                    LoadedAnim->FrameCount = AnimResult.FrameCount;
+                    LoadedAnim->AssetStatus = Asset.Temp == 1 ? WraithAssetStatus::Placeholder : WraithAssetStatus::Loaded;
+                    LoadedAnim->BoneCount = AnimResult.TotalBoneCount;
+                    // Add
+                    List.LoadedAssets.push_back(LoadedAnim);
+                }
+            });
         });
     }
 
     if (NeedsMaterials)
     {
-        auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 11 * sizeof(ps::XAssetPool64));
-        ps::PoolParser64(Pool.Root, CoDAssets::ParasyteRequest, [](ps::XAsset64& Asset)
+        Pools.emplace_back("materials", [](AssetList& List)
         {
+            auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 11 * sizeof(ps::XAssetPool64));
             // Check for SP Files
             if (CoDAssets::GameFlags == SupportedGameFlags::SP)
             {
-                // Read
-                auto MatResult = CoDAssets::GameInstance->Read<MW5XMaterialSP>(Asset.Header);
-
-                std::string MaterialName;
-
-                // Validate and load if need be
-                if (MatResult.NamePtr > 0)
-                    MaterialName = Strings::Replace(CoDAssets::GameInstance->ReadNullTerminatedString(MatResult.NamePtr), "*", "");
-                else
-                    MaterialName = CoDAssets::GetHashedName("xmaterial", MatResult.Hash);
-
-                // Log it
-                CoDAssets::LogXAsset("Material", MaterialName);
-
-                // Make and add
-                auto LoadedMaterial = new CoDMaterial_t();
-                // Set
-                LoadedMaterial->AssetName = FileSystems::GetFileName(MaterialName);
-                LoadedMaterial->AssetPointer = Asset.Header;
-                LoadedMaterial->ImageCount = MatResult.ImageCount;
-                LoadedMaterial->AssetStatus = WraithAssetStatus::Loaded;
-
-                // Add
-                CoDAssets::GameAssets->LoadedAssets.push_back(LoadedMaterial);
+                ps::PoolParserBatched64<MW5XMaterialSP>(Pool.Root, CoDAssets::ParasyteBlockRequest, [&List](std::vector<ps::XAsset64>& Assets, std::vector<MW5XMaterialSP>& Materials)
+                {
+                    // Read the names of the batch together
+                    std::vector<uint64_t> NamePtrs;
+                    std::vector<std::string> Names;
+
+                    for (auto& Header : Materials)
+                        NamePtrs.push_back(Header.NamePtr);
+
+                    ps::ReadStrings64(NamePtrs, CoDAssets::ParasyteBlockRequest, Names);
+
+                    for (size_t i = 0; i < Assets.size(); i++)
+                    {
+                        auto& Asset = Assets[i];
+                        auto& MatResult = Materials[i];
+
+                        std::string MaterialName;
+
+                        // Validate and load if need be
+                        if (MatResult.NamePtr > 0)
+                            MaterialName = Strings::Replace(Names[i], "*", "");
+                        else
+                            MaterialName = CoDAssets::GetHashedName("xmaterial", MatResult.Hash);
+
+                        // Log it
+                        CoDAssets::LogXAsset("Material", MaterialName);
+
+                        // Make and add
+                        auto LoadedMaterial = List.Create<CoDMaterial_t>();
+                        // Set
+                        LoadedMaterial->AssetName = FileSystems::GetFileName(MaterialName);
+                        LoadedMaterial->AssetPointer = Asset.Header;
+                        LoadedMaterial->ImageCount = MatResult.ImageCount;
+                        LoadedMaterial->AssetStatus = WraithAssetStatus::Loaded;
+
+                        // Add
+                        List.LoadedAssets.push_back(LoadedMaterial);
+                    }
+                });
             }
             else
             {
-                // Read
-                auto MatResult = CoDAssets::GameInstance->Read<MW5XMaterial>(Asset.Header);
+                ps::PoolParserBatched64<MW5XMaterial>(Pool.Root, CoDAssets::ParasyteBlockRequest, [&List](std::vector<ps::XAsset64>& Assets, std::vector<MW5XMaterial>& Materials)
+                {
+                    for (size_t i = 0; i < Assets.size(); i++)
+                    {
+                        auto& Asset = Assets[i];
+                        auto& MatResult = Materials[i];
 
-                // Validate and load if need be
-                auto MaterialName = CoDAssets::GetHashedName("xmaterial", MatResult.Hash);
+                        // Validate and load if need be
+                        auto MaterialName = CoDAssets::GetHashedName("xmaterial", MatResult.Hash);
 
-                // Log it
-                CoDAssets::LogXAsset("Material", MaterialName);
+                        // Log it
+                        CoDAssets::LogXAsset("Material", MaterialName);
 
-                // Make and add
-                auto LoadedMaterial = new CoDMaterial_t();
-                // Set
-                LoadedMaterial->AssetName = FileSystems::GetFileName(MaterialName);
-                LoadedMaterial->AssetPointer = Asset.Header;
-                LoadedMaterial->ImageCount = MatResult.ImageCount;
-                LoadedMaterial->AssetStatus = WraithAssetStatus::Loaded;
+                        // Make and add
+                        auto LoadedMaterial = List.Create<CoDMaterial_t>();
+                        // Set
+                        LoadedMaterial->AssetName = FileSystems::GetFileName(MaterialName);
+                        LoadedMaterial->AssetPointer = Asset.Header;
+                        LoadedMaterial->ImageCount = MatResult.ImageCount;
+                        LoadedMaterial->AssetStatus = WraithAssetStatus::Loaded;
 
-                // Add
-                CoDAssets::GameAssets->LoadedAssets.push_back(LoadedMaterial);
+                        // Add
+                        List.LoadedAssets.push_back(LoadedMaterial);
+                    }
+                });
             }
         });
     }
 
     if (NeedsSounds)
     {
-        auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 197 * sizeof(ps::XAssetPool64));
-        ps::PoolParser64(Pool.Root, CoDAssets::ParasyteRequest, [](ps::XAsset64& Asset)
+        Pools.emplace_back("sounds", [](AssetList& List)
         {
-            // Read
-            auto SoundResult = CoDAssets::GameInstance->Read<MW5SndAsset>(Asset.Header);
-            // Mask the name as hashes are 60Bit (Actually 63Bit but maintain with our existing tables)
-            SoundResult.Name &= 0xFFFFFFFFFFFFFFF;
-            // Validate and load if need be
-            auto SoundName = CoDAssets::GetHashedName("xsound", SoundResult.Name);
-
-            // Log it
-            CoDAssets::LogXAsset("Sound", SoundName);
-
-            // Make and add
-            auto LoadedSound = new CoDSound_t();
-            // Set the name, but remove all extensions first
-            LoadedSound->AssetName = FileSystems::GetFileNamePurgeExtensions(SoundName);
-            LoadedSound->FullPath = FileSystems::GetDirectoryName(SoundName);
-            LoadedSound->AssetPointer = Asset.Header;
-            LoadedSound->AssetStatus = WraithAssetStatus::Loaded;
-            // Set various properties
-            LoadedSound->FrameRate = SoundResult.FrameRate;
-            LoadedSound->FrameCount = SoundResult.FrameCount;
-            LoadedSound->ChannelsCount = SoundResult.ChannelCount;
-            LoadedSound->AssetSize = -1;
-            LoadedSound->AssetStatus = WraithAssetStatus::Loaded;
-            LoadedSound->IsFileEntry = false;
-            LoadedSound->Length = (uint32_t)(1000.0f * (float)(LoadedSound->FrameCount / (float)(LoadedSound->FrameRate)));
-            // Add
-            CoDAssets::GameAssets->LoadedAssets.push_back(LoadedSound);
+            auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 197 * sizeof(ps::XAssetPool64));
+            ps::PoolParserBatched64<MW5SndAsset>(Pool.Root, CoDAssets::ParasyteBlockRequest, [&List](std::vector<ps::XAsset64>& Assets, std::vector<MW5SndAsset>& Sounds)
+            {
+                for (size_t i = 0; i < Assets.size(); i++)
+                {
+                    auto& Asset = Assets[i];
+                    auto& SoundResult = Sounds[i];
+                    // Mask the name as hashes are 60Bit (Actually 63Bit but maintain with our existing tables)
+                    SoundResult.Name &= 0xFFFFFFFFFFFFFFF;
+                    // Validate and load if need be
+                    auto SoundName = CoDAssets::GetHashedName("xsound", SoundResult.Name);
+
+                    // Log it
+                    CoDAssets::LogXAsset("Sound", SoundName);
+
+                    // Make and add
+                    auto LoadedSound = List.Create<CoDSound_t>();
+                    // Set the name, but remove all extensions first
+                    LoadedSound->AssetName = FileSystems::GetFileNamePurgeExtensions(SoundName);
+                    LoadedSound->FullPath = FileSystems::GetDirectoryName(SoundName);
+                    LoadedSound->AssetPointer = Asset.Header;
+                    LoadedSound->AssetStatus = WraithAssetStatus::Loaded;
+                    // Set various properties
+                    LoadedSound->FrameRate = SoundResult.FrameRate;
+                    LoadedSound->FrameCount = SoundResult.FrameCount;
+                    LoadedSound->ChannelsCount = SoundResult.ChannelCount;
+                    LoadedSound->AssetSize = -1;
+                    LoadedSound->AssetStatus = WraithAssetStatus::Loaded;
+                    LoadedSound->IsFileEntry = false;
+                    LoadedSound->Length = (uint32_t)(1000.0f * (float)(LoadedSound->FrameCount / (float)(LoadedSound->FrameRate)));
+                    // Add
+                    List.LoadedAssets.push_back(LoadedSound);
+                }
+            });
         });
     }
 
+    // Load them all
+    CoDAssets::LoadAssetPools(Pools);
+
     // Success, error only on specific load
     return true;
 }
@@ -785,7 +855,7 @@ std::unique_ptr<XSound> GameModernWarfare5::ReadXSound(const CoDSound_t* Sound)
         if (SoundBuffer == nullptr)
             return nullptr;
 
-        return SABSupport::DecodeOpusInterleaved(SoundBuffer.get() + SoundData.SeekTableSize, (size_t)SoundMemoryResult - SoundData.SeekTableSize, 0, SoundData.FrameRate, SoundData.ChannelCount, SoundData.FrameCount);
+        return SABSupport::LoadOpusInterleaved(std::move(SoundBuffer), (size_t)SoundMemoryResult - SoundData.SeekTableSize, SoundData.SeekTableSize, SoundData.FrameRate, SoundData.ChannelCount, SoundData.FrameCount);
     }
     else
     {
@@ -801,18 +871,18 @@ std::unique_ptr<XSound> GameModernWarfare5::ReadXSound(const CoDSound_t* Sound)
         if (SoundBuffer == nullptr)
             return nullptr;
 
-        return SABSupport::DecodeOpusInterleaved(SoundBuffer.get() + 32 + SoundData.SeekTableSize, (size_t)SoundMemoryResult - 32 - SoundData.SeekTableSize, 0, SoundData.FrameRate, SoundData.ChannelCount, SoundData.FrameCount);
+        return SABSupport::LoadOpusInterleaved(std::move(SoundBuffer), (size_t)SoundMemoryResult - 32 - SoundData.SeekTableSize, 32 + (size_t)SoundData.SeekTableSize, SoundData.FrameRate, SoundData.ChannelCount, SoundData.FrameCount);
     }
 
 }
 
-void GameModernWarfare5::TranslateRawfile(const CoDRawFile_t * Rawfile, const std::string & ExportPath)
+void GameModernWarfare5::TranslateRawfile(const CoDRawFile_t * Rawfile, const std::string & ExportPath, const CoDExportSettings& Settings)
 {
     // Build the export path
     std::string ExportFolder = ExportPath;
 
     // Check to preserve the paths
-    if (SettingsManager::GetSetting("keeprawpath", "true") == "true")
+    if (Settings.KeepRawfilePath)
     {
         // Apply the base path
         ExportFolder = FileSystems::CombinePath(ExportFolder, Rawfile->RawFilePath);
@@ -1050,7 +1120,7 @@ std::unique_ptr<XImageDDS> GameModernWarfare5::LoadXImage(const XImage_t& Image)
         if (Fallback != HighestIndex && CoDAssets::OnDemandCache != nullptr)
         {
             uint32_t PackageSize = 0;
-            ImageData = CoDAssets::OnDemandCache->ExtractPackageObject(Mips.MipMaps[HighestIndex].HashID, Mips.GetImageSize(HighestIndex), PackageSize);
+            ImageData = CoDAssets::OnDemandCache->ExtractPackageObjectCached(Mips.MipMaps[HighestIndex].HashID, Mips.GetImageSize(HighestIndex), PackageSize);
             ImageSize = PackageSize;
         }
 
@@ -1065,7 +1135,7 @@ std::unique_ptr<XImageDDS> GameModernWarfare5::LoadXImage(const XImage_t& Image)
         if (ImageData == nullptr)
         {
             uint32_t PackageSize = 0;
-            ImageData = CoDAssets::GamePackageCache->ExtractPackageObject(Mips.MipMaps[Fallback].HashID, Mips.GetImageSize(Fallback), PackageSize);
+            ImageData = CoDAssets::GamePackageCache->ExtractPackageObjectCached(Mips.MipMaps[Fallback].HashID, Mips.GetImageSize(Fallback), PackageSize);
             ImageSize = PackageSize;
             HighestIndex = Fallback;
         }
@@ -1090,12 +1160,10 @@ std::unique_ptr<XImageDDS> GameModernWarfare5::LoadXImage(const XImage_t& Image)
     return nullptr;
 }
 
-void GameModernWarfare5::LoadXModel(const std::unique_ptr<XModel_t>& Model, const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel)
+void GameModernWarfare5::LoadXModel(const std::unique_ptr<XModel_t>& Model, const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel, const CoDExportSettings& Settings)
 {
-    // Scale to use
-    auto ScaleConstant = (1.0f / 0x1FFFFF) * 2.0f;
     // Check if we want Vertex Colors
-    bool ExportColors = (SettingsManager::GetSetting("exportvtxcolor", "true") == "true");
+    bool ExportColors = Settings.ExportVertexColors;
     // Read the mesh information
     auto MeshInfo = CoDAssets::GameInstance->Read<MW5XModelMesh>(ModelLOD.LODStreamInfoPtr);
 
@@ -1157,9 +1225,7 @@ void GameModernWarfare5::LoadXModel(const std::unique_ptr<XModel_t>& Model, cons
         ResultModel->PrepareSubmeshes((uint32_t)ModelLOD.Submeshes.size());
 
         // Readers for all data types, global so that we can use them when streaming...
-        MemoryReader VertexPosReader;
         MemoryReader VertexNormReader;
-        MemoryReader VertexUVReader;
         MemoryReader VertexColorReader;
         MemoryReader VertexWeightReader;
         MemoryReader SimpleWeightReader;
@@ -1181,9 +1247,7 @@ void GameModernWarfare5::LoadXModel(const std::unique_ptr<XModel_t>& Model, cons
             auto VertexWeights = std::vector<WeightsData>(Submesh.VertexCount);
 
             // Vertex Readers
-            VertexPosReader.Setup((int8_t*)MeshDataBuffer.get() + Submesh.VertexPtr, Submesh.VertexCount * sizeof(uint64_t), true);
             VertexNormReader.Setup((int8_t*)MeshDataBuffer.get() + Submesh.VertexNormalsPtr, Submesh.VertexCount * sizeof(uint32_t), true);
-            VertexUVReader.Setup((int8_t*)MeshDataBuffer.get() + Submesh.VertexUVsPtr, Submesh.VertexCount * sizeof(uint32_t), true);
             FaceIndiciesReader.Setup((int8_t*)MeshDataBuffer.get() + Submesh.FacesPtr, Submesh.FaceCount * sizeof(uint16_t) * 3, true);
 
             // Calculate Weights Size
@@ -1205,20 +1269,20 @@ void GameModernWarfare5::LoadXModel(const std::unique_ptr<XModel_t>& Model, cons
                 PrepareVertexWeights(VertexWeightReader, VertexWeights, Submesh);
             }
 
+            // Unpack the positions and uvs of the submesh in one go
+            auto Positions = std::vector<Vector3>(Submesh.VertexCount);
+            auto UVs = std::vector<float>((size_t)Submesh.VertexCount * 2);
+            CoDXModelMeshHelper::Unpack21BitVertices((const uint64_t*)(MeshDataBuffer.get() + Submesh.VertexPtr), Submesh.VertexCount, Submesh.Scale, { Submesh.XOffset, Submesh.YOffset, Submesh.ZOffset }, Positions.data());
+            HalfFloats::ToFloats((const uint16_t*)(MeshDataBuffer.get() + Submesh.VertexUVsPtr), UVs.size(), UVs.data());
+
             // Iterate over verticies
             for (uint32_t i = 0; i < Submesh.VertexCount; i++)
             {
                 // Make a new vertex
                 auto& Vertex = Mesh.AddVertex();
 
-                // Read Vertex
-                auto VertexPosition = VertexPosReader.Read<uint64_t>();
-
-                // Read and assign position
-                Vertex.Position = Vector3(
-                    (((((VertexPosition >> 00) & 0x1FFFFF) * ScaleConstant) - 1.0f) * Submesh.Scale) + Submesh.XOffset,
-                    (((((VertexPosition >> 21) & 0x1FFFFF) * ScaleConstant) - 1.0f) * Submesh.Scale) + Submesh.YOffset,
-                    (((((VertexPosition >> 42) & 0x1FFFFF) * ScaleConstant) - 1.0f) * Submesh.Scale) + Submesh.ZOffset);
+                // Assign position
+                Vertex.Position = Positions[i];
 
                 // Read Tangent/Normal
                 auto QTangent = VertexNormReader.Read<CoDQTangent>();
@@ -1226,12 +1290,8 @@ void GameModernWarfare5::LoadXModel(const std::unique_ptr<XModel_t>& Model, cons
                 // Add normal
                 Vertex.Normal = QTangent.Unpack(nullptr, nullptr);
 
-                // Read and set UVs
-                auto UVU = HalfFloats::ToFloat(VertexUVReader.Read<uint16_t>());
-                auto UVV = HalfFloats::ToFloat(VertexUVReader.Read<uint16_t>());
-
-                // Set it
-                Vertex.AddUVLayer(UVU, UVV);
+                // Set UVs
+                Vertex.AddUVLayer(UVs[i * 2], UVs[i * 2 + 1]);
 
                 // Apply Color (some models don't store colors, so we need to check ptr below)
                 Vertex.Color[0] = 255;
@@ -1350,6 +1410,9 @@ void GameModernWarfare5::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
     // uint32_t FrameSize = (Anim->FrameCount > 255) ? 2 : 1;
     // uint32_t BoneTypeSize = (Anim->TotalBoneCount > 255) ? 2 : 1;
 
+    // Every bone will likely be keyed, so size the bone table once
+    ResultAnim->ReserveBones((uint32_t)Anim->Reader->BoneNames.size());
+
     size_t currentBoneIndex = 0;
     size_t currentSize = Anim->NoneRotatedBoneCount;
     bool byteFrames = Anim->FrameCount < 0x100;
@@ -1373,6 +1436,10 @@ void GameModernWarfare5::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
         if (tableSize >= 0x40 && !byteFrames)
             dataShort += (tableSize - 1 >> 8) + 2;
 
+        // Resolve the bone once and size its keys
+        auto animBoneIndex = ResultAnim->AddBone(Anim->Reader->BoneNames[currentBoneIndex]);
+        ResultAnim->ReserveRotationKeys(animBoneIndex, tableSize + 1);
+
         for (int i = 0; i < tableSize + 1; i++)
         {
             uint32_t frame = 0;
@@ -1393,7 +1460,7 @@ void GameModernWarfare5::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
             float RZ = (float)randomDataShort[0] * 0.000030518509f;
             float RW = (float)randomDataShort[1] * 0.000030518509f;
 
-            ResultAnim->AddRotationKey(Anim->Reader->BoneNames[currentBoneIndex], frame, 0, 0, RZ, RW);
+            ResultAnim->AddRotationKey(animBoneIndex, frame, 0, 0, RZ, RW);
         }
 
         XAnimIncrementBuffers(&state, tableSize + 1, 2, randomDataShorts);
@@ -1410,6 +1477,10 @@ void GameModernWarfare5::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
         if (tableSize >= 0x40 && !byteFrames)
             dataShort += (tableSize - 1 >> 8) + 2;
 
+        // Resolve the bone once and size its keys
+        auto animBoneIndex = ResultAnim->AddBone(Anim->Reader->BoneNames[currentBoneIndex]);
+        ResultAnim->ReserveRotationKeys(animBoneIndex, tableSize + 1);
+
         for (int i = 0; i < tableSize + 1; i++)
         {
             uint32_t frame = 0;
@@ -1432,7 +1503,7 @@ void GameModernWarfare5::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
             float RZ = (float)randomDataShort[2] * 0.000030518509f;
             float RW = (float)randomDataShort[3] * 0.000030518509f;
 
-            ResultAnim->AddRotationKey(Anim->Reader->BoneNames[currentBoneIndex], frame, RX, RY, RZ, RW);
+            ResultAnim->AddRotationKey(animBoneIndex, frame, RX, RY, RZ, RW);
         }
 
         XAnimIncrementBuffers(&state, tableSize + 1, 4, randomDataShorts);
@@ -1483,6 +1554,10 @@ void GameModernWarfare5::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
         float frameVecY = *(float*)dataInt++;
         float frameVecZ = *(float*)dataInt++;
 
+        // Resolve the bone once and size its keys
+        auto animBoneIndex = ResultAnim->AddBone(Anim->Reader->BoneNames[boneIndex]);
+        ResultAnim->ReserveTranslationKeys(animBoneIndex, tableSize + 1);
+
         for (int i = 0; i < tableSize + 1; i++)
         {
             int frame = 0;
@@ -1505,7 +1580,7 @@ void GameModernWarfare5::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
             float TranslationY = (frameVecY * (float)randomDataByte[1]) + minsVecY;
             float TranslationZ = (frameVecZ * (float)randomDataByte[2]) + minsVecZ;
             // Add
-            ResultAnim->AddTranslationKey(Anim->Reader->BoneNames[boneIndex], frame, TranslationX, TranslationY, TranslationZ);
+            ResultAnim->AddTranslationKey(animBoneIndex, frame, TranslationX, TranslationY, TranslationZ);
         }
 
         XAnimIncrementBuffers(&state, tableSize + 1, 3, randomDataBytes);
@@ -1529,6 +1604,10 @@ void GameModernWarfare5::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
         float frameVecY = *(float*)dataInt++;
         float frameVecZ = *(float*)dataInt++;
 
+        // Resolve the bone once and size its keys
+        auto animBoneIndex = ResultAnim->AddBone(Anim->Reader->BoneNames[boneIndex]);
+        ResultAnim->ReserveTranslationKeys(animBoneIndex, tableSize + 1);
+
         for (int i = 0; i < tableSize + 1; i++)
         {
             int frame = 0;
@@ -1551,7 +1630,7 @@ void GameModernWarfare5::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
             float TranslationY = (frameVecY * (float)(uint16_t)randomDataShort[1]) + minsVecY;
             float TranslationZ = (frameVecZ * (float)(uint16_t)randomDataShort[2]) + minsVecZ;
             // Add
-            ResultAnim->AddTranslationKey(Anim->Reader->BoneNames[boneIndex], frame, TranslationX, TranslationY, TranslationZ);
+            ResultAnim->AddTranslationKey(animBoneIndex, frame, TranslationX, TranslationY, TranslationZ);
         }
 
         XAnimIncrementBuffers(&state, tableSize + 1, 3, randomDataShorts);
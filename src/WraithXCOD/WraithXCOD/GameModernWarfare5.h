@@ -40,12 +40,12 @@ public:
     // Reads an XMaterial from it's logical offset in memory
     static const XMaterial_t ReadXMaterial(uint64_t MaterialPointer);
     // Reads a XImage from Modern Warfare 5
-    static void TranslateRawfile(const CoDRawFile_t* Rawfile, const std::string& ExportPath);
+    static void TranslateRawfile(const CoDRawFile_t* Rawfile, const std::string& ExportPath, const CoDExportSettings& Settings);
 
     // Reads an XImageDDS from a image reference from Modern Warfare 5
     static std::unique_ptr<XImageDDS> LoadXImage(const XImage_t& Image);
     // Loads a streamed XModel lod, streaming from cache if need be.
-    static void LoadXModel(const std::unique_ptr<XModel_t>& Model, const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel);
+    static void LoadXModel(const std::unique_ptr<XModel_t>& Model, const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel, const CoDExportSettings& Settings);
     // Loads a streamed XAnim, streaming from cache if need be.
     static void LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::unique_ptr<WraithAnim>& ResultAnim);
 
@@ -105,177 +105,222 @@ bool GameModernWarfare6::LoadAssets()
     // bool NeedsRawFiles  = (SettingsManager::GetSetting("showxrawfiles", "false") == "true");
     bool NeedsMaterials = (SettingsManager::GetSetting("showxmtl", "false") == "true");
 
+    // The pools to load, each is loaded in parallel with the others
+    std::vector<CoDAssetPoolLoader> Pools;
+
     if (NeedsModels)
     {
-        auto RemoveMdlBasename = SettingsManager::GetSetting("remove_mdl_basename", "false") == "true";
-        auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 9 * sizeof(ps::XAssetPool64));
-        ps::PoolParser64(Pool.Root, CoDAssets::ParasyteRequest, [&RemoveMdlBasename](ps::XAsset64& Asset)
+        Pools.emplace_back("models", [](AssetList& List)
         {
-            // Read
-            auto ModelResult = CoDAssets::GameInstance->Read<MW6XModel>(Asset.Header);
+            auto RemoveMdlBasename = SettingsManager::GetSetting("remove_mdl_basename", "false") == "true";
+            auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 9 * sizeof(ps::XAssetPool64));
+            ps::PoolParserBatched64<MW6XModel>(Pool.Root, CoDAssets::ParasyteBlockRequest, [&List, &RemoveMdlBasename](std::vector<ps::XAsset64>& Assets, std::vector<MW6XModel>& Models)
+            {
+                // Read the names of the batch together
+                std::vector<uint64_t> NamePtrs;
+                std::vector<std::string> Names;
 
-            std::string ModelName;
+                for (auto& Header : Models)
+                    NamePtrs.push_back(Header.NamePtr);
 
-            // Check if the asset actually has a name.
-            if (ModelResult.NamePtr > 0)
-            {
-                ModelName = CoDAssets::GameInstance->ReadNullTerminatedString(ModelResult.NamePtr);
+                ps::ReadStrings64(NamePtrs, CoDAssets::ParasyteBlockRequest, Names);
 
-                if (RemoveMdlBasename)
+                for (size_t i = 0; i < Assets.size(); i++)
                 {
-                    const size_t DoubleColonPos = ModelName.find("::");
-                    if (DoubleColonPos != std::string::npos)
+                    auto& Asset = Assets[i];
+                    auto& ModelResult = Models[i];
+
+                    std::string ModelName;
+
+                    // Check if the asset actually has a name.
+                    if (ModelResult.NamePtr > 0)
                     {
-                        ModelName = ModelName.substr(0, DoubleColonPos);
+                        ModelName = Names[i];
+
+                        if (RemoveMdlBasename)
+                        {
+                            const size_t DoubleColonPos = ModelName.find("::");
+                            if (DoubleColonPos != std::string::npos)
+                            {
+                                ModelName = ModelName.substr(0, DoubleColonPos);
+                            }
+                        }
+                        else
+                        {
+                            ModelName = Strings::Replace(ModelName, "::", "_");
+                        }
+
+                        ModelName = FileSystems::GetFileName(ModelName);
+                    }
+                    else
+                    {
+                        ModelName = CoDAssets::GetHashedName("xmodel", ModelResult.Hash);
                     }
-                }
-                else
-                {
-                    ModelName = Strings::Replace(ModelName, "::", "_");
-                }
-
-                ModelName = FileSystems::GetFileName(ModelName);
-            }
-            else
-            {
-                ModelName = CoDAssets::GetHashedName("xmodel", ModelResult.Hash);
-            }
 
-            // Make and add
-            auto LoadedModel = new CoDModel_t();
-            // Set
-            LoadedModel->AssetName = ModelName;
-            LoadedModel->AssetPointer = Asset.Header;
-            // Bone counts (check counts, since there's some weird models that we don't want, they have thousands of bones with no info)
-            if ((ModelResult.NumBones + ModelResult.UnkBoneCount) > 1 && ModelResult.ParentListPtr == 0)
-                LoadedModel->BoneCount = 0;
-            else
-                LoadedModel->BoneCount = ModelResult.NumBones + ModelResult.UnkBoneCount;
-            LoadedModel->LodCount = ModelResult.NumLods;
-            LoadedModel->AssetStatus = Asset.Temp == 1 ? WraithAssetStatus::Placeholder : WraithAssetStatus::Loaded;
-            // Log it
-            CoDAssets::LogXAsset("Model", ModelName);
-            // Add
-            CoDAssets::GameAssets->LoadedAssets.push_back(LoadedModel);
+                    // Make and add
+                    auto LoadedModel = List.Create<CoDModel_t>();
+                    // Set
+                    LoadedModel->AssetName = ModelName;
+                    LoadedModel->AssetPointer = Asset.Header;
+                    // Bone counts (check counts, since there's some weird models that we don't want, they have thousands of bones with no info)
+                    if ((ModelResult.NumBones + ModelResult.UnkBoneCount) > 1 && ModelResult.ParentListPtr == 0)
+                        LoadedModel->BoneCount = 0;
+                    else
+                        LoadedModel->BoneCount = ModelResult.NumBones + ModelResult.UnkBoneCount;
+                    LoadedModel->LodCount = ModelResult.NumLods;
+                    LoadedModel->AssetStatus = Asset.Temp == 1 ? WraithAssetStatus::Placeholder : WraithAssetStatus::Loaded;
+                    // Log it
+                    CoDAssets::LogXAsset("Model", ModelName);
+                    // Add
+                    List.LoadedAssets.push_back(LoadedModel);
+                }
+            });
         });
     }
 
     if (NeedsImages)
     {
-        auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 21 * sizeof(ps::XAssetPool64));
-        ps::PoolParser64(Pool.Root, CoDAssets::ParasyteRequest, [](ps::XAsset64& Asset)
+        Pools.emplace_back("images", [](AssetList& List)
         {
-            // Read
-            auto ImageResult = CoDAssets::GameInstance->Read<MW6GfxImage>(Asset.Header);
-            // Mask the name as hashes are 60Bit (Actually 63Bit but maintain with our existing tables)
-            ImageResult.Hash &= 0xFFFFFFFFFFFFFFF;
-            // Validate and load if need be
-            auto ImageName = CoDAssets::GetHashedName("ximage", ImageResult.Hash);
-            // Log it
-            CoDAssets::LogXAsset("Image", ImageName);
-            // Make and add
-            auto LoadedImage = new CoDImage_t();
-            // Set
-            LoadedImage->AssetName = ImageName;
-            LoadedImage->AssetPointer = Asset.Header;
-            LoadedImage->Width = ImageResult.Width;
-            LoadedImage->Height = ImageResult.Height;
-            LoadedImage->Format = ImageResult.ImageFormat;
-            LoadedImage->AssetStatus = WraithAssetStatus::Loaded;
-            LoadedImage->Streamed = ImageResult.LoadedImagePtr == 0;
-            // Add
-            CoDAssets::GameAssets->LoadedAssets.push_back(LoadedImage);
+            auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 21 * sizeof(ps::XAssetPool64));
+            ps::PoolParserBatched64<MW6GfxImage>(Pool.Root, CoDAssets::ParasyteBlockRequest, [&List](std::vector<ps::XAsset64>& Assets, std::vector<MW6GfxImage>& Images)
+            {
+                for (size_t i = 0; i < Assets.size(); i++)
+                {
+                    auto& Asset = Assets[i];
+                    auto& ImageResult = Images[i];
+                    // Mask the name as hashes are 60Bit (Actually 63Bit but maintain with our existing tables)
+                    ImageResult.Hash &= 0xFFFFFFFFFFFFFFF;
+                    // Validate and load if need be
+                    auto ImageName = CoDAssets::GetHashedName("ximage", ImageResult.Hash);
+                    // Log it
+                    CoDAssets::LogXAsset("Image", ImageName);
+                    // Make and add
+                    auto LoadedImage = List.Create<CoDImage_t>();
+                    // Set
+                    LoadedImage->AssetName = ImageName;
+                    LoadedImage->AssetPointer = Asset.Header;
+                    LoadedImage->Width = ImageResult.Width;
+                    LoadedImage->Height = ImageResult.Height;
+                    LoadedImage->Format = ImageResult.ImageFormat;
+                    LoadedImage->AssetStatus = WraithAssetStatus::Loaded;
+                    LoadedImage->Streamed = ImageResult.LoadedImagePtr == 0;
+                    // Add
+                    List.LoadedAssets.push_back(LoadedImage);
+                }
+            });
         });
     }
 
     if (NeedsAnims)
     {
-        auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 7 * sizeof(ps::XAssetPool64));
-        ps::PoolParser64(Pool.Root, CoDAssets::ParasyteRequest, [](ps::XAsset64& Asset)
+        Pools.emplace_back("anims", [](AssetList& List)
         {
-            // Read
-            auto AnimResult = CoDAssets::GameInstance->Read<MW6XAnim>(Asset.Header);
-            // Validate and load if need be
-            auto AnimName = CoDAssets::GetHashedName("xanim", AnimResult.Hash);
-
-            // Log it
-            CoDAssets::LogXAsset("Anim", AnimName);
-
-            // Make and add
-            auto LoadedAnim = new CoDAnim_t();
-            // Set
-            LoadedAnim->AssetName = AnimName;
-            LoadedAnim->AssetPointer = Asset.Header;
-            LoadedAnim->Framerate = AnimResult.Framerate;
-            LoadedAnim->FrameCount = AnimResult.FrameCount;
-            LoadedAnim->AssetStatus = Asset.Temp == 1 ? WraithAssetStatus::Placeholder : WraithAssetStatus::Loaded;
-            LoadedAnim->BoneCount = AnimResult.TotalBoneCount;
-            // Add
-            CoDAssets::GameAssets->LoadedAssets.push_back(LoadedAnim);
+            auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 7 * sizeof(ps::XAssetPool64));
+            ps::PoolParserBatched64<MW6XAnim>(Pool.Root, CoDAssets::ParasyteBlockRequest, [&List](std::vector<ps::XAsset64>& Assets, std::vector<MW6XAnim>& Anims)
+            {
+                for (size_t i = 0; i < Assets.size(); i++)
+                {
+                    auto& Asset = Assets[i];
+                    auto& AnimResult = Anims[i];
+                    // Validate and load if need be
+                    auto AnimName = CoDAssets::GetHashedName("xanim", AnimResult.Hash);
+
+                    // Log it
+                    CoDAssets::LogXAsset("Anim", AnimName);
+
+                    // Make and add
+                    auto LoadedAnim = List.Create<CoDAnim_t>();
+                    // Set
+                    LoadedAnim->AssetName = AnimName;
+                    LoadedAnim->AssetPointer = Asset.Header;
+                    LoadedAnim->Framerate = AnimResult.Framerate;
+                    LoadedAnim->FrameCount = AnimResult.FrameCount;
+                    LoadedAnim->AssetStatus = Asset.Temp == 1 ? WraithAssetStatus::Placeholder : WraithAssetStatus::Loaded;
+                    LoadedAnim->BoneCount = AnimResult.TotalBoneCount;
+                    // Add
+                    List.LoadedAssets.push_back(LoadedAnim);
+                }
+            });
         });
     }
 
     if (NeedsMaterials)
     {
-        auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 11 * sizeof(ps::XAssetPool64));
-        ps::PoolParser64(Pool.Root, CoDAssets::ParasyteRequest, [](ps::XAsset64& Asset)
+        Pools.emplace_back("materials", [](AssetList& List)
         {
-            // Read
-            auto MatResult = CoDAssets::GameInstance->Read<MW6XMaterial>(Asset.Header);
-            // Validate and load if need be
-            auto MaterialName = CoDAssets::GetHashedName("xmaterial", MatResult.Hash);
-
-            // Log it
-            CoDAssets::LogXAsset("Material", MaterialName);
-
-            // Make and add
-            auto LoadedMaterial = new CoDMaterial_t();
-            // Set
-            LoadedMaterial->AssetName = FileSystems::GetFileName(MaterialName);
-            LoadedMaterial->AssetPointer = Asset.Header;
-            LoadedMaterial->ImageCount = MatResult.ImageCount;
-            LoadedMaterial->AssetStatus = WraithAssetStatus::Loaded;
-
-            // Add
-            CoDAssets::GameAssets->LoadedAssets.push_back(LoadedMaterial);
+            auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 11 * sizeof(ps::XAssetPool64));
+            ps::PoolParserBatched64<MW6XMaterial>(Pool.Root, CoDAssets::ParasyteBlockRequest, [&List](std::vector<ps::XAsset64>& Assets, std::vector<MW6XMaterial>& Materials)
+            {
+                for (size_t i = 0; i < Assets.size(); i++)
+                {
+                    auto& Asset = Assets[i];
+                    auto& MatResult = Materials[i];
+                    // Validate and load if need be
+                    auto MaterialName = CoDAssets::GetHashedName("xmaterial", MatResult.Hash);
+
+                    // Log it
+                    CoDAssets::LogXAsset("Material", MaterialName);
+
+                    // Make and add
+                    auto LoadedMaterial = List.Create<CoDMaterial_t>();
+                    // Set
+                    LoadedMaterial->AssetName = FileSystems::GetFileName(MaterialName);
+                    LoadedMaterial->AssetPointer = Asset.Header;
+                    LoadedMaterial->ImageCount = MatResult.ImageCount;
+                    LoadedMaterial->AssetStatus = WraithAssetStatus::Loaded;
+
+                    // Add
+                    List.LoadedAssets.push_back(LoadedMaterial);
+                }
+            });
         });
     }
 
     if (NeedsSounds)
     {
-        auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 0xc1 * sizeof(ps::XAssetPool64));
-        ps::PoolParser64(Pool.Root, CoDAssets::ParasyteRequest, [](ps::XAsset64& Asset)
+        Pools.emplace_back("sounds", [](AssetList& List)
         {
-            // Read
-            auto SoundResult = CoDAssets::GameInstance->Read<MW6SndAsset>(Asset.Header);
-            // Mask the name as hashes are 60Bit (Actually 63Bit but maintain with our existing tables)
-            SoundResult.Name &= 0xFFFFFFFFFFFFFFF;
-            // Validate and load if need be
-            auto SoundName = CoDAssets::GetHashedName("xsound", SoundResult.Name);
-
-            // Log it
-            CoDAssets::LogXAsset("Sound", SoundName);
-
-            // Make and add
-            auto LoadedSound = new CoDSound_t();
-            // Set the name, but remove all extensions first
-            LoadedSound->AssetName = FileSystems::GetFileNamePurgeExtensions(SoundName);
-            LoadedSound->FullPath = FileSystems::GetDirectoryName(SoundName);
-            LoadedSound->AssetPointer = Asset.Header;
-            LoadedSound->AssetStatus = WraithAssetStatus::Loaded;
-            // Set various properties
-            LoadedSound->FrameRate = SoundResult.FrameRate;
-            LoadedSound->FrameCount = SoundResult.FrameCount;
-            LoadedSound->ChannelsCount = SoundResult.ChannelCount;
-            LoadedSound->AssetSize = -1;
-            LoadedSound->AssetStatus = WraithAssetStatus::Loaded;
-            LoadedSound->IsFileEntry = false;
-            LoadedSound->Length = (uint32_t)(1000.0f * (float)(LoadedSound->FrameCount / (float)(LoadedSound->FrameRate)));
-            // Add
-            CoDAssets::GameAssets->LoadedAssets.push_back(LoadedSound);
+            auto Pool = CoDAssets::GameInstance->Read<ps::XAssetPool64>(ps::state->PoolsAddress + 0xc1 * sizeof(ps::XAssetPool64));
+            ps::PoolParserBatched64<MW6SndAsset>(Pool.Root, CoDAssets::ParasyteBlockRequest, [&List](std::vector<ps::XAsset64>& Assets, std::vector<MW6SndAsset>& Sounds)
+            {
+                for (size_t i = 0; i < Assets.size(); i++)
+                {
+                    auto& Asset = Assets[i];
+                    auto& SoundResult = Sounds[i];
+                    // Mask the name as hashes are 60Bit (Actually 63Bit but maintain with our existing tables)
+                    SoundResult.Name &= 0xFFFFFFFFFFFFFFF;
+                    // Validate and load if need be
+                    auto SoundName = CoDAssets::GetHashedName("xsound", SoundResult.Name);
+
+                    // Log it
+                    CoDAssets::LogXAsset("Sound", SoundName);
+
+                    // Make and add
+                    auto LoadedSound = List.Create<CoDSound_t>();
+                    // Set the name, but remove all extensions first
+                    LoadedSound->AssetName = FileSystems::GetFileNamePurgeExtensions(SoundName);
+                    LoadedSound->FullPath = FileSystems::GetDirectoryName(SoundName);
+                    LoadedSound->AssetPointer = Asset.Header;
+                    LoadedSound->AssetStatus = WraithAssetStatus::Loaded;
+                    // Set various properties
+                    LoadedSound->FrameRate = SoundResult.FrameRate;
+                    LoadedSound->FrameCount = SoundResult.FrameCount;
+                    LoadedSound->ChannelsCount = SoundResult.ChannelCount;
+                    LoadedSound->AssetSize = -1;
+                    LoadedSound->AssetStatus = WraithAssetStatus::Loaded;
+                    LoadedSound->IsFileEntry = false;
+                    LoadedSound->Length = (uint32_t)(1000.0f * (float)(LoadedSound->FrameCount / (float)(LoadedSound->FrameRate)));
+                    // Add
+                    List.LoadedAssets.push_back(LoadedSound);
+                }
+            });
         });
     }
 
+    // Load them all
+    CoDAssets::LoadAssetPools(Pools);
+
     // Success, error only on specific load
     return true;
 }
@@ -623,7 +668,7 @@ std::unique_ptr<XSound> GameModernWarfare6::ReadXSound(const CoDSound_t* Sound)
         if (SoundBuffer == nullptr)
             return nullptr;
 
-        return SABSupport::DecodeOpusInterleaved(SoundBuffer.get() + SoundData.SeekTableSize, (size_t)SoundMemoryResult - SoundData.SeekTableSize, 0, SoundData.FrameRate, SoundData.ChannelCount, SoundData.FrameCount);
+        return SABSupport::LoadOpusInterleaved(std::move(SoundBuffer), (size_t)SoundMemoryResult - SoundData.SeekTableSize, SoundData.SeekTableSize, SoundData.FrameRate, SoundData.ChannelCount, SoundData.FrameCount);
     }
     else
     {
@@ -639,18 +684,18 @@ std::unique_ptr<XSound> GameModernWarfare6::ReadXSound(const CoDSound_t* Sound)
         if (SoundBuffer == nullptr)
             return nullptr;
 
-        return SABSupport::DecodeOpusInterleaved(SoundBuffer.get() + 32 + SoundData.SeekTableSize, (size_t)SoundMemoryResult - 32 - SoundData.SeekTableSize, 0, SoundData.FrameRate, SoundData.ChannelCount, SoundData.FrameCount);
+        return SABSupport::LoadOpusInterleaved(std::move(SoundBuffer), (size_t)SoundMemoryResult - 32 - SoundData.SeekTableSize, 32 + (size_t)SoundData.SeekTableSize, SoundData.FrameRate, SoundData.ChannelCount, SoundData.FrameCount);
     }
 
 }
 
-void GameModernWarfare6::TranslateRawfile(const CoDRawFile_t * Rawfile, const std::string & ExportPath)
+void GameModernWarfare6::TranslateRawfile(const CoDRawFile_t * Rawfile, const std::string & ExportPath, const CoDExportSettings& Settings)
 {
     // Build the export path
     std::string ExportFolder = ExportPath;
 
     // Check to preserve the paths
-    if (SettingsManager::GetSetting("keeprawpath", "true") == "true")
+    if (Settings.KeepRawfilePath)
     {
         // Apply the base path
         ExportFolder = FileSystems::CombinePath(ExportFolder, Rawfile->RawFilePath);
@@ -861,7 +906,7 @@ std::unique_ptr<XImageDDS> GameModernWarfare6::LoadXImage(const XImage_t& Image)
         if (Fallback != HighestIndex && CoDAssets::OnDemandCache != nullptr)
         {
             uint32_t PackageSize = 0;
-            ImageData = CoDAssets::OnDemandCache->ExtractPackageObject(Mips.MipMaps[HighestIndex].HashID, Mips.GetImageSize(HighestIndex), PackageSize);
+            ImageData = CoDAssets::OnDemandCache->ExtractPackageObjectCached(Mips.MipMaps[HighestIndex].HashID, Mips.GetImageSize(HighestIndex), PackageSize);
             ImageSize = PackageSize;
         }
 
@@ -876,7 +921,7 @@ std::unique_ptr<XImageDDS> GameModernWarfare6::LoadXImage(const XImage_t& Image)
         if (ImageData == nullptr)
         {
             uint32_t PackageSize = 0;
-            ImageData = CoDAssets::GamePackageCache->ExtractPackageObject(Mips.MipMaps[Fallback].HashID, Mips.GetImageSize(Fallback), PackageSize);
+            ImageData = CoDAssets::GamePackageCache->ExtractPackageObjectCached(Mips.MipMaps[Fallback].HashID, Mips.GetImageSize(Fallback), PackageSize);
             ImageSize = PackageSize;
             HighestIndex = Fallback;
         }
@@ -901,12 +946,12 @@ std::unique_ptr<XImageDDS> GameModernWarfare6::LoadXImage(const XImage_t& Image)
     return nullptr;
 }
 
-void GameModernWarfare6::LoadXModel(const std::unique_ptr<XModel_t>& Model, const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel)
+void GameModernWarfare6::LoadXModel(const std::unique_ptr<XModel_t>& Model, const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel, const CoDExportSettings& Settings)
 {
     // Scale to use
     // auto ScaleConstant = (1.0f / 0x1FFFFF) * 2.0f;
     // Check if we want Vertex Colors
-    bool ExportColors = (SettingsManager::GetSetting("exportvtxcolor", "true") == "true");
+    bool ExportColors = Settings.ExportVertexColors;
     // Read the mesh information
     auto MeshInfo = CoDAssets::GameInstance->Read<MW6XModelMesh>(ModelLOD.LODStreamInfoPtr);
 
@@ -968,9 +1013,7 @@ void GameModernWarfare6::LoadXModel(const std::unique_ptr<XModel_t>& Model, cons
         ResultModel->PrepareSubmeshes((uint32_t)ModelLOD.Submeshes.size());
 
         // Readers for all data types, global so that we can use them when streaming...
-        MemoryReader VertexPosReader;
         MemoryReader VertexNormReader;
-        MemoryReader VertexUVReader;
         MemoryReader VertexColorReader;
         MemoryReader VertexWeightReader;
         MemoryReader SimpleWeightReader;
@@ -992,9 +1035,7 @@ void GameModernWarfare6::LoadXModel(const std::unique_ptr<XModel_t>& Model, cons
             auto VertexWeights = std::vector<WeightsData>(Submesh.VertexCount);
 
             // Vertex Readers
-            VertexPosReader.Setup((int8_t*)MeshDataBuffer.get() + Submesh.VertexPtr, Submesh.VertexCount * sizeof(uint64_t), true);
             VertexNormReader.Setup((int8_t*)MeshDataBuffer.get() + Submesh.VertexNormalsPtr, Submesh.VertexCount * sizeof(uint32_t), true);
-            VertexUVReader.Setup((int8_t*)MeshDataBuffer.get() + Submesh.VertexUVsPtr, Submesh.VertexCount * sizeof(uint32_t), true);
             FaceIndiciesReader.Setup((int8_t*)MeshDataBuffer.get() + Submesh.FacesPtr, Submesh.FaceCount * sizeof(uint16_t) * 3, true);
 
             // Calculate Weights Size
@@ -1016,22 +1057,24 @@ void GameModernWarfare6::LoadXModel(const std::unique_ptr<XModel_t>& Model, cons
                 PrepareVertexWeights(VertexWeightReader, VertexWeights, Submesh);
             }
 
+            // Unpack the positions and uvs of the submesh in one go
+            auto Positions = std::vector<Vector3>(Submesh.VertexCount);
+            auto UVs = std::vector<float>((size_t)Submesh.VertexCount * 2);
+            CoDXModelMeshHelper::Unpack21BitVertices((const uint64_t*)(MeshDataBuffer.get() + Submesh.VertexPtr), Submesh.VertexCount, Submesh.Scale, { Submesh.XOffset, Submesh.YOffset, Submesh.ZOffset }, Positions.data());
+            HalfFloats::ToFloats((const uint16_t*)(MeshDataBuffer.get() + Submesh.VertexUVsPtr), UVs.size(), UVs.data());
+
             // Iterate over verticies
             for (uint32_t i = 0; i < Submesh.VertexCount; i++)
             {
                 // Make a new vertex
                 auto& Vertex = Mesh.AddVertex();
 
-                // Read and assign position
-                Vertex.Position = CoDXModelMeshHelper::Unpack21BitVertex(VertexPosReader.Read<uint64_t>(), Submesh.Scale, { Submesh.XOffset, Submesh.YOffset, Submesh.ZOffset });
+                // Assign position
+                Vertex.Position = Positions[i];
                 Vertex.Normal = VertexNormReader.Read<CoDQTangent>().Unpack(nullptr, nullptr);
 
-                // Read and set UVs
-                auto UVU = HalfFloats::ToFloat(VertexUVReader.Read<uint16_t>());
-                auto UVV = HalfFloats::ToFloat(VertexUVReader.Read<uint16_t>());
-
-                // Set it
-                Vertex.AddUVLayer(UVU, UVV);
+                // Set UVs
+                Vertex.AddUVLayer(UVs[i * 2], UVs[i * 2 + 1]);
 
                 // Apply Color (some models don't store colors, so we need to check ptr below)
                 Vertex.Color[0] = 255;
@@ -1066,17 +1109,18 @@ void GameModernWarfare6::LoadXModel(const std::unique_ptr<XModel_t>& Model, cons
                 }
             }
 
-            uint32_t x[3]{};
             uint8_t* table = MeshDataBuffer.get() + Submesh.PackedIndexTablePtr;
             uint8_t* packed = MeshDataBuffer.get() + Submesh.PackedIndexBufferPtr;
             uint8_t* indices = MeshDataBuffer.get() + Submesh.FacesPtr;
 
-            for (uint16_t i = 0; i < Submesh.FaceCount; i++)
-            {
-                CoDXModelMeshHelper::UnpackFaceIndices(table, Submesh.PackedIndexTableCount, packed, (uint16_t*)indices, i, x);
+            // Unpack all faces in a single pass over the tables
+            auto Faces = std::vector<uint32_t>((size_t)Submesh.FaceCount * 3);
+            CoDXModelMeshHelper::UnpackFaceIndexBuffer(table, Submesh.PackedIndexTableCount, packed, (uint16_t*)indices, Submesh.FaceCount, Faces.data());
 
+            for (size_t i = 0; i < Faces.size(); i += 3)
+            {
                 // Add the face
-                Mesh.AddFace(x[0], x[1], x[2]);
+                Mesh.AddFace(Faces[i], Faces[i + 1], Faces[i + 2]);
             }
         }
     }
@@ -1153,6 +1197,9 @@ void GameModernWarfare6::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
     // uint32_t FrameSize = (Anim->FrameCount > 255) ? 2 : 1;
     // uint32_t BoneTypeSize = (Anim->TotalBoneCount > 255) ? 2 : 1;
 
+    // Every bone will likely be keyed, so size the bone table once
+    ResultAnim->ReserveBones((uint32_t)Anim->Reader->BoneNames.size());
+
     size_t currentBoneIndex = 0;
     size_t currentSize = Anim->NoneRotatedBoneCount;
     bool byteFrames = Anim->FrameCount < 0x100;
@@ -1176,6 +1223,10 @@ void GameModernWarfare6::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
         if (tableSize >= 0x40 && !byteFrames)
             dataShort += (tableSize - 1 >> 8) + 2;
 
+        // Resolve the bone once and size its keys
+        auto animBoneIndex = ResultAnim->AddBone(Anim->Reader->BoneNames[currentBoneIndex]);
+        ResultAnim->ReserveRotationKeys(animBoneIndex, tableSize + 1);
+
         for (int i = 0; i < tableSize + 1; i++)
         {
             uint32_t frame = 0;
@@ -1196,7 +1247,7 @@ void GameModernWarfare6::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
             float RZ = (float)randomDataShort[0] * 0.000030518509f;
             float RW = (float)randomDataShort[1] * 0.000030518509f;
 
-            ResultAnim->AddRotationKey(Anim->Reader->BoneNames[currentBoneIndex], frame, 0, 0, RZ, RW);
+            ResultAnim->AddRotationKey(animBoneIndex, frame, 0, 0, RZ, RW);
         }
 
         MW6XAnimIncrementBuffers(&state, tableSize + 1, 2, randomDataShorts);
@@ -1213,6 +1264,10 @@ void GameModernWarfare6::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
         if (tableSize >= 0x40 && !byteFrames)
             dataShort += (tableSize - 1 >> 8) + 2;
 
+        // Resolve the bone once and size its keys
+        auto animBoneIndex = ResultAnim->AddBone(Anim->Reader->BoneNames[currentBoneIndex]);
+        ResultAnim->ReserveRotationKeys(animBoneIndex, tableSize + 1);
+
         for (int i = 0; i < tableSize + 1; i++)
         {
             uint32_t frame = 0;
@@ -1235,7 +1290,7 @@ void GameModernWarfare6::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
             float RZ = (float)randomDataShort[2] * 0.000030518509f;
             float RW = (float)randomDataShort[3] * 0.000030518509f;
 
-            ResultAnim->AddRotationKey(Anim->Reader->BoneNames[currentBoneIndex], frame, RX, RY, RZ, RW);
+            ResultAnim->AddRotationKey(animBoneIndex, frame, RX, RY, RZ, RW);
         }
 
         MW6XAnimIncrementBuffers(&state, tableSize + 1, 4, randomDataShorts);
@@ -1286,6 +1341,10 @@ void GameModernWarfare6::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
         float frameVecY = *(float*)dataInt++;
         float frameVecZ = *(float*)dataInt++;
 
+        // Resolve the bone once and size its keys
+        auto animBoneIndex = ResultAnim->AddBone(Anim->Reader->BoneNames[boneIndex]);
+        ResultAnim->ReserveTranslationKeys(animBoneIndex, tableSize + 1);
+
         for (int i = 0; i < tableSize + 1; i++)
         {
             int frame = 0;
@@ -1308,7 +1367,7 @@ void GameModernWarfare6::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
             float TranslationY = (frameVecY * (float)randomDataByte[1]) + minsVecY;
             float TranslationZ = (frameVecZ * (float)randomDataByte[2]) + minsVecZ;
             // Add
-            ResultAnim->AddTranslationKey(Anim->Reader->BoneNames[boneIndex], frame, TranslationX, TranslationY, TranslationZ);
+            ResultAnim->AddTranslationKey(animBoneIndex, frame, TranslationX, TranslationY, TranslationZ);
         }
 
         MW6XAnimIncrementBuffers(&state, tableSize + 1, 3, randomDataBytes);
@@ -1332,6 +1391,10 @@ void GameModernWarfare6::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
         float frameVecY = *(float*)dataInt++;
         float frameVecZ = *(float*)dataInt++;
 
+        // Resolve the bone once and size its keys
+        auto animBoneIndex = ResultAnim->AddBone(Anim->Reader->BoneNames[boneIndex]);
+        ResultAnim->ReserveTranslationKeys(animBoneIndex, tableSize + 1);
+
         for (int i = 0; i < tableSize + 1; i++)
         {
             int frame = 0;
@@ -1354,7 +1417,7 @@ void GameModernWarfare6::LoadXAnim(const std::unique_ptr<XAnim_t>& Anim, std::un
             float TranslationY = (frameVecY * (float)(uint16_t)randomDataShort[1]) + minsVecY;
             float TranslationZ = (frameVecZ * (float)(uint16_t)randomDataShort[2]) + minsVecZ;
             // Add
-            ResultAnim->AddTranslationKey(Anim->Reader->BoneNames[boneIndex], frame, TranslationX, TranslationY, TranslationZ);
+            ResultAnim->AddTranslationKey(animBoneIndex, frame, TranslationX, TranslationY, TranslationZ);
         }
 
         MW6XAnimIncrementBuffers(&state, tableSize + 1, 3, randomDataShorts);
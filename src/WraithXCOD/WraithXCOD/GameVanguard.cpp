@@ -320,12 +320,12 @@ bool GameVanguard::LoadAssets()
                     LoadedSound->Length = (uint32_t)(1000.0f * (float)(LoadedSound->FrameCount / (float)(LoadedSound->FrameRate)));
                     LoadedSound->DataType = SoundDataTypes::Opus_Interleaved;
 
-                    auto NameResult = AssetNameCache.NameDatabase.find(Entry.Key);
+                    std::string NameResult;
 
-                    if (NameResult != AssetNameCache.NameDatabase.end())
+                    if (AssetNameCache.TryGetName(Entry.Key, NameResult))
                     {
-                        LoadedSound->AssetName = FileSystems::GetFileNamePurgeExtensions(NameResult->second);
-                        LoadedSound->FullPath = FileSystems::GetDirectoryName(NameResult->second);
+                        LoadedSound->AssetName = FileSystems::GetFileNamePurgeExtensions(NameResult);
+                        LoadedSound->FullPath = FileSystems::GetDirectoryName(NameResult);
                     }
                     else
                     {
@@ -371,12 +371,12 @@ bool GameVanguard::LoadAssets()
                     LoadedSound->Length = (uint32_t)(1000.0f * (float)(LoadedSound->FrameCount / (float)(LoadedSound->FrameRate)));
                     LoadedSound->DataType = SoundDataTypes::Opus_Interleaved_Streamed;
 
-                    auto NameResult = AssetNameCache.NameDatabase.find(Entry.Key);
+                    std::string NameResult;
 
-                    if (NameResult != AssetNameCache.NameDatabase.end())
+                    if (AssetNameCache.TryGetName(Entry.Key, NameResult))
                     {
-                        LoadedSound->AssetName = FileSystems::GetFileNamePurgeExtensions(NameResult->second);
-                        LoadedSound->FullPath = FileSystems::GetDirectoryName(NameResult->second);
+                        LoadedSound->AssetName = FileSystems::GetFileNamePurgeExtensions(NameResult);
+                        LoadedSound->FullPath = FileSystems::GetDirectoryName(NameResult);
                     }
                     else
                     {
@@ -719,19 +719,19 @@ std::unique_ptr<XSound> GameVanguard::ReadXSound(const CoDSound_t* Sound)
 
     if (SoundBuffer != nullptr)
     {
-        return SABSupport::DecodeOpusInterleaved(SoundBuffer.get(), Sound->AssetSize, OpusOffset, Sound->FrameRate, Sound->ChannelsCount, Sound->FrameCount);
+        return SABSupport::LoadOpusInterleaved(std::move(SoundBuffer), (size_t)Sound->AssetSize, OpusOffset, Sound->FrameRate, Sound->ChannelsCount, Sound->FrameCount);
     }
     
     return nullptr;
 }
 
-void GameVanguard::TranslateRawfile(const CoDRawFile_t * Rawfile, const std::string & ExportPath)
+void GameVanguard::TranslateRawfile(const CoDRawFile_t * Rawfile, const std::string & ExportPath, const CoDExportSettings& Settings)
 {
     // Build the export path
     std::string ExportFolder = ExportPath;
 
     // Check to preserve the paths
-    if (SettingsManager::GetSetting("keeprawpath", "true") == "true")
+    if (Settings.KeepRawfilePath)
     {
         // Apply the base path
         ExportFolder = FileSystems::CombinePath(ExportFolder, Rawfile->RawFilePath);
@@ -998,7 +998,7 @@ std::unique_ptr<XImageDDS> GameVanguard::LoadXImage(const XImage_t& Image)
     if (Fallback != HighestIndex && CoDAssets::OnDemandCache != nullptr)
     {
         uint32_t PackageSize = 0;
-        ImageData = CoDAssets::OnDemandCache->ExtractPackageObject(Mips.MipMaps[HighestIndex].HashID, Mips.GetImageSize(HighestIndex), PackageSize);
+        ImageData = CoDAssets::OnDemandCache->ExtractPackageObjectCached(Mips.MipMaps[HighestIndex].HashID, Mips.GetImageSize(HighestIndex), PackageSize);
         ImageSize = PackageSize;
     }
 
@@ -1013,7 +1013,7 @@ std::unique_ptr<XImageDDS> GameVanguard::LoadXImage(const XImage_t& Image)
     if (ImageData == nullptr)
     {
         uint32_t PackageSize = 0;
-        ImageData = CoDAssets::GamePackageCache->ExtractPackageObject(Mips.MipMaps[Fallback].HashID, Mips.GetImageSize(Fallback), PackageSize);
+        ImageData = CoDAssets::GamePackageCache->ExtractPackageObjectCached(Mips.MipMaps[Fallback].HashID, Mips.GetImageSize(Fallback), PackageSize);
         ImageSize = PackageSize;
         HighestIndex = Fallback;
     }
@@ -1107,12 +1107,12 @@ struct MeshBlendShapesData
     uint16_t UnkValue;
 };
 
-void GameVanguard::LoadXModel(const std::unique_ptr<XModel_t>& Model, const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel)
+void GameVanguard::LoadXModel(const std::unique_ptr<XModel_t>& Model, const XModelLod_t& ModelLOD, const std::unique_ptr<WraithModel>& ResultModel, const CoDExportSettings& Settings)
 {
     // Scale to use
     auto ScaleConstant = (1.0f / 0x1FFFFF) * 2.0f;
     // Check if we want Vertex Colors
-    bool ExportColors = (SettingsManager::GetSetting("exportvtxcolor", "true") == "true");
+    bool ExportColors = Settings.ExportVertexColors;
     // Read the mesh information
     auto MeshInfo = CoDAssets::GameInstance->Read<VGXModelMesh>(ModelLOD.LODStreamInfoPtr);
     // Read Buffer Info
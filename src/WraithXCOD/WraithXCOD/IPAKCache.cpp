@@ -80,6 +80,8 @@ bool IPAKCache::LoadPackage(const std::string& FilePath)
         {
             // Hop to the offset
             Reader.SetPosition(IPAKEntriesSegment.Offset);
+            // Make room up front
+            CacheObjects.Reserve(CacheObjects.Size() + IPAKEntriesSegment.EntryCount);
 
             // Loop and read entries
             for (uint32_t i = 0; i < IPAKEntriesSegment.EntryCount; i++)
@@ -96,7 +98,7 @@ bool IPAKCache::LoadPackage(const std::string& FilePath)
                 NewObject.PackageFileIndex = PackageIndex;
 
                 // Append to database
-                CacheObjects.insert(std::make_pair(Entry.Key, NewObject));
+                CacheObjects.Insert(Entry.Key, NewObject);
             }
         }
 
@@ -111,10 +113,11 @@ bool IPAKCache::LoadPackage(const std::string& FilePath)
 std::unique_ptr<uint8_t[]> IPAKCache::ExtractPackageObject(uint64_t CacheID, uint32_t& ResultSize)
 {
     // Prepare to extract if found
-    if (CacheObjects.find(CacheID) != CacheObjects.end())
+    PackageCacheObject CacheInfo;
+
+    if (FindCacheObject(CacheID, CacheInfo))
     {
         // Take cache data, and extract from the IPAK (Uncompressed size = offset of data segment!)
-        auto& CacheInfo = CacheObjects[CacheID];
         // Get the IPAK name
         auto& IPAKFileName = PackageFilePaths[CacheInfo.PackageFileIndex];
 
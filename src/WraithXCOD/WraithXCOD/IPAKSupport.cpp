@@ -62,12 +62,7 @@ bool IPAKSupport::ParseIPAK(const std::string& FilePath)
                 // The entry name
                 std::string AssetName = "";
                 // Attempt to find the name
-                if (IPAKNames.NameDatabase.find(Entry.Key) != IPAKNames.NameDatabase.end())
-                {
-                    // Set
-                    AssetName = IPAKNames.NameDatabase[Entry.Key];
-                }
-                else
+                if (!IPAKNames.TryGetName(Entry.Key, AssetName))
                 {
                     // Format from key
                     AssetName = Strings::Format("_%llx", Entry.Key);
@@ -104,7 +99,7 @@ std::unique_ptr<XImageDDS> IPAKSupport::ReadImageFile(const CoDImage_t* Image)
     // Resulting buffer
     uint32_t ResultSize = 0;
     // We have a streamed image, prepare to extract (AssetPointer = Image Key)
-    auto ImageData = CoDAssets::GamePackageCache->ExtractPackageObject(Image->AssetPointer, ResultSize);
+    auto ImageData = CoDAssets::GamePackageCache->ExtractPackageObjectCached(Image->AssetPointer, ResultSize);
 
     // Prepare if we have it
     if (ImageData != nullptr)
@@ -113,7 +108,7 @@ std::unique_ptr<XImageDDS> IPAKSupport::ReadImageFile(const CoDImage_t* Image)
         auto Result = CoDIWITranslator::TranslateIWI(ImageData, ResultSize);
 
         // Check for, and apply patch if required, if we got a raw result
-        if (Result != nullptr && (SettingsManager::GetSetting("patchnormals", "true") == "true"))
+        if (Result != nullptr && CoDAssets::GetExportSettings()->PatchNormals)
         {
             // We can check the name here for _n and _nml
             if (Strings::EndsWith(Image->AssetName, "_n") || Strings::EndsWith(Image->AssetName, "_nml") | Strings::EndsWith(Image->AssetName, "_n2") || Strings::EndsWith(Image->AssetName, "_n3"))
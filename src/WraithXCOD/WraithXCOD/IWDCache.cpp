@@ -94,7 +94,7 @@ bool IWDCache::LoadPackage(const std::string& FilePath)
                 NewObject.PackageFileIndex = PackageIndex;
 
                 // Append to database
-                CacheObjects.insert(std::make_pair(AssetEntryHash, NewObject));
+                CacheObjects.Insert(AssetEntryHash, NewObject);
             }
         }
     }
@@ -109,10 +109,11 @@ bool IWDCache::LoadPackage(const std::string& FilePath)
 std::unique_ptr<uint8_t[]> IWDCache::ExtractPackageObject(uint64_t CacheID, uint32_t& ResultSize)
 {
     // Prepare to extract if found
-    if (CacheObjects.find(CacheID) != CacheObjects.end())
+    PackageCacheObject CacheInfo;
+
+    if (FindCacheObject(CacheID, CacheInfo))
     {
         // Take cache data, and extract from the IWD
-        auto& CacheInfo = CacheObjects[CacheID];
         // Get the IWD name
         auto& IWDFileName = PackageFilePaths[CacheInfo.PackageFileIndex];
 
@@ -78,7 +78,7 @@ std::unique_ptr<XImageDDS> IWDSupport::ReadImageFile(const CoDImage_t* Image)
     // Resulting buffer
     uint32_t ResultSize = 0;
     // We have a streamed image, prepare to extract (Hash the name for the id)
-    auto ImageData = CoDAssets::GamePackageCache->ExtractPackageObject(CoDAssets::GamePackageCache->HashPackageID(Image->AssetName), ResultSize);
+    auto ImageData = CoDAssets::GamePackageCache->ExtractPackageObjectCached(CoDAssets::GamePackageCache->HashPackageID(Image->AssetName), ResultSize);
 
     // Prepare if we have it
     if (ImageData != nullptr)
@@ -87,7 +87,7 @@ std::unique_ptr<XImageDDS> IWDSupport::ReadImageFile(const CoDImage_t* Image)
         auto Result = CoDIWITranslator::TranslateIWI(ImageData, ResultSize);
 
         // Check for, and apply patch if required, if we got a raw result
-        if (Result != nullptr && (SettingsManager::GetSetting("patchnormals", "true") == "true"))
+        if (Result != nullptr && CoDAssets::GetExportSettings()->PatchNormals)
         {
             // We can check the name here for _n and _nml
             if (Strings::EndsWith(Image->AssetName, "_n") || Strings::EndsWith(Image->AssetName, "_nml") | Strings::EndsWith(Image->AssetName, "_n2") || Strings::EndsWith(Image->AssetName, "_n3"))
@@ -172,6 +172,7 @@ int APIENTRY WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
             { "usesabindexbo4", "false" },
             { "sortbydetails", "false" },
             { "createxassetlog", "false" },
+            { "recordsnapshot", "false" },
             { "exportmodelimg", "true" },
             { "exportalllods", "false" },
             { "exporthitbox", "false" },
@@ -213,7 +214,9 @@ int APIENTRY WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
             { "overwrite_gdt", "true" },
             { "cdn_downloader", "true" },
             { "match_game_lod_index", "false" },
-            { "remove_mdl_basename", "false" }
+            { "remove_mdl_basename", "false" },
+            { "exportthreads", "0" },
+            { "objectcachesize", "256" }
         });
 
 #ifndef _DEBUG
@@ -1,4 +1,5 @@
 #include "Parasyte.h"
+#include <cstring>
 
 // Current Context Information
 std::unique_ptr<ps::State> ps::state = nullptr;
@@ -98,3 +99,198 @@ void ps::PoolParser64(uint64_t offset, std::function<XAsset64(const uint64_t&)>
 	}
 }
 
+void ps::PoolParserBatched64(uint64_t offset, BlockRequest64 request, std::function<void(std::vector<XAsset64>&)> callback)
+{
+	// Entries are allocated together, so the blocks holding them are kept, as the chain may visit them in any order.
+	std::unordered_map<uint64_t, std::vector<uint8_t>> blocks;
+
+	std::vector<XAsset64> batch;
+	batch.reserve(PoolBatchSize);
+
+	for (auto next = offset; next != 0; )
+	{
+		auto blockAddress = next & ~(uint64_t)(PoolBlockSize - 1);
+		auto block = blocks.find(blockAddress);
+
+		if (block == blocks.end())
+		{
+			if (blocks.size() >= PoolMaxBlocks)
+				blocks.clear();
+
+			std::vector<uint8_t> data(PoolBlockSize);
+			data.resize(request(data.data(), blockAddress, PoolBlockSize));
+
+			block = blocks.emplace(blockAddress, std::move(data)).first;
+		}
+
+		XAsset64 p;
+
+		if (next + sizeof(XAsset64) <= blockAddress + block->second.size())
+		{
+			std::memcpy(&p, block->second.data() + (next - blockAddress), sizeof(p));
+		}
+		// The block may run into memory we can't read, so fall back to just this entry, a failed read ends the chain.
+		else if (request((uint8_t*)&p, next, sizeof(p)) != sizeof(p))
+		{
+			break;
+		}
+
+		if (p.Header != 0)
+		{
+			batch.push_back(p);
+
+			if (batch.size() >= PoolBatchSize)
+			{
+				callback(batch);
+				batch.clear();
+			}
+		}
+
+		next = p.Next;
+	}
+
+	if (batch.size() > 0)
+		callback(batch);
+}
+
+void ps::ReadHeaders64(const std::vector<XAsset64>& assets, size_t headerSize, uint8_t* headers, BlockRequest64 request)
+{
+	// Same as a failed read, anything we can't read is left zeroed.
+	std::memset(headers, 0, assets.size() * headerSize);
+
+	// Visit the headers in address order, so neighbours can be read together.
+	std::vector<size_t> order(assets.size());
+
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+
+	std::sort(order.begin(), order.end(), [&assets](const size_t a, const size_t b)
+	{
+		return assets[a].Header < assets[b].Header;
+	});
+
+	std::vector<uint8_t> arena(std::max(PoolBlockSize, headerSize));
+
+	for (size_t i = 0; i < order.size(); )
+	{
+		auto start = assets[order[i]].Header;
+		auto end = start + headerSize;
+		auto j = i + 1;
+
+		for (; j < order.size(); j++)
+		{
+			auto header = assets[order[j]].Header;
+
+			if (header > end + PoolGatherGap || header + headerSize - start > PoolBlockSize)
+				break;
+
+			end = std::max<uint64_t>(end, header + headerSize);
+		}
+
+		auto read = request(arena.data(), start, (size_t)(end - start));
+
+		for (auto k = i; k < j; k++)
+		{
+			auto index = order[k];
+			auto header = assets[index].Header;
+
+			if (header + headerSize <= start + read)
+				std::memcpy(headers + index * headerSize, arena.data() + (header - start), headerSize);
+			else
+				request(headers + index * headerSize, header, headerSize);
+		}
+
+		i = j;
+	}
+}
+
+void ps::ReadStrings64(const std::vector<uint64_t>& addresses, BlockRequest64 request, std::vector<std::string>& results)
+{
+	results.clear();
+	results.resize(addresses.size());
+
+	// Visit the strings in address order, names tend to be stored together.
+	std::vector<size_t> order;
+	order.reserve(addresses.size());
+
+	for (size_t i = 0; i < addresses.size(); i++)
+	{
+		if (addresses[i] != 0)
+			order.push_back(i);
+	}
+
+	std::sort(order.begin(), order.end(), [&addresses](const size_t a, const size_t b)
+	{
+		return addresses[a] < addresses[b];
+	});
+
+	std::vector<uint8_t> arena(PoolBlockSize);
+
+	for (size_t i = 0; i < order.size(); )
+	{
+		auto start = addresses[order[i]];
+		auto end = start + PoolStringSize;
+		auto j = i + 1;
+
+		for (; j < order.size(); j++)
+		{
+			auto address = addresses[order[j]];
+
+			if (address > end + PoolGatherGap || address + PoolStringSize - start > PoolBlockSize)
+				break;
+
+			end = std::max<uint64_t>(end, address + PoolStringSize);
+		}
+
+		auto read = request(arena.data(), start, (size_t)(end - start));
+
+		for (auto k = i; k < j; k++)
+		{
+			auto index = order[k];
+			auto address = addresses[index];
+			auto& result = results[index];
+
+			// Take what we can from the block.
+			if (address < start + read)
+			{
+				auto str = (const char*)arena.data() + (address - start);
+				auto available = (size_t)(start + read - address);
+				auto terminator = (const char*)std::memchr(str, 0, available);
+
+				if (terminator != nullptr)
+				{
+					result.assign(str, terminator);
+					continue;
+				}
+
+				result.assign(str, available);
+				address += available;
+			}
+
+			// The string runs past the block, read the rest in pieces.
+			char buffer[PoolStringSize];
+
+			while (true)
+			{
+				auto size = request((uint8_t*)buffer, address, sizeof(buffer));
+
+				if (size == 0)
+					break;
+
+				auto terminator = (const char*)std::memchr(buffer, 0, size);
+
+				if (terminator != nullptr)
+				{
+					result.append(buffer, (size_t)(terminator - buffer));
+					break;
+				}
+
+				result.append(buffer, size);
+				address += size;
+			}
+		}
+
+		i = j;
+	}
+}
+
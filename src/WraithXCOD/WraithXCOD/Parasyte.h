@@ -5,7 +5,9 @@
 #include <memory>
 #include <functional>
 #include <map>
+#include <unordered_map>
 #include <fstream>
+#include <algorithm>
 
 // Parasyte Helpers.
 namespace ps
@@ -64,10 +66,44 @@ namespace ps
         uint64_t AssetMemory;
     };
 
+    // Reads a block of memory into the buffer, returning the amount read.
+    typedef std::function<size_t(uint8_t*, uint64_t, size_t)> BlockRequest64;
+
+    // The most assets handed to a batch callback at once.
+    constexpr size_t PoolBatchSize = 4096;
+    // The size of the blocks nodes, headers, and strings are read in.
+    constexpr size_t PoolBlockSize = 0x10000;
+    // The most blocks of nodes kept while parsing a pool (16 MiB).
+    constexpr size_t PoolMaxBlocks = 256;
+    // The most bytes between two headers or strings before they're read separately.
+    constexpr size_t PoolGatherGap = 0x1000;
+    // The size we expect most strings to fit in.
+    constexpr size_t PoolStringSize = 256;
+
     // Current State Information
     extern std::unique_ptr<State> state;
 
     // Parse the pool, givin the current offset and asset type
     void PoolParser64(uint64_t offset, std::function<XAsset64(const uint64_t&)> request, std::function<void(XAsset64&)> callback);
+    // Parse the pool in batches, nodes are read ahead in blocks rather than one at a time.
+    void PoolParserBatched64(uint64_t offset, BlockRequest64 request, std::function<void(std::vector<XAsset64>&)> callback);
+    // Gathers the headers of the assets into the buffer, headers close to each other are read together.
+    void ReadHeaders64(const std::vector<XAsset64>& assets, size_t headerSize, uint8_t* headers, BlockRequest64 request);
+    // Reads the null terminated strings at the addresses, strings close to each other are read together, null addresses give empty strings.
+    void ReadStrings64(const std::vector<uint64_t>& addresses, BlockRequest64 request, std::vector<std::string>& results);
+
+    // Parse the pool in batches, with the headers of each batch gathered in bulk.
+    template <typename T>
+    void PoolParserBatched64(uint64_t offset, BlockRequest64 request, std::function<void(std::vector<XAsset64>&, std::vector<T>&)> callback)
+    {
+        std::vector<T> headers;
+
+        PoolParserBatched64(offset, request, [&headers, &request, &callback](std::vector<XAsset64>& assets)
+        {
+            headers.resize(assets.size());
+            ReadHeaders64(assets, sizeof(T), (uint8_t*)headers.data(), request);
+            callback(assets, headers);
+        });
+    }
 };
 
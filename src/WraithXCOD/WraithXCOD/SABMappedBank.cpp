@@ -0,0 +1,159 @@
+#include "stdafx.h"
+
+// The class we are implementing
+#include "SABMappedBank.h"
+
+// We need the following classes
+#include "CoDXConverter.h"
+
+SABMappedBank::SABMappedBank()
+{
+    // Defaults
+    FileHandle = INVALID_HANDLE_VALUE;
+    MappingHandle = NULL;
+    View = nullptr;
+    ViewSize = 0;
+    DecryptionKeyLength = 0;
+}
+
+SABMappedBank::~SABMappedBank()
+{
+    // Clean up
+    Close();
+}
+
+bool SABMappedBank::Open(const std::string& Path)
+{
+    // Close any existing bank
+    Close();
+
+    // Open the file
+    FileHandle = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    // Get the size
+    LARGE_INTEGER FileSize{};
+
+    if (!GetFileSizeEx(FileHandle, &FileSize) || FileSize.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+
+    // Map it, the whole bank is mapped, pages are only read as sounds use them
+    MappingHandle = CreateFileMappingA(FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (MappingHandle == NULL)
+    {
+        Close();
+        return false;
+    }
+
+    View = (const int8_t*)MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+    ViewSize = FileSize.QuadPart;
+
+    if (View == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    // Success
+    FileName = Path;
+    return true;
+}
+
+void SABMappedBank::Close()
+{
+    // Clean up in reverse
+    if (View != nullptr)
+        UnmapViewOfFile(View);
+    if (MappingHandle != NULL)
+        ::CloseHandle(MappingHandle);
+    if (FileHandle != INVALID_HANDLE_VALUE)
+        ::CloseHandle(FileHandle);
+
+    FileHandle = INVALID_HANDLE_VALUE;
+    MappingHandle = NULL;
+    View = nullptr;
+    ViewSize = 0;
+    DecryptionKeyLength = 0;
+    FileName.clear();
+}
+
+void SABMappedBank::SetDecryption(const Salsa20Key& Key)
+{
+    // Check the key
+    if (Key.IV == nullptr || Key.Key == nullptr || Key.KeyLength == 0)
+        return;
+
+    // Copy the key, the caller's may not outlive us
+    std::memcpy(DecryptionKey, Key.Key, (Key.KeyLength == 128) ? 16 : 32);
+    std::memcpy(DecryptionIV, Key.IV, sizeof(DecryptionIV));
+    DecryptionKeyLength = Key.KeyLength;
+}
+
+const int8_t* SABMappedBank::GetView(uint64_t Offset, uint64_t Size) const
+{
+    // Encrypted data can't be used in place
+    if (IsEncrypted() || !IsInBounds(Offset, Size))
+        return nullptr;
+
+    // The data is used as is
+    return View + Offset;
+}
+
+bool SABMappedBank::Read(uint64_t Offset, uint64_t Size, int8_t* Buffer) const
+{
+    // Check bounds
+    if (!IsInBounds(Offset, Size))
+        return false;
+
+    // Copy it
+    std::memcpy(Buffer, View + Offset, (size_t)Size);
+
+    // Decrypt it if need be, the keystream is taken from where it is in the bank
+    if (IsEncrypted())
+    {
+        // The key
+        Salsa20Key Key;
+        // Set data
+        Key.Key = (uint8_t*)DecryptionKey;
+        Key.IV = (uint8_t*)DecryptionIV;
+        Key.KeyLength = DecryptionKeyLength;
+
+        // Grab the converter we're working for, if any
+        auto Converter = CoDXConverter::Current();
+
+        // Decrypt, large reads are split over the converter's workers, otherwise it's done here
+        if (Converter != nullptr)
+        {
+            Encryption::Salsa20Range(Buffer, Size, Offset, Key, Converter->GetDegreeOfParallelism(), [](uint32_t PartCount, const std::function<void(uint32_t)>& DecryptPart)
+            {
+                // The group waits on the parts, running them itself if no one else picks them up
+                CoDXConverterGroup PartGroup;
+
+                for (uint32_t i = 1; i < PartCount; i++)
+                    PartGroup.Run(CoDXConverterStage::Decompress, [&DecryptPart, i] { DecryptPart(i); });
+
+                // Do the first part ourselves
+                DecryptPart(0);
+            });
+        }
+        else
+        {
+            Encryption::Salsa20Range(Buffer, Size, Offset, Key);
+        }
+    }
+
+    // Success
+    return true;
+}
+
+bool SABMappedBank::IsInBounds(uint64_t Offset, uint64_t Size) const
+{
+    // Check it's mapped and the range doesn't overflow the view
+    return View != nullptr && Offset <= ViewSize && Size <= (ViewSize - Offset);
+}
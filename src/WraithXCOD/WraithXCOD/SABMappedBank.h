@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// We need the encryption classes
+#include "Encryption.h"
+
+// A class that maps a SAB file into memory, so sounds can be read from it in place
+class SABMappedBank
+{
+public:
+    // Constructors
+    SABMappedBank();
+    ~SABMappedBank();
+
+    // Maps the bank, returns false if it can't be opened
+    bool Open(const std::string& FileName);
+    // Unmaps the bank
+    void Close();
+
+    // Sets the key of an encrypted bank, its data can then only be read with a copy
+    void SetDecryption(const Salsa20Key& Key);
+
+    // Gets the name of the mapped file
+    const std::string& GetFileName() const { return FileName; }
+    // Gets the size of the mapped file
+    uint64_t GetSize() const { return ViewSize; }
+    // Gets whether or not the bank is encrypted
+    bool IsEncrypted() const { return DecryptionKeyLength != 0; }
+
+    // Gets a view of a range of the bank, nullptr if it's out of bounds or the bank is encrypted
+    const int8_t* GetView(uint64_t Offset, uint64_t Size) const;
+    // Copies a range of the bank to the buffer, decrypting it if need be, returns false if it's out of bounds
+    bool Read(uint64_t Offset, uint64_t Size, int8_t* Buffer) const;
+
+private:
+    // The mapped file name
+    std::string FileName;
+    // The open file
+    HANDLE FileHandle;
+    // The file mapping
+    HANDLE MappingHandle;
+    // The mapped view
+    const int8_t* View;
+    // The size of the mapped view
+    uint64_t ViewSize;
+
+    // A copy of the key, iv and key length, the length is 0 when not encrypted
+    uint8_t DecryptionKey[32];
+    uint8_t DecryptionIV[8];
+    uint32_t DecryptionKeyLength;
+
+    // Checks that a range is within the bank
+    bool IsInBounds(uint64_t Offset, uint64_t Size) const;
+};
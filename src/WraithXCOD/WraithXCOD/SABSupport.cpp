@@ -21,6 +21,15 @@
 // We need Opus
 #include "..\..\External\Opus\include\opus.h"
 
+// The key and iv of encrypted SAB files
+static uint8_t SABKeyData[32] = { 0x91, 0x92, 0xD4, 0xDE, 0xF2, 0xEA, 0x37, 0x58, 0xE7, 0x4A, 0x0, 0xC1, 0x16, 0x21, 0x26, 0x46, 0xB, 0x93, 0xD0, 0xED, 0x6E, 0xED, 0xDC, 0x64, 0xD8, 0x21, 0xAB, 0xA9, 0x14, 0x5E, 0x2F, 0xC9 };
+static uint8_t SABIVData[8] = { 0x4A, 0x1B, 0xB1, 0x2, 0x0, 0x0, 0x0, 0x0 };
+
+// -- Setup the mapped bank
+
+std::shared_ptr<SABMappedBank> SABSupport::MappedBank = nullptr;
+std::mutex SABSupport::MappedBankMutex;
+
 // Calculates the hash of a sound string
 uint32_t HashSoundString(const std::string& Value)
 {
@@ -155,10 +164,11 @@ bool SABSupport::ParseSAB(const std::string& FilePath)
                 {
                     // Read and mask it
                     auto Hash = Reader.Read<uint64_t>() & 0xFFFFFFFFFFFFFFF;
+                    std::string FileName;
                     // Check for an override in the name DB
-                    if (SABNames.NameDatabase.find(Hash) != SABNames.NameDatabase.end())
+                    if (SABNames.TryGetName(Hash, FileName))
                     {
-                        SABFileNames.emplace_back(SABNames.NameDatabase[Hash]);
+                        SABFileNames.emplace_back(FileName);
                     }
                     else
                     {
@@ -245,19 +255,12 @@ bool SABSupport::ParseSAB(const std::string& FilePath)
 
 std::unique_ptr<XSound> SABSupport::LoadSound(const CoDSound_t* SoundAsset)
 {
-    // Prepare to extract the sound asset, and clean up the data if need be
-    auto& SoundBankPath = CoDAssets::GamePackageCache->GetPackagesPath();
-
-    // Open the bank file
-    auto Reader = BinaryReader();
-    // Open it
-    Reader.Open(SoundBankPath);
-
-    // Handle encryption once again
-    HandleSABEncryption(Reader, SoundBankPath);
+    // Prepare to extract the sound asset, the bank is mapped once for every sound
+    auto Bank = GetMappedBank(CoDAssets::GamePackageCache->GetPackagesPath());
 
-    // Jump to the offset
-    Reader.SetPosition(SoundAsset->AssetPointer);
+    // Make sure we have it
+    if (Bank == nullptr)
+        return nullptr;
 
     // Allocate the sound asset
     auto SoundResult = std::make_unique<XSound>();
@@ -278,32 +281,56 @@ std::unique_ptr<XSound> SABSupport::LoadSound(const CoDSound_t* SoundAsset)
         SoundResult->DataType = SoundDataTypes::FLAC_WithHeader;
     }
 
-    // Allocate the buffer
-    SoundResult->DataBuffer = new int8_t[(uint32_t)(HeaderSpace + SoundAsset->AssetSize)];
-    // Set the buffer size
-    SoundResult->DataSize = (uint32_t)(HeaderSpace + SoundAsset->AssetSize);
-    
-    // Result read
-    uint64_t ReadResult = 0;
-    // Read the buffer
-    auto AudioBuffer = Reader.Read(SoundAsset->AssetSize, ReadResult);
+    // Where the header goes
+    int8_t* HeaderBuffer = nullptr;
+
+    // Encrypted banks must be decrypted, so they're copied, otherwise we use the data in place and keep the header apart
+    if (Bank->IsEncrypted())
+    {
+        // Allocate the buffer
+        SoundResult->DataBuffer = new int8_t[(uint32_t)(HeaderSpace + SoundAsset->AssetSize)];
+        // Set the buffer size
+        SoundResult->DataSize = (uint32_t)(HeaderSpace + SoundAsset->AssetSize);
+
+        // Read the buffer
+        if (!Bank->Read(SoundAsset->AssetPointer, SoundAsset->AssetSize, SoundResult->DataBuffer + HeaderSpace))
+            return nullptr;
+
+        // The header is at the start
+        HeaderBuffer = SoundResult->DataBuffer;
+    }
+    else
+    {
+        // Grab the view
+        SoundResult->DataView = Bank->GetView(SoundAsset->AssetPointer, SoundAsset->AssetSize);
+
+        // Make sure it's within the bank
+        if (SoundResult->DataView == nullptr)
+            return nullptr;
 
-    // Copy it
-    std::memcpy((SoundResult->DataBuffer + HeaderSpace), AudioBuffer, ReadResult);
+        // The sound keeps the bank mapped
+        SoundResult->DataViewOwner = Bank;
+        SoundResult->DataSize = (uint32_t)SoundAsset->AssetSize;
 
-    // Clean up
-    delete[] AudioBuffer;
+        // Make sure the header fits
+        if ((size_t)HeaderSpace > sizeof(SoundResult->HeaderBuffer))
+            return nullptr;
+
+        // The header is separate, and kept in the sound
+        SoundResult->HeaderSize = HeaderSpace;
+        HeaderBuffer = SoundResult->HeaderBuffer;
+    }
 
     // Prepare the audio header
     if (SoundAsset->DataType == SoundDataTypes::WAV_NeedsHeader)
     {
         // Write WAV Header
-        Sound::WriteWAVHeaderToStream(SoundResult->DataBuffer, SoundAsset->FrameRate, SoundAsset->ChannelsCount, (uint32_t)SoundAsset->AssetSize);
+        Sound::WriteWAVHeaderToStream(HeaderBuffer, SoundAsset->FrameRate, SoundAsset->ChannelsCount, (uint32_t)SoundAsset->AssetSize);
     }
     else if (SoundAsset->DataType == SoundDataTypes::FLAC_NeedsHeader)
     {
         // Write FLAC Header
-        Sound::WriteFLACHeaderToStream(SoundResult->DataBuffer, SoundAsset->FrameRate, SoundAsset->ChannelsCount, SoundAsset->FrameCount);
+        Sound::WriteFLACHeaderToStream(HeaderBuffer, SoundAsset->FrameRate, SoundAsset->ChannelsCount, SoundAsset->FrameCount);
     }
 
     // Return result
@@ -312,103 +339,216 @@ std::unique_ptr<XSound> SABSupport::LoadSound(const CoDSound_t* SoundAsset)
 
 std::unique_ptr<XSound> SABSupport::LoadOpusSound(const CoDSound_t* SoundAsset)
 {
-    // Prepare to extract the sound asset, and clean up the data if need be
-    auto& SoundBankPath = CoDAssets::GamePackageCache->GetPackagesPath();
+    // Prepare to extract the sound asset, the bank is mapped once for every sound
+    auto Bank = GetMappedBank(CoDAssets::GamePackageCache->GetPackagesPath());
 
-    // Open the bank file
-    auto Reader = BinaryReader();
-    // Open it
-    Reader.Open(SoundBankPath);
+    // Make sure we have it
+    if (Bank == nullptr)
+        return nullptr;
 
-    // Handle encryption once again
-    HandleSABEncryption(Reader, SoundBankPath);
+    // Encrypted banks must be decrypted, so they're copied, otherwise we decode in place
+    if (Bank->IsEncrypted())
+    {
+        // Allocate the buffer
+        auto SoundBuffer = std::make_unique<uint8_t[]>((size_t)SoundAsset->AssetSize);
 
-    // Jump to the offset
-    Reader.SetPosition(SoundAsset->AssetPointer);
+        // Read the audio buffer
+        if (!Bank->Read(SoundAsset->AssetPointer, SoundAsset->AssetSize, (int8_t*)SoundBuffer.get()))
+            return nullptr;
 
-    // Buffer
-    std::unique_ptr<uint8_t[]> SoundBuffer = std::make_unique<uint8_t[]>((size_t)SoundAsset->AssetSize);
+        // The sound takes the copy
+        return LoadOpusInterleaved(std::move(SoundBuffer), (size_t)SoundAsset->AssetSize, 0, SoundAsset->FrameRate, SoundAsset->ChannelsCount, SoundAsset->FrameCount);
+    }
 
-    // Read the audio buffer
-    uint64_t ReadResult = 0;
-    Reader.Read(SoundBuffer.get(), SoundAsset->AssetSize, ReadResult);
+    // Grab the view, the sound keeps the bank mapped
+    auto OpusData = Bank->GetView(SoundAsset->AssetPointer, SoundAsset->AssetSize);
 
     // Validate
-    if (ReadResult != (size_t)SoundAsset->AssetSize)
+    if (OpusData == nullptr)
         return nullptr;
 
-    return DecodeOpusInterleaved(SoundBuffer.get(), SoundAsset->AssetSize, 0, SoundAsset->FrameRate, SoundAsset->ChannelsCount, SoundAsset->FrameCount);
+    return LoadOpusInterleaved(Bank, (const uint8_t*)OpusData, (size_t)SoundAsset->AssetSize, 0, SoundAsset->FrameRate, SoundAsset->ChannelsCount, SoundAsset->FrameCount);
+}
+
+void SABSupport::CloseMappedBank()
+{
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(MappedBankMutex);
+
+    // Release it, any sound still using it holds its own reference
+    MappedBank.reset();
 }
 
-std::unique_ptr<XSound> SABSupport::DecodeOpusInterleaved(uint8_t* OpusBuffer, size_t OpusBufferSize, size_t OpusDataOffset, uint32_t FrameRate, uint32_t Channels, uint32_t FrameCount)
+std::shared_ptr<SABMappedBank> SABSupport::GetMappedBank(const std::string& FilePath)
 {
-    // Initialize Opus
-    int ErrorCode;
-    auto Decoder = opus_decoder_create(FrameRate, Channels, &ErrorCode);
+    // Aquire lock
+    std::lock_guard<std::mutex> Lock(MappedBankMutex);
 
-    if (ErrorCode != OPUS_OK)
+    // Use the current bank if it's the one we're after
+    if (MappedBank != nullptr && MappedBank->GetFileName() == FilePath)
+        return MappedBank;
+
+    // Map the new bank
+    auto Bank = std::make_shared<SABMappedBank>();
+
+    // Make sure we got it
+    if (!Bank->Open(FilePath))
         return nullptr;
 
-    // Create new buffer for each 960 frame block
-    auto PCMBuffer = std::make_unique<opus_int16[]>(960 * 2 * (size_t)Channels);
+    // Now, we must check for encrypted files, those are decrypted as sounds are read
+    Salsa20Key Key;
+    // Check it
+    if (GetSABEncryptionKey(FilePath, Key))
+        Bank->SetDecryption(Key);
 
-    // Allocate the sound asset
-    auto SoundResult = std::make_unique<XSound>();
+    // Keep it for the next sound
+    MappedBank = Bank;
+
+    // Done
+    return Bank;
+}
+
+std::unique_ptr<XSound> SABSupport::LoadOpusInterleaved(std::unique_ptr<uint8_t[]> OpusBuffer, size_t OpusBufferSize, size_t OpusDataOffset, uint32_t FrameRate, uint32_t Channels, uint32_t FrameCount, uint32_t BlockHeaderSize)
+{
+    // The sound shares the buffer until it's written
+    auto Data = OpusBuffer.get();
+    std::shared_ptr<void> OpusOwner(OpusBuffer.release(), std::default_delete<uint8_t[]>());
+
+    // Pass off
+    return LoadOpusInterleaved(OpusOwner, Data, OpusBufferSize, OpusDataOffset, FrameRate, Channels, FrameCount, BlockHeaderSize);
+}
+
+std::unique_ptr<XSound> SABSupport::LoadOpusInterleaved(const std::shared_ptr<void>& OpusOwner, const uint8_t* OpusBuffer, size_t OpusBufferSize, size_t OpusDataOffset, uint32_t FrameRate, uint32_t Channels, uint32_t FrameCount, uint32_t BlockHeaderSize)
+{
+    // Make sure we have data
+    if (OpusBuffer == nullptr)
+        return nullptr;
+
+    // Allocate the sound asset, the data is kept encoded, it's decoded block by block as it's written
+    auto Result = std::make_unique<XSound>();
 
-    // Output Writer (Note: Frame Count in Asset isn't 100% accurate, so we add on some padding
-    //                      to account for 960 frame split so that we can avoid realloc)
-    MemoryWriter TempWriter((FrameRate + 4096) * 2 * Channels);
+    // Set the data
+    Result->DataView = (const int8_t*)(OpusBuffer + OpusDataOffset);
+    Result->DataViewOwner = OpusOwner;
+    Result->DataSize = (uint32_t)OpusBufferSize;
+    Result->DataType = SoundDataTypes::Opus_Interleaved;
 
-    // Offset to the data, depending on the buffer
-    size_t OpusDataSize = OpusBufferSize;
+    // Set the format
+    Result->FrameRate = FrameRate;
+    Result->ChannelsCount = Channels;
+    Result->FrameCount = FrameCount;
+    Result->BlockHeaderSize = BlockHeaderSize;
+
+    // Done
+    return Result;
+}
+
+// Opus decoders, kept per thread and reused for each sound rather than created for each one
+struct OpusDecoderCache
+{
+    // The decoders, by frame rate and channel count
+    std::unordered_map<uint64_t, OpusDecoder*> Decoders;
+
+    ~OpusDecoderCache()
+    {
+        // Clean up
+        for (auto& Decoder : Decoders)
+            opus_decoder_destroy(Decoder.second);
+    }
+
+    // Gets a decoder for the format, reset for a new stream, nullptr if the format is invalid
+    OpusDecoder* GetDecoder(uint32_t FrameRate, uint32_t Channels)
+    {
+        // The key we're after
+        auto Key = ((uint64_t)FrameRate << 32) | Channels;
+        // Check if we have it
+        auto Result = Decoders.find(Key);
+
+        if (Result != Decoders.end())
+        {
+            // Reset it, the last sound's state mustn't carry over
+            opus_decoder_ctl(Result->second, OPUS_RESET_STATE);
+            return Result->second;
+        }
+
+        // Make a new one
+        int ErrorCode;
+        auto Decoder = opus_decoder_create(FrameRate, Channels, &ErrorCode);
+
+        if (ErrorCode != OPUS_OK)
+            return nullptr;
+
+        // Keep it
+        Decoders[Key] = Decoder;
+
+        // Done
+        return Decoder;
+    }
+};
+
+// This thread's decoders
+static thread_local OpusDecoderCache OpusDecoders;
+
+bool SABSupport::WriteOpusInterleaved(const XSound& OpusSound, const std::string& OutputFile, SoundFormat OutFormat, uint32_t CompressionLevel)
+{
+    // Grab a decoder
+    auto Decoder = OpusDecoders.GetDecoder(OpusSound.FrameRate, OpusSound.ChannelsCount);
+
+    if (Decoder == nullptr)
+        return false;
+
+    // The output, samples are sent to it as each block is decoded
+    SoundStreamWriter Writer;
+
+    // Create it, the frame count is close enough to size the output, the writer fixes it when it's done
+    if (!Writer.Create(OutputFile, OutFormat, OpusSound.FrameRate, OpusSound.ChannelsCount, OpusSound.FrameCount, CompressionLevel))
+        return false;
+
+    // A buffer for each 960 frame block
+    auto PCMBuffer = std::make_unique<opus_int16[]>(960 * (size_t)OpusSound.ChannelsCount);
+
+    // The data
+    auto OpusBuffer = (const uint8_t*)OpusSound.DataView;
+    auto OpusDataSize = (size_t)OpusSound.DataSize;
     size_t OpusConsumed = 0;
-    size_t PCMDataSize = 0;
+    // The size of the length before each block
+    size_t BlockHeaderSize = OpusSound.BlockHeaderSize;
+    // Whether or not every block decoded and wrote
+    bool Result = true;
 
     // Consume Opus Data
-    while (OpusConsumed < OpusDataSize)
+    while (Result && OpusConsumed + BlockHeaderSize <= OpusDataSize)
     {
-        uint16_t BlockSize = *(uint16_t*)(OpusBuffer + OpusConsumed + OpusDataOffset);
-        OpusConsumed += 2;
+        size_t BlockSize = (BlockHeaderSize == 4) ? *(const uint32_t*)(OpusBuffer + OpusConsumed) : *(const uint16_t*)(OpusBuffer + OpusConsumed);
+        OpusConsumed += BlockHeaderSize;
+
+        // Make sure the block is within the data
+        if (OpusConsumed + BlockSize > OpusDataSize)
+            break;
 
         auto DecoderResult = opus_decode(
             Decoder,
-            (OpusBuffer + OpusConsumed + OpusDataOffset),
-            BlockSize,
+            (OpusBuffer + OpusConsumed),
+            (opus_int32)BlockSize,
             PCMBuffer.get(),
             960,
             0);
 
-        // Any negative is a failure in Opus
-        if (DecoderResult < 0)
-            return nullptr;
-
-        // Output to Buffer
-        TempWriter.Write((uint8_t*)PCMBuffer.get(), 960 * 2 * Channels);
+        // Any negative is a failure in Opus, otherwise output to the file
+        Result = (DecoderResult >= 0) && Writer.Write(PCMBuffer.get(), (uint32_t)DecoderResult);
 
         // Advance Info
         OpusConsumed += BlockSize;
-        PCMDataSize += 960 * 2 * (size_t)Channels;
     }
 
-    // Prepare to read the sound data, for WAV, we must include a WAV header...
-    auto Result = std::make_unique<XSound>();
+    // Finish it, always closing the file first
+    Result = Writer.Close() && Result;
 
-    // The offset of which to store the data
-    uint32_t DataOffset = 0;
-
-    // We'll convert all BOCW sounds to 16bit PCM WAV
-    Result->DataBuffer = new int8_t[PCMDataSize + (size_t)Sound::GetMaximumWAVHeaderSize()];
-    Result->DataType = SoundDataTypes::WAV_WithHeader;
-    Result->DataSize = (uint32_t)(PCMDataSize + Sound::GetMaximumWAVHeaderSize());
-
-    DataOffset += Sound::GetMaximumWAVHeaderSize();
-
-    // Make the header
-    Sound::WriteWAVHeaderToStream(Result->DataBuffer, (uint32_t)FrameRate, (uint32_t)Channels, (uint32_t)PCMDataSize);
-
-    // Copy output
-    std::memcpy(Result->DataBuffer + DataOffset, TempWriter.GetCurrentStream(), PCMDataSize);
+    // Don't leave a partial sound behind
+    if (!Result)
+        FileSystems::DeleteFile(OutputFile);
 
+    // Done
     return Result;
 }
 
@@ -432,10 +572,9 @@ void SABSupport::HandleSABv4(BinaryReader& Reader, const SABFileHeader& Header,
             // We have it in file
             EntryName = NameList[i];
         }
-        else if (NameIndex.NameDatabase.find(Entry.Key) != NameIndex.NameDatabase.end())
+        else if (NameIndex.TryGetName(Entry.Key, EntryName))
         {
             // We have it in a database
-            EntryName = NameIndex.NameDatabase.at(Entry.Key);
         }
         else
         {
@@ -557,10 +696,9 @@ void SABSupport::HandleSABv14(BinaryReader& Reader, const SABFileHeader& Header,
             // We have it in file
             EntryName = NameList[i];
         }
-        else if (NameIndex.NameDatabase.find(Entry.Key) != NameIndex.NameDatabase.end())
+        else if (NameIndex.TryGetName(Entry.Key, EntryName))
         {
             // We have it in a database
-            EntryName = NameIndex.NameDatabase.at(Entry.Key);
         }
         else
         {
@@ -635,10 +773,9 @@ void SABSupport::HandleSABv15(BinaryReader& Reader, const SABFileHeader& Header,
             // We have it in file
             EntryName = NameList[i];
         }
-        else if (NameIndex.NameDatabase.find(Entry.Key) != NameIndex.NameDatabase.end())
+        else if (NameIndex.TryGetName(Entry.Key, EntryName))
         {
             // We have it in a database
-            EntryName = NameIndex.NameDatabase.at(Entry.Key);
         }
         else
         {
@@ -793,10 +930,9 @@ void SABSupport::HandleSABv21(BinaryReader& Reader, const SABFileHeader& Header,
                 LoadedSound->FullPath = FileSystems::GetDirectoryName(EntryName);
             }
         }
-        else if (NameIndex.NameDatabase.find(Entry.Key) != NameIndex.NameDatabase.end())
+        else if (NameIndex.TryGetName(Entry.Key, EntryName))
         {
             // We have it in a database
-            EntryName = NameIndex.NameDatabase.at(Entry.Key);
 
             // Set the name, but remove all extensions first
             LoadedSound->AssetName = EntryName;
@@ -921,6 +1057,16 @@ void SABSupport::HandleSABv21v2(BinaryReader& Reader, const SABFileHeader& Heade
 }
 
 void SABSupport::HandleSABEncryption(BinaryReader& Reader, const std::string& FilePath)
+{
+    // The key
+    Salsa20Key Key;
+
+    // Salsa20 is a stream cipher, so rather than decrypting the whole bank to disk, decrypt only what's read
+    if (GetSABEncryptionKey(FilePath, Key))
+        Reader.SetDecryption(Key);
+}
+
+bool SABSupport::GetSABEncryptionKey(const std::string& FilePath, Salsa20Key& Key)
 {
     // Currently, the only encrypted SAB files are in Black Ops 3
     // They are identified using zm_genesis and use the same key
@@ -929,43 +1075,15 @@ void SABSupport::HandleSABEncryption(BinaryReader& Reader, const std::string& Fi
 
     if (Strings::Contains(FileSystems::GetFileName(FilePath), "zm_genesis"))
     {
-        // We must swap out for a decrypted reader
-        if (!FileSystems::FileExists(FilePath + ".wraithdec"))
-        {
-            // Allocate a key / iv buffer
-            // Current data is taken from Key 1 (32 bytes, 8 bytes)
-            uint8_t KeyData[32] = { 0x91, 0x92, 0xD4, 0xDE, 0xF2, 0xEA, 0x37, 0x58, 0xE7, 0x4A, 0x0, 0xC1, 0x16, 0x21, 0x26, 0x46, 0xB, 0x93, 0xD0, 0xED, 0x6E, 0xED, 0xDC, 0x64, 0xD8, 0x21, 0xAB, 0xA9, 0x14, 0x5E, 0x2F, 0xC9 };
-            uint8_t IVData[8] = { 0x4A, 0x1B, 0xB1, 0x2, 0x0, 0x0, 0x0, 0x0 };
-
-            // Result size
-            uint64_t ResultSize = 0;
-            // Decrypt the buffer to a file
-            auto FileBuffer = Reader.Read(Reader.GetLength(), ResultSize);
-            // Close the file
-            Reader.Close();
-
-            // The key
-            Salsa20Key Key;
-            // Set data
-            Key.Key = &KeyData[0];
-            Key.IV = &IVData[0];
-            Key.KeyLength = 256;
-            // Decrypt it
-            Encryption::Salsa20Block(FileBuffer, (uint32_t)ResultSize, Key);
-
-            // Write the clean buffer to a file
-            auto Writer = BinaryWriter();
-
-            // Write the buffer to the decrypted file...
-            Writer.Create(FilePath + ".wraithdec");
-            Writer.Write(FileBuffer, (uint32_t)ResultSize);
-            Writer.Close();
-
-            // Clean up
-            delete[] FileBuffer;
-        }
-
-        // Open new file
-        Reader.Open(FilePath + ".wraithdec");
+        // Current data is taken from Key 1 (32 bytes, 8 bytes)
+        Key.Key = &SABKeyData[0];
+        Key.IV = &SABIVData[0];
+        Key.KeyLength = 256;
+
+        // Encrypted
+        return true;
     }
+
+    // Not encrypted
+    return false;
 }
\ No newline at end of file
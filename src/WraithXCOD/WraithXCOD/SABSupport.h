@@ -3,12 +3,15 @@
 #include <string>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 
 // We need the following classes
 #include "CoDAssetType.h"
 #include "BinaryReader.h"
+#include "Sound.h"
 #include "DBGameFiles.h"
 #include "WraithNameIndex.h"
+#include "SABMappedBank.h"
 
 // A class that handles parsing SAB files
 class SABSupport
@@ -27,17 +30,34 @@ public:
     // Loads a sound file from a SAB package that uses Opus
     static std::unique_ptr<XSound> LoadOpusSound(const CoDSound_t* SoundAsset);
 
+    // Releases the mapped sound bank, sounds still using it keep it mapped until they're written
+    static void CloseMappedBank();
+
     // -- Decoding functions
 
-    // Decodes an Opus Buffer
-    static std::unique_ptr<XSound> DecodeOpusInterleaved(uint8_t* OpusBuffer, size_t OpusBufferSize, size_t OpusDataOffset, uint32_t FrameRate, uint32_t Channels, uint32_t FrameCount);
+    // Loads an Opus buffer as a sound that's decoded as it's written, the sound takes the buffer
+    static std::unique_ptr<XSound> LoadOpusInterleaved(std::unique_ptr<uint8_t[]> OpusBuffer, size_t OpusBufferSize, size_t OpusDataOffset, uint32_t FrameRate, uint32_t Channels, uint32_t FrameCount, uint32_t BlockHeaderSize = 2);
+    // Loads an Opus buffer as a sound that's decoded as it's written, the sound keeps the buffer's owner alive
+    static std::unique_ptr<XSound> LoadOpusInterleaved(const std::shared_ptr<void>& OpusOwner, const uint8_t* OpusBuffer, size_t OpusBufferSize, size_t OpusDataOffset, uint32_t FrameRate, uint32_t Channels, uint32_t FrameCount, uint32_t BlockHeaderSize = 2);
+    // Decodes an Opus sound straight to a WAV or FLAC file, a block at a time, with this thread's decoder
+    static bool WriteOpusInterleaved(const XSound& OpusSound, const std::string& OutputFile, SoundFormat OutFormat, uint32_t CompressionLevel);
 
 private:
 
     // -- Utility functions
 
-    // Handles decrypting SAB files to unencrypted results and loading them
+    // Handles encrypted SAB files, reads from the reader are decrypted as they're made
     static void HandleSABEncryption(BinaryReader& Reader, const std::string& FilePath);
+    // Gets the key of an encrypted SAB file, returns false if the file isn't encrypted
+    static bool GetSABEncryptionKey(const std::string& FilePath, Salsa20Key& Key);
+
+    // Gets the mapped sound bank, the bank is mapped once and shared by every sound loaded from it
+    static std::shared_ptr<SABMappedBank> GetMappedBank(const std::string& FilePath);
+
+    // The mapped sound bank
+    static std::shared_ptr<SABMappedBank> MappedBank;
+    // A mutex for mapping the sound bank
+    static std::mutex MappedBankMutex;
 
     // -- Game specific load functions
 
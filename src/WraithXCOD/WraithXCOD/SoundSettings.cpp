@@ -58,12 +58,15 @@ void SoundSettings::OnBeforeLoad()
     // Add
     ComboControl->InsertString(0, L"WAV");
     ComboControl->InsertString(1, L"FLAC");
+    ComboControl->InsertString(2, L"FLAC (Fast)");
 
     // Image settings
     auto ImageFormat = SettingsManager::GetSetting("exportsnd", "WAV");
+    // Fast FLAC is FLAC at the lowest compression level
+    auto FastFlac = (SettingsManager::GetSetting("flaclevel", "5") == "0");
     // Apply
     if (ImageFormat == "WAV") { ComboControl->SetCurSel(0); }
-    if (ImageFormat == "FLAC") { ComboControl->SetCurSel(1); }
+    if (ImageFormat == "FLAC") { ComboControl->SetCurSel(FastFlac ? 2 : 1); }
 }
 
 void SoundSettings::OnKeepPaths()
@@ -106,7 +109,8 @@ void SoundSettings::OnSoundFormat()
     switch (SelectedFormat)
     {
     case 0: SettingsManager::SetSetting("exportsnd", "WAV"); break;
-    case 1: SettingsManager::SetSetting("exportsnd", "FLAC"); break;
+    case 1: SettingsManager::SetSetting("exportsnd", "FLAC"); SettingsManager::SetSetting("flaclevel", "5"); break;
+    case 2: SettingsManager::SetSetting("exportsnd", "FLAC"); SettingsManager::SetSetting("flaclevel", "0"); break;
     default: SettingsManager::SetSetting("exportsnd", "WAV"); break;
     }
 }
\ No newline at end of file
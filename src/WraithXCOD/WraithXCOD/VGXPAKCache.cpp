@@ -35,12 +35,9 @@ void VGXPAKCache::LoadPackageCache(const std::string& BasePath)
         // We need to enumerate all files in this path, load them, and aquire hashes of the names
         auto PathXPAKFiles = FileSystems::GetFiles(BasePath, "*.xpak");
 
-        // Iterate over file paths
-        for (auto& XPAKFile : PathXPAKFiles)
-        {
-            // Some of the smaller blank XPAKs are causing this to return false, since the bigger XPAKs are fine now from what I can tell, just skip the bad ones
-            this->LoadPackage(XPAKFile);
-        }
+        // Load them, unchanged packages come from the index snapshot, some of the smaller blank XPAKs
+        // are causing this to return false, since the bigger XPAKs are fine now from what I can tell, just skip the bad ones
+        this->LoadPackages(PathXPAKFiles);
     }
     catch (...)
     {
@@ -52,15 +49,27 @@ void VGXPAKCache::LoadPackageCache(const std::string& BasePath)
 
 bool VGXPAKCache::LoadPackage(const std::string& FilePath)
 {
-#ifdef _DEBUG
-    std::cout << "VGXPAKCache::LoadPackage(): Parsing " << FilePath << "\n";
-#endif
-
     // Call Base function first
     CoDPackageCache::LoadPackage(FilePath);
 
-    // Add to package files
-    auto PackageIndex = (uint32_t)PackageFilePaths.size();
+    // Parse it
+    PackageIndex Index;
+
+    if (!ParsePackage(FilePath, Index))
+        return false;
+
+    // Add it
+    AddPackage(Index);
+
+    // No issues
+    return true;
+}
+
+bool VGXPAKCache::ParsePackage(const std::string& FilePath, PackageIndex& Index)
+{
+#ifdef _DEBUG
+    std::cout << "VGXPAKCache::ParsePackage(): Parsing " << FilePath << "\n";
+#endif
 
     // Open the file
     auto Reader = BinaryReader();
@@ -88,6 +97,8 @@ bool VGXPAKCache::LoadPackage(const std::string& FilePath)
         // Read the hash data into a buffer
         MemoryReader HashData((int8_t*)Buffer, (size_t)HashResult);
 
+        Index.Entries.reserve((size_t)(HashResult / sizeof(VGXPAKHashEntry)));
+
         // Loop and setup entries
         for (int64_t i = 0; i < Header.HashCount; i++)
         {
@@ -95,22 +106,21 @@ bool VGXPAKCache::LoadPackage(const std::string& FilePath)
             auto Entry = HashData.Read<VGXPAKHashEntry>();
 
             // Prepare a cache entry
-            PackageCacheObject NewObject;
+            PackageIndexEntry NewEntry{};
             // Set data
-            NewObject.Offset = (Entry.PackedInfo >> 32) << 7;
-            NewObject.CompressedSize = (Entry.PackedInfo >> 1) & 0x3FFFFFFF;
-            NewObject.UncompressedSize = 0;
-            NewObject.PackageFileIndex = PackageIndex;
-
-            // Append to database
-            CacheObjects.insert(std::make_pair(Entry.Key, NewObject));
+            NewEntry.Key = Entry.Key;
+            NewEntry.Offset = (Entry.PackedInfo >> 32) << 7;
+            NewEntry.CompressedSize = (Entry.PackedInfo >> 1) & 0x3FFFFFFF;
+            NewEntry.UncompressedSize = 0;
+            // Append to package
+            Index.Entries.push_back(NewEntry);
         }
 
-        // Append the file path
-        PackageFilePaths.push_back(FilePath + "data");
+        // Set the file path, the data lives next to the index
+        Index.FilePath = FilePath + "data";
 
 #ifdef _DEBUG
-        std::cout << "VGXPAKCache::LoadPackage(): Added " << FilePath << " to cache.\n";
+        std::cout << "VGXPAKCache::ParsePackage(): Parsed " << FilePath << ".\n";
 #endif
 
         // No issues
@@ -118,7 +128,7 @@ bool VGXPAKCache::LoadPackage(const std::string& FilePath)
     }
 
 #ifdef _DEBUG
-    std::cout << "VGXPAKCache::LoadPackage(): Failed to parse package.\n";
+    std::cout << "VGXPAKCache::ParsePackage(): Failed to parse package.\n";
 #endif
 
     // Failed
@@ -128,10 +138,11 @@ bool VGXPAKCache::LoadPackage(const std::string& FilePath)
 std::unique_ptr<uint8_t[]> VGXPAKCache::ExtractPackageObject(uint64_t CacheID, int32_t Size, uint32_t& ResultSize)
 {
     // Prepare to extract if found
-    if (CacheObjects.find(CacheID) != CacheObjects.end())
+    PackageCacheObject CacheInfo;
+
+    if (FindCacheObject(CacheID, CacheInfo))
     {
         // Take cache data, and extract from the XPAK (Uncompressed size = offset of data segment!)
-        auto& CacheInfo = CacheObjects[CacheID];
         // Get the XPAK name
         auto& XPAKFileName = PackageFilePaths[CacheInfo.PackageFileIndex];
         // Open the file
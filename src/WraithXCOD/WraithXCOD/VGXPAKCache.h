@@ -16,6 +16,8 @@ public:
     virtual void LoadPackageCache(const std::string& BasePath);
     // Implement the load package
     virtual bool LoadPackage(const std::string& FilePath);
+    // Implement the parse package
+    virtual bool ParsePackage(const std::string& FilePath, PackageIndex& Index);
     // Implement the extract function
     virtual std::unique_ptr<uint8_t[]> ExtractPackageObject(uint64_t CacheID, int32_t Size, uint32_t& ResultSize);
 };
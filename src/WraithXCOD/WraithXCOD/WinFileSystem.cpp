@@ -110,6 +110,24 @@ size_t WinFileSystem::Read(HANDLE handle, uint8_t* buffer, const size_t offset,
 	return sizeRead;
 }
 
+size_t WinFileSystem::ReadAt(HANDLE handle, uint8_t* buffer, const size_t position, const size_t size)
+{
+	// Windows takes the position from the overlapped structure, so there's no shared file pointer to fight over.
+	OVERLAPPED overlapped{};
+	overlapped.Offset = (DWORD)position;
+	overlapped.OffsetHigh = (DWORD)((uint64_t)position >> 32);
+
+	DWORD sizeRead = 0;
+
+	if (!ReadFile(handle, buffer, (DWORD)size, &sizeRead, &overlapped))
+	{
+		LastErrorCode = 0x505008;
+		return 0;
+	}
+
+	return sizeRead;
+}
+
 size_t WinFileSystem::Write(HANDLE handle, const uint8_t* buffer, const size_t offset, const size_t size)
 {
 	DWORD sizeWritten = 0;
@@ -167,6 +185,27 @@ size_t WinFileSystem::Size(HANDLE handle)
 	return output.QuadPart;
 }
 
+bool WinFileSystem::GetFileInfo(const std::string& fileName, uint64_t& size, uint64_t& modifiedTime)
+{
+	size = 0;
+	modifiedTime = 0;
+
+	auto fullPath = PathIsRelativeA(fileName.c_str()) ? Directory + "\\" + fileName : fileName;
+	WIN32_FILE_ATTRIBUTE_DATA attributes{};
+
+	if (!GetFileAttributesExA(fullPath.c_str(), GetFileExInfoStandard, &attributes))
+	{
+		LastErrorCode = 0x505009;
+		return false;
+	}
+
+	size = (uint64_t)attributes.nFileSizeLow | ((uint64_t)attributes.nFileSizeHigh << 32);
+	modifiedTime = (uint64_t)attributes.ftLastWriteTime.dwLowDateTime | ((uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32);
+
+	LastErrorCode = 0;
+	return true;
+}
+
 size_t WinFileSystem::EnumerateFiles(const std::string& pattern, std::function<void(const std::string&, const size_t)> onFileFound)
 {
 	HANDLE findHandle;
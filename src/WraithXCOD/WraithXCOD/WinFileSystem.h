@@ -17,6 +17,8 @@ public:
 	virtual bool Exists(const std::string& fileName);
 	// Reads data from the file.
 	virtual size_t Read(HANDLE handle, uint8_t* buffer, const size_t offset, const size_t size);
+	// Reads data from the given position without using the file pointer, safe to call from multiple threads.
+	virtual size_t ReadAt(HANDLE handle, uint8_t* buffer, const size_t position, const size_t size);
 	// Reads data from the file.
 	virtual size_t Write(HANDLE handle, const uint8_t* buffer, const size_t offset, const size_t size);
 	// Tells the file position.
@@ -25,6 +27,8 @@ public:
 	virtual size_t Seek(HANDLE handle, size_t position, size_t direction);
 	// Gets the size of the file.
 	virtual size_t Size(HANDLE handle);
+	// Gets the size and last write time of the file, used to tell if a file has changed.
+	virtual bool GetFileInfo(const std::string& fileName, uint64_t& size, uint64_t& modifiedTime);
 	// Gets the list of files matching the provided pattern.
 	virtual size_t EnumerateFiles(const std::string& pattern, std::function<void(const std::string&, const size_t)> onFileFound);
 };
\ No newline at end of file
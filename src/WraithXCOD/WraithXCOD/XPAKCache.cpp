@@ -39,11 +39,16 @@ void XPAKCache::LoadPackageCache(const std::string& BasePath)
     CoDPackageCache::LoadPackageCache(BasePath);
 
     // Grab files
-    FileSystem->EnumerateFiles("*.xpak", [this](const std::string& name, const size_t size)
+    std::vector<std::string> FilePaths;
+
+    FileSystem->EnumerateFiles("*.xpak", [&FilePaths](const std::string& name, const size_t size)
     {
-        this->LoadPackage(name);
+        FilePaths.push_back(name);
     });
 
+    // Load them, unchanged packages come from the index snapshot
+    this->LoadPackages(FilePaths);
+
     // We've finished loading, set status
     this->SetLoadedState();
 }
@@ -53,12 +58,24 @@ bool XPAKCache::LoadPackage(const std::string& FilePath)
     // Call Base function first
     CoDPackageCache::LoadPackage(FilePath);
 
-    // Add to package files
-    auto PackageIndex = (uint32_t)PackageFilePaths.size();
-
 	if (FileSystem == nullptr)
 		FileSystem = std::make_unique<WinFileSystem>(FileSystems::GetDirectoryName(FilePath));
 
+    // Parse it
+    PackageIndex Index;
+
+    if (!ParsePackage(FilePath, Index))
+        return false;
+
+    // Add it
+    AddPackage(Index);
+
+    // No issues
+    return true;
+}
+
+bool XPAKCache::ParsePackage(const std::string& FilePath, PackageIndex& Index)
+{
     // Open the file
     auto Reader = CoDFileHandle(FileSystem->OpenFile(FilePath, "r"), FileSystem.get());
 
@@ -74,31 +91,42 @@ bool XPAKCache::LoadPackage(const std::string& FilePath)
         Reader.Read((uint8_t*)&Header + 24, 0, 96);
     }
 
+    // The size of the package
+    auto FileSize = Reader.Size();
+
     // Verify the magic and offset
-    if (Header.Magic == 0x4950414b && Header.HashOffset < Reader.Size())
+    if (Header.Magic == 0x4950414b && Header.HashOffset < FileSize && Header.HashCount <= (FileSize - Header.HashOffset) / sizeof(BO3XPakHashEntry))
     {
         // Jump to hash offset
         Reader.Seek(Header.HashOffset, SEEK_SET);
 
+        // Read the whole table at once
+        auto Buffer = Reader.Read(Header.HashCount * sizeof(BO3XPakHashEntry));
+
+        // Verify result
+        if (Buffer == nullptr && Header.HashCount > 0)
+            return false;
+
+        auto Entries = (const BO3XPakHashEntry*)Buffer.get();
+
+        Index.Entries.reserve(Header.HashCount);
+
         // Loop and setup entries
         for (uint64_t i = 0; i < Header.HashCount; i++)
         {
-            // Read it
-            auto Entry = Reader.Read<BO3XPakHashEntry>();
-
             // Prepare a cache entry
-            PackageCacheObject NewObject{};
+            PackageIndexEntry NewEntry{};
             // Set data
-            NewObject.Offset = Header.DataOffset + Entry.Offset;
-            NewObject.CompressedSize = Entry.Size & 0xFFFFFFFFFFFFFF; // 0x80 in last 8 bits in some entries in new XPAKs
-            NewObject.UncompressedSize = 0;
-            NewObject.PackageFileIndex = PackageIndex;
-            // Append to database
-            CacheObjects.insert(std::make_pair(Entry.Key, NewObject));
+            NewEntry.Key = Entries[i].Key;
+            NewEntry.Offset = Header.DataOffset + Entries[i].Offset;
+            NewEntry.CompressedSize = Entries[i].Size & 0xFFFFFFFFFFFFFF; // 0x80 in last 8 bits in some entries in new XPAKs
+            NewEntry.UncompressedSize = 0;
+            // Append to package
+            Index.Entries.push_back(NewEntry);
         }
 
-        // Append the file path
-        PackageFilePaths.push_back(FilePath);
+        // Set the file path
+        Index.FilePath = FilePath;
 
         // No issues
         return true;
@@ -111,31 +139,30 @@ bool XPAKCache::LoadPackage(const std::string& FilePath)
 std::unique_ptr<uint8_t[]> XPAKCache::ExtractPackageObject(uint64_t CacheID, int32_t Size, uint32_t& ResultSize)
 {
     // Prepare to extract if found
-    if (CacheObjects.find(CacheID) != CacheObjects.end())
+    PackageCacheObject CacheInfo;
+
+    if (FindCacheObject(CacheID, CacheInfo))
     {
         // Take cache data, and extract from the XPAK (Uncompressed size = offset of data segment!)
-        const auto& CacheInfo = CacheObjects[CacheID];
-        // Get the XPAK name
-        const auto& XPAKFileName = PackageFilePaths[CacheInfo.PackageFileIndex];
-        // Open File
-        auto Reader = CoDFileHandle(FileSystem->OpenFile(XPAKFileName, "r"), FileSystem.get());
-
-        if (!Reader.IsValid())
-            return nullptr;
 
 #if _DEBUG
-        printf("XPAKCache::ExtractPackageObject(): Streaming Object: 0x%llx from File: %s\n", CacheID, XPAKFileName.c_str());
+        printf("XPAKCache::ExtractPackageObject(): Streaming Object: 0x%llx from File: %s\n", CacheID, PackageFilePaths[CacheInfo.PackageFileIndex].c_str());
 #endif // _DEBUG
 
-        // Hop to the beginning offset
-        Reader.Seek(CacheInfo.Offset, SEEK_SET);
-
         // Decompressed Size
         const uint64_t DecompressedSize = Size == -1 ? CacheInfo.UncompressedSize : Size;
         // Output Size
         size_t ResultSizeSizeT = 0;
 
-        const auto payload = Reader.Read(CacheInfo.CompressedSize);
+        // Read from the pooled handle, the package stays open between objects
+        const auto payload = ReadPackageData(CacheInfo.PackageFileIndex, CacheInfo.Offset, CacheInfo.CompressedSize);
+
+        if (payload == nullptr)
+        {
+            ResultSize = 0;
+            return nullptr;
+        }
+
         auto outputBuffer = DecompressPackageObject(CacheID, payload.get(), CacheInfo.CompressedSize, DecompressedSize, ResultSizeSizeT);
 
         // TODO: Switch to size_t in package class
@@ -151,14 +178,11 @@ std::unique_ptr<uint8_t[]> XPAKCache::ExtractPackageObject(uint64_t CacheID, int
     return nullptr;
 }
 
-std::unique_ptr<uint8_t[]> XPAKCache::DecompressPackageObject(uint64_t cacheID, uint8_t* buffer, size_t bufferSize, size_t decompressedSize, size_t& resultSize)
+// Decompresses a package object one block at a time, required when LZ4 blocks are present as they don't store their decompressed size.
+static std::unique_ptr<uint8_t[]> DecompressPackageObjectSerial(uint8_t* buffer, size_t bufferSize, size_t decompressedSize, size_t& resultSize)
 {
     resultSize = 0;
 
-    // We don't accept unknown sizes in xsub, caller must know how much memory is needed.
-    if (decompressedSize == 0)
-        return nullptr;
-
     // Our final big blob of data to return, this will be the entire decompressed buffer.
     auto result = std::make_unique<uint8_t[]>(decompressedSize);
     auto reader = MemoryReader((int8_t*)buffer, bufferSize, true);
@@ -240,3 +264,97 @@ std::unique_ptr<uint8_t[]> XPAKCache::DecompressPackageObject(uint64_t cacheID,
 
     return result;
 }
+
+std::unique_ptr<uint8_t[]> XPAKCache::DecompressPackageObject(uint64_t cacheID, uint8_t* buffer, size_t bufferSize, size_t decompressedSize, size_t& resultSize)
+{
+    resultSize = 0;
+
+    // We don't accept unknown sizes in xsub, caller must know how much memory is needed.
+    if (decompressedSize == 0)
+        return nullptr;
+
+    // First pass, work out where each block lands so they can be decompressed in any order.
+    std::vector<PackageObjectBlock> blocks;
+    auto reader = MemoryReader((int8_t*)buffer, bufferSize, true);
+    auto remaining = decompressedSize;
+    auto full = false;
+
+    while (!full && reader.GetPosition() < reader.GetLength())
+    {
+        // Read the block header
+        const auto blockHeader = reader.Read<BO3XPakDataHeader>();
+
+        // Loop for block count
+        for (uint32_t i = 0; i < blockHeader.Count; i++)
+        {
+            // Unpack the command information
+            const size_t blockSize = (blockHeader.Commands[i] & 0xFFFFFF);
+            const size_t flag = (blockHeader.Commands[i] >> 24);
+
+            // Get the current stream, avoids constant allocations as we know we have a memory pointer.
+            const auto dataBlock = reader.GetCurrentStream(blockSize);
+
+            // If we hit EOF on this, we can't verify this stream is valid or something is wrong.
+            if (dataBlock == nullptr)
+                return nullptr;
+
+            PackageObjectBlock block{};
+
+            block.DecompressedOffset = decompressedSize - remaining;
+
+            // Check the block type (anything else = skip over!)
+            switch (flag)
+            {
+                case 0x3: // compressed (lz4), no stored size so nothing after it can be placed
+                    return DecompressPackageObjectSerial(buffer, bufferSize, decompressedSize, resultSize);
+                case 0x6: // compressed (oodle), fixed size blocks
+                    block.Compression = 0x6;
+                    block.CompressedData = (const uint8_t*)dataBlock;
+                    block.CompressedSize = blockSize;
+                    block.DecompressedSize = std::min<size_t>(remaining, 262112);
+                    break;
+                case 0x8: // compressed (oodle), size prefixed
+                    block.Compression = 0x6;
+                    block.CompressedData = (const uint8_t*)(dataBlock + 4);
+                    block.CompressedSize = blockSize - 4;
+                    block.DecompressedSize = *(uint32_t*)(dataBlock);
+                    break;
+                case 0x0: // raw data
+                    block.Compression = 0x0;
+                    block.CompressedData = (const uint8_t*)dataBlock;
+                    block.CompressedSize = blockSize;
+                    block.DecompressedSize = blockSize;
+                    break;
+                default:
+                    block.DecompressedSize = 0;
+                    break;
+            }
+
+            // Anything past the requested size is dropped.
+            if (block.DecompressedSize > remaining)
+            {
+                full = true;
+                break;
+            }
+
+            if (block.DecompressedSize > 0)
+            {
+                blocks.push_back(block);
+                remaining -= block.DecompressedSize;
+            }
+
+            // TODO: Don't like depending on game for this, maybe use XPAK version and pass in flag?
+            if (CoDAssets::GameID == SupportedGames::ModernWarfare4)
+                reader.Advance(((blockSize + 3) & 0xFFFFFFFC) - blockSize);
+        }
+
+        reader.SetPosition((reader.GetPosition() + 0x7F) & 0xFFFFFFFFFFFFF80);
+    }
+
+    // Second pass, large objects are spread over the converter.
+    auto result = std::make_unique<uint8_t[]>(decompressedSize);
+    CoDPackageCache::DecompressPackageBlocks(blocks, result.get(), decompressedSize);
+    resultSize = decompressedSize - remaining;
+
+    return result;
+}
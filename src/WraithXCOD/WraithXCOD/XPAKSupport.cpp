@@ -197,8 +197,7 @@ bool XPAKSupport::ParseXPAK(const std::string& FilePath)
                                 Name = Strings::Format("ximage_%llx", Result);
 
                                 // Check for an override in the name DB
-                                if (XPAKNames.NameDatabase.find(Result) != XPAKNames.NameDatabase.end())
-                                    Name = XPAKNames.NameDatabase[Result];
+                                XPAKNames.TryGetName(Result, Name);
                             }
 
                         }
@@ -288,7 +287,7 @@ std::unique_ptr<XImageDDS> XPAKSupport::ReadImageFile(const CoDImage_t* Image)
     // Resulting buffer
     uint32_t ResultSize = 0;
     // We have a streamed image, prepare to extract (AssetPointer = Image Key)
-    auto ImageData = CoDAssets::GamePackageCache->ExtractPackageObject(Image->AssetPointer, Image->AssetSize, ResultSize);
+    auto ImageData = CoDAssets::GamePackageCache->ExtractPackageObjectCached(Image->AssetPointer, Image->AssetSize, ResultSize);
 
     // Prepare if we have it
     if (ImageData != nullptr)
@@ -297,7 +296,7 @@ std::unique_ptr<XImageDDS> XPAKSupport::ReadImageFile(const CoDImage_t* Image)
         auto Result = CoDRawImageTranslator::TranslateBC(ImageData, ResultSize, Image->Width, Image->Height, (uint8_t)ImageFormat);
 
         // Check for, and apply patch if required, if we got a raw result
-        if (Result != nullptr && (SettingsManager::GetSetting("patchnormals", "true") == "true"))
+        if (Result != nullptr && CoDAssets::GetExportSettings()->PatchNormals)
         {
             // We can check the name here for _n and _nml
             if (Strings::EndsWith(Image->AssetName, "_n") || Strings::EndsWith(Image->AssetName, "_nml") || Strings::EndsWith(Image->AssetName, "_n2") || Strings::EndsWith(Image->AssetName, "_n3"))
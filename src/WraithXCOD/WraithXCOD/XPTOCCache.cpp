@@ -56,6 +56,9 @@ bool XPTOCCache::LoadPackage(const std::string& FilePath)
     // Verify the magic
     if (Header.Magic == 0x3030336966663253)
     {
+        // Make room up front
+        CacheObjects.Reserve(CacheObjects.Size() + Header.EntriesCount);
+
         // Loop and read entries
         for (uint32_t i = 0; i < Header.EntriesCount; i++)
         {
@@ -85,7 +88,7 @@ bool XPTOCCache::LoadPackage(const std::string& FilePath)
             NewObject.PackageFileIndex = Entry.PackageIndex;
 
             // Append to database
-            CacheObjects.insert(std::make_pair(Key, NewObject));
+            CacheObjects.Insert(Key, NewObject);
         }
     }
 
@@ -96,10 +99,11 @@ bool XPTOCCache::LoadPackage(const std::string& FilePath)
 std::unique_ptr<uint8_t[]> XPTOCCache::ExtractPackageObject(uint64_t CacheID, uint32_t& ResultSize)
 {
     // Prepare to extract if found
-    if (CacheObjects.find(CacheID) != CacheObjects.end())
+    PackageCacheObject CacheInfo;
+
+    if (FindCacheObject(CacheID, CacheInfo))
     {
         // Take cache data, and extract from the XPAKFile (Uncompressed size = final chunk size!)
-        auto& CacheInfo = CacheObjects[CacheID];
         // Get the XPAKFile name
         auto FilePath = FileSystems::CombinePath(this->PackageFilesPath, Strings::Format("xpakfile%d.pak", CacheInfo.PackageFileIndex));
 
@@ -67,33 +67,43 @@ void XSUBCache::LoadPackageCache(const std::string& BasePath)
     CoDPackageCache::LoadPackageCache(BasePath);
 
     // Grab files
-    FileSystem->EnumerateFiles("*.xsub", [this](const std::string& name, const size_t size)
-    {
-        try
-        {
-            this->LoadPackage(name);
-        }
-        catch (...)
-        {
+    std::vector<std::string> FilePaths;
 
-        }
+    FileSystem->EnumerateFiles("*.xsub", [&FilePaths](const std::string& name, const size_t size)
+    {
+        FilePaths.push_back(name);
     });
 
+    // Load them, unchanged packages come from the index snapshot
+    this->LoadPackages(FilePaths);
+
     // We've finished loading, set status
     this->SetLoadedState();
 }
 
 bool XSUBCache::LoadPackage(const std::string& FilePath)
 {
-#ifdef _DEBUG
-    std::cout << "XSUBCache::LoadPackage(): Parsing " << FilePath << "\n";
-#endif
-
     // Call Base function first
     CoDPackageCache::LoadPackage(FilePath);
 
-    // Add to package files
-    auto PackageIndex = (uint32_t)PackageFilePaths.size();
+    // Parse it
+    PackageIndex Index;
+
+    if (!ParsePackage(FilePath, Index))
+        return false;
+
+    // Add it
+    AddPackage(Index);
+
+    // No issues
+    return true;
+}
+
+bool XSUBCache::ParsePackage(const std::string& FilePath, PackageIndex& Index)
+{
+#ifdef _DEBUG
+    std::cout << "XSUBCache::ParsePackage(): Parsing " << FilePath << "\n";
+#endif
 
     // Open CASC File
     // TODO: Implement read, seek, etc. right in this handle class.
@@ -106,42 +116,45 @@ bool XSUBCache::LoadPackage(const std::string& FilePath)
     if (Header.Type != 3)
         return true;
 
+    // The size of the package
+    auto FileSize = Reader.Size();
 
     // Verify the magic and offset
-    if (Header.Magic == 0x4950414b && Header.HashOffset < Reader.Size())
+    if (Header.Magic == 0x4950414b && Header.HashOffset >= 0 && (uint64_t)Header.HashOffset < FileSize && Header.HashCount >= 0 && (uint64_t)Header.HashCount <= (FileSize - Header.HashOffset) / sizeof(BOCWXSubHashEntry))
     {
         // Jump to hash offset
         Reader.Seek(Header.HashOffset, SEEK_SET);
-        // Hash result size
-        uint64_t HashResult = 0;
-        // Read Buffer
+
+        // Read the whole table at once
         auto Buffer = Reader.Read(Header.HashCount * sizeof(BOCWXSubHashEntry));
-        // Read the hash data into a buffer
-        auto HashData = MemoryReader((int8_t*)Buffer.release(), Header.HashCount * sizeof(BOCWXSubHashEntry));
+
+        // Verify result
+        if (Buffer == nullptr && Header.HashCount > 0)
+            return false;
+
+        auto Entries = (const BOCWXSubHashEntry*)Buffer.get();
+
+        Index.Entries.reserve(Header.HashCount);
 
         // Loop and setup entries
         for (int64_t i = 0; i < Header.HashCount; i++)
         {
-            // Read it
-            auto Entry = HashData.Read<BOCWXSubHashEntry>();
-
             // Prepare a cache entry
-            PackageCacheObject NewObject;
+            PackageIndexEntry NewEntry{};
             // Set data
-            NewObject.Offset = (Entry.PackedInfo >> 32) << 7;
-            NewObject.CompressedSize = (Entry.PackedInfo >> 1) & 0x3FFFFFFF;
-            NewObject.UncompressedSize = 0;
-            NewObject.PackageFileIndex = PackageIndex;
-
-            // Append to database
-            CacheObjects.insert(std::make_pair(Entry.Key, NewObject));
+            NewEntry.Key = Entries[i].Key;
+            NewEntry.Offset = (Entries[i].PackedInfo >> 32) << 7;
+            NewEntry.CompressedSize = (Entries[i].PackedInfo >> 1) & 0x3FFFFFFF;
+            NewEntry.UncompressedSize = 0;
+            // Append to package
+            Index.Entries.push_back(NewEntry);
         }
 
-        // Append the file path
-        PackageFilePaths.push_back(FilePath);
+        // Set the file path
+        Index.FilePath = FilePath;
 
 #ifdef _DEBUG
-        std::cout << "XSUBCache::LoadPackage(): Added " << FilePath << " to cache.\n";
+        std::cout << "XSUBCache::ParsePackage(): Parsed " << FilePath << ".\n";
 #endif
 
         // No issues
@@ -149,7 +162,7 @@ bool XSUBCache::LoadPackage(const std::string& FilePath)
     }
 
 #ifdef _DEBUG
-    std::cout << "XSUBCache::LoadPackage(): Failed to parse package.\n";
+    std::cout << "XSUBCache::ParsePackage(): Failed to parse package.\n";
 #endif
 
     // Failed
@@ -159,25 +172,17 @@ bool XSUBCache::LoadPackage(const std::string& FilePath)
 std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObjectRaw(uint64_t CacheID, uint32_t & ResultSize)
 {
     // Prepare to extract if found
-    if (CacheObjects.find(CacheID) != CacheObjects.end())
-    {
-        // Aquire lock
-        std::lock_guard<std::shared_mutex> Gaurd(ReadMutex);
+    PackageCacheObject CacheInfo;
 
+    if (FindCacheObject(CacheID, CacheInfo))
+    {
         // Take cache data, and extract from the XPAK (Uncompressed size = offset of data segment!)
-        auto& CacheInfo = CacheObjects[CacheID];
-        // Get the XPAK name
-        auto& XPAKFileName = PackageFilePaths[CacheInfo.PackageFileIndex];
-        // Open CASC File
-        auto Reader = CoDFileHandle(FileSystem->OpenFile(XPAKFileName, "r"), FileSystem.get());
-        // Hop to the beginning offset
-        Reader.Seek(CacheInfo.Offset, SEEK_SET);
 
-        // Allocate just the raw size of the buffer, that's all we're returning
-        auto ResultBuffer = Reader.Read(CacheInfo.CompressedSize);
+        // Read just the raw size of the buffer from the pooled handle, that's all we're returning
+        auto ResultBuffer = ReadPackageData(CacheInfo.PackageFileIndex, CacheInfo.Offset, CacheInfo.CompressedSize);
 
         // Set result size
-        ResultSize = (uint32_t)CacheInfo.CompressedSize;
+        ResultSize = ResultBuffer != nullptr ? (uint32_t)CacheInfo.CompressedSize : 0;
         // Return the safe buffer
         return ResultBuffer;
     }
@@ -191,24 +196,27 @@ std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObjectRaw(uint64_t CacheID,
 std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObject(uint64_t CacheID, uint32_t& ResultSize)
 {
     // Prepare to extract if found
-    if (CacheObjects.find(CacheID) != CacheObjects.end())
-    {
-        // Aquire lock
-        std::lock_guard<std::shared_mutex> Gaurd(ReadMutex);
+    PackageCacheObject CacheInfo;
 
+    if (FindCacheObject(CacheID, CacheInfo))
+    {
         // Take cache data, and extract from the XPAK (Uncompressed size = offset of data segment!)
-        auto& CacheInfo = CacheObjects[CacheID];
-        // Get the XPAK name
-        auto& XPAKFileName = PackageFilePaths[CacheInfo.PackageFileIndex];
-        // Open CASC File
-        auto Reader = CoDFileHandle(FileSystem->OpenFile(XPAKFileName, "r"), FileSystem.get());
 #if _DEBUG
-        printf("XSUBCache::ExtractPackageObject(): Streaming Object: 0x%llx from CASC File: %s\n", CacheID, XPAKFileName.c_str());
+        printf("XSUBCache::ExtractPackageObject(): Streaming Object: 0x%llx from CASC File: %s\n", CacheID, PackageFilePaths[CacheInfo.PackageFileIndex].c_str());
 #endif // _DEBUG
 
+        // Read the whole object from the pooled handle, then walk the blocks in memory
+        auto Payload = ReadPackageData(CacheInfo.PackageFileIndex, CacheInfo.Offset, CacheInfo.CompressedSize);
+
+        // Check if we read data
+        if (Payload == nullptr)
+        {
+            ResultSize = 0;
+            return nullptr;
+        }
 
-        // Hop to the beginning offset
-        Reader.Seek(CacheInfo.Offset, SEEK_SET);
+        // Positions in here are relative to the object offset
+        auto Reader = MemoryReader((int8_t*)Payload.get(), CacheInfo.CompressedSize, true);
 
         // A buffer for data read
         uint64_t DataRead = 0;
@@ -224,6 +232,10 @@ std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObject(uint64_t CacheID, uin
         // Loop until we have all our data
         while (DataRead < CacheInfo.CompressedSize)
         {
+            // Make sure we have a block header left
+            if (Reader.GetPosition() + 8 > Reader.GetLength())
+                break;
+
             // Read the block header
             auto Count = Reader.Read<uint32_t>();
             auto Offset = Reader.Read<uint32_t>();
@@ -233,9 +245,14 @@ std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObject(uint64_t CacheID, uin
                 break;
             // Read Variable Length Commands Buffer
             uint32_t Commands[256];
-            Reader.Read((uint8_t*)&Commands, 0, Count <= 30 ? 120 : Count * 4);
+            auto CommandsSize = Count <= 30 ? 120 : Count * 4;
+            auto CommandsData = Reader.GetCurrentStream(CommandsSize);
+            // Check if we read data
+            if (CommandsData == nullptr)
+                break;
+            std::memcpy(Commands, CommandsData, CommandsSize);
 #if _DEBUG
-            std::cout << "XSUBCache::LoadPackage(): Block Begin " << Reader.Tell() << ".\n";
+            std::cout << "XSUBCache::LoadPackage(): Block Begin " << Reader.GetPosition() << ".\n";
             std::cout << "XSUBCache::LoadPackage(): Block Count " << Count * 4 << ".\n";
 #endif
 
@@ -247,19 +264,19 @@ std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObject(uint64_t CacheID, uin
                 uint32_t CompressedFlag = (Commands[i] >> 24);
 
                 // Get current position
-                uint64_t CurrentPosition = Reader.Tell();
+                uint64_t CurrentPosition = Reader.GetPosition();
 
                 // Check the block type (3 = compressed (lz4), 8 = compressed (oodle), 0 = raw data, anything else = skip over!)
                 if (CompressedFlag == 0x3)
                 {
                     // Read the block
-                    auto DataBlock = Reader.Read(BlockSize);
+                    auto DataBlock = Reader.GetCurrentStream(BlockSize);
 
                     // Check if we read data
                     if (DataBlock != nullptr)
                     {
                         // Decompress the LZ4 block
-                        auto Result = Compression::DecompressLZ4Block((const int8_t*)DataBlock.get(), DataTemporaryBuffer + TotalDataSize, (uint32_t)BlockSize, 0x2400000);
+                        auto Result = Compression::DecompressLZ4Block((const int8_t*)DataBlock, DataTemporaryBuffer + TotalDataSize, (uint32_t)BlockSize, 0x2400000);
 
                         // Append size
                         TotalDataSize += Result;
@@ -268,13 +285,13 @@ std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObject(uint64_t CacheID, uin
                 else if (CompressedFlag == 0x8 || CompressedFlag == 0x9)
                 {
                     // Read the block
-                    auto DataBlock = Reader.Read(BlockSize);
+                    auto DataBlock = Reader.GetCurrentStream(BlockSize);
 
                     // Check if we read data
                     if (DataBlock != nullptr)
                     {
                         // Read oodle decompressed size
-                        uint32_t DecompressedSize = *(uint32_t*)(DataBlock.get());
+                        uint32_t DecompressedSize = *(uint32_t*)(DataBlock);
                         // Realloc if needed
                         if (TotalDataSize + DecompressedSize >= DataTemporaryBufferSize)
                         {
@@ -282,7 +299,7 @@ std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObject(uint64_t CacheID, uin
                             DataTemporaryBuffer = (int8_t*)std::realloc(DataTemporaryBuffer, DataTemporaryBufferSize);
                         }
                         // Decompress the Oodle block
-                        auto Result = Siren::Decompress((const uint8_t*)DataBlock.get() + 4, (uint32_t)BlockSize - 4, (uint8_t*)DataTemporaryBuffer + TotalDataSize, DecompressedSize);
+                        auto Result = Siren::Decompress((const uint8_t*)DataBlock + 4, (uint32_t)BlockSize - 4, (uint8_t*)DataTemporaryBuffer + TotalDataSize, DecompressedSize);
                         // Append size
                         TotalDataSize += Result;
                     }
@@ -290,7 +307,7 @@ std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObject(uint64_t CacheID, uin
                 else if (CompressedFlag == 0x6)
                 {
                     // Read the block
-                    auto DataBlock = Reader.Read(BlockSize);
+                    auto DataBlock = Reader.GetCurrentStream(BlockSize);
                     // Check if we're at the end of the block/less than the max block size, if so, use that
                     uint64_t RawBlockSize = DecompressedSize < 262112 ? DecompressedSize : 262112;
                     // Subtract from our total size
@@ -300,7 +317,7 @@ std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObject(uint64_t CacheID, uin
                     if (DataBlock != nullptr)
                     {
                         // Decompress the Oodle block
-                        auto Result = Siren::Decompress((const uint8_t*)DataBlock.get(), (uint32_t)BlockSize, (uint8_t*)DataTemporaryBuffer + TotalDataSize, RawBlockSize);
+                        auto Result = Siren::Decompress((const uint8_t*)DataBlock, (uint32_t)BlockSize, (uint8_t*)DataTemporaryBuffer + TotalDataSize, RawBlockSize);
                         // Append size
                         TotalDataSize += RawBlockSize;
                     }
@@ -308,7 +325,7 @@ std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObject(uint64_t CacheID, uin
                 else if (CompressedFlag == 0x0)
                 {
                     // Read the block
-                    auto DataBlock = Reader.Read(BlockSize);
+                    auto DataBlock = Reader.GetCurrentStream(BlockSize);
                     // Subtract from our total size
                     DecompressedSize -= BlockSize;
 
@@ -322,7 +339,7 @@ std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObject(uint64_t CacheID, uin
                             DataTemporaryBuffer = (int8_t*)std::realloc(DataTemporaryBuffer, DataTemporaryBufferSize);
                         }
                         // We just need to append it
-                        std::memcpy(DataTemporaryBuffer + TotalDataSize, DataBlock.get(), BlockSize);
+                        std::memcpy(DataTemporaryBuffer + TotalDataSize, DataBlock, BlockSize);
                         // Append size
                         TotalDataSize += BlockSize;
                     }
@@ -330,7 +347,7 @@ std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObject(uint64_t CacheID, uin
                 else
                 {
                     // As far as we care, any other flag value is padding (0xCF is one of them)
-                    Reader.Seek(BlockSize, SEEK_CUR);
+                    Reader.Advance(BlockSize);
                 }
 
                 // We must append the block size and pad it properly (If it's the last block)
@@ -346,8 +363,8 @@ std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObject(uint64_t CacheID, uin
                 }
                 else
                 {
-                    // We must pad this
-                    NextSegmentOffset = (((CurrentPosition + BlockSize) + 0x7F) & 0xFFFFFFFFFFFFF80);
+                    // We must pad this, the alignment is relative to the start of the package
+                    NextSegmentOffset = ((((CacheInfo.Offset + CurrentPosition + BlockSize) + 0x7F) & 0xFFFFFFFFFFFFF80) - CacheInfo.Offset);
                     TotalBlockSize += (NextSegmentOffset - CurrentPosition);
                 }
 
@@ -355,11 +372,11 @@ std::unique_ptr<uint8_t[]> XSUBCache::ExtractPackageObject(uint64_t CacheID, uin
                 DataRead += TotalBlockSize;
 
                 // Jump to next segment
-                Reader.Seek(NextSegmentOffset, SEEK_SET);
+                Reader.SetPosition(NextSegmentOffset);
             }
 
 #if _DEBUG
-            std::cout << "XSUBCache::LoadPackage(): Block End " << Reader.Tell() << ".\n";
+            std::cout << "XSUBCache::LoadPackage(): Block End " << Reader.GetPosition() << ".\n";
             std::cout << "XSUBCache::LoadPackage(): Block Count " << Count * 4 << ".\n";
 #endif
 
@@ -2,14 +2,10 @@
 // We need the package cache
 #include "CoDAssets.h"
 #include "CoDPackageCache.h"
-#include <shared_mutex>
 
 // A class that handles reading, caching and extracting CASC Resources
 class XSUBCache : public CoDPackageCache
 {
-private:
-    // Cache Mutex
-    std::shared_mutex ReadMutex;
 public:
     // Constructors
     XSUBCache();
@@ -19,6 +15,8 @@ public:
     virtual void LoadPackageCache(const std::string& BasePath);
     // Implement the load package
     virtual bool LoadPackage(const std::string& FilePath);
+    // Implement the parse package
+    virtual bool ParsePackage(const std::string& FilePath, PackageIndex& Index);
     // Implement the extract raw function
     virtual std::unique_ptr<uint8_t[]> ExtractPackageObjectRaw(uint64_t CacheID, uint32_t& ResultSize);
     // Implement the extract function
@@ -33,24 +33,22 @@ void XSUBCacheV2::LoadPackageCache(const std::string& BasePath)
     CoDPackageCache::LoadPackageCache(BasePath);
 
     // Verify we've successfully opened it.
-    if (!FileSystem->IsValid())
+    if (FileSystem == nullptr || !FileSystem->IsValid())
     {
         FileSystem = nullptr;
     }
     else
     {
         // First pass, catch xsub.
-        FileSystem->EnumerateFiles("*.xsub", [this](const std::string& name, const size_t size)
-        {
-            try
-            {
-                this->LoadPackage(name);
-            }
-            catch (...)
-            {
+        std::vector<std::string> FilePaths;
 
-            }
+        FileSystem->EnumerateFiles("*.xsub", [&FilePaths](const std::string& name, const size_t size)
+        {
+            FilePaths.push_back(name);
         });
+
+        // Load them, unchanged packages come from the index snapshot
+        this->LoadPackages(FilePaths);
     }
 
 
@@ -60,15 +58,27 @@ void XSUBCacheV2::LoadPackageCache(const std::string& BasePath)
 
 bool XSUBCacheV2::LoadPackage(const std::string& FilePath)
 {
-#ifdef _DEBUG
-    std::cout << "XSUBCacheV2::LoadPackage(): Parsing " << FilePath << "\n";
-#endif
-
     // Call Base function first
     CoDPackageCache::LoadPackage(FilePath);
 
-    // Add to package files
-    auto PackageIndex = (uint32_t)PackageFilePaths.size();
+    // Parse it
+    PackageIndex Index;
+
+    if (!ParsePackage(FilePath, Index))
+        return false;
+
+    // Add it
+    AddPackage(Index);
+
+    // No issues
+    return true;
+}
+
+bool XSUBCacheV2::ParsePackage(const std::string& FilePath, PackageIndex& Index)
+{
+#ifdef _DEBUG
+    std::cout << "XSUBCacheV2::ParsePackage(): Parsing " << FilePath << "\n";
+#endif
 
     auto Reader = CoDFileHandle(FileSystem->OpenFile(FilePath, "r"), FileSystem.get());
 
@@ -79,40 +89,45 @@ bool XSUBCacheV2::LoadPackage(const std::string& FilePath)
     if (Header.Type != 3)
         return true;
 
+    // The size of the package
+    auto FileSize = Reader.Size();
 
     // Verify the magic and offset
-    if (Header.Magic == 0x4950414b && Header.HashOffset < Reader.Size())
+    if (Header.Magic == 0x4950414b && Header.HashOffset >= 0 && (uint64_t)Header.HashOffset < FileSize && Header.HashCount >= 0 && (uint64_t)Header.HashCount <= (FileSize - Header.HashOffset) / sizeof(VGXSUBHashEntry))
     {
         // Jump to hash offset
         Reader.Seek(Header.HashOffset, SEEK_SET);
-        // Read Buffer
+
+        // Read the whole table at once
         auto Buffer = Reader.Read(Header.HashCount * sizeof(VGXSUBHashEntry));
-        // Read the hash data into a buffer
-        auto HashData = MemoryReader((int8_t*)Buffer.release(), Header.HashCount * sizeof(VGXSUBHashEntry));
+
+        // Verify result
+        if (Buffer == nullptr && Header.HashCount > 0)
+            return false;
+
+        auto Entries = (const VGXSUBHashEntry*)Buffer.get();
+
+        Index.Entries.reserve(Header.HashCount);
 
         // Loop and setup entries
         for (int64_t i = 0; i < Header.HashCount; i++)
         {
-            // Read it
-            auto Entry = HashData.Read<VGXSUBHashEntry>();
-
             // Prepare a cache entry
-            PackageCacheObject NewObject{};
+            PackageIndexEntry NewEntry{};
             // Set data
-            NewObject.Offset = (Entry.PackedInfo >> 32) << 7;
-            NewObject.CompressedSize = (Entry.PackedInfo >> 1) & 0x3FFFFFFF;
-            NewObject.UncompressedSize = (Entry.PackedInfo >> 1) & 0xFFFFFFFF;
-            NewObject.PackageFileIndex = PackageIndex;
-
-            // Append to database
-            CacheObjects.insert(std::make_pair(Entry.Key, NewObject));
+            NewEntry.Key = Entries[i].Key;
+            NewEntry.Offset = (Entries[i].PackedInfo >> 32) << 7;
+            NewEntry.CompressedSize = (Entries[i].PackedInfo >> 1) & 0x3FFFFFFF;
+            NewEntry.UncompressedSize = (Entries[i].PackedInfo >> 1) & 0xFFFFFFFF;
+            // Append to package
+            Index.Entries.push_back(NewEntry);
         }
 
-        // Append the file path
-        PackageFilePaths.push_back(FilePath);
+        // Set the file path
+        Index.FilePath = FilePath;
 
 #ifdef _DEBUG
-        std::cout << "XSUBCacheV2::LoadPackage(): Added " << FilePath << " to cache.\n";
+        std::cout << "XSUBCacheV2::ParsePackage(): Parsed " << FilePath << ".\n";
 #endif
 
         // No issues
@@ -120,7 +135,7 @@ bool XSUBCacheV2::LoadPackage(const std::string& FilePath)
     }
 
 #ifdef _DEBUG
-    std::cout << "XSUBCacheV2::LoadPackage(): Failed to parse package.\n";
+    std::cout << "XSUBCacheV2::ParsePackage(): Failed to parse package.\n";
 #endif
 
     // Failed
@@ -130,101 +145,111 @@ bool XSUBCacheV2::LoadPackage(const std::string& FilePath)
 std::unique_ptr<uint8_t[]> XSUBCacheV2::ExtractPackageObject(uint64_t CacheID, int32_t Size, uint32_t& ResultSize)
 {
     // Prepare to extract if found
-    if (CacheObjects.find(CacheID) != CacheObjects.end())
+    PackageCacheObject CacheInfo;
+
+    if (FindCacheObject(CacheID, CacheInfo))
     {
         // Take cache data, and extract from the XPAK (Uncompressed size = offset of data segment!)
-        auto& CacheInfo = CacheObjects[CacheID];
-        // Get the XPAK name
-        auto& XPAKFileName = PackageFilePaths[CacheInfo.PackageFileIndex];
-        auto Reader = CoDFileHandle(FileSystem->OpenFile(XPAKFileName, "r"), FileSystem.get());
-
 
-        auto ReadUsage = 0.0;
 #if _DEBUG
-        // printf("XSUBCache::ExtractPackageObject(): Streaming Object: 0x%llx from CASC File: %s\n", CacheID, XPAKFileName.c_str());
+        // printf("XSUBCache::ExtractPackageObject(): Streaming Object: 0x%llx from CASC File: %s\n", CacheID, PackageFilePaths[CacheInfo.PackageFileIndex].c_str());
 #endif // _DEBUG
 
+        // Read the whole object from the pooled handle, then walk the blocks in memory
+        auto Payload = ReadPackageData(CacheInfo.PackageFileIndex, CacheInfo.Offset, CacheInfo.CompressedSize);
+
+        // Check if we read data
+        if (Payload == nullptr || CacheInfo.CompressedSize < 10)
+        {
+            ResultSize = 0;
+            return nullptr;
+        }
+
         // A buffer for total size
         uint64_t TotalDataSize = 0;
 
         // A buffer for the data, this will eventually be shipped off, it's 50MB of memory
-        auto DataTemporaryBufferSize = Size > 0 ? Size : 0x2400000;
+        auto DataTemporaryBufferSize = std::max<uint64_t>(Size > 0 ? Size : 0x2400000, CacheInfo.CompressedSize);
         auto ResultBuffer = std::make_unique<uint8_t[]>(DataTemporaryBufferSize);
-        // Block Info
-        auto BlockPosition = CacheInfo.Offset;
-        auto BlockEnd = CacheInfo.Offset + CacheInfo.CompressedSize;
+        // Block Info, positions are relative to the object, blocks are aligned in the package though
+        uint64_t BlockPosition = 0;
         VGXSUBBlock Blocks[256];
 
-        // Hop to the beginning offset
-        Reader.Seek(BlockPosition + 2, SEEK_SET);
-
         // Raw block, hacky check, probably will be info
         // within Gfx Mips and other data
-        if (Reader.Read<uint64_t>() != CacheID)
+        if (*(uint64_t*)(Payload.get() + 2) != CacheID)
         {
-            // Hop to the beginning offset
-            Reader.Seek(BlockPosition, SEEK_SET);
-            // Read
-            Reader.Read((uint8_t*)ResultBuffer.get(), 0, CacheInfo.CompressedSize);
+            // Copy it
+            std::memcpy(ResultBuffer.get(), Payload.get(), CacheInfo.CompressedSize);
             // Set size
-            TotalDataSize = CacheInfo.CompressedSize;
+            ResultSize = (uint32_t)CacheInfo.CompressedSize;
             // Done
             return ResultBuffer;
         }
 
-        while ((uint64_t)Reader.Tell() < BlockEnd)
+        auto Reader = MemoryReader((int8_t*)Payload.get(), CacheInfo.CompressedSize, true);
+        // The blocks to decompress, offsets are stored so they can run in any order
+        std::vector<PackageObjectBlock> ObjectBlocks;
+
+        while (BlockPosition + 23 <= Reader.GetLength())
         {
             // Hop to the beginning offset, skip header
-            Reader.Seek(BlockPosition + 22, SEEK_SET);
+            Reader.SetPosition(BlockPosition + 22);
 
             // Read blocks
             auto BlockCount = (uint32_t)Reader.Read<uint8_t>();
+            auto BlockInfo = Reader.GetCurrentStream(BlockCount * sizeof(VGXSUBBlock));
+
+            // Check if we read data
+            if (BlockInfo == nullptr)
+                break;
+
             std::memset(Blocks, 0, sizeof(Blocks));
-            Reader.Read((uint8_t*)&Blocks, 0, BlockCount * sizeof(VGXSUBBlock));
+            std::memcpy(Blocks, BlockInfo, BlockCount * sizeof(VGXSUBBlock));
 
             // Loop for block count
             for (uint32_t i = 0; i < BlockCount; i++)
             {
                 // Hop to the beginning offset, skip header
-                Reader.Seek(BlockPosition + Blocks[i].BlockOffset, SEEK_SET);
+                Reader.SetPosition(BlockPosition + Blocks[i].BlockOffset);
                 // Read the block
-                auto DataBlock = Reader.Read(Blocks[i].CompressedSize);
+                auto DataBlock = Reader.GetCurrentStream(Blocks[i].CompressedSize);
+
+                // Check if we read data
+                if (DataBlock == nullptr)
+                    continue;
 
                 switch (Blocks[i].Compression)
                 {
                 case 0x3:
-                    // Decompress the LZ4 block
-                    Compression::DecompressLZ4Block((const int8_t*)DataBlock.get(), (int8_t*)ResultBuffer.get() + Blocks[i].DecompressedOffset, Blocks[i].CompressedSize, Blocks[i].DecompressedSize);
-                    // Append size
-                    TotalDataSize += Blocks[i].DecompressedSize;
-                    // Done
-                    break;
                 case 0x6:
-                    // Decompress the Oodle block
-                    Siren::Decompress((const uint8_t*)DataBlock.get(), Blocks[i].CompressedSize, ResultBuffer.get() + Blocks[i].DecompressedOffset, Blocks[i].DecompressedSize);
-                    // Append size
-                    TotalDataSize += Blocks[i].DecompressedSize;
-                    // Done
-                    break;
                 case 0x0:
-                    // We just need to append it
-                    std::memcpy(ResultBuffer.get() + Blocks[i].DecompressedOffset, DataBlock.get(), Blocks[i].CompressedSize);
+                    // Queue the LZ4, Oodle or raw block
+                    ObjectBlocks.push_back({ Blocks[i].Compression, (const uint8_t*)DataBlock, Blocks[i].CompressedSize, Blocks[i].DecompressedOffset, Blocks[i].DecompressedSize });
                     // Append size
                     TotalDataSize += Blocks[i].DecompressedSize;
                     // Done
                     break;
                 default:
                     // As far as we care, any other flag value is padding (0xCF is one of them)
-                    Reader.Seek(Blocks[i].CompressedSize, SEEK_CUR);
+                    Reader.Advance(Blocks[i].CompressedSize);
                     // Done
                     break;
                 }
             }
 
-            // Set next block
-            BlockPosition = ((Reader.Tell() + 0x7F) & 0xFFFFFFFFFFFFF80);
+            // Set next block, the alignment is relative to the start of the package, stop if we didn't move forward
+            auto NextBlockPosition = (((CacheInfo.Offset + Reader.GetPosition()) + 0x7F) & 0xFFFFFFFFFFFFF80) - CacheInfo.Offset;
+
+            if (NextBlockPosition <= BlockPosition)
+                break;
+
+            BlockPosition = NextBlockPosition;
         }
 
+        // Decompress the blocks, large objects are spread over the converter
+        DecompressPackageBlocks(ObjectBlocks, ResultBuffer.get(), DataTemporaryBufferSize);
+
         // Return the safe buffer
         ResultSize = (uint32_t)TotalDataSize;
         return ResultBuffer;
@@ -253,6 +278,7 @@ std::unique_ptr<uint8_t[]> XSUBCacheV2::DecompressPackageObject(uint64_t cacheID
 
     size_t blockPosition = 0;
     VGXSUBBlock Blocks[256];
+    std::vector<PackageObjectBlock> objectBlocks;
 
     while (reader.GetPosition() < reader.GetLength())
     {
@@ -303,15 +329,9 @@ std::unique_ptr<uint8_t[]> XSUBCacheV2::DecompressPackageObject(uint64_t cacheID
             switch (Blocks[i].Compression)
             {
             case 0x3:
-                Compression::DecompressLZ4Block((const int8_t*)dataBlock, (int8_t*)result.get() + Blocks[i].DecompressedOffset, Blocks[i].CompressedSize, Blocks[i].DecompressedSize);
-                resultSize += Blocks[i].DecompressedSize;
-                break;
             case 0x6:
-                Siren::Decompress((const uint8_t*)dataBlock, Blocks[i].CompressedSize, result.get() + Blocks[i].DecompressedOffset, Blocks[i].DecompressedSize);
-                resultSize += Blocks[i].DecompressedSize;
-                break;
             case 0x0:
-                std::memcpy(result.get() + Blocks[i].DecompressedOffset, dataBlock, Blocks[i].CompressedSize);
+                objectBlocks.push_back({ Blocks[i].Compression, (const uint8_t*)dataBlock, Blocks[i].CompressedSize, Blocks[i].DecompressedOffset, Blocks[i].DecompressedSize });
                 resultSize += Blocks[i].DecompressedSize;
                 break;
             default:
@@ -323,5 +343,8 @@ std::unique_ptr<uint8_t[]> XSUBCacheV2::DecompressPackageObject(uint64_t cacheID
         reader.SetPosition((reader.GetPosition() + 0x7F) & 0xFFFFFFFFFFFFF80);
     }
 
+    // Every block has its own offset, so they can be decompressed in any order.
+    DecompressPackageBlocks(objectBlocks, result.get(), decompressedSize);
+
     return result;
 }
\ No newline at end of file
@@ -39,36 +39,27 @@ void XSUBCacheV3::LoadPackageCache(const std::string& BasePath)
     CoDPackageCache::LoadPackageCache(BasePath);
 
     // Verify we've successfully opened it.
-    if (!FileSystem->IsValid())
+    if (FileSystem == nullptr || !FileSystem->IsValid())
     {
         FileSystem = nullptr;
     }
     else
     {
+        std::vector<std::string> FilePaths;
+
         // First pass, catch xsub.
-        FileSystem->EnumerateFiles("*.xsub", [this](const std::string& name, const size_t size)
+        FileSystem->EnumerateFiles("*.xsub", [&FilePaths](const std::string& name, const size_t size)
         {
-            try
-            {
-                this->LoadPackage(name);
-            }
-            catch (...)
-            {
-
-            }
+            FilePaths.push_back(name);
         });
         // Secon pass, catch xpak.
-        FileSystem->EnumerateFiles("*.xpak", [this](const std::string& name, const size_t size)
+        FileSystem->EnumerateFiles("*.xpak", [&FilePaths](const std::string& name, const size_t size)
         {
-            try
-            {
-                this->LoadPackage(name);
-            }
-            catch (...)
-            {
-
-            }
+            FilePaths.push_back(name);
         });
+
+        // Load them, unchanged packages come from the index snapshot
+        this->LoadPackages(FilePaths);
     }
 
     // We've finished loading, set status
@@ -77,15 +68,27 @@ void XSUBCacheV3::LoadPackageCache(const std::string& BasePath)
 
 bool XSUBCacheV3::LoadPackage(const std::string& FilePath)
 {
-#ifdef _DEBUG
-    std::cout << "XSUBCacheV3::LoadPackage(): Parsing " << FilePath << "\n";
-#endif
-
     // Call Base function first
     CoDPackageCache::LoadPackage(FilePath);
 
-    // Add to package files
-    auto PackageIndex = (uint32_t)PackageFilePaths.size();
+    // Parse it
+    PackageIndex Index;
+
+    if (!ParsePackage(FilePath, Index))
+        return false;
+
+    // Add it
+    AddPackage(Index);
+
+    // No issues
+    return true;
+}
+
+bool XSUBCacheV3::ParsePackage(const std::string& FilePath, PackageIndex& Index)
+{
+#ifdef _DEBUG
+    std::cout << "XSUBCacheV3::ParsePackage(): Parsing " << FilePath << "\n";
+#endif
 
     // Open CASC File
     // TODO: Implement read, seek, etc. right in this handle class.
@@ -107,12 +110,15 @@ bool XSUBCacheV3::LoadPackage(const std::string& FilePath)
         return false;
     }
 
+    // The size of the package
+    auto FileSize = FileSystem->Size(Handle.GetHandle());
+
     // Verify the magic and offset
-    if (Header.Magic == 0x4950414b && Header.HashOffset < FileSystem->Size(Handle.GetHandle()))
+    if (Header.Magic == 0x4950414b && Header.HashOffset < FileSize && Header.HashCount <= (FileSize - Header.HashOffset) / sizeof(XSUBHashEntryV2))
     {
         // Jump to hash offset
         FileSystem->Seek(Handle.GetHandle(), Header.HashOffset, SEEK_SET);
-        // Read Buffer
+        // Read the whole table at once
         auto Buffer = FileSystem->Read(Handle.GetHandle(), Header.HashCount * sizeof(XSUBHashEntryV2));
 
         // Verify result
@@ -121,32 +127,29 @@ bool XSUBCacheV3::LoadPackage(const std::string& FilePath)
             return false;
         }
 
-        // Read the hash data into a buffer
-        auto HashData = MemoryReader((int8_t*)Buffer.release(), Header.HashCount * sizeof(XSUBHashEntryV2));
+        auto Entries = (const XSUBHashEntryV2*)Buffer.get();
+
+        Index.Entries.reserve(Header.HashCount);
 
         // Loop and setup entries
-        for (int64_t i = 0; i < Header.HashCount; i++)
+        for (uint64_t i = 0; i < Header.HashCount; i++)
         {
-            // Read it
-            auto Entry = HashData.Read<XSUBHashEntryV2>();
-
             // Prepare a cache entry
-            PackageCacheObject NewObject{};
+            PackageIndexEntry NewEntry{};
             // Set data
-            NewObject.Offset           = (Entry.PackedInfo >> 32) << 7;
-            NewObject.CompressedSize   = (Entry.PackedInfo >> 1) & 0x3FFFFFFF;
-            NewObject.UncompressedSize = 0;
-            NewObject.PackageFileIndex = PackageIndex;
-
-            // Append to database
-            CacheObjects.insert(std::make_pair(Entry.Key, NewObject));
+            NewEntry.Key              = Entries[i].Key;
+            NewEntry.Offset           = (Entries[i].PackedInfo >> 32) << 7;
+            NewEntry.CompressedSize   = (Entries[i].PackedInfo >> 1) & 0x3FFFFFFF;
+            NewEntry.UncompressedSize = 0;
+            // Append to package
+            Index.Entries.push_back(NewEntry);
         }
 
-        // Append the file path
-        PackageFilePaths.push_back(FinalPath);
+        // Set the file path
+        Index.FilePath = FinalPath;
 
 #ifdef _DEBUG
-        std::cout << "XSUBCacheV3::LoadPackage(): Added " << FilePath << " to cache.\n";
+        std::cout << "XSUBCacheV3::ParsePackage(): Parsed " << FilePath << ".\n";
 #endif
 
         // No issues
@@ -154,7 +157,7 @@ bool XSUBCacheV3::LoadPackage(const std::string& FilePath)
     }
 
 #ifdef _DEBUG
-    std::cout << "XSUBCacheV3::LoadPackage(): Failed to parse package.\n";
+    std::cout << "XSUBCacheV3::ParsePackage(): Failed to parse package.\n";
 #endif
 
     // Failed
@@ -164,10 +167,11 @@ bool XSUBCacheV3::LoadPackage(const std::string& FilePath)
 std::unique_ptr<uint8_t[]> XSUBCacheV3::ExtractPackageObject(uint64_t CacheID, int32_t Size, uint32_t& ResultSize)
 {
     // Prepare to extract if found
-    if (CacheObjects.find(CacheID) != CacheObjects.end())
+    PackageCacheObject CacheInfo;
+
+    if (FindCacheObject(CacheID, CacheInfo))
     {
         // Take cache data, and extract from the XPAK (Uncompressed size = offset of data segment!)
-        auto& CacheInfo = CacheObjects[CacheID];
         // Get the XPAK name
         auto& XPAKFileName = PackageFilePaths[CacheInfo.PackageFileIndex];
         // Open CASC File